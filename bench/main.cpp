@@ -0,0 +1,829 @@
+// ptmanager_bench: repeatable microbenchmarks for the thread pool, IPC
+// channels, lock primitives, process creation and tracing.
+//
+// Every benchmark runs a fixed amount of work, is repeated --repetitions
+// times and reports the median of each metric, so two runs on the same
+// machine are comparable. Results are printed as a table; --json writes
+// them for regression tracking.
+//
+// Usage: ptmanager_bench [--json FILE|-] [--filter TEXT] [--repetitions N]
+//                        [--quick] [--list]
+
+#include "ProcessManager.h"
+#include "ThreadPool.h"
+#include "IPC.h"
+#include "ShmRingBuffer.h"
+#include "Synchronization.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace PTManager;
+
+namespace {
+
+// ============================================================================
+// HARNESS
+// ============================================================================
+
+using Params = std::vector<std::pair<std::string, std::string>>;
+using Metrics = std::vector<std::pair<std::string, double>>;
+
+struct Result {
+    std::string group;
+    std::string name;
+    Params params;
+    Metrics metrics;
+};
+
+struct Options {
+    std::string jsonPath;
+    std::string filter;
+    int repetitions = 5;
+    bool quick = false;
+    bool list = false;
+};
+
+Options options;
+std::vector<Result> results;
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Scales an iteration count down for --quick
+size_t iterations(size_t full) {
+    return options.quick ? std::max<size_t>(full / 10, 1) : full;
+}
+
+double percentile(std::vector<uint64_t> samples, double q) {
+    if (samples.empty()) {
+        return 0;
+    }
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(q * static_cast<double>(samples.size())));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(index), samples.end());
+    return static_cast<double>(samples[index]);
+}
+
+double mean(const std::vector<uint64_t>& samples) {
+    if (samples.empty()) {
+        return 0;
+    }
+    double sum = 0;
+    for (uint64_t sample : samples) sum += static_cast<double>(sample);
+    return sum / static_cast<double>(samples.size());
+}
+
+std::string describe(const std::string& group, const std::string& name, const Params& params) {
+    std::string text = group + "/" + name;
+    for (const auto& [key, value] : params) {
+        text += " " + key + "=" + value;
+    }
+    return text;
+}
+
+std::string formatValue(double value) {
+    std::ostringstream out;
+    if (value != 0 && (value >= 1e7 || value < 0.01)) {
+        out << std::scientific << std::setprecision(3) << value;
+    } else {
+        out << std::fixed << std::setprecision(value >= 100 ? 0 : 2) << value;
+    }
+    return out.str();
+}
+
+// Runs one benchmark configuration options.repetitions times and records
+// the median of every metric. A run returning no metrics counts as failed.
+void run(const std::string& group, const std::string& name, const Params& params,
+         const std::function<Metrics()>& body) {
+    std::string label = describe(group, name, params);
+    if (!options.filter.empty() && label.find(options.filter) == std::string::npos) {
+        return;
+    }
+    if (options.list) {
+        std::cout << label << std::endl;
+        return;
+    }
+
+    std::vector<Metrics> runs;
+    for (int i = 0; i < options.repetitions; ++i) {
+        Metrics metrics = body();
+        if (metrics.empty()) {
+            std::cout << std::left << std::setw(56) << label << " FAILED" << std::endl;
+            return;
+        }
+        runs.push_back(std::move(metrics));
+    }
+
+    Result result{group, name, params, {}};
+    for (size_t m = 0; m < runs.front().size(); ++m) {
+        std::vector<double> values;
+        for (const Metrics& metrics : runs) values.push_back(metrics[m].second);
+        std::sort(values.begin(), values.end());
+        result.metrics.emplace_back(runs.front()[m].first, values[values.size() / 2]);
+    }
+
+    std::cout << std::left << std::setw(56) << label;
+    for (const auto& [key, value] : result.metrics) {
+        std::cout << " " << key << "=" << formatValue(value);
+    }
+    std::cout << std::endl;
+    results.push_back(std::move(result));
+}
+
+std::string jsonEscape(const std::string& text) {
+    std::string out;
+    for (char c : text) {
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char code[8];
+                    std::snprintf(code, sizeof(code), "\\u%04x", c);
+                    out += code;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+void writeJson(std::ostream& out) {
+    utsname host{};
+    uname(&host);
+    out << "{\n";
+    out << "  \"benchmark\": \"ptmanager_bench\",\n";
+    out << "  \"timestamp\": " << std::chrono::duration_cast<std::chrono::seconds>(
+                                      std::chrono::system_clock::now().time_since_epoch()).count() << ",\n";
+    out << "  \"host\": {\"cpus\": " << std::thread::hardware_concurrency() << ", \"kernel\": \""
+        << jsonEscape(host.release) << "\", \"machine\": \"" << jsonEscape(host.machine) << "\"},\n";
+    out << "  \"repetitions\": " << options.repetitions << ",\n";
+    out << "  \"quick\": " << (options.quick ? "true" : "false") << ",\n";
+    out << "  \"results\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"group\": \"" << jsonEscape(result.group) << "\", \"name\": \"" << jsonEscape(result.name)
+            << "\", \"params\": {";
+        for (size_t p = 0; p < result.params.size(); ++p) {
+            out << (p == 0 ? "" : ", ") << "\"" << jsonEscape(result.params[p].first) << "\": \""
+                << jsonEscape(result.params[p].second) << "\"";
+        }
+        out << "}, \"metrics\": {";
+        for (size_t m = 0; m < result.metrics.size(); ++m) {
+            out << (m == 0 ? "" : ", ") << "\"" << jsonEscape(result.metrics[m].first) << "\": "
+                << std::setprecision(17) << result.metrics[m].second;
+        }
+        out << "}}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+// ============================================================================
+// THREAD POOL
+// ============================================================================
+
+const char* modeName(SchedulingMode mode) {
+    return mode == SchedulingMode::WORK_STEALING ? "stealing" : "global";
+}
+
+// One task at a time into an idle pool: the cost of waking a worker
+Metrics poolDispatchLatency(size_t workers, SchedulingMode mode) {
+    ThreadPool pool(workers, mode);
+    size_t count = iterations(5000);
+    std::vector<uint64_t> latencies(count);
+    std::atomic<size_t> started{0};
+
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t submitted = nowNs();
+        pool.post([&latencies, &started, submitted, i] {
+            latencies[i] = nowNs() - submitted;
+            started.store(i + 1, std::memory_order_release);
+        });
+        while (started.load(std::memory_order_acquire) != i + 1) {
+            std::this_thread::yield();
+        }
+    }
+    pool.waitForCompletion();
+    return {{"dispatch_p50_ns", percentile(latencies, 0.5)},
+            {"dispatch_p99_ns", percentile(latencies, 0.99)}};
+}
+
+// A burst of empty tasks: submission plus scheduling overhead per task
+Metrics poolPostThroughput(size_t workers, SchedulingMode mode) {
+    ThreadPool pool(workers, mode);
+    size_t count = iterations(200000);
+    std::atomic<size_t> executed{0};
+
+    uint64_t start = nowNs();
+    for (size_t i = 0; i < count; ++i) {
+        pool.post([&executed] { executed.fetch_add(1, std::memory_order_relaxed); });
+    }
+    uint64_t submitted = nowNs();
+    pool.waitForCompletion();
+    uint64_t finished = nowNs();
+
+    if (executed.load() != count) {
+        return {};
+    }
+    return {{"tasks_per_sec", static_cast<double>(count) * 1e9 / static_cast<double>(finished - start)},
+            {"enqueue_ns", static_cast<double>(submitted - start) / static_cast<double>(count)}};
+}
+
+// Like poolPostThroughput, but every task carries a future
+Metrics poolEnqueueThroughput(size_t workers, SchedulingMode mode) {
+    ThreadPool pool(workers, mode);
+    size_t count = iterations(100000);
+    std::vector<std::future<size_t>> futures;
+    futures.reserve(count);
+
+    uint64_t start = nowNs();
+    for (size_t i = 0; i < count; ++i) {
+        futures.push_back(pool.enqueue([i] { return i; }));
+    }
+    size_t sum = 0;
+    for (auto& future : futures) {
+        sum += future.get();
+    }
+    uint64_t finished = nowNs();
+
+    if (sum != count * (count - 1) / 2) {
+        return {};
+    }
+    return {{"tasks_per_sec", static_cast<double>(count) * 1e9 / static_cast<double>(finished - start)}};
+}
+
+void benchThreadPool() {
+    for (SchedulingMode mode : {SchedulingMode::GLOBAL_QUEUE, SchedulingMode::WORK_STEALING}) {
+        for (size_t workers : {1, 2, 4, 8}) {
+            Params params = {{"workers", std::to_string(workers)}, {"mode", modeName(mode)}};
+            run("threadpool", "dispatch_latency", params, [=] { return poolDispatchLatency(workers, mode); });
+            run("threadpool", "post_throughput", params, [=] { return poolPostThroughput(workers, mode); });
+            run("threadpool", "enqueue_throughput", params, [=] { return poolEnqueueThroughput(workers, mode); });
+        }
+    }
+}
+
+// ============================================================================
+// IPC
+// ============================================================================
+
+// Fixed-size messages in both directions between this process and a forked
+// peer. open() runs before the fork, attach() in each process after it.
+class Channel {
+public:
+    virtual ~Channel() = default;
+    virtual bool open() = 0;
+    virtual bool attach(bool peer) { (void)peer; return true; }
+    virtual bool send(bool peer, const char* data, size_t size) = 0;
+    virtual bool receive(bool peer, char* buffer, size_t size) = 0;
+    virtual void close() {}
+};
+
+class PipeChannel : public Channel {
+private:
+    Pipe toPeer;
+    Pipe toParent;
+    std::unique_ptr<FrameReader> reader;
+
+public:
+    bool open() override {
+        return toPeer.getReadFd() != -1 && toParent.getReadFd() != -1;
+    }
+    bool attach(bool peer) override {
+        if (peer) {
+            toPeer.closeWrite();
+            toParent.closeRead();
+            reader = std::make_unique<FrameReader>(toPeer.getReadFd());
+        } else {
+            toPeer.closeRead();
+            toParent.closeWrite();
+            reader = std::make_unique<FrameReader>(toParent.getReadFd());
+        }
+        return true;
+    }
+    bool send(bool peer, const char* data, size_t size) override {
+        return (peer ? toParent : toPeer).writeFrame(data, size);
+    }
+    bool receive(bool, char* buffer, size_t size) override {
+        std::string_view frame;
+        if (!reader->next(frame) || frame.size() != size) {
+            return false;
+        }
+        std::memcpy(buffer, frame.data(), size);
+        return true;
+    }
+    void close() override {
+        toPeer.close();
+        toParent.close();
+    }
+};
+
+class FifoChannel : public Channel {
+private:
+    NamedPipe toPeer;
+    NamedPipe toParent;
+    std::unique_ptr<FrameReader> reader;
+
+public:
+    FifoChannel()
+        : toPeer("/tmp/ptm_bench_fifo_" + std::to_string(getpid()) + "_down"),
+          toParent("/tmp/ptm_bench_fifo_" + std::to_string(getpid()) + "_up") {}
+
+    bool open() override {
+        return toPeer.create() && toParent.create();
+    }
+    // Both sides open the down FIFO first, so the blocking opens pair up
+    bool attach(bool peer) override {
+        bool opened = peer ? toPeer.openForReading() && toParent.openForWriting()
+                           : toPeer.openForWriting() && toParent.openForReading();
+        reader = std::make_unique<FrameReader>(peer ? toPeer.getFd() : toParent.getFd());
+        return opened;
+    }
+    bool send(bool peer, const char* data, size_t size) override {
+        return (peer ? toParent : toPeer).writeFrame(data, size);
+    }
+    bool receive(bool, char* buffer, size_t size) override {
+        std::string_view frame;
+        if (!reader->next(frame) || frame.size() != size) {
+            return false;
+        }
+        std::memcpy(buffer, frame.data(), size);
+        return true;
+    }
+    void close() override {
+        toPeer.close();
+        toParent.close();
+        toPeer.remove();
+        toParent.remove();
+    }
+};
+
+// One queue; type 1 carries messages to the peer, type 2 back
+class SysVChannel : public Channel {
+private:
+    MessageQueue queue{"/tmp", 'B'};
+
+public:
+    bool open() override {
+        if (!queue.create()) {
+            return false;
+        }
+        std::vector<std::vector<char>> stale;
+        queue.receiveBatch(stale, SIZE_MAX, 0, IPC_NOWAIT);
+        return true;
+    }
+    bool send(bool peer, const char* data, size_t size) override {
+        return queue.send(peer ? 2 : 1, data, size);
+    }
+    bool receive(bool peer, char* buffer, size_t size) override {
+        long type = 0;
+        return queue.receive(buffer, size, type, peer ? 1 : 2) == static_cast<ssize_t>(size);
+    }
+    void close() override {
+        queue.remove();
+    }
+};
+
+class ShmRingChannel : public Channel {
+private:
+    static constexpr size_t CAPACITY = 256 * 1024;
+    SharedMemory downShm;
+    SharedMemory upShm;
+    ShmRingBuffer down{downShm};
+    ShmRingBuffer up{upShm};
+
+public:
+    ShmRingChannel()
+        : downShm("/ptm_bench_ring_down", ShmRingBuffer::requiredSize(CAPACITY)),
+          upShm("/ptm_bench_ring_up", ShmRingBuffer::requiredSize(CAPACITY)) {}
+
+    bool open() override {
+        return downShm.create() && downShm.map() && upShm.create() && upShm.map() &&
+               down.initialize(RingMode::SPSC) && up.initialize(RingMode::SPSC);
+    }
+    bool send(bool peer, const char* data, size_t size) override {
+        return (peer ? up : down).write(data, size, std::chrono::milliseconds(10000));
+    }
+    bool receive(bool peer, char* buffer, size_t size) override {
+        size_t length = 0;
+        return (peer ? down : up).read(buffer, size, length, std::chrono::milliseconds(10000)) &&
+               length == size;
+    }
+    void close() override {
+        downShm.unmap();
+        downShm.unlink();
+        upShm.unmap();
+        upShm.unlink();
+    }
+};
+
+std::unique_ptr<Channel> makeChannel(const std::string& kind) {
+    if (kind == "pipe") return std::make_unique<PipeChannel>();
+    if (kind == "fifo") return std::make_unique<FifoChannel>();
+    if (kind == "sysv") return std::make_unique<SysVChannel>();
+    return std::make_unique<ShmRingChannel>();
+}
+
+// Ping-pong for round-trip latency, then a one-way stream acknowledged by
+// a single reply for message rate
+Metrics ipcRoundTripAndRate(const std::string& kind, size_t size) {
+    std::unique_ptr<Channel> channel = makeChannel(kind);
+    if (!channel->open()) {
+        channel->close();
+        return {};
+    }
+
+    const size_t warmup = 100;
+    const size_t roundTrips = iterations(10000);
+    const size_t streamed = iterations(100000);
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        std::vector<char> message(size);
+        bool ok = channel->attach(true);
+        for (size_t i = 0; ok && i < warmup + roundTrips; ++i) {
+            ok = channel->receive(true, message.data(), size) && channel->send(true, message.data(), size);
+        }
+        for (size_t i = 0; ok && i < streamed; ++i) {
+            ok = channel->receive(true, message.data(), size);
+        }
+        ok = ok && channel->send(true, message.data(), size);
+        _exit(ok ? 0 : 1);
+    }
+    if (pid < 0) {
+        channel->close();
+        return {};
+    }
+
+    std::vector<char> message(size, 'm');
+    std::vector<uint64_t> rtts;
+    rtts.reserve(roundTrips);
+    bool ok = channel->attach(false);
+    for (size_t i = 0; ok && i < warmup + roundTrips; ++i) {
+        uint64_t start = nowNs();
+        ok = channel->send(false, message.data(), size) && channel->receive(false, message.data(), size);
+        if (i >= warmup) {
+            rtts.push_back(nowNs() - start);
+        }
+    }
+
+    uint64_t start = nowNs();
+    for (size_t i = 0; ok && i < streamed; ++i) {
+        ok = channel->send(false, message.data(), size);
+    }
+    ok = ok && channel->receive(false, message.data(), size);
+    uint64_t elapsed = nowNs() - start;
+
+    if (!ok) {
+        kill(pid, SIGKILL);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    channel->close();
+    if (!ok || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return {};
+    }
+
+    double rate = static_cast<double>(streamed) * 1e9 / static_cast<double>(elapsed);
+    return {{"rtt_p50_ns", percentile(rtts, 0.5)},
+            {"rtt_p99_ns", percentile(rtts, 0.99)},
+            {"msgs_per_sec", rate},
+            {"mb_per_sec", rate * static_cast<double>(size) / 1e6}};
+}
+
+void benchIPC() {
+    // 8 KiB is the default SysV MSGMAX, so it is the largest size all four
+    // channels accept
+    for (const char* kind : {"pipe", "fifo", "sysv", "shm_ring"}) {
+        for (size_t size : {64, 1024, 8192}) {
+            run("ipc", kind, {{"size", std::to_string(size)}},
+                [=] { return ipcRoundTripAndRate(kind, size); });
+        }
+    }
+}
+
+// ============================================================================
+// SYNCHRONIZATION
+// ============================================================================
+
+// threads each run their share of acquire/increment/release cycles on one
+// shared counter
+Metrics lockThroughput(size_t threads, const std::function<void()>& acquire,
+                       const std::function<void()>& release) {
+    size_t perThread = iterations(200000);
+    uint64_t counter = 0;
+    std::atomic<size_t> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for (size_t i = 0; i < perThread; ++i) {
+                acquire();
+                counter++;
+                release();
+            }
+        });
+    }
+    while (ready.load() != threads) {
+        std::this_thread::yield();
+    }
+    uint64_t start = nowNs();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    uint64_t elapsed = nowNs() - start;
+
+    if (counter != threads * perThread) {
+        return {};
+    }
+    double total = static_cast<double>(threads * perThread);
+    return {{"ops_per_sec", total * 1e9 / static_cast<double>(elapsed)},
+            {"ns_per_op", static_cast<double>(elapsed) / total}};
+}
+
+// Shared acquisitions only measure reader scalability; the counter is
+// atomic there so the result can still be checked
+Metrics sharedLockThroughput(size_t threads, const std::function<void()>& acquire,
+                             const std::function<void()>& release) {
+    size_t perThread = iterations(200000);
+    std::atomic<uint64_t> counter{0};
+    std::vector<std::thread> workers;
+
+    uint64_t start = nowNs();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            for (size_t i = 0; i < perThread; ++i) {
+                acquire();
+                counter.fetch_add(1, std::memory_order_relaxed);
+                release();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    uint64_t elapsed = nowNs() - start;
+
+    if (counter.load() != threads * perThread) {
+        return {};
+    }
+    double total = static_cast<double>(threads * perThread);
+    return {{"ops_per_sec", total * 1e9 / static_cast<double>(elapsed)},
+            {"ns_per_op", static_cast<double>(elapsed) / total}};
+}
+
+void benchSynchronization() {
+    for (size_t threads : {1, 2, 4, 8}) {
+        Params params = {{"threads", std::to_string(threads)}};
+
+        run("lock", "std_mutex", params, [=] {
+            std::mutex m;
+            return lockThroughput(threads, [&] { m.lock(); }, [&] { m.unlock(); });
+        });
+        run("lock", "safe_mutex", params, [=] {
+            SafeMutex m("bench");
+            return lockThroughput(threads, [&] { m.lock(); }, [&] { m.unlock(); });
+        });
+        run("lock", "safe_mutex_untracked", params, [=] {
+            SafeMutex m("bench", false);
+            return lockThroughput(threads, [&] { m.lock(); }, [&] { m.unlock(); });
+        });
+        run("lock", "adaptive_mutex", params, [=] {
+            AdaptiveMutex m;
+            return lockThroughput(threads, [&] { m.lock(); }, [&] { m.unlock(); });
+        });
+        run("lock", "spin_lock", params, [=] {
+            SpinLock m;
+            return lockThroughput(threads, [&] { m.lock(); }, [&] { m.unlock(); });
+        });
+        run("lock", "semaphore", params, [=] {
+            Semaphore s(1);
+            return lockThroughput(threads, [&] { s.wait(); }, [&] { s.post(); });
+        });
+        run("lock", "rwlock_write", params, [=] {
+            RWLock l;
+            return lockThroughput(threads, [&] { l.writeLock(); }, [&] { l.writeUnlock(); });
+        });
+        run("lock", "rwlock_read", params, [=] {
+            RWLock l;
+            return sharedLockThroughput(threads, [&] { l.readLock(); }, [&] { l.readUnlock(); });
+        });
+        run("lock", "sharded_rwlock_write", params, [=] {
+            ShardedRWLock l;
+            return lockThroughput(threads, [&] { l.writeLock(); }, [&] { l.writeUnlock(); });
+        });
+        run("lock", "sharded_rwlock_read", params, [=] {
+            ShardedRWLock l;
+            return sharedLockThroughput(threads, [&] { l.readLock(); }, [&] { l.readUnlock(); });
+        });
+    }
+}
+
+// ============================================================================
+// PROCESS CREATION
+// ============================================================================
+
+long residentKb() {
+    std::ifstream statm("/proc/self/statm");
+    long pages = 0;
+    long resident = 0;
+    statm >> pages >> resident;
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+// Time until the call returns and until the child has been reaped
+Metrics spawnCost(ProcessManager& manager, const std::function<pid_t()>& launch) {
+    size_t count = iterations(200);
+    std::vector<uint64_t> launched;
+    std::vector<uint64_t> reaped;
+
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t start = nowNs();
+        pid_t pid = launch();
+        uint64_t returned = nowNs();
+        if (pid < 0 || !manager.waitForProcess(pid)) {
+            return {};
+        }
+        launched.push_back(returned - start);
+        reaped.push_back(nowNs() - start);
+    }
+    manager.purgeTerminated();
+    return {{"launch_p50_us", percentile(launched, 0.5) / 1e3},
+            {"launch_mean_us", mean(launched) / 1e3},
+            {"total_p50_us", percentile(reaped, 0.5) / 1e3}};
+}
+
+void benchProcesses() {
+    ProcessManager manager;
+    std::vector<char> ballast;
+
+    std::vector<size_t> sizesMb = options.quick ? std::vector<size_t>{0, 64} : std::vector<size_t>{0, 64, 256};
+    for (size_t mb : sizesMb) {
+        // Touch every page so the parent's RSS, and the page tables fork
+        // copies, really grow
+        if (!options.list) {
+            ballast.assign(mb * 1024 * 1024, 1);
+        }
+        Params params = {{"parent_rss_mb", std::to_string(residentKb() / 1024)}};
+
+        run("process", "create_fork", params, [&] {
+            return spawnCost(manager, [&] { return manager.createProcess("bench", [] { _exit(0); return 0; }); });
+        });
+        const std::pair<const char*, SpawnMethod> methods[] = {
+            {"spawn_posix_spawn", SpawnMethod::POSIX_SPAWN},
+            {"spawn_vfork", SpawnMethod::VFORK},
+            {"spawn_clone", SpawnMethod::CLONE},
+            {"spawn_fork_exec", SpawnMethod::FORK},
+        };
+        for (const auto& [name, method] : methods) {
+            SpawnOptions spawnOptions;
+            spawnOptions.method = method;
+            run("process", name, params, [&] {
+                return spawnCost(manager, [&] { return manager.spawnProcess("bench", "true", {}, spawnOptions); });
+            });
+        }
+    }
+}
+
+void usage(const char* program) {
+    std::cout << "Usage: " << program << " [--json FILE|-] [--filter TEXT] [--repetitions N] [--quick] [--list]\n"
+              << "  --json FILE      Also write results as JSON (- for stdout)\n"
+              << "  --filter TEXT    Only run benchmarks whose label contains TEXT\n"
+              << "  --repetitions N  Runs per benchmark; the median is reported (default 5)\n"
+              << "  --quick          A tenth of the iterations and smaller ballast, for smoke runs\n"
+              << "  --list           Print benchmark labels without running them\n";
+}
+
+bool parseOptions(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--repetitions" && hasValue) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--quick") {
+            options.quick = true;
+        } else if (arg == "--list") {
+            options.list = true;
+        } else {
+            usage(argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============================================================================
+// TRACING
+// ============================================================================
+
+// Cost of one traced span (two clock reads and the ring append) on each of
+// threads threads tracing at once; with tracing off, just the enabled check
+Metrics traceSpanCost(size_t threads, bool enabled) {
+    size_t perThread = iterations(1000000);
+    if (enabled && !Tracer::enable()) {
+        return {};
+    }
+    if (!enabled) {
+        Tracer::disable();
+    }
+
+    std::atomic<uint64_t> busyNs{0};
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&] {
+            uint64_t start = nowNs();
+            for (size_t i = 0; i < perThread; ++i) {
+                TraceSpan span(TraceEventType::IPC_SEND, 1, static_cast<int64_t>(i));
+            }
+            busyNs += nowNs() - start;
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    Tracer::disable();
+
+    double total = static_cast<double>(threads * perThread);
+    double nsPerSpan = static_cast<double>(busyNs.load()) / total;
+    return {{"ns_per_span", nsPerSpan},
+            {"spans_per_sec", static_cast<double>(threads) * 1e9 / nsPerSpan}};
+}
+
+void benchTracing() {
+    for (size_t threads : {1, 4}) {
+        for (bool enabled : {true, false}) {
+            run("trace", "span", {{"threads", std::to_string(threads)}, {"tracing", enabled ? "on" : "off"}},
+                [=] { return traceSpanCost(threads, enabled); });
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (!parseOptions(argc, argv)) {
+        return 2;
+    }
+
+    // Library status lines would only add noise to the measurements
+    Logger::instance().setSink(std::make_shared<NullSink>());
+
+    // With --json - the table goes to stderr so stdout stays valid JSON
+    std::streambuf* table = std::cout.rdbuf();
+    if (options.jsonPath == "-") {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+
+    benchThreadPool();
+    benchIPC();
+    benchSynchronization();
+    benchProcesses();
+    benchTracing();
+
+    std::cout.rdbuf(table);
+    if (options.jsonPath == "-") {
+        writeJson(std::cout);
+    } else if (!options.jsonPath.empty()) {
+        std::ofstream out(options.jsonPath);
+        writeJson(out);
+        if (!out) {
+            std::cerr << "Failed to write " << options.jsonPath << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,240 @@
+#ifndef PROCESS_THREAD_MANAGER_COROUTINE_H
+#define PROCESS_THREAD_MANAGER_COROUTINE_H
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "RingQueue.h"
+#include "ThreadPool.h"
+
+namespace PTManager {
+
+// C++20 coroutine support.
+//
+// Task<T> is a lazily started coroutine: it runs when awaited (or handed to
+// spawn()/syncWait()) and resumes its awaiter when it finishes, without
+// going through a scheduler. Where a coroutine runs is decided by what it
+// awaits: co_await pool.schedule() moves it onto a pool worker, and the
+// EventLoop awaitables resume it on a given pool once a descriptor is ready.
+
+template<typename T = void>
+class Task;
+
+namespace detail {
+
+class TaskPromiseBase {
+public:
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        // Symmetric transfer to the awaiter, so chains of tasks do not grow the stack
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> self) noexcept {
+            std::coroutine_handle<> next = self.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase {
+private:
+    std::optional<T> value;
+
+public:
+    Task<T> get_return_object();
+
+    template<typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+
+    T result() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    Task<void> get_return_object();
+
+    void return_void() {}
+
+    void result() {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+// Eagerly started, self-destroying coroutine used to drive a Task from
+// ordinary code
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+template<typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    explicit Task(std::coroutine_handle<promise_type> h) noexcept : handle(h) {}
+
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    bool isReady() const noexcept { return !handle || handle.done(); }
+
+    // Starts the task and suspends the awaiter until it completes; the
+    // result (or exception) of the task is returned (or rethrown)
+    auto operator co_await() && noexcept {
+        struct Awaiter {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{handle};
+    }
+};
+
+template<typename T>
+Task<T> detail::TaskPromise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> detail::TaskPromise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+namespace detail {
+
+template<typename T>
+DetachedTask driveTask(ThreadPool* pool, Task<T> task, std::promise<T> promise) {
+    try {
+        if (pool != nullptr) {
+            co_await pool->schedule();
+        }
+        if constexpr (std::is_void_v<T>) {
+            co_await std::move(task);
+            promise.set_value();
+        } else {
+            promise.set_value(co_await std::move(task));
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+    }
+}
+
+} // namespace detail
+
+// Starts a task on a worker of the pool; the future delivers its result
+template<typename T>
+std::future<T> spawn(ThreadPool& pool, Task<T> task) {
+    std::promise<T> promise;
+    std::future<T> result = promise.get_future();
+    detail::driveTask(&pool, std::move(task), std::move(promise));
+    return result;
+}
+
+// Runs a task on the calling thread until its first suspension, then blocks
+// until it completes wherever it was resumed
+template<typename T>
+T syncWait(Task<T> task) {
+    std::promise<T> promise;
+    std::future<T> result = promise.get_future();
+    detail::driveTask(nullptr, std::move(task), std::move(promise));
+    return result.get();
+}
+
+// Counting semaphore for coroutines: acquire() suspends instead of blocking
+// a thread. release() hands the permit directly to the oldest waiter (FIFO)
+// and resumes it on the pool it asked for, or inline on the releasing thread.
+class AsyncSemaphore {
+private:
+    struct Waiter {
+        std::coroutine_handle<> handle;
+        ThreadPool* pool = nullptr;
+    };
+
+    mutable std::mutex mutex;
+    size_t count;
+    RingQueue<Waiter> waiters;
+
+    bool suspendWaiter(std::coroutine_handle<> handle, ThreadPool* pool);
+
+public:
+    explicit AsyncSemaphore(size_t initialCount = 0);
+
+    AsyncSemaphore(const AsyncSemaphore&) = delete;
+    AsyncSemaphore& operator=(const AsyncSemaphore&) = delete;
+
+    class AcquireAwaiter {
+    private:
+        AsyncSemaphore& semaphore;
+        ThreadPool* pool;
+
+    public:
+        AcquireAwaiter(AsyncSemaphore& sem, ThreadPool* resumeOn) : semaphore(sem), pool(resumeOn) {}
+
+        bool await_ready() { return semaphore.tryAcquire(); }
+        bool await_suspend(std::coroutine_handle<> handle) { return semaphore.suspendWaiter(handle, pool); }
+        void await_resume() const noexcept {}
+    };
+
+    AcquireAwaiter acquire(ThreadPool* resumeOn = nullptr) { return AcquireAwaiter(*this, resumeOn); }
+    bool tryAcquire();
+    void release(size_t permits = 1);
+
+    size_t getValue() const;
+    size_t getWaiters() const;
+};
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_COROUTINE_H
@@ -0,0 +1,170 @@
+#ifndef PROCESS_THREAD_MANAGER_EVENTLOOP_H
+#define PROCESS_THREAD_MANAGER_EVENTLOOP_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+
+#include "Coroutine.h"
+#include "TaskFunction.h"
+#include "ThreadPool.h"
+
+namespace PTManager {
+
+// epoll-based readiness loop running on its own thread.
+//
+// It multiplexes three kinds of sources: descriptors (pipes, FIFOs,
+// sockets, POSIX message queues), process exits (pidfd) and timers (one
+// timerfd shared by all timers). SysV MessageQueue has no descriptor and
+// cannot be watched.
+//
+// watchReadable()/watchWritable() registrations are one-shot: each runs
+// once when the descriptor becomes ready (or reports an error/hangup). At
+// most one read and one write registration may be pending per descriptor.
+// addHandler() registrations are persistent and are re-armed after every
+// invocation, so a handler never runs concurrently with itself.
+//
+// Without a dispatch pool callbacks run on the loop thread and should be
+// short. With one, every callback is posted to the pool and the loop thread
+// only waits for events, so one loop can serve many endpoints.
+class EventLoop {
+public:
+    // Receives the ready epoll events (EPOLLIN, EPOLLOUT, EPOLLHUP, ...)
+    using Handler = std::function<void(uint32_t events)>;
+    // Receives the exit status in waitpid() encoding, or -1 if it could not
+    // be collected (the process is not our child or was already reaped)
+    using ExitCallback = std::function<void(pid_t pid, int status)>;
+    // As ExitCallback, plus the child's resource usage (nullptr with -1)
+    using UsageExitCallback = std::function<void(pid_t pid, int status, const struct rusage* usage)>;
+    using TimerId = uint64_t;
+
+private:
+    struct Watch {
+        TaskFunction onReadable;
+        TaskFunction onWritable;
+    };
+
+    struct HandlerEntry {
+        uint32_t events;
+        std::shared_ptr<Handler> handler;
+    };
+
+    struct ProcessWatch {
+        pid_t pid;
+        UsageExitCallback callback;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer {
+        Clock::time_point due;
+        std::chrono::nanoseconds interval;     // Zero for one-shot timers
+        std::shared_ptr<std::function<void()>> callback;
+    };
+
+    int epollFd;
+    int wakeFd;                  // eventfd used to interrupt epoll_wait()
+    int timerFd;                 // timerfd armed for the earliest timer
+    ThreadPool* dispatchPool;
+    std::atomic<bool> running;
+    std::mutex mutex;            // Guards the registrations below and epoll
+    std::unordered_map<int, Watch> watches;
+    std::unordered_map<int, HandlerEntry> handlers;
+    std::unordered_map<int, ProcessWatch> processes;  // Keyed by pidfd
+    std::unordered_map<TimerId, Timer> timers;
+    std::set<std::pair<Clock::time_point, TimerId>> timerQueue;
+    TimerId nextTimerId;
+    std::thread thread;
+
+    std::mutex dispatchMutex;
+    std::condition_variable dispatchDone;
+    size_t inFlight;             // Callbacks posted to dispatchPool and not yet finished
+
+    void run();
+    void watch(int fd, bool writable, TaskFunction&& callback);
+    void updateRegistration(int fd, const Watch& watch);
+    void rearmHandler(int fd, const std::shared_ptr<Handler>& handler);
+    void collectTimers(std::vector<TaskFunction>& ready);
+    void armTimerFd();
+    void reapProcess(int pidfd, std::vector<TaskFunction>& ready);
+    void dispatch(TaskFunction&& callback);
+
+public:
+    explicit EventLoop(ThreadPool* pool = nullptr);
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    void watchReadable(int fd, TaskFunction callback);
+    void watchWritable(int fd, TaskFunction callback);
+    void cancel(int fd);
+
+    // Persistent readiness handler for events (EPOLLIN and/or EPOLLOUT)
+    void addHandler(int fd, Handler handler, uint32_t events = EPOLLIN);
+    bool removeHandler(int fd);
+
+    // Runs callback once when pid exits; false if no pidfd could be opened
+    bool watchProcess(pid_t pid, ExitCallback callback);
+    bool watchProcess(pid_t pid, UsageExitCallback callback);
+    bool unwatchProcess(pid_t pid);
+
+    // Runs callback after delay, then every interval if it is non-zero
+    TimerId addTimer(std::chrono::milliseconds delay, std::function<void()> callback,
+                     std::chrono::milliseconds interval = std::chrono::milliseconds::zero());
+    bool cancelTimer(TimerId id);
+
+    void stop();
+
+    bool isRunning() const { return running.load(); }
+    ThreadPool* getDispatchPool() const { return dispatchPool; }
+    size_t getWatchCount();
+    size_t getHandlerCount();
+    size_t getProcessWatchCount();
+    size_t getTimerCount();
+
+    // Awaitable readiness: suspends the coroutine until fd is readable or
+    // writable, then resumes it on resumeOn (or on the loop thread if null)
+    class FdAwaiter {
+    private:
+        EventLoop& loop;
+        int fd;
+        bool writable;
+        ThreadPool* pool;
+
+    public:
+        FdAwaiter(EventLoop& eventLoop, int descriptor, bool forWrite, ThreadPool* resumeOn)
+            : loop(eventLoop), fd(descriptor), writable(forWrite), pool(resumeOn) {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+    };
+
+    FdAwaiter readable(int fd, ThreadPool* resumeOn = nullptr) { return FdAwaiter(*this, fd, false, resumeOn); }
+    FdAwaiter writable(int fd, ThreadPool* resumeOn = nullptr) { return FdAwaiter(*this, fd, true, resumeOn); }
+
+    // Coroutine I/O on blocking descriptors (pipes, FIFOs, sockets). The
+    // descriptor is only touched after epoll reported it ready, so no
+    // thread blocks; there must be a single reader/writer per descriptor.
+    Task<ssize_t> readAsync(int fd, void* buffer, size_t size, ThreadPool* resumeOn = nullptr);
+    Task<ssize_t> writeAsync(int fd, const void* data, size_t size, ThreadPool* resumeOn = nullptr);
+};
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_EVENTLOOP_H
@@ -0,0 +1,51 @@
+#ifndef PROCESS_THREAD_MANAGER_FUTEX_H
+#define PROCESS_THREAD_MANAGER_FUTEX_H
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace PTManager {
+
+// Thin wrappers over futex(2) on 32-bit atomics.
+//
+// The shared (non-PRIVATE) operations key the wait queue on the physical
+// page, so they work between processes on a MAP_SHARED mapping as well as
+// between threads. Atomics placed in shared memory must be lock-free.
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) &&
+              std::atomic<uint32_t>::is_always_lock_free,
+              "futex words must be plain lock-free 32-bit atomics");
+
+// Sleeps while *word == expected. Returns false on timeout; spurious
+// wakeups and value changes return true, so callers re-check their condition.
+inline bool futexWait(std::atomic<uint32_t>& word, uint32_t expected,
+                      std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max()) {
+    timespec ts{};
+    timespec* tsp = nullptr;
+    if (timeout != std::chrono::nanoseconds::max()) {
+        auto secs = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        ts.tv_sec = static_cast<time_t>(secs.count());
+        ts.tv_nsec = static_cast<long>((timeout - secs).count());
+        tsp = &ts;
+    }
+
+    long rc = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT,
+                      expected, tsp, nullptr, 0);
+    return !(rc == -1 && errno == ETIMEDOUT);
+}
+
+// Wakes up to count waiters blocked on word; returns the number woken
+inline int futexWake(std::atomic<uint32_t>& word, int count = INT_MAX) {
+    return static_cast<int>(syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE,
+                                    count, nullptr, nullptr, 0));
+}
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_FUTEX_H
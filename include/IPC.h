@@ -1,11 +1,19 @@
 #ifndef PROCESS_THREAD_MANAGER_IPC_H
 #define PROCESS_THREAD_MANAGER_IPC_H
 
+#include <chrono>
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <memory>
+#include <span>
+#include <string_view>
+#include <mqueue.h>
+#include <sys/msg.h>
 #include <sys/types.h>
 
+#include "EventLoop.h"
+
 namespace PTManager {
 
 // Unnamed Pipe
@@ -35,6 +43,33 @@ public:
     // Helper for string communication
     bool writeString(const std::string& str);
     std::string readString(size_t maxSize = 4096);
+
+    // Framed messages (the writeString wire format) sent with writev: one
+    // syscall per frame, or per up to IOV_MAX / 2 frames for a batch.
+    // Read them back with a FrameReader on getReadFd().
+    bool writeFrame(const void* data, size_t size);
+    bool writeBatch(std::span<const std::string_view> messages);
+    bool writeBatch(const std::vector<std::string>& messages);
+
+    // Zero-copy transfer between the pipe and any descriptor (file, socket,
+    // pipe). splice/vmsplice calls move up to length bytes, stopping early
+    // at end of input, and return the count moved (-1 if nothing could be).
+    // vmsplice'd memory is read by reference: leave it unchanged until the
+    // reader has consumed it. teeTo duplicates buffered data into another
+    // pipe without consuming it.
+    ssize_t spliceFrom(int fd, size_t length, off_t* offset = nullptr);
+    ssize_t spliceTo(int fd, size_t length, off_t* offset = nullptr);
+    ssize_t vmspliceFrom(const void* data, size_t size);
+    ssize_t teeTo(int pipeFd, size_t length);
+
+    // Kernel buffer size (F_SETPIPE_SZ); unprivileged callers are capped
+    // by /proc/sys/fs/pipe-max-size
+    bool setCapacity(size_t bytes);
+    size_t getCapacity() const;
+
+    // Coroutine I/O: suspends on the event loop instead of blocking a thread
+    Task<ssize_t> readAsync(EventLoop& loop, void* buffer, size_t size, ThreadPool* resumeOn = nullptr);
+    Task<ssize_t> writeAsync(EventLoop& loop, const void* data, size_t size, ThreadPool* resumeOn = nullptr);
 };
 
 // Named Pipe (FIFO)
@@ -59,6 +94,68 @@ public:
 
     bool writeString(const std::string& str);
     std::string readString(size_t maxSize = 4096);
+
+    bool writeFrame(const void* data, size_t size);
+    bool writeBatch(std::span<const std::string_view> messages);
+    bool writeBatch(const std::vector<std::string>& messages);
+
+    int getFd() const { return fd; }
+
+    // Zero-copy transfer, as for Pipe; use the direction the FIFO was
+    // opened for
+    ssize_t spliceFrom(int sourceFd, size_t length, off_t* offset = nullptr);
+    ssize_t spliceTo(int targetFd, size_t length, off_t* offset = nullptr);
+    ssize_t vmspliceFrom(const void* data, size_t size);
+    ssize_t teeTo(int pipeFd, size_t length);
+
+    bool setCapacity(size_t bytes);
+    size_t getCapacity() const;
+
+    Task<ssize_t> readAsync(EventLoop& loop, void* buffer, size_t size, ThreadPool* resumeOn = nullptr);
+    Task<ssize_t> writeAsync(EventLoop& loop, const void* data, size_t size, ThreadPool* resumeOn = nullptr);
+};
+
+// Buffered reader for length-prefixed frames (size_t length + body).
+// One read() fills an internal buffer that is reused across calls, and
+// every complete frame in it is returned before the descriptor is read
+// again. The buffer grows for frames larger than it, up to maxFrameSize.
+class FrameReader {
+private:
+    int fd;
+    std::vector<char> buffer;
+    size_t begin;      // First unparsed byte
+    size_t end;        // One past the last buffered byte
+    size_t maxFrameSize;
+    size_t readCalls;
+
+    bool fill(size_t needed);
+
+public:
+    explicit FrameReader(int readFd, size_t bufferSize = 64 * 1024, size_t maxFrame = 16 * 1024 * 1024);
+
+    // Next frame; the view stays valid until the next call. Returns false at
+    // end of stream, on a read error, or for a frame above maxFrameSize.
+    bool next(std::string_view& frame);
+
+    size_t getReadCalls() const { return readCalls; }
+    size_t getBufferedBytes() const { return end - begin; }
+};
+
+// Page size backing a SharedMemory mapping
+enum class HugePageMode {
+    NONE,         // Regular pages
+    TRANSPARENT,  // madvise(MADV_HUGEPAGE); depends on the kernel's shmem THP setting
+    HUGETLB       // Segment file on a hugetlbfs mount, mapped with MAP_HUGETLB
+};
+
+// Mapping options, fixed when the SharedMemory object is constructed
+struct MapOptions {
+    HugePageMode hugePages = HugePageMode::NONE;
+    std::string hugetlbfsPath = "/dev/hugepages"; // Mount point used for HUGETLB
+    bool fallbackToSmallPages = true;  // Use a POSIX shm segment if hugetlbfs is unavailable
+    bool populate = false;             // Prefault every page when mapping
+    bool lock = false;                 // mlock() the mapping; map() fails if that is refused
+    int advice = 0;                    // Extra madvise() hint, e.g. MADV_SEQUENTIAL; 0 = MADV_NORMAL
 };
 
 // Shared Memory
@@ -70,9 +167,16 @@ private:
     size_t size;
     bool isCreated;
     bool isMapped;
+    MapOptions options;
+    std::string hugetlbPath;  // Backing file when the segment lives on hugetlbfs
+    bool isLocked;
+    int protection;
+
+    bool openSegment(int flags, mode_t mode);
+    bool applyOptions(bool prefault);
 
 public:
-    SharedMemory(const std::string& shmName, size_t shmSize);
+    SharedMemory(const std::string& shmName, size_t shmSize, const MapOptions& mapOptions = MapOptions{});
     ~SharedMemory();
 
     bool create(mode_t mode = 0666);
@@ -81,9 +185,14 @@ public:
     void unmap();
     void close();
     bool unlink();
+    bool resize(size_t newSize);
 
     void* getAddress() const { return addr; }
     size_t getSize() const { return size; }
+    const MapOptions& getMapOptions() const { return options; }
+    bool usesHugetlbfs() const { return !hugetlbPath.empty(); }
+    bool isMemoryLocked() const { return isLocked; }
+    static size_t hugePageSize();
 
     // Helper methods
     bool writeData(const void* data, size_t dataSize, size_t offset = 0);
@@ -91,6 +200,26 @@ public:
 
     template<typename T>
     T* getAs() { return static_cast<T*>(addr); }
+
+    // Zero-copy views into the mapping. Out-of-range (or misaligned) requests
+    // yield an empty span / nullptr instead of touching memory.
+    std::span<std::byte> view();
+    std::span<std::byte> view(size_t offset, size_t length);
+    std::span<const std::byte> view(size_t offset, size_t length) const;
+
+    template<typename T>
+    T* at(size_t offset) {
+        std::span<T> element = arrayAt<T>(offset, 1);
+        return element.empty() ? nullptr : element.data();
+    }
+
+    template<typename T>
+    std::span<T> arrayAt(size_t offset, size_t count) {
+        if (offset % alignof(T) != 0 || count > size / sizeof(T)) return {};
+        std::span<std::byte> bytes = view(offset, count * sizeof(T));
+        if (bytes.data() == nullptr) return {};
+        return {reinterpret_cast<T*>(bytes.data()), count};
+    }
 };
 
 // Message Queue wrapper
@@ -103,6 +232,9 @@ class MessageQueue {
 private:
     key_t key;
     int msgid;
+    std::vector<char> receiveBuffer;   // mtype + payload scratch for variable-length receives
+
+    ssize_t receiveRaw(long& type, long typeFilter, int flags);
 
 public:
     MessageQueue(const std::string& path, int projId);
@@ -114,6 +246,81 @@ public:
 
     bool send(const Message& msg, int flags = 0);
     bool receive(Message& msg, long type = 0, int flags = 0);
+
+    // Variable-length messages: only the payload bytes are copied, and
+    // anything up to the kernel's msgmax fits in one message
+    bool send(long type, const void* data, size_t size, int flags = 0);
+    ssize_t receive(void* buffer, size_t capacity, long& type, long typeFilter = 0, int flags = 0);
+    bool receive(std::vector<char>& message, long& type, long typeFilter = 0, int flags = 0);
+
+    // sendBatch stops at the first failure and returns how many were sent.
+    // receiveBatch waits (unless flags has IPC_NOWAIT) for one message, then
+    // takes whatever else is already queued, up to maxMessages.
+    size_t sendBatch(long type, std::span<const std::string_view> messages, int flags = 0);
+    size_t receiveBatch(std::vector<std::vector<char>>& messages, size_t maxMessages,
+                        long typeFilter = 0, int flags = 0);
+
+    int getId() const { return msgid; }
+};
+
+// POSIX message queue (mq_open). Messages carry a priority and are
+// delivered highest priority first. On Linux the queue is a descriptor, so
+// it can be registered with EventLoop::addHandler() (EPOLLIN when a message
+// is queued, EPOLLOUT when there is room) instead of blocking a thread.
+class PosixMessageQueue {
+private:
+    std::string name;
+    mqd_t mq;
+    long maxMessages;
+    long messageSize;
+
+    bool openQueue(int flags, bool nonBlocking);
+
+public:
+    // name must start with '/'. The limits only apply when create() makes
+    // the queue; unprivileged processes are capped by /proc/sys/fs/mqueue.
+    explicit PosixMessageQueue(const std::string& queueName, long maxMsgs = 10, long maxMsgSize = 8192);
+    ~PosixMessageQueue();
+
+    PosixMessageQueue(const PosixMessageQueue&) = delete;
+    PosixMessageQueue& operator=(const PosixMessageQueue&) = delete;
+
+    bool create(bool nonBlocking = false);
+    bool open(bool nonBlocking = false);
+    void close();
+    bool unlink();
+
+    bool isOpen() const { return mq != static_cast<mqd_t>(-1); }
+    int getFd() const { return static_cast<int>(mq); }
+    bool setNonBlocking(bool enabled);
+
+    // In non-blocking mode a full queue fails send() and an empty one
+    // fails receive() with errno EAGAIN, without logging
+    bool send(const void* data, size_t size, unsigned int priority = 0);
+    bool sendString(std::string_view message, unsigned int priority = 0);
+    bool timedSend(const void* data, size_t size, std::chrono::milliseconds timeout,
+                   unsigned int priority = 0);
+
+    // capacity must be at least getMessageSize()
+    ssize_t receive(void* buffer, size_t capacity, unsigned int* priority = nullptr);
+    bool receive(std::vector<char>& message, unsigned int* priority = nullptr);
+    ssize_t timedReceive(void* buffer, size_t capacity, std::chrono::milliseconds timeout,
+                         unsigned int* priority = nullptr);
+
+    // Same contract as the MessageQueue batches
+    size_t sendBatch(std::span<const std::string_view> messages, unsigned int priority = 0);
+    size_t receiveBatch(std::vector<std::vector<char>>& messages, size_t maxCount);
+
+    // One-shot mq_notify(): signo is raised when a message arrives on an
+    // empty queue and no process is blocked receiving. Re-register after
+    // each notification.
+    bool notifyBySignal(int signo);
+    bool cancelNotify();
+
+    const std::string& getName() const { return name; }
+    long getMaxMessages() const { return maxMessages; }
+    long getMessageSize() const { return messageSize; }
+    long getQueuedMessages() const;
 };
 
 } // namespace PTManager
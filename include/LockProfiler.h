@@ -0,0 +1,179 @@
+#ifndef PROCESS_THREAD_MANAGER_LOCKPROFILER_H
+#define PROCESS_THREAD_MANAGER_LOCKPROFILER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace PTManager {
+
+// Opt-in instrumentation of SafeMutex, RWLock, Semaphore and SpinLock.
+//
+// Built with PTMANAGER_LOCK_PROFILING defined, every lock registers with
+// the LockProfiler and records acquisitions, contended acquisitions and
+// wait/hold time histograms, and each blocking acquisition is checked
+// against a global lock-order graph: acquiring B while holding A adds the
+// edge A -> B, and an edge that closes a cycle is reported once, before the
+// acquisition blocks. Without the macro the locks hold an empty LockProbe
+// whose calls compile to nothing, and the profiler reports no locks.
+//
+// A destroyed lock leaves the graph and its record is reused by the next
+// lock, so per-object locks do not grow the profiler; its counters are
+// summed into one entry per name (per kind for unnamed locks).
+
+// Snapshot of one lock's counters. Histogram bucket i counts durations in
+// [2^i, 2^(i+1)) nanoseconds; the last bucket takes everything longer.
+struct LockStats {
+    static constexpr size_t BUCKETS = 40;
+
+    std::string kind;
+    std::string name;
+    uint64_t acquisitions = 0;
+    uint64_t contended = 0;         // Acquisitions that could not take the lock at once
+    uint64_t totalWaitNs = 0;
+    uint64_t maxWaitNs = 0;
+    uint64_t totalHoldNs = 0;       // Not tracked for Semaphore (not owned)
+    uint64_t maxHoldNs = 0;
+    std::array<uint64_t, BUCKETS> waitHistogram{};
+    std::array<uint64_t, BUCKETS> holdHistogram{};
+
+    // Upper bound of the bucket holding the q-th quantile (0 < q <= 1)
+    static uint64_t percentileNs(const std::array<uint64_t, BUCKETS>& histogram, double q);
+};
+
+// A potential deadlock: each lock was held while the next was acquired,
+// and the last was held while the first was acquired
+struct LockCycle {
+    std::vector<std::string> locks;
+    std::thread::id thread;         // Thread whose acquisition closed the cycle
+};
+
+class LockProfiler {
+public:
+    using CycleHandler = std::function<void(const LockCycle& cycle)>;
+
+#ifdef PTMANAGER_LOCK_PROFILING
+    static constexpr bool enabled = true;
+#else
+    static constexpr bool enabled = false;
+#endif
+
+    struct Record {
+        uint32_t id;                // Index in the graph, reused after the lock is destroyed
+        uint64_t serial;            // Unique per registered lock, never reused
+        bool anonymous;
+        bool live = true;           // Guarded by the profiler's mutex
+        std::string kind;
+        std::string name;
+        std::atomic<uint64_t> acquisitions{0};
+        std::atomic<uint64_t> contended{0};
+        std::atomic<uint64_t> totalWaitNs{0};
+        std::atomic<uint64_t> maxWaitNs{0};
+        std::atomic<uint64_t> totalHoldNs{0};
+        std::atomic<uint64_t> maxHoldNs{0};
+        std::array<std::atomic<uint64_t>, LockStats::BUCKETS> waitHistogram{};
+        std::array<std::atomic<uint64_t>, LockStats::BUCKETS> holdHistogram{};
+
+        Record(uint32_t lockId, uint64_t lockSerial, const char* lockKind, const std::string& lockName);
+
+        void assign(uint64_t lockSerial, const char* lockKind, const std::string& lockName);
+        void recordWait(uint64_t ns, bool wasContended);
+        void recordHold(uint64_t ns);
+        void clearCounters();
+        LockStats snapshot() const;
+    };
+
+private:
+    mutable std::mutex mutex;
+    std::deque<Record> records;                     // Stable addresses; reused via freeRecords
+    std::vector<uint32_t> freeRecords;              // Ids of destroyed locks
+    std::vector<std::vector<uint32_t>> successors;  // Lock-order graph by record id
+    std::vector<std::vector<uint32_t>> predecessors;
+    std::map<std::string, LockStats> retired;       // Counters of destroyed locks by name
+    std::vector<LockCycle> cycles;
+    CycleHandler cycleHandler;
+    uint64_t nextSerial = 1;
+    std::atomic<uint64_t> epoch{1};
+
+    // Depth-first search state, sized by the peak number of live locks and
+    // kept between searches
+    std::vector<uint32_t> visitMarks;
+    uint32_t visitMark = 0;
+    std::vector<std::pair<uint32_t, size_t>> searchStack;
+
+    LockProfiler() = default;
+
+    bool findPath(uint32_t from, uint32_t to, std::vector<uint32_t>& path);
+
+public:
+    static LockProfiler& instance();
+
+    LockProfiler(const LockProfiler&) = delete;
+    LockProfiler& operator=(const LockProfiler&) = delete;
+
+    Record* registerLock(const char* kind, const std::string& name);
+    // Removes a destroyed lock from the graph and recycles its record
+    void unregisterLock(Record* record);
+    // Adds held -> acquiring edges; reports any cycle they close
+    void checkOrder(const Record* acquiring, const std::vector<const Record*>& held);
+
+    std::vector<LockStats> getStats() const;
+    std::vector<LockCycle> getCycles() const;
+    // Replaces the default handler, which logs the cycle as a warning
+    void setCycleHandler(CycleHandler handler);
+    // Zeroes all counters and forgets the order graph and reported cycles
+    void reset();
+    // Changes whenever reset() clears the order graph, so that edges cached
+    // by probes can be dropped
+    uint64_t graphEpoch() const { return epoch.load(std::memory_order_acquire); }
+    void printReport(std::ostream& out) const;
+};
+
+#ifdef PTMANAGER_LOCK_PROFILING
+
+// Per-lock hook called by the instrumented primitives. Owned locks (all but
+// Semaphore) also track hold times and take part in the order graph.
+class LockProbe {
+private:
+    LockProfiler::Record* record;
+    bool owned;
+
+public:
+    LockProbe(const char* kind, const std::string& name, bool ownedLock = true);
+    ~LockProbe();
+
+    LockProbe(const LockProbe&) = delete;
+    LockProbe& operator=(const LockProbe&) = delete;
+
+    // Returns the start time for afterAcquire(); blocking acquisitions are
+    // checked against the lock order first
+    uint64_t beforeAcquire(bool blocking = true);
+    void afterAcquire(uint64_t start, bool contended);
+    void beforeRelease();
+};
+
+#else
+
+class LockProbe {
+public:
+    LockProbe(const char*, const std::string&, bool = true) {}
+
+    uint64_t beforeAcquire(bool = true) { return 0; }
+    void afterAcquire(uint64_t, bool) {}
+    void beforeRelease() {}
+};
+
+#endif
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_LOCKPROFILER_H
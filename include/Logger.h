@@ -0,0 +1,240 @@
+#ifndef PROCESS_THREAD_MANAGER_LOGGER_H
+#define PROCESS_THREAD_MANAGER_LOGGER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/types.h>
+
+namespace PTManager {
+
+// Library-wide diagnostics.
+//
+// PTM_LOG_INFO("Created " << name) checks the level before evaluating its
+// arguments, formats into a thread-local fixed buffer and pushes the line
+// onto the calling thread's lock-free ring. A background thread drains all
+// rings, merges them by timestamp and hands them to the sink, so the caller
+// never takes a stream lock or flushes. A full ring drops the line and
+// counts it rather than blocking.
+//
+// Lines are written synchronously instead when no background thread can
+// run them: in a forked child (the drainer did not survive fork), after
+// process exit has begun, or once setAsync(false) is called.
+
+enum class LogLevel : uint8_t {
+    DEBUG,
+    INFO,
+    WARN,
+    ERROR,
+    OFF
+};
+
+const char* logLevelName(LogLevel level);
+
+struct LogRecord {
+    LogLevel level;
+    uint64_t timeNs;            // CLOCK_REALTIME
+    pid_t pid;
+    uint32_t thread;            // Logger-assigned thread index
+    std::string_view message;   // Valid only during LogSink::write
+};
+
+class LogSink {
+public:
+    virtual ~LogSink() = default;
+    virtual void write(const LogRecord& record) = 0;
+    virtual void flush() {}
+    // A discarding sink lets log statements skip formatting entirely
+    virtual bool discards() const { return false; }
+};
+
+// Plain message lines: DEBUG and INFO to stdout, WARN and ERROR to stderr.
+// Uses write(2) on the descriptors, so it is safe in forked children.
+class ConsoleSink : public LogSink {
+private:
+    bool prefixed;
+
+public:
+    // prefixed adds "[time] LEVEL pid/thread" before each message
+    explicit ConsoleSink(bool withPrefix = false) : prefixed(withPrefix) {}
+    void write(const LogRecord& record) override;
+};
+
+class StreamSink : public LogSink {
+private:
+    std::ostream& out;
+
+public:
+    explicit StreamSink(std::ostream& stream) : out(stream) {}
+    void write(const LogRecord& record) override;
+    void flush() override;
+};
+
+class NullSink : public LogSink {
+public:
+    void write(const LogRecord&) override {}
+    bool discards() const override { return true; }
+};
+
+class Logger {
+public:
+    static constexpr size_t MAX_MESSAGE = 232;      // Longer lines are truncated
+    static constexpr size_t RING_CAPACITY = 256;    // Lines buffered per thread
+
+private:
+    struct Entry {
+        uint64_t timeNs;
+        LogLevel level;
+        uint16_t length;
+        char text[MAX_MESSAGE];
+    };
+
+    // Single-producer (owning thread), single-consumer (drain) ring
+    struct ThreadRing {
+        alignas(64) std::atomic<uint64_t> head{0};    // Next slot to write
+        alignas(64) std::atomic<uint64_t> tail{0};    // Next slot to read
+        std::atomic<bool> retired{false};             // Owning thread exited
+        uint32_t thread = 0;
+        Entry entries[RING_CAPACITY];
+    };
+
+    struct PendingLine {
+        Entry entry;
+        uint32_t thread;
+    };
+
+    struct RingHandle {
+        std::shared_ptr<ThreadRing> ring;
+        ~RingHandle();
+    };
+
+    // Raised to OFF while the sink discards; enabled() reads only this
+    inline static std::atomic<uint8_t> threshold{static_cast<uint8_t>(LogLevel::INFO)};
+
+    std::atomic<LogLevel> level;
+    std::atomic<bool> async;
+    std::atomic<uint64_t> dropped;
+    std::atomic<uint32_t> nextThread;
+    pid_t pid;                          // Cached; refreshed in forked children
+    std::atomic<bool> forked;           // Child without a drainer thread
+    uint64_t reportedDrops;             // Guarded by sinkMutex
+
+    std::mutex ringsMutex;
+    std::vector<std::shared_ptr<ThreadRing>> rings;
+
+    std::mutex drainMutex;              // Serializes consumers of the rings
+    std::vector<PendingLine> batch;     // Drain buffers, guarded by drainMutex
+    std::vector<std::pair<uint64_t, uint32_t>> order;
+    std::mutex sinkMutex;
+    std::shared_ptr<LogSink> sink;
+
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    std::atomic<bool> stopping;
+    std::thread drainer;
+
+    Logger();
+
+    ThreadRing* localRing();
+    uint32_t threadIndex();
+    bool writesSynchronously() const;
+    void writeNow(LogLevel lineLevel, uint64_t timeNs, uint32_t thread, std::string_view text);
+    size_t drain();
+    void drainLoop();
+    void updateThreshold();
+
+    static void beforeFork();
+    static void afterForkParent();
+    static void afterForkChild();
+    static void atExit();
+
+public:
+    static Logger& instance();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    static bool enabled(LogLevel lineLevel) {
+        return static_cast<uint8_t>(lineLevel) >= threshold.load(std::memory_order_relaxed);
+    }
+
+    void setLevel(LogLevel minimum);
+    LogLevel getLevel() const { return level.load(std::memory_order_relaxed); }
+    // Replaces the sink; nullptr installs a NullSink. Buffered lines are
+    // written to the old sink first.
+    void setSink(std::shared_ptr<LogSink> newSink);
+    std::shared_ptr<LogSink> getSink();
+    // false writes every line on the logging thread, under a sink lock
+    void setAsync(bool enable);
+    bool isAsync() const { return async.load(std::memory_order_relaxed); }
+
+    void submit(LogLevel lineLevel, std::string_view text);
+    // Writes every line buffered so far and flushes the sink
+    void flush();
+    uint64_t getDroppedCount() const { return dropped.load(std::memory_order_relaxed); }
+};
+
+// Formats one line into a per-thread buffer; submits it on destruction
+class LogLine {
+private:
+    class Buffer : public std::streambuf {
+    private:
+        char text[Logger::MAX_MESSAGE];
+        bool truncated = false;
+
+    protected:
+        int_type overflow(int_type ch) override;
+
+    public:
+        Buffer() { setp(text, text + sizeof(text)); }
+        void reset() { setp(text, text + sizeof(text)); truncated = false; }
+        std::string_view view();
+    };
+
+    struct Formatter {
+        Buffer buffer;
+        std::ostream stream{&buffer};
+        bool busy = false;
+    };
+
+    LogLevel lineLevel;
+    Formatter* formatter;
+    std::unique_ptr<Formatter> nested;  // For a line logged while formatting another
+
+    static Formatter& local();
+
+public:
+    explicit LogLine(LogLevel level);
+    ~LogLine();
+
+    LogLine(const LogLine&) = delete;
+    LogLine& operator=(const LogLine&) = delete;
+
+    std::ostream& stream() { return formatter->stream; }
+};
+
+} // namespace PTManager
+
+#define PTM_LOG(level, expr) \
+    do { \
+        if (::PTManager::Logger::enabled(level)) { \
+            ::PTManager::LogLine ptmLogLine(level); \
+            ptmLogLine.stream() << expr; \
+        } \
+    } while (0)
+
+#define PTM_LOG_DEBUG(expr) PTM_LOG(::PTManager::LogLevel::DEBUG, expr)
+#define PTM_LOG_INFO(expr) PTM_LOG(::PTManager::LogLevel::INFO, expr)
+#define PTM_LOG_WARN(expr) PTM_LOG(::PTManager::LogLevel::WARN, expr)
+#define PTM_LOG_ERROR(expr) PTM_LOG(::PTManager::LogLevel::ERROR, expr)
+
+#endif //PROCESS_THREAD_MANAGER_LOGGER_H
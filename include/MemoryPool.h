@@ -0,0 +1,59 @@
+#ifndef PROCESS_THREAD_MANAGER_MEMORYPOOL_H
+#define PROCESS_THREAD_MANAGER_MEMORYPOOL_H
+
+#include <cstddef>
+#include <new>
+
+namespace PTManager {
+
+namespace detail {
+
+// Size-class block pool backing the allocation-free task path.
+//
+// Blocks of up to MAX_POOLED_SIZE bytes come from a per-thread cache that is
+// refilled from (and spills back to) a shared depot in batches, so steady
+// state allocation touches neither the heap nor a lock on most calls.
+// Larger requests fall through to ::operator new.
+constexpr size_t MAX_POOLED_SIZE = 512;
+
+void* poolAllocate(size_t bytes);
+void poolDeallocate(void* ptr, size_t bytes) noexcept;
+
+} // namespace detail
+
+// Standard allocator over the block pool, usable with std::allocate_shared,
+// std::promise(std::allocator_arg, ...) and containers
+template<typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template<typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        if constexpr (alignof(T) > alignof(std::max_align_t)) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        } else {
+            return static_cast<T*>(detail::poolAllocate(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* ptr, size_t n) noexcept {
+        if constexpr (alignof(T) > alignof(std::max_align_t)) {
+            ::operator delete(ptr, std::align_val_t(alignof(T)));
+        } else {
+            detail::poolDeallocate(ptr, n * sizeof(T));
+        }
+    }
+
+    template<typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    template<typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+};
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_MEMORYPOOL_H
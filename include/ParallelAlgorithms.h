@@ -0,0 +1,175 @@
+#ifndef PROCESS_THREAD_MANAGER_PARALLELALGORITHMS_H
+#define PROCESS_THREAD_MANAGER_PARALLELALGORITHMS_H
+
+#include <algorithm>
+#include <concepts>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+#include "ThreadPool.h"
+
+namespace PTManager {
+
+// Parallel algorithms built on ThreadPool and TaskGroup.
+//
+// Ranges are split recursively: the right half becomes a task, the left half
+// is processed by the current thread, until a piece is no larger than the
+// grain size. The calling thread works on the leftmost pieces and, while
+// waiting for the other halves, helps run queued pieces instead of just
+// blocking, whether or not it is a worker of the pool. Idle workers pick up
+// (or steal, in WORK_STEALING mode) the remaining halves, which balances
+// uneven pieces.
+//
+// A grain size of 0 selects one automatically (about 8 leaves per thread).
+
+namespace detail {
+
+inline size_t autoGrainSize(const ThreadPool& pool, size_t count) {
+    size_t threads = pool.getPoolSize() + 1;   // Workers plus the caller
+    size_t grain = count / (threads * 8);
+    return grain > 0 ? grain : 1;
+}
+
+// Calls leaf(lo, hi) on disjoint subranges covering [lo, hi)
+template<typename Index, typename Leaf>
+void splitRange(ThreadPool& pool, Index lo, Index hi, size_t grain, Leaf& leaf) {
+    if (static_cast<size_t>(hi - lo) <= grain) {
+        leaf(lo, hi);
+        return;
+    }
+
+    Index mid = lo + (hi - lo) / 2;
+    TaskGroup group(pool);
+    group.run([&pool, mid, hi, grain, &leaf]() { splitRange(pool, mid, hi, grain, leaf); });
+    splitRange(pool, lo, mid, grain, leaf);
+    group.waitAndHelp();
+}
+
+template<typename RandomIt, typename T, typename BinaryOp>
+T reduceRange(ThreadPool& pool, RandomIt first, RandomIt last, size_t grain, BinaryOp& op) {
+    auto count = static_cast<size_t>(last - first);
+    if (count <= grain) {
+        T acc = *first;
+        for (++first; first != last; ++first) {
+            acc = op(std::move(acc), *first);
+        }
+        return acc;
+    }
+
+    RandomIt mid = first + static_cast<std::ptrdiff_t>(count / 2);
+    std::optional<T> right;
+    TaskGroup group(pool);
+    group.run([&pool, &right, mid, last, grain, &op]() {
+        right.emplace(reduceRange<RandomIt, T>(pool, mid, last, grain, op));
+    });
+    T left = reduceRange<RandomIt, T>(pool, first, mid, grain, op);
+    group.waitAndHelp();
+    return op(std::move(left), std::move(*right));
+}
+
+template<typename RandomIt, typename Compare>
+void sortRange(ThreadPool& pool, RandomIt first, RandomIt last, size_t grain,
+               Compare& comp, int depthLimit) {
+    auto count = static_cast<size_t>(last - first);
+    if (count <= grain || depthLimit == 0) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    // Median-of-three pivot, then a three-way split so runs of equal keys
+    // do not degrade the recursion
+    RandomIt mid = first + static_cast<std::ptrdiff_t>(count / 2);
+    RandomIt back = last - 1;
+    if (comp(*mid, *first)) std::iter_swap(mid, first);
+    if (comp(*back, *mid)) {
+        std::iter_swap(back, mid);
+        if (comp(*mid, *first)) std::iter_swap(mid, first);
+    }
+    auto pivot = *mid;
+
+    RandomIt lessEnd = std::partition(first, last,
+        [&](const auto& value) { return comp(value, pivot); });
+    RandomIt greaterBegin = std::partition(lessEnd, last,
+        [&](const auto& value) { return !comp(pivot, value); });
+
+    TaskGroup group(pool);
+    group.run([&pool, greaterBegin, last, grain, &comp, depthLimit]() {
+        sortRange(pool, greaterBegin, last, grain, comp, depthLimit - 1);
+    });
+    sortRange(pool, first, lessEnd, grain, comp, depthLimit - 1);
+    group.waitAndHelp();
+}
+
+} // namespace detail
+
+// Calls body(i) for every i in [first, last)
+template<std::integral Index, typename F>
+void parallel_for(ThreadPool& pool, Index first, Index last, F&& body, size_t grainSize = 0) {
+    if (last <= first) return;
+
+    size_t count = static_cast<size_t>(last - first);
+    size_t grain = grainSize > 0 ? grainSize : detail::autoGrainSize(pool, count);
+
+    auto leaf = [&body](Index lo, Index hi) {
+        for (Index i = lo; i < hi; ++i) {
+            body(i);
+        }
+    };
+    detail::splitRange(pool, first, last, grain, leaf);
+}
+
+// Returns op(init, x0 op x1 op ... op xn); op must be associative
+template<std::random_access_iterator RandomIt, typename T, typename BinaryOp = std::plus<>>
+T parallel_reduce(ThreadPool& pool, RandomIt first, RandomIt last, T init,
+                  BinaryOp op = BinaryOp(), size_t grainSize = 0) {
+    if (first == last) return init;
+
+    size_t count = static_cast<size_t>(last - first);
+    size_t grain = grainSize > 0 ? grainSize : detail::autoGrainSize(pool, count);
+
+    T total = detail::reduceRange<RandomIt, T>(pool, first, last, grain, op);
+    return op(std::move(init), std::move(total));
+}
+
+// Writes op(*it) to the output range for every element of [first, last)
+template<std::random_access_iterator InputIt, std::random_access_iterator OutputIt, typename UnaryOp>
+OutputIt parallel_transform(ThreadPool& pool, InputIt first, InputIt last, OutputIt out,
+                            UnaryOp op, size_t grainSize = 0) {
+    if (first == last) return out;
+
+    size_t count = static_cast<size_t>(last - first);
+    size_t grain = grainSize > 0 ? grainSize : detail::autoGrainSize(pool, count);
+
+    auto leaf = [&](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            out[static_cast<std::ptrdiff_t>(i)] = op(first[static_cast<std::ptrdiff_t>(i)]);
+        }
+    };
+    detail::splitRange(pool, size_t{0}, count, grain, leaf);
+    return out + static_cast<std::ptrdiff_t>(count);
+}
+
+// Sorts [first, last) with a parallel quicksort (not stable)
+template<std::random_access_iterator RandomIt, typename Compare = std::less<>>
+void parallel_sort(ThreadPool& pool, RandomIt first, RandomIt last,
+                   Compare comp = Compare(), size_t grainSize = 0) {
+    size_t count = static_cast<size_t>(last - first);
+    if (count < 2) return;
+
+    // Leaves below a few thousand elements are cheaper to sort serially
+    size_t grain = grainSize > 0 ? grainSize
+                                 : std::max<size_t>(detail::autoGrainSize(pool, count), 2048);
+
+    int depthLimit = 0;
+    for (size_t n = count; n > 1; n >>= 1) {
+        depthLimit += 2;
+    }
+
+    detail::sortRange(pool, first, last, grain, comp, depthLimit);
+}
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_PARALLELALGORITHMS_H
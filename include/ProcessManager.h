@@ -1,21 +1,22 @@
 #ifndef PROCESS_THREAD_MANAGER_PROCESSMANAGER_H
 #define PROCESS_THREAD_MANAGER_PROCESSMANAGER_H
 
+#include <chrono>
+#include <condition_variable>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <string>
+#include <sys/resource.h>
 #include <sys/types.h>
 
-namespace PTManager {
+#include "ProcessTable.h"
 
-    enum class ProcessState {
-        CREATED,
-        RUNNING,
-        BLOCKED,
-        READY,
-        TERMINATED
-    };
+namespace PTManager {
 
     class Process {
     public:
@@ -23,31 +24,147 @@ namespace PTManager {
         ProcessState state;
         std::string name;
         int exitStatus;
+        ResourceUsage usage;    // Filled in when the process is reaped
 
         Process(pid_t p, const std::string& n);
         ~Process() = default;
     };
 
+    // How exec-style launches create the child. FORK copies the parent's
+    // page tables, so its cost grows with the parent's RSS; the others share
+    // the parent's memory until the child execs and cost the same at any size.
+    enum class SpawnMethod {
+        POSIX_SPAWN,  // glibc posix_spawn (clone(CLONE_VM | CLONE_VFORK) internally)
+        VFORK,        // vfork() + execve()
+        CLONE,        // clone(CLONE_VM | CLONE_VFORK) on a private stack + execve()
+        FORK          // fork() + execve()
+    };
+
+    struct RLimit {
+        int resource;           // RLIMIT_AS, RLIMIT_NOFILE, RLIMIT_CPU, ...
+        rlim_t soft;
+        rlim_t hard;
+    };
+
+    // Per-child limits, applied in the child before it runs its task or
+    // execs. The cgroup settings create a cgroup v2 group
+    // <cgroupParent>/ptm-<ourpid>-<n> for the child, which must be a
+    // delegated directory with the controllers enabled in its
+    // cgroup.subtree_control; the group is removed once the child is reaped.
+    struct ResourceLimits {
+        std::vector<RLimit> rlimits;
+        std::vector<int> cpuAffinity;           // CPUs the child may run on; empty inherits ours
+        std::string cgroupParent;               // Empty: no cgroup
+        double cpuQuota = 0;                    // cpu.max in CPUs (0.5 = half a CPU), 0 unlimited
+        int64_t memoryMax = 0;                  // memory.max in bytes, 0 unlimited
+        int64_t memoryHigh = 0;                 // memory.high (throttling point) in bytes, 0 unset
+        uint32_t ioWeight = 0;                  // io.weight 1-10000, 0 keeps the default
+
+        bool empty() const { return rlimits.empty() && cpuAffinity.empty() && cgroupParent.empty(); }
+    };
+
+    struct SpawnOptions {
+        SpawnMethod method = SpawnMethod::POSIX_SPAWN;
+        bool searchPath = true;                 // Resolve program through PATH
+        std::vector<std::string> environment;   // "KEY=value" entries; empty inherits ours
+        std::string workingDirectory;           // Empty keeps ours
+        int stdinFd = -1;                       // Descriptors dup'ed onto 0/1/2; -1 inherits
+        int stdoutFd = -1;
+        int stderrFd = -1;
+        bool newProcessGroup = false;
+        // Applying limits needs code in the child, so POSIX_SPAWN launches
+        // with limits use VFORK instead
+        ResourceLimits resources;
+    };
+
+    struct SpawnRequest {
+        std::string name;
+        std::string program;
+        std::vector<std::string> args;          // argv[1..]; argv[0] is program
+    };
+
+    class EventLoop;
+
+    // Children are reaped asynchronously, in completion order, by a reaper
+    // thread watching one pidfd per child, so state queries are plain map
+    // lookups and waits block on a condition variable rather than in
+    // waitpid(). Children whose pidfd cannot be opened (kernels before 5.3)
+    // fall back to waitpid() on demand.
     class ProcessManager {
+    public:
+        // Runs on the reaper thread after the process is marked TERMINATED
+        using ExitCallback = std::function<void(pid_t pid, int exitStatus)>;
+
     private:
-        std::unordered_map<pid_t, Process> processes;
+        ProcessTable table;
+        std::unordered_set<pid_t> unwatched;     // Reaped with wait4() instead
+        std::unordered_map<pid_t, std::string> cgroups;   // Groups to collect and remove on reap
+        mutable std::mutex processMutex;         // Guards unwatched, cgroups, exitCallback and waits on processExited
+        std::condition_variable processExited;
+        ExitCallback exitCallback;
+        std::unique_ptr<EventLoop> reaper;
+
+        void registerProcess(pid_t pid, const std::string& name, const std::string& cgroupPath = {});
+        void onChildExit(pid_t pid, int waitStatus, const struct rusage* usage);
+        ResourceUsage collectUsage(pid_t pid, const struct rusage* usage);
+        bool reapUnwatched(pid_t pid, int options);
+        bool allTerminated(std::unique_lock<std::mutex>& lock, std::chrono::steady_clock::time_point deadline);
 
     public:
-        ProcessManager() = default;
+        ProcessManager();
         ~ProcessManager();
 
+        ProcessManager(const ProcessManager&) = delete;
+        ProcessManager& operator=(const ProcessManager&) = delete;
+
         // Process creation and management
         pid_t createProcess(const std::string& name,
-                           std::function<int()> task);
+                           std::function<int()> task,
+                           const ResourceLimits& limits = ResourceLimits{});
+
+        // Exec-style launch; returns -1 if the child could not be started
+        // (including when the program cannot be executed)
+        pid_t spawnProcess(const std::string& name, const std::string& program,
+                           const std::vector<std::string>& args = {},
+                           const SpawnOptions& options = SpawnOptions{});
+
+        // Bulk creation from up to concurrency threads at once. Results are
+        // per index, -1 where creation failed. Forking from several threads is
+        // only safe if task sticks to what is safe after fork() in a
+        // multithreaded process.
+        std::vector<pid_t> createProcesses(size_t count, const std::string& namePrefix,
+                                           std::function<int(size_t index)> task,
+                                           size_t concurrency = 1);
+        std::vector<pid_t> spawnProcesses(const std::vector<SpawnRequest>& requests,
+                                          const SpawnOptions& options = SpawnOptions{},
+                                          size_t concurrency = 1);
 
         bool waitForProcess(pid_t pid, int* status = nullptr);
+        bool waitForProcess(pid_t pid, std::chrono::milliseconds timeout, int* status = nullptr);
         bool terminateProcess(pid_t pid, int signal = 15);
         bool killProcess(pid_t pid);
 
         ProcessState getProcessState(pid_t pid);
+        std::optional<Process> getProcess(pid_t pid) const;
         std::vector<pid_t> getAllProcesses() const;
+        // Visits every tracked process as a ProcessRecord without copying
+        // the table; visit must not create, reap or purge processes
+        template<typename Visitor>
+        void forEachProcess(Visitor&& visit) const { table.forEach(std::forward<Visitor>(visit)); }
+        size_t getProcessCount() const { return table.size(); }
+        size_t getRunningCount() const { return table.liveCount(); }
         void waitForAll();
-        void terminateAll();
+        // SIGTERM everything, SIGKILL whatever is left once gracePeriod
+        // lapses (or immediately when all have exited), then reap
+        void terminateAll(std::chrono::milliseconds gracePeriod = std::chrono::milliseconds(1000));
+
+        // Terminated processes stay queryable until more than maxTerminated
+        // have exited, then the oldest are evicted
+        void setRetention(size_t maxTerminated) { table.setRetention(maxTerminated); }
+        size_t purgeTerminated() { return table.purgeTerminated(); }
+
+        void setExitCallback(ExitCallback callback);
+        bool isReapingAsync() const { return reaper != nullptr; }
 
         // Process information
         void printProcessInfo(pid_t pid);
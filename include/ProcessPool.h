@@ -0,0 +1,111 @@
+#ifndef PROCESS_THREAD_MANAGER_PROCESSPOOL_H
+#define PROCESS_THREAD_MANAGER_PROCESSPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <sys/types.h>
+
+#include "IPC.h"
+#include "ProcessManager.h"
+
+namespace PTManager {
+
+// Pool of pre-forked worker processes running registered handlers.
+//
+// Handlers are registered by name before start(); every worker is forked
+// after that and so holds the same table, which means only the handler name
+// and its byte payload cross the process boundary. Each worker is fed over
+// its own request/response pipe pair by a supervising thread in the parent,
+// so a task costs two framed pipe round trips instead of a fork and exit.
+//
+// A worker that dies mid-task fails that task's future and is replaced; with
+// maxTasksPerWorker set, workers exit after that many tasks and are
+// replaced too, bounding leaks and fragmentation in long-running handlers.
+// Workers are forked from a multithreaded process, so handlers should not
+// rely on locks the parent's other threads may have held (stdio streams,
+// for example), only on what the handler itself sets up.
+class ProcessPool {
+public:
+    using Handler = std::function<std::string(std::string_view payload)>;
+
+private:
+    struct PendingTask {
+        uint32_t handlerId;
+        std::string payload;
+        std::promise<std::string> result;
+    };
+
+    struct Worker {
+        pid_t pid = -1;
+        std::unique_ptr<Pipe> requests;    // Parent writes, worker reads
+        std::unique_ptr<Pipe> responses;   // Worker writes, parent reads
+        size_t tasksRun = 0;
+        std::thread supervisor;
+    };
+
+    ProcessManager manager;
+    std::mutex managerMutex;           // Serializes forks and reaping through manager
+    std::vector<Handler> handlers;
+    std::unordered_map<std::string, uint32_t> handlerIds;
+    std::vector<Worker> workers;
+    size_t maxTasksPerWorker;
+
+    std::mutex queueMutex;
+    std::condition_variable queueCondition;
+    std::deque<PendingTask> queue;
+    bool started;
+    bool stopping;
+    size_t liveWorkers;
+
+    std::atomic<size_t> completedTasks;
+    std::atomic<size_t> failedTasks;
+    std::atomic<size_t> crashes;
+    std::atomic<size_t> recycles;
+
+    bool spawnWorker(size_t index);
+    void retireWorker(Worker& worker);
+    void workerMain(size_t index);
+    static void closeInheritedDescriptors(int keepA, int keepB);
+    void supervise(size_t index);
+    void failQueued(const std::string& reason);
+
+public:
+    explicit ProcessPool(size_t workerCount, size_t maxTasks = 0);
+    ~ProcessPool();
+
+    ProcessPool(const ProcessPool&) = delete;
+    ProcessPool& operator=(const ProcessPool&) = delete;
+
+    // Only valid before start()
+    void registerHandler(const std::string& name, Handler handler);
+
+    bool start();
+    void shutdown();
+
+    // The future holds the handler's result, or an exception if the handler
+    // threw or its worker died
+    std::future<std::string> submit(const std::string& handlerName, std::string payload);
+
+    size_t getWorkerCount() const { return workers.size(); }
+    std::vector<pid_t> getWorkerPids();
+    size_t getPendingTasks();
+    size_t getCompletedTasks() const { return completedTasks.load(); }
+    size_t getFailedTasks() const { return failedTasks.load(); }
+    size_t getCrashCount() const { return crashes.load(); }
+    size_t getRecycleCount() const { return recycles.load(); }
+};
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_PROCESSPOOL_H
@@ -0,0 +1,177 @@
+#ifndef PROCESS_THREAD_MANAGER_PROCESSTABLE_H
+#define PROCESS_THREAD_MANAGER_PROCESSTABLE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <sys/types.h>
+
+namespace PTManager {
+
+    enum class ProcessState : uint8_t {
+        CREATED,
+        RUNNING,
+        BLOCKED,
+        READY,
+        TERMINATED
+    };
+
+    // What a child cost, collected when it is reaped. The cgroup fields are
+    // -1 unless the child ran in its own cgroup v2 group.
+    struct ResourceUsage {
+        std::chrono::microseconds userTime{0};
+        std::chrono::microseconds systemTime{0};
+        long maxRssKb = 0;
+        long minorFaults = 0;
+        long majorFaults = 0;
+        long voluntaryContextSwitches = 0;
+        long involuntaryContextSwitches = 0;
+        int64_t cgroupCpuUsec = -1;         // cpu.stat usage_usec
+        int64_t cgroupMemoryPeak = -1;      // memory.peak, bytes
+        int64_t cgroupOomKills = -1;        // memory.events oom_kill
+    };
+
+    // Read-only view of a table entry. name points into the table's
+    // interned names and stays valid for the table's lifetime.
+    struct ProcessRecord {
+        pid_t pid;
+        ProcessState state;
+        int exitStatus;
+        std::string_view name;
+        ResourceUsage usage;    // Zero until the process is reaped
+    };
+
+    // Append-only string intern pool: each distinct name is stored once and
+    // referred to by a 32-bit id. Names are never freed, so they should come
+    // from a bounded set (worker roles, not per-task strings).
+    class NameTable {
+    private:
+        mutable std::shared_mutex mutex;
+        std::deque<std::string> names;                       // Stable addresses
+        std::unordered_map<std::string_view, uint32_t> ids;  // Views into names
+
+    public:
+        uint32_t intern(std::string_view name);
+        std::string_view lookup(uint32_t id) const;
+        size_t size() const;
+    };
+
+    // Thread-safe PID -> process map for many short-lived children.
+    //
+    // Entries are spread over SHARD_COUNT shards by PID hash, each guarded
+    // by its own reader-writer lock, so lookups from monitoring threads only
+    // contend with writers of the same shard. A shard is a flat
+    // open-addressing array of 16-byte slots (linear probing, backward-shift
+    // deletion), so there is no per-entry allocation and probes walk
+    // contiguous memory. Resource usage lives in a parallel array that is
+    // only touched once a probe has found its slot.
+    //
+    // Terminated entries are retained for status queries, up to a bounded
+    // number; beyond that the oldest are evicted automatically.
+    class ProcessTable {
+    public:
+        static constexpr size_t SHARD_COUNT = 16;
+
+    private:
+        struct Slot {
+            pid_t pid;              // 0 marks an empty slot
+            ProcessState state;
+            uint32_t nameId;
+            int32_t exitStatus;
+        };
+        static_assert(sizeof(Slot) <= 16, "slots should stay compact");
+
+        struct alignas(64) Shard {
+            mutable std::shared_mutex mutex;
+            std::vector<Slot> slots;    // Power-of-two size
+            std::vector<ResourceUsage> usage;   // usage[i] belongs to slots[i]
+            std::vector<uint64_t> retirements;  // Retirement of slots[i], set when it terminates
+            size_t count = 0;
+        };
+
+        std::array<Shard, SHARD_COUNT> shards;
+        NameTable names;
+        std::atomic<size_t> entries;
+        std::atomic<size_t> live;        // Entries not yet TERMINATED
+
+        // A terminated entry is queued with a table-wide retirement number
+        // and only evicted by the matching queue entry, so a PID that was
+        // reused and terminated again is not evicted by its stale entry
+        struct Retirement {
+            pid_t pid;
+            uint64_t number;
+        };
+
+        std::mutex retiredMutex;
+        std::deque<Retirement> retired;  // Oldest first
+        std::atomic<uint64_t> nextRetirement;
+        size_t maxRetired;
+
+        static uint64_t hashOf(pid_t pid);
+        Shard& shardFor(pid_t pid) { return shards[hashOf(pid) & (SHARD_COUNT - 1)]; }
+        const Shard& shardFor(pid_t pid) const { return shards[hashOf(pid) & (SHARD_COUNT - 1)]; }
+        static size_t probeStart(const Shard& shard, pid_t pid);
+        static const Slot* findSlot(const Shard& shard, pid_t pid);
+        static Slot* findSlot(Shard& shard, pid_t pid);
+        static void grow(Shard& shard);
+        void eraseSlot(Shard& shard, Slot* slot);
+        void evictRetired();
+
+    public:
+        explicit ProcessTable(size_t maxTerminated = 1024);
+
+        ProcessTable(const ProcessTable&) = delete;
+        ProcessTable& operator=(const ProcessTable&) = delete;
+
+        // Adds or replaces the entry for pid (PIDs are reused)
+        void insert(pid_t pid, std::string_view name, ProcessState state);
+        // Records the exit; false if pid is unknown or already terminated
+        bool markTerminated(pid_t pid, int exitStatus, const ResourceUsage& usage = ResourceUsage{});
+        bool setState(pid_t pid, ProcessState state);
+        bool erase(pid_t pid);
+
+        std::optional<ProcessRecord> find(pid_t pid) const;
+        bool contains(pid_t pid) const { return find(pid).has_value(); }
+
+        // Visits every entry without copying the table: one shard at a time,
+        // under that shard's read lock, so visit must not call back into the
+        // table for writing
+        template<typename Visitor>
+        void forEach(Visitor&& visit) const;
+
+        size_t purgeTerminated();
+        void setRetention(size_t maxTerminated);
+        size_t getRetention();
+
+        size_t size() const { return entries.load(std::memory_order_relaxed); }
+        size_t liveCount() const { return live.load(std::memory_order_acquire); }
+        size_t internedNames() const { return names.size(); }
+    };
+
+    template<typename Visitor>
+    void ProcessTable::forEach(Visitor&& visit) const {
+        for (const Shard& shard : shards) {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            for (size_t i = 0; i < shard.slots.size(); ++i) {
+                const Slot& slot = shard.slots[i];
+                if (slot.pid != 0) {
+                    visit(ProcessRecord{slot.pid, slot.state, slot.exitStatus, names.lookup(slot.nameId),
+                                        shard.usage[i]});
+                }
+            }
+        }
+    }
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_PROCESSTABLE_H
@@ -0,0 +1,67 @@
+#ifndef PROCESS_THREAD_MANAGER_RINGQUEUE_H
+#define PROCESS_THREAD_MANAGER_RINGQUEUE_H
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace PTManager {
+
+// Growable FIFO ring buffer (not thread-safe).
+//
+// Replacement for std::queue where steady-state push/pop must not allocate:
+// storage only grows when the queue exceeds its previous high-water mark.
+// T must be default constructible and move assignable.
+template<typename T>
+class RingQueue {
+private:
+    std::vector<T> slots;
+    size_t head;
+    size_t count;
+
+    void grow() {
+        std::vector<T> bigger(slots.size() * 2);
+        for (size_t i = 0; i < count; ++i) {
+            bigger[i] = std::move(slots[(head + i) & (slots.size() - 1)]);
+        }
+        slots.swap(bigger);
+        head = 0;
+    }
+
+public:
+    explicit RingQueue(size_t initialCapacity = 64) : head(0), count(0) {
+        size_t cap = 1;
+        while (cap < initialCapacity) cap <<= 1;
+        slots.resize(cap);
+    }
+
+    void push(T&& value) {
+        if (count == slots.size()) {
+            grow();
+        }
+        slots[(head + count) & (slots.size() - 1)] = std::move(value);
+        ++count;
+    }
+
+    // Moves the oldest element into out; returns false if empty
+    bool pop(T& out) {
+        if (count == 0) return false;
+        T& slot = slots[head];
+        out = std::move(slot);
+        slot = T();
+        head = (head + 1) & (slots.size() - 1);
+        --count;
+        return true;
+    }
+
+    T& front() { return slots[head]; }
+    const T& front() const { return slots[head]; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    size_t capacity() const { return slots.size(); }
+};
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_RINGQUEUE_H
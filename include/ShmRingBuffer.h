@@ -0,0 +1,164 @@
+#ifndef PROCESS_THREAD_MANAGER_SHMRINGBUFFER_H
+#define PROCESS_THREAD_MANAGER_SHMRINGBUFFER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "IPC.h"
+
+namespace PTManager {
+
+enum class RingMode : uint32_t {
+    SPSC, // One producer and one consumer (possibly in different processes)
+    MPMC  // Any number of producers and consumers
+};
+
+// Lock-free byte ring for cross-process messaging, laid out in a mapped
+// SharedMemory region: a control block followed by a power-of-two data area.
+//
+// Messages are variable-length records, framed by a 16-byte header and
+// padded to 16 bytes; a record that would straddle the end of the data area
+// is preceded by a padding record, so every payload is contiguous. The hot
+// indices sit on separate cache lines. Readers and writers only enter the
+// kernel (futex) when the ring is empty or full.
+//
+// One process calls initialize() on a freshly created mapping; the others
+// attach() to it. Each ShmRingBuffer object is one endpoint; in SPSC mode
+// each endpoint may only be used by a single thread per side.
+class ShmRingBuffer {
+public:
+    static constexpr size_t RECORD_ALIGN = 16;
+    static constexpr size_t RECORD_HEADER_SIZE = 16;
+
+private:
+    struct alignas(64) ControlBlock {
+        uint32_t magic;
+        RingMode mode;
+        uint64_t capacity;                        // Data area size, power of two
+
+        alignas(64) std::atomic<uint64_t> tail;   // End of reserved records
+        alignas(64) std::atomic<uint64_t> claim;  // MPMC: end of records claimed by readers
+        alignas(64) std::atomic<uint64_t> head;   // End of released records; writers wait on this
+
+        alignas(64) std::atomic<uint32_t> dataSignal;   // Futex word bumped when records are published
+        std::atomic<uint32_t> readersWaiting;
+        alignas(64) std::atomic<uint32_t> spaceSignal;  // Futex word bumped when space is released
+        std::atomic<uint32_t> writersWaiting;
+    };
+
+    // state holds 2 * position + 1 once committed and 2 * position + 2 once
+    // consumed, so values left over from earlier laps never match
+    struct RecordHeader {
+        std::atomic<uint64_t> state;
+        std::atomic<uint32_t> length;
+        std::atomic<uint32_t> padding;            // Non-zero for wrap padding records
+    };
+
+    static_assert(sizeof(RecordHeader) == RECORD_HEADER_SIZE);
+    static_assert(std::atomic<uint64_t>::is_always_lock_free,
+                  "ring indices must be address-free atomics");
+
+    SharedMemory& memory;
+    ControlBlock* control;
+    char* data;
+    uint64_t mask;
+
+    // SPSC endpoint caches of the other side's index
+    uint64_t cachedHead;
+    uint64_t cachedTail;
+
+    RecordHeader* recordAt(uint64_t position) const {
+        return reinterpret_cast<RecordHeader*>(data + (position & mask));
+    }
+
+    static std::byte* payloadOf(RecordHeader* record) {
+        return reinterpret_cast<std::byte*>(record) + RECORD_HEADER_SIZE;
+    }
+
+public:
+    // Space handed out by reserve(): fill data in place, then commit()
+    struct Reservation {
+        std::span<std::byte> data;
+        uint64_t position = 0;  // Ring position of the record header
+        uint64_t end = 0;       // Ring position after the record
+
+        explicit operator bool() const { return end != 0; }
+    };
+
+    // Record handed out by peek(): read data in place, then release()
+    struct Record {
+        std::span<const std::byte> data;
+        uint64_t position = 0;
+        uint64_t end = 0;
+
+        explicit operator bool() const { return end != 0; }
+    };
+
+private:
+    Reservation reserveSpsc(size_t size);
+    Reservation reserveMpmc(size_t size);
+    int claim(size_t maxLength, Record& record);
+    int claimSpsc(size_t maxLength, Record& record);
+    int claimMpmc(size_t maxLength, Record& record);
+    void releaseConsumed();
+
+    void signalReaders();
+    void signalWriters();
+    template<typename Attempt>
+    static bool blockUntil(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiting,
+                           std::chrono::milliseconds timeout, Attempt&& attempt);
+
+public:
+    explicit ShmRingBuffer(SharedMemory& shm);
+
+    ShmRingBuffer(const ShmRingBuffer&) = delete;
+    ShmRingBuffer& operator=(const ShmRingBuffer&) = delete;
+
+    // Bytes a SharedMemory region needs for a ring with dataCapacity bytes
+    static size_t requiredSize(size_t dataCapacity);
+
+    bool initialize(RingMode mode = RingMode::SPSC);
+    bool attach();
+    bool isAttached() const { return control != nullptr; }
+
+    // Non-blocking: false if the ring is full or the record can never fit
+    bool tryWrite(const void* payload, size_t size);
+    // Blocks while the ring is full; false on timeout or oversized record
+    bool write(const void* payload, size_t size,
+               std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    // Zero-copy writer side. In SPSC mode only one reservation may be
+    // outstanding; MPMC reservations may be committed in any order.
+    Reservation tryReserve(size_t size);
+    Reservation reserve(size_t size, std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+    void commit(const Reservation& slot);
+
+    // Zero-copy reader side: the record's bytes stay valid until release()
+    Record tryPeek();
+    Record peek(std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+    void release(const Record& record);
+
+    // Non-blocking: false if the ring is empty. If the next record does not
+    // fit in buffer it stays queued, false is returned and length is set to
+    // its size.
+    bool tryRead(void* buffer, size_t capacity, size_t& length);
+    bool read(void* buffer, size_t capacity, size_t& length,
+              std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+    bool tryRead(std::vector<char>& message);
+    bool read(std::vector<char>& message,
+              std::chrono::milliseconds timeout = std::chrono::milliseconds::max());
+
+    RingMode getMode() const { return control->mode; }
+    size_t getCapacity() const { return static_cast<size_t>(control->capacity); }
+    size_t maxRecordSize() const;
+    size_t usedBytes() const;
+    bool empty() const;
+};
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_SHMRINGBUFFER_H
@@ -8,21 +8,68 @@
 #include <atomic>
 #include <chrono>
 #include <string>
+#include <thread>
 #include <cstring>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <pthread.h>
 #include <semaphore.h>
+#include <sys/types.h>
+
+#include "LockProfiler.h"
 
 namespace PTManager {
 
-// Enhanced Mutex with deadlock detection
+// Futex-based mutex that spins briefly before sleeping. Uncontended lock()
+// and unlock() are one atomic operation each. A contended locker spins with
+// exponential backoff for an adaptively tuned number of rounds (none on a
+// single CPU, where the holder cannot run meanwhile), then parks in the
+// kernel until the holder releases it.
+class AdaptiveMutex {
+private:
+    std::atomic<uint32_t> state;          // 0 unlocked, 1 locked, 2 locked with sleepers
+    std::atomic<uint32_t> spinEstimate;   // Moving average of rounds a successful spin took
+
+    bool spinAcquire();
+    bool lockSlow(std::chrono::steady_clock::time_point deadline);
+    void wakeOne();
+
+public:
+    AdaptiveMutex();
+
+    AdaptiveMutex(const AdaptiveMutex&) = delete;
+    AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+
+    void lock() {
+        if (!tryLock()) lockSlow(std::chrono::steady_clock::time_point::max());
+    }
+    bool tryLock() {
+        uint32_t expected = 0;
+        return state.compare_exchange_strong(expected, 1, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+    bool tryLockFor(std::chrono::milliseconds timeout);
+    void unlock() {
+        if (state.exchange(0, std::memory_order_release) == 2) wakeOne();
+    }
+
+    bool isLocked() const { return state.load(std::memory_order_relaxed) != 0; }
+};
+
+// Enhanced Mutex with deadlock detection. With tracking off, the recursion
+// check and owner bookkeeping are skipped and an uncontended lock() is a
+// single compare-and-swap.
 class SafeMutex {
 private:
-    std::timed_mutex mtx;
+    AdaptiveMutex mtx;
     std::string name;
+    bool tracking;
     std::atomic<std::thread::id> owner;
     std::atomic<int> lockCount;
+    [[no_unique_address]] LockProbe probe;
 
 public:
-    explicit SafeMutex(const std::string& mutexName = "");
+    explicit SafeMutex(const std::string& mutexName = "", bool trackOwner = true);
 
     bool lock(std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
     bool tryLock();
@@ -30,6 +77,8 @@ public:
 
     std::string getName() const { return name; }
     bool isLocked() const;
+    bool isTracking() const { return tracking; }
+    // Always a default id when tracking is off
     std::thread::id getOwner() const { return owner.load(); }
 };
 
@@ -53,6 +102,7 @@ private:
     sem_t sem;
     std::string name;
     bool initialized;
+    [[no_unique_address]] LockProbe probe;
 
 public:
     explicit Semaphore(unsigned int value = 0, const std::string& semName = "");
@@ -76,17 +126,151 @@ private:
     int readers;
     int writers;
     int waitingWriters;
+    [[no_unique_address]] LockProbe probe;
+
+public:
+    explicit RWLock(const std::string& lockName = "");
+
+    void readLock();
+    void readUnlock();
+
+    void writeLock();
+    void writeUnlock();
+};
+
+// Reader-writer lock whose read side scales with the number of cores.
+//
+// Each reader thread counts itself in one of several cache-line-sized
+// slots (picked once per thread), so concurrent readers touch different
+// lines and never share a mutex. A writer raises the writer flag, which
+// keeps new readers out (writer preference), then waits for every slot to
+// drain, so writes cost O(slots) and should be rare. Readers and writers
+// that must wait sleep on futexes.
+class ShardedRWLock {
+private:
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint32_t> readers{0};
+    };
+
+    std::unique_ptr<ReaderSlot[]> slots;
+    size_t slotMask;
+    alignas(64) std::atomic<uint32_t> writers;   // Waiting or active writers
+    AdaptiveMutex writerMutex;                   // Serializes writers
+
+    ReaderSlot& slotForThread();
 
 public:
-    RWLock();
+    // slotCount is rounded up to a power of two; 0 sizes for this machine
+    explicit ShardedRWLock(size_t slotCount = 0);
+
+    ShardedRWLock(const ShardedRWLock&) = delete;
+    ShardedRWLock& operator=(const ShardedRWLock&) = delete;
 
     void readLock();
+    bool tryReadLock();
     void readUnlock();
 
     void writeLock();
     void writeUnlock();
+
+    size_t getSlotCount() const { return slotMask + 1; }
+};
+
+// Sequence lock for small trivially copyable values read far more often
+// than written. Readers never write shared memory: they copy the value
+// and retry if a writer was active meanwhile, so reads scale perfectly and
+// writers are never starved, at the cost of readers spinning during a
+// write. The value is stored as relaxed 64-bit atomic words, so the
+// concurrent copy is not a data race.
+template<typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock values are copied bytewise");
+    static constexpr size_t WORD_COUNT = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+private:
+    std::atomic<uint32_t> sequence;     // Odd while a write is in progress
+    std::atomic<uint64_t> words[WORD_COUNT];
+    AdaptiveMutex writerMutex;
+
+    void storeWords(const T& value);
+
+public:
+    explicit SeqLock(const T& initial = T{});
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    T load() const;
+    void store(const T& value);
+    // Replaces the value with update(current) atomically with respect to
+    // other writers
+    template<typename Update>
+    void update(Update&& update);
+
+    uint32_t getSequence() const { return sequence.load(std::memory_order_acquire); }
 };
 
+template<typename T>
+SeqLock<T>::SeqLock(const T& initial) : sequence(0) {
+    storeWords(initial);
+}
+
+template<typename T>
+void SeqLock<T>::storeWords(const T& value) {
+    uint64_t buffer[WORD_COUNT] = {};
+    std::memcpy(buffer, &value, sizeof(T));
+    for (size_t i = 0; i < WORD_COUNT; ++i) {
+        words[i].store(buffer[i], std::memory_order_relaxed);
+    }
+}
+
+template<typename T>
+T SeqLock<T>::load() const {
+    uint64_t buffer[WORD_COUNT];
+    while (true) {
+        uint32_t before = sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            buffer[i] = words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sequence.load(std::memory_order_relaxed) == before) {
+            break;
+        }
+    }
+    T value;
+    std::memcpy(&value, buffer, sizeof(T));
+    return value;
+}
+
+template<typename T>
+void SeqLock<T>::store(const T& value) {
+    update([&value](const T&) { return value; });
+}
+
+template<typename T>
+template<typename Update>
+void SeqLock<T>::update(Update&& update) {
+    std::lock_guard<AdaptiveMutex> lock(writerMutex);
+    uint32_t current = sequence.load(std::memory_order_relaxed);
+
+    uint64_t buffer[WORD_COUNT];
+    for (size_t i = 0; i < WORD_COUNT; ++i) {
+        buffer[i] = words[i].load(std::memory_order_relaxed);
+    }
+    T value;
+    std::memcpy(&value, buffer, sizeof(T));
+    T next = update(static_cast<const T&>(value));
+
+    sequence.store(current + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    storeWords(next);
+    sequence.store(current + 2, std::memory_order_release);
+}
+
 // Barrier for synchronizing multiple threads
 class Barrier {
 private:
@@ -124,19 +308,133 @@ public:
     void setReady(bool r);
 };
 
-// Spinlock implementation
+// Test-and-test-and-set spinlock with exponential backoff (pause
+// instructions between attempts) that falls back to yielding the CPU once
+// the holder has taken longer than a bounded spin. Never sleeps in the
+// kernel; use AdaptiveMutex when holders may be descheduled.
 class SpinLock {
 private:
     std::atomic_flag flag;
+    [[no_unique_address]] LockProbe probe;
 
 public:
-    SpinLock();
+    explicit SpinLock(const std::string& lockName = "");
 
     void lock();
     bool tryLock();
     void unlock();
 };
 
+// ===== Process-shared primitives =====
+//
+// These hold no pointers or process-local state, so they can be constructed
+// in place inside a SharedMemory mapping (placement new at an address from
+// SharedMemory::at<T>()) by one process and then used by every process that
+// maps the segment. Construct once, before the other processes use it, and
+// destroy once, after they are done.
+
+// Outcome of acquiring a process-shared lock
+enum class LockResult {
+    ACQUIRED,
+    OWNER_DIED,  // Acquired, but the previous holder died holding it
+    TIMEOUT,
+    FAILED
+};
+
+// Robust process-shared mutex. If a holder dies, the next locker gets
+// OWNER_DIED while holding the lock; it should repair the protected data
+// and call makeConsistent(), otherwise unlocking marks the mutex
+// permanently unusable (every later lock returns FAILED).
+class ProcessMutex {
+private:
+    pthread_mutex_t mutex;
+    bool initialized;
+
+    LockResult interpret(int result);
+
+public:
+    ProcessMutex();
+    ~ProcessMutex();
+
+    ProcessMutex(const ProcessMutex&) = delete;
+    ProcessMutex& operator=(const ProcessMutex&) = delete;
+
+    LockResult lock();
+    LockResult lock(std::chrono::milliseconds timeout);
+    LockResult tryLock();
+    void unlock();
+    bool makeConsistent();
+};
+
+// Process-shared counting semaphore (sem_init with pshared = 1)
+class ProcessSemaphore {
+private:
+    sem_t sem;
+    bool initialized;
+
+public:
+    explicit ProcessSemaphore(unsigned int value = 0);
+    ~ProcessSemaphore();
+
+    ProcessSemaphore(const ProcessSemaphore&) = delete;
+    ProcessSemaphore& operator=(const ProcessSemaphore&) = delete;
+
+    bool wait();
+    bool tryWait();
+    bool timedWait(std::chrono::milliseconds timeout);
+    bool post();
+
+    int getValue();
+};
+
+// Futex-based reader-writer lock for processes. Uncontended acquire and
+// release are a single atomic operation; the kernel is entered only to
+// sleep or to wake sleepers. Waiting writers block new readers. A writer
+// that dies holding the lock is detected by its waiters once the process
+// has been reaped (a zombie still counts as alive), and the one that
+// recovers the lock gets OWNER_DIED; readers that die are not tracked.
+class ProcessRWLock {
+private:
+    std::atomic<uint32_t> state;    // Reader count | WRITER | WRITER_WAITING
+    std::atomic<uint32_t> sleepers;
+    std::atomic<pid_t> writerPid;
+
+    bool writerDied(pid_t& pid);
+    void sleep(uint32_t observed);
+    void wakeAll();
+
+public:
+    ProcessRWLock();
+
+    ProcessRWLock(const ProcessRWLock&) = delete;
+    ProcessRWLock& operator=(const ProcessRWLock&) = delete;
+
+    LockResult readLock();
+    bool tryReadLock();
+    void readUnlock();
+
+    LockResult writeLock();
+    bool tryWriteLock();
+    void writeUnlock();
+};
+
+// Futex-based reusable barrier for processes
+class ProcessBarrier {
+private:
+    const uint32_t threshold;
+    std::atomic<uint32_t> arrived;
+    std::atomic<uint32_t> generation;
+
+public:
+    explicit ProcessBarrier(uint32_t parties);
+
+    ProcessBarrier(const ProcessBarrier&) = delete;
+    ProcessBarrier& operator=(const ProcessBarrier&) = delete;
+
+    // Returns true in exactly one participant per generation (the last to arrive)
+    bool wait();
+};
+
 } // namespace PTManager
 
 
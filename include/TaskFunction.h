@@ -0,0 +1,128 @@
+#ifndef PROCESS_THREAD_MANAGER_TASKFUNCTION_H
+#define PROCESS_THREAD_MANAGER_TASKFUNCTION_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "MemoryPool.h"
+
+namespace PTManager {
+
+// Move-only, type-erased void() callable with small-buffer optimization.
+//
+// Callables up to INLINE_SIZE bytes with a nothrow move constructor are
+// stored inline; larger ones are placed in a pooled block. Unlike
+// std::function it accepts move-only callables (e.g. lambdas owning a
+// std::promise), so a task needs no extra shared_ptr indirection.
+class TaskFunction {
+public:
+    static constexpr size_t INLINE_SIZE = 64;
+
+private:
+    struct Ops {
+        void (*invoke)(void* storage);
+        void (*move)(void* dst, void* src) noexcept;   // Move-construct dst from src, destroy src
+        void (*destroy)(void* storage) noexcept;
+    };
+
+    template<typename F>
+    static constexpr bool storedInline =
+        sizeof(F) <= INLINE_SIZE &&
+        alignof(F) <= alignof(std::max_align_t) &&
+        std::is_nothrow_move_constructible_v<F>;
+
+    template<typename F>
+    struct InlineModel {
+        static void invoke(void* s) { (*static_cast<F*>(s))(); }
+        static void move(void* dst, void* src) noexcept {
+            ::new (dst) F(std::move(*static_cast<F*>(src)));
+            static_cast<F*>(src)->~F();
+        }
+        static void destroy(void* s) noexcept { static_cast<F*>(s)->~F(); }
+        static constexpr Ops ops{&invoke, &move, &destroy};
+    };
+
+    template<typename F>
+    struct PooledModel {
+        static F*& ptr(void* s) { return *static_cast<F**>(s); }
+        static void invoke(void* s) { (*ptr(s))(); }
+        static void move(void* dst, void* src) noexcept {
+            ::new (dst) F*(ptr(src));
+        }
+        static void destroy(void* s) noexcept {
+            F* f = ptr(s);
+            f->~F();
+            PoolAllocator<F>().deallocate(f, 1);
+        }
+        static constexpr Ops ops{&invoke, &move, &destroy};
+    };
+
+    alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+    const Ops* ops = nullptr;
+
+public:
+    TaskFunction() noexcept = default;
+
+    template<typename F,
+             typename Fn = std::decay_t<F>,
+             typename = std::enable_if_t<!std::is_same_v<Fn, TaskFunction> &&
+                                         std::is_invocable_v<Fn&>>>
+    TaskFunction(F&& f) {
+        if constexpr (storedInline<Fn>) {
+            ::new (static_cast<void*>(storage)) Fn(std::forward<F>(f));
+            ops = &InlineModel<Fn>::ops;
+        } else {
+            PoolAllocator<Fn> alloc;
+            Fn* p = alloc.allocate(1);
+            try {
+                ::new (static_cast<void*>(p)) Fn(std::forward<F>(f));
+            } catch (...) {
+                alloc.deallocate(p, 1);
+                throw;
+            }
+            ::new (static_cast<void*>(storage)) Fn*(p);
+            ops = &PooledModel<Fn>::ops;
+        }
+    }
+
+    TaskFunction(TaskFunction&& other) noexcept : ops(other.ops) {
+        if (ops != nullptr) {
+            ops->move(storage, other.storage);
+            other.ops = nullptr;
+        }
+    }
+
+    TaskFunction& operator=(TaskFunction&& other) noexcept {
+        if (this != &other) {
+            reset();
+            if (other.ops != nullptr) {
+                other.ops->move(storage, other.storage);
+                ops = other.ops;
+                other.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+
+    TaskFunction(const TaskFunction&) = delete;
+    TaskFunction& operator=(const TaskFunction&) = delete;
+
+    ~TaskFunction() { reset(); }
+
+    void reset() noexcept {
+        if (ops != nullptr) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+    void operator()() { ops->invoke(storage); }
+
+    explicit operator bool() const noexcept { return ops != nullptr; }
+};
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_TASKFUNCTION_H
@@ -3,13 +3,30 @@
 
 #include <thread>
 #include <vector>
-#include <queue>
 #include <functional>
 #include <mutex>
 #include <condition_variable>
+#include <coroutine>
 #include <future>
 #include <atomic>
 #include <memory>
+#include <type_traits>
+#include <exception>
+#include <limits>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <latch>
+#include <ranges>
+#include <string>
+
+#include "MemoryPool.h"
+#include "RingQueue.h"
+#include "TaskFunction.h"
+#include "WorkStealingDeque.h"
 
 namespace PTManager {
 
@@ -20,23 +37,232 @@ enum class ThreadState {
     TERMINATED
 };
 
+// How tasks are distributed to workers
+enum class SchedulingMode {
+    GLOBAL_QUEUE,   // Single shared FIFO queue guarded by one mutex
+    WORK_STEALING   // Per-worker deques; the global queue only takes external submissions
+};
+
+// What happens when a bounded global queue is full
+enum class OverflowPolicy {
+    BLOCK,        // Wait for space (workers of the pool run the task inline instead)
+    FAIL,         // enqueue()/post() throw std::runtime_error
+    CALLER_RUNS   // Run the task synchronously on the submitting thread
+};
+
+// Priority class of a task in the global queue
+enum class TaskPriority {
+    HIGH,     // Latency-sensitive work, served before the other classes
+    NORMAL,   // Default for submissions without an explicit priority
+    LOW       // Bulk/background work
+};
+
+constexpr size_t TASK_PRIORITY_COUNT = 3;
+
+// Where and how the workers of a pool run (applied by each worker to itself
+// at startup). A setting that cannot be applied, e.g. a real-time policy
+// without CAP_SYS_NICE, is logged as a warning and the worker keeps running.
+struct WorkerPlacement {
+    std::vector<int> cpus;            // Allowed CPUs; empty = inherit the creator's mask
+    bool pinWorkers = false;          // Pin worker i to cpus[i % cpus.size()] only
+    int numaNode = -1;                // Use this node's CPUs when cpus is empty, -1 = any
+
+    int schedPolicy = -1;             // SCHED_OTHER/BATCH/IDLE/FIFO/RR, -1 = inherit
+    int schedPriority = 0;            // Static priority for SCHED_FIFO and SCHED_RR
+    std::optional<int> niceValue;     // Per-thread nice value, nullopt = inherit
+
+    std::string threadName;           // Workers are named "<threadName>-<id>" (max 15 chars)
+};
+
+struct ThreadPoolConfig {
+    size_t numThreads = std::thread::hardware_concurrency();
+    SchedulingMode schedulingMode = SchedulingMode::GLOBAL_QUEUE;
+
+    // Maximum number of tasks waiting in the global queue, 0 = unbounded.
+    // Nested submissions into work-stealing local deques are not bounded.
+    size_t queueCapacity = 0;
+    OverflowPolicy overflowPolicy = OverflowPolicy::BLOCK;
+
+    // Starvation guard: a NORMAL or LOW task that has waited this long is
+    // served before higher classes. 0 = strict priority.
+    std::chrono::milliseconds starvationLimit{100};
+
+    // Elastic sizing: with maxThreads > numThreads, numThreads is the minimum
+    // and a worker is added (up to maxThreads) whenever the oldest task in the
+    // global queue has waited longer than spawnThreshold and no worker is
+    // idle. Workers above the minimum retire after idleTimeout without work.
+    // maxThreads = 0 keeps the pool at a fixed size.
+    size_t maxThreads = 0;
+    std::chrono::milliseconds spawnThreshold{1};
+    std::chrono::milliseconds idleTimeout{10000};
+
+    WorkerPlacement placement{};
+};
+
+// NUMA layout as reported by sysfs. A kernel without NUMA support reports a
+// single node 0 holding every CPU.
+class NumaTopology {
+public:
+    static std::vector<int> getNodes();
+    static std::vector<int> getNodeCpus(int node);
+
+    // Parses the kernel list format, e.g. "0-3,8,10-11"
+    static std::vector<int> parseCpuList(const std::string& list);
+};
+
+// Number of buckets in the per-worker execution time histogram. Bucket 0
+// counts tasks under 1us, bucket i counts [2^(i-1), 2^i) us, and the last
+// bucket also absorbs everything slower.
+constexpr size_t EXEC_HISTOGRAM_BUCKETS = 24;
+
+// Point-in-time counters of one worker (see ThreadPool::getStats)
+struct WorkerStats {
+    ThreadState state = ThreadState::IDLE;
+    uint64_t tasksExecuted = 0;
+    uint64_t steals = 0;                         // Tasks taken from a peer's deque
+    std::chrono::nanoseconds idleTime{0};        // Time parked waiting for work
+    std::chrono::nanoseconds queueWaitTime{0};   // Sum of enqueue-to-start latency
+    std::chrono::nanoseconds executionTime{0};   // Sum of task run time
+    std::array<uint64_t, EXEC_HISTOGRAM_BUCKETS> executionHistogram{};
+};
+
+struct ThreadPoolStats {
+    size_t poolSize = 0;
+    size_t activeTasks = 0;
+    size_t queuedTasks = 0;
+    std::array<size_t, TASK_PRIORITY_COUNT> queuedByPriority{};   // Global queue only
+    uint64_t workersSpawned = 0;   // Elastic workers started after construction
+    uint64_t workersRetired = 0;   // Elastic workers stopped after idleTimeout
+    std::vector<WorkerStats> workers;   // One entry per slot; unused slots are TERMINATED
+
+    uint64_t totalTasksExecuted() const;
+    uint64_t totalSteals() const;
+};
+
 class ThreadPool {
 private:
+    // Task plus its submission time, as stored in the global queue and local deques
+    struct QueuedTask {
+        TaskFunction function;
+        uint64_t enqueueTime = 0;   // steady_clock nanoseconds
+        uint64_t traceId = 0;       // Links the TASK_ENQUEUE and TASK_RUN events
+    };
+
+    // Per-worker state and counters. Each slot has a single writer (its
+    // worker) and sits on its own cache line, so updates are plain relaxed
+    // stores and readers never take a lock.
+    struct alignas(64) WorkerSlot {
+        std::atomic<ThreadState> state{ThreadState::IDLE};
+        std::atomic<uint64_t> tasksExecuted{0};
+        std::atomic<uint64_t> steals{0};
+        std::atomic<uint64_t> idleNanos{0};
+        std::atomic<uint64_t> queueWaitNanos{0};
+        std::atomic<uint64_t> execNanos{0};
+        std::array<std::atomic<uint64_t>, EXEC_HISTOGRAM_BUCKETS> execHistogram{};
+    };
+
+    // Global queue: one FIFO ring per priority class, guarded by queueMutex.
+    // pop() serves the highest non-empty class, unless the oldest task of a
+    // lower class has waited past the starvation limit; then the longest
+    // waiting such task goes first.
+    class TaskQueues {
+    private:
+        std::array<RingQueue<QueuedTask>, TASK_PRIORITY_COUNT> rings;
+        uint64_t starvationNanos = 0;
+
+    public:
+        void setStarvationLimit(uint64_t nanos) { starvationNanos = nanos; }
+        void reallocate();
+
+        void push(TaskPriority priority, QueuedTask&& task) {
+            rings[static_cast<size_t>(priority)].push(std::move(task));
+        }
+        bool pop(QueuedTask& out, TaskPriority& priority);
+
+        size_t size() const;
+        size_t size(TaskPriority priority) const { return rings[static_cast<size_t>(priority)].size(); }
+        bool empty() const { return size() == 0; }
+        uint64_t oldestEnqueueTime() const;
+    };
+
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> tasks;
+    TaskQueues tasks;
 
     std::mutex queueMutex;
     std::condition_variable condition;
     std::atomic<bool> stop;
     std::atomic<size_t> activeTasks;
+    std::atomic<size_t> unfinishedTasks;  // Submitted but not yet completed; waited on via atomic wait
+
+    // Bounded queue
+    std::condition_variable notFull;      // Signalled when a bounded queue drains
+    size_t queueCapacity;
+    OverflowPolicy overflowPolicy;
+    size_t blockedProducers;              // Guarded by queueMutex
+
+    size_t numWorkers;                    // Worker slots, i.e. the maximum pool size
+    std::unique_ptr<WorkerSlot[]> workerSlots;
 
-    std::vector<ThreadState> workerStates;
-    std::mutex stateMutex;
+    // Elastic sizing. workers[i] is the thread of slot i; a retired worker
+    // leaves its slot free and its thread joinable until it is reaped.
+    size_t minWorkers;
+    std::atomic<size_t> liveWorkers;
+    std::vector<uint8_t> slotInUse;       // Guarded by queueMutex
+    uint64_t spawnThresholdNanos;
+    std::chrono::milliseconds idleTimeout;
+    std::atomic<uint64_t> workersSpawned;
+    std::atomic<uint64_t> workersRetired;
+    std::thread growthSupervisor;         // Re-runs maybeGrow() while a backlog ages
+    std::condition_variable growthCondition;
+    bool supervisorParked;                // Guarded by queueMutex
 
+    // Work-stealing mode
+    SchedulingMode mode;
+    std::vector<std::unique_ptr<WorkStealingDeque<QueuedTask*>>> localQueues;
+    std::atomic<size_t> pendingTasks;     // Queued in the global queue and all local deques
+    std::atomic<size_t> globalQueued;     // Mirror of tasks.size() readable without the lock
+    std::array<std::atomic<size_t>, TASK_PRIORITY_COUNT> queuedByPriority{};   // Per-class mirror
+    std::atomic<size_t> sleepingWorkers;
+
+    // Worker placement; cpuList is placement.cpus or the NUMA node's CPUs
+    WorkerPlacement placement;
+    std::vector<int> cpuList;
+    std::latch workersStarted;            // Released once every worker has run initWorker()
+
+    static thread_local ThreadPool* currentPool;
+    static thread_local size_t currentWorker;
+    static constexpr size_t EXTERNAL_THREAD = std::numeric_limits<size_t>::max();
+
+    void initWorker(size_t id, bool firstStart);
+    void applyPlacement(size_t id);
     void workerThread(size_t id);
+    template<typename Ready>
+    bool parkWorker(size_t id, std::unique_lock<std::mutex>& lock, Ready ready);
+    void retireWorker(size_t id, std::unique_lock<std::mutex>& lock);
+    void maybeGrow();
+    void superviseGrowth();
+    void spawnWorker(size_t id);
+    void workStealingLoop(size_t id);
+    bool takeTask(size_t id, QueuedTask& task);
+    void runTask(size_t id, QueuedTask& task);
+    bool pushTask(TaskFunction&& task, TaskPriority priority = TaskPriority::NORMAL,
+                  bool nonBlocking = false);
+    void pushBatch(TaskFunction* batch, size_t count);
+    void taskDequeued(TaskPriority priority);
+    void waitForSpace(std::unique_lock<std::mutex>& lock);
+    void notifyWorkers(size_t count);
+    void runInline(TaskFunction& task);
+
+    template<typename F, typename... Args>
+    static auto makePromiseTask(F&& f, Args&&... args);
+
+    static QueuedTask* newTaskNode(QueuedTask&& task);
+    static void deleteTaskNode(QueuedTask* node);
 
 public:
-    explicit ThreadPool(size_t numThreads);
+    explicit ThreadPool(size_t numThreads,
+                        SchedulingMode schedulingMode = SchedulingMode::GLOBAL_QUEUE);
+    explicit ThreadPool(const ThreadPoolConfig& config);
     ~ThreadPool();
 
     // Disable copy and move
@@ -46,46 +272,280 @@ public:
     // Task submission
     template<typename F, typename... Args>
     auto enqueue(F&& f, Args&&... args)
-        -> std::future<std::result_of_t<F(Args...)>>;
+        -> std::future<std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>>;
+
+    // Submission into a priority class of the global queue
+    template<typename F, typename... Args>
+    auto enqueue(TaskPriority priority, F&& f, Args&&... args)
+        -> std::future<std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>>;
+
+    // Fire-and-forget submission: no future, no shared state
+    template<typename F, typename... Args>
+        requires std::invocable<std::decay_t<F>&, std::decay_t<Args>&...>
+    void post(F&& f, Args&&... args);
+
+    template<typename F, typename... Args>
+    void post(TaskPriority priority, F&& f, Args&&... args);
+
+    // Non-blocking submission: returns nullopt / false if the bounded queue is full
+    template<typename F, typename... Args>
+    auto tryEnqueue(F&& f, Args&&... args)
+        -> std::optional<std::future<std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>>>;
+
+    template<typename F, typename... Args>
+    bool tryPost(F&& f, Args&&... args);
+
+    // Submits every callable of a range under a single lock acquisition
+    template<typename Range>
+    auto enqueueBatch(Range&& callables)
+        -> std::vector<std::future<std::invoke_result_t<std::ranges::range_value_t<Range>&>>>;
+
+    template<typename Range>
+    void postBatch(Range&& callables);
+
+    // Awaitable that resumes the awaiting coroutine on a worker of this pool:
+    // co_await pool.schedule();
+    class ScheduleAwaiter {
+    private:
+        ThreadPool& pool;
+        TaskPriority priority;
+
+    public:
+        ScheduleAwaiter(ThreadPool& threadPool, TaskPriority taskPriority)
+            : pool(threadPool), priority(taskPriority) {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) {
+            pool.post(priority, [handle] { handle.resume(); });
+        }
+        void await_resume() const noexcept {}
+    };
+
+    ScheduleAwaiter schedule(TaskPriority priority = TaskPriority::NORMAL) {
+        return ScheduleAwaiter(*this, priority);
+    }
 
     // Pool management
-    size_t getPoolSize() const { return workers.size(); }
+    size_t getPoolSize() const { return liveWorkers.load(); }
+    size_t getMinPoolSize() const { return minWorkers; }
+    size_t getMaxPoolSize() const { return numWorkers; }
     size_t getActiveTasks() const { return activeTasks.load(); }
     size_t getQueuedTasks();
+    size_t getQueuedTasks(TaskPriority priority) const;
+    size_t getQueueCapacity() const { return queueCapacity; }
+    OverflowPolicy getOverflowPolicy() const { return overflowPolicy; }
+    SchedulingMode getSchedulingMode() const { return mode; }
+    const WorkerPlacement& getPlacement() const { return placement; }
+
+    // One pool per NUMA node with CPUs, each confined to its node and
+    // allocating its queues there. placement.cpus and numaNode of the given
+    // config are ignored; numThreads == 0 means one worker per CPU of the node.
+    static std::vector<std::unique_ptr<ThreadPool>> createPerNumaNode(ThreadPoolConfig config);
 
     void waitForCompletion();
     void shutdown();
 
-    // Thread state monitoring
-    ThreadState getThreadState(size_t id);
+    // Runs one queued task on the calling thread if any is available.
+    // Used by waiters (TaskGroup, parallel algorithms) to help instead of blocking.
+    bool tryRunPendingTask();
+    bool isWorkerThread() const { return currentPool == this; }
+
+    // Thread state monitoring (lock-free, safe to call at any rate)
+    ThreadState getThreadState(size_t id) const;
+    ThreadPoolStats getStats() const;
     void printThreadStates();
 };
 
+// Group of tasks that can be waited on independently of the rest of the pool.
+//
+// wait() helps execute queued tasks while the group is incomplete, so it is
+// safe to call from inside a pool task. waitAndHelp() does so on any thread,
+// for callers that split work with the pool. The first exception thrown by a
+// task of the group is rethrown from either.
+class TaskGroup {
+private:
+    ThreadPool& pool;
+    std::atomic<size_t> pending;
+    std::atomic<bool> failed;
+    std::exception_ptr firstError;
+
+    void finishOne();
+    void waitFor(bool help);
+
+public:
+    explicit TaskGroup(ThreadPool& threadPool);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    template<typename F>
+    void run(F&& f);
+
+    void wait();
+    void waitAndHelp();
+    size_t getPending() const { return pending.load(); }
+};
+
 // Template implementation must be in header
+
+// Wraps a callable and its arguments into a task that fulfils a pooled promise.
+// Returns the task together with the matching future.
+template<typename F, typename... Args>
+auto ThreadPool::makePromiseTask(F&& f, Args&&... args)
+{
+    using return_type = std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>;
+
+    // Shared state comes from the block pool; the promise lives inside the
+    // task itself, so small callables never touch the heap
+    std::promise<return_type> promise(std::allocator_arg, PoolAllocator<char>());
+    std::future<return_type> res = promise.get_future();
+
+    TaskFunction task(
+        [promise = std::move(promise),
+         func = std::forward<F>(f),
+         ...params = std::forward<Args>(args)]() mutable {
+            try {
+                if constexpr (std::is_void_v<return_type>) {
+                    std::invoke(func, params...);
+                    promise.set_value();
+                } else {
+                    promise.set_value(std::invoke(func, params...));
+                }
+            } catch (...) {
+                promise.set_exception(std::current_exception());
+            }
+        });
+
+    return std::make_pair(std::move(task), std::move(res));
+}
+
 template<typename F, typename... Args>
 auto ThreadPool::enqueue(F&& f, Args&&... args)
-    -> std::future<std::result_of_t<F(Args...)>>
+    -> std::future<std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>>
 {
-    using return_type = std::result_of_t<F(Args...)>;
+    auto [task, res] = makePromiseTask(std::forward<F>(f), std::forward<Args>(args)...);
+    pushTask(std::move(task));
+    return std::move(res);
+}
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
-        std::bind(std::forward<F>(f), std::forward<Args>(args)...)
-    );
+template<typename F, typename... Args>
+auto ThreadPool::enqueue(TaskPriority priority, F&& f, Args&&... args)
+    -> std::future<std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>>
+{
+    auto [task, res] = makePromiseTask(std::forward<F>(f), std::forward<Args>(args)...);
+    pushTask(std::move(task), priority);
+    return std::move(res);
+}
 
-    std::future<return_type> res = task->get_future();
+template<typename F, typename... Args>
+    requires std::invocable<std::decay_t<F>&, std::decay_t<Args>&...>
+void ThreadPool::post(F&& f, Args&&... args)
+{
+    post(TaskPriority::NORMAL, std::forward<F>(f), std::forward<Args>(args)...);
+}
 
-    {
-        std::unique_lock<std::mutex> lock(queueMutex);
+template<typename F, typename... Args>
+void ThreadPool::post(TaskPriority priority, F&& f, Args&&... args)
+{
+    pushTask(TaskFunction(
+        [func = std::forward<F>(f),
+         ...params = std::forward<Args>(args)]() mutable {
+            std::invoke(func, params...);
+        }), priority);
+}
+
+template<typename F, typename... Args>
+auto ThreadPool::tryEnqueue(F&& f, Args&&... args)
+    -> std::optional<std::future<std::invoke_result_t<std::decay_t<F>&, std::decay_t<Args>&...>>>
+{
+    auto [task, res] = makePromiseTask(std::forward<F>(f), std::forward<Args>(args)...);
+    if (!pushTask(std::move(task), TaskPriority::NORMAL, true)) {
+        return std::nullopt;
+    }
+    return std::move(res);
+}
+
+template<typename F, typename... Args>
+bool ThreadPool::tryPost(F&& f, Args&&... args)
+{
+    return pushTask(TaskFunction(
+        [func = std::forward<F>(f),
+         ...params = std::forward<Args>(args)]() mutable {
+            std::invoke(func, params...);
+        }), TaskPriority::NORMAL, true);
+}
+
+template<typename Range>
+auto ThreadPool::enqueueBatch(Range&& callables)
+    -> std::vector<std::future<std::invoke_result_t<std::ranges::range_value_t<Range>&>>>
+{
+    using return_type = std::invoke_result_t<std::ranges::range_value_t<Range>&>;
 
-        if (stop) {
-            throw std::runtime_error("Cannot enqueue on stopped ThreadPool");
+    std::vector<TaskFunction> batch;
+    std::vector<std::future<return_type>> results;
+    if constexpr (std::ranges::sized_range<Range>) {
+        batch.reserve(std::ranges::size(callables));
+        results.reserve(std::ranges::size(callables));
+    }
+
+    // Elements of an rvalue range are moved from, otherwise copied
+    for (auto&& f : callables) {
+        if constexpr (std::is_rvalue_reference_v<Range&&>) {
+            auto [task, res] = makePromiseTask(std::move(f));
+            batch.push_back(std::move(task));
+            results.push_back(std::move(res));
+        } else {
+            auto [task, res] = makePromiseTask(f);
+            batch.push_back(std::move(task));
+            results.push_back(std::move(res));
         }
+    }
+
+    pushBatch(batch.data(), batch.size());
+    return results;
+}
+
+template<typename Range>
+void ThreadPool::postBatch(Range&& callables)
+{
+    using callable_type = std::ranges::range_value_t<Range>;
 
-        tasks.emplace([task](){ (*task)(); });
+    std::vector<TaskFunction> batch;
+    if constexpr (std::ranges::sized_range<Range>) {
+        batch.reserve(std::ranges::size(callables));
     }
 
-    condition.notify_one();
-    return res;
+    for (auto&& f : callables) {
+        if constexpr (std::is_rvalue_reference_v<Range&&>) {
+            batch.emplace_back([func = callable_type(std::move(f))]() mutable { func(); });
+        } else {
+            batch.emplace_back([func = callable_type(f)]() mutable { func(); });
+        }
+    }
+
+    pushBatch(batch.data(), batch.size());
+}
+
+template<typename F>
+void TaskGroup::run(F&& f)
+{
+    pending++;
+    try {
+        pool.post([this, func = std::forward<F>(f)]() mutable {
+            try {
+                func();
+            } catch (...) {
+                if (!failed.exchange(true)) {
+                    firstError = std::current_exception();
+                }
+            }
+            finishOne();
+        });
+    } catch (...) {
+        finishOne();
+        throw;
+    }
 }
 
 } // namespace PTManager
@@ -0,0 +1,146 @@
+#ifndef PROCESS_THREAD_MANAGER_TRACER_H
+#define PROCESS_THREAD_MANAGER_TRACER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <sys/types.h>
+
+namespace PTManager {
+
+// Always-on event tracing for task, lock, IPC and process lifecycles.
+//
+// Tracer::enable() maps a trace region: a header, one slot per thread and a
+// fixed ring of records per slot. Each thread claims a slot on its first
+// event and from then on appends to its own ring with a few relaxed stores
+// and no lock; the oldest records are overwritten when it wraps. Readers
+// validate each record's sequence number, so exporting while threads keep
+// tracing is safe and only skips records overwritten mid-copy.
+//
+// A slot is released when its thread exits, or when the reaper reports the
+// exit of its process (see processExited()). Released slots keep their
+// events and are only handed to new threads once every slot has been used,
+// so a long-running process keeps tracing however many threads and
+// children come and go.
+//
+// The region is MAP_SHARED. Children forked after enable() inherit it and
+// their threads claim fresh slots, and a named region can be attach()ed by
+// unrelated processes, so one export shows every process on a common
+// timeline. Timestamps are TSC ticks where the TSC is invariant, otherwise
+// CLOCK_MONOTONIC nanoseconds; export converts them to microseconds.
+//
+// The region stays mapped for the life of the process. Disabled, every
+// instrumentation point costs one relaxed load.
+
+enum class TraceEventType : uint8_t {
+    TASK_ENQUEUE,   // Instant; id links it to the TASK_RUN of the same task
+    TASK_RUN,       // Span; value = worker index, -1 for a helping caller
+    LOCK_WAIT,      // Span of a contended acquisition; id = lock address
+    IPC_SEND,       // Span; id = channel (fd, queue id), value = bytes or -1
+    IPC_RECEIVE,    // Span; id = channel, value = bytes or -1
+    PROCESS_SPAWN,  // Span in the parent; id links it to PROCESS_START, value = PID
+    PROCESS_START,  // Instant in a forked child before its task runs
+    PROCESS_EXIT    // Instant on the reaper; id = PID, value = exit status (see processExited())
+};
+
+const char* traceEventName(TraceEventType type);
+
+struct TraceOptions {
+    std::string sharedName;         // "/name" for a named region; empty for anonymous
+    size_t eventsPerThread = 4096;  // Rounded up to a power of two
+    size_t maxThreads = 256;        // Live threads beyond this, across all processes, are not traced
+};
+
+struct TraceStats {
+    size_t threads = 0;             // Slots holding a live or exited thread's events
+    uint64_t recorded = 0;          // Events written, including overwritten ones
+    uint64_t retained = 0;          // Events still in the rings
+    uint64_t droppedThreads = 0;    // Threads that found no free slot
+    uint64_t recycledSlots = 0;     // Released slots handed to a new thread
+};
+
+class Tracer {
+private:
+    inline static std::atomic<bool> active{false};
+    inline static std::atomic<bool> tscClock{false};
+
+    static uint64_t monotonicNanos();
+
+public:
+    // Maps the region on first use and starts recording. Options apply only
+    // when the region is created; later calls resume recording into it.
+    static bool enable(const TraceOptions& options = {});
+    // Joins a named region created by another process and starts recording
+    static bool attach(const std::string& sharedName);
+    // Stops recording; the region and its events stay available for export
+    static void disable();
+    static bool isEnabled() { return active.load(std::memory_order_relaxed); }
+
+    // Current time in trace ticks
+    static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+        if (tscClock.load(std::memory_order_relaxed)) {
+            return __builtin_ia32_rdtsc();
+        }
+#endif
+        return monotonicNanos();
+    }
+
+    // Appends one event to the calling thread's ring; a no-op while disabled
+    static void record(TraceEventType type, uint64_t start, uint64_t end, uint64_t id, int64_t value);
+    static void instant(TraceEventType type, uint64_t id = 0, int64_t value = 0) {
+        if (isEnabled()) {
+            uint64_t at = now();
+            record(type, at, at, id, value);
+        }
+    }
+    // Id unique across every process sharing the region, for linking events
+    static uint64_t newId();
+    // Records PROCESS_EXIT for a reaped child and releases the slots its
+    // threads still held, e.g. after _exit() or a fatal signal
+    static void processExited(pid_t pid, int exitStatus);
+
+    // Writes every retained event as Chrome trace JSON (chrome://tracing,
+    // ui.perfetto.dev): spans as complete events, task and process
+    // hand-offs as flow arrows
+    static bool writeChromeTrace(std::ostream& out);
+    static bool exportChromeTrace(const std::string& path);
+    // Hides the events recorded so far from later exports and stats
+    static void clear();
+    static TraceStats getStats();
+    static bool unlinkShared(const std::string& sharedName);
+};
+
+// Records a span from construction to end() or destruction. Inactive if
+// tracing was disabled when it was constructed.
+class TraceSpan {
+private:
+    uint64_t start;
+    uint64_t id;
+    int64_t value;
+    TraceEventType type;
+
+public:
+    explicit TraceSpan(TraceEventType eventType, uint64_t eventId = 0, int64_t eventValue = 0)
+        : start(Tracer::isEnabled() ? Tracer::now() : 0), id(eventId), value(eventValue), type(eventType) {}
+    ~TraceSpan() { end(); }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    void setId(uint64_t eventId) { id = eventId; }
+    void setValue(int64_t eventValue) { value = eventValue; }
+
+    void end() {
+        if (start != 0) {
+            Tracer::record(type, start, Tracer::now(), id, value);
+            start = 0;
+        }
+    }
+};
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_TRACER_H
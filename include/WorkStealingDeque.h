@@ -0,0 +1,143 @@
+#ifndef PROCESS_THREAD_MANAGER_WORKSTEALINGDEQUE_H
+#define PROCESS_THREAD_MANAGER_WORKSTEALINGDEQUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <type_traits>
+
+namespace PTManager {
+
+// Chase-Lev work-stealing deque.
+//
+// The owning thread pushes and pops at the bottom (LIFO), any other thread
+// may steal from the top (FIFO). T must be trivially copyable (typically a
+// pointer) because slots are read speculatively by thieves.
+template<typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "WorkStealingDeque elements must be trivially copyable");
+
+private:
+    struct Array {
+        int64_t capacity;
+        int64_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(int64_t cap)
+            : capacity(cap), mask(cap - 1), slots(new std::atomic<T>[cap]) {}
+
+        T get(int64_t i) const { return slots[i & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, T value) { slots[i & mask].store(value, std::memory_order_relaxed); }
+    };
+
+    alignas(64) std::atomic<int64_t> top;
+    alignas(64) std::atomic<int64_t> bottom;
+    alignas(64) std::atomic<Array*> array;
+
+    // Arrays replaced by grow() are kept alive until destruction because a
+    // thief may still be reading from them. Only touched by the owner.
+    std::vector<std::unique_ptr<Array>> arrays;
+
+    Array* grow(Array* old, int64_t b, int64_t t) {
+        auto bigger = std::make_unique<Array>(old->capacity * 2);
+        for (int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        Array* raw = bigger.get();
+        arrays.push_back(std::move(bigger));
+        array.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+public:
+    explicit WorkStealingDeque(size_t initialCapacity = 256) : top(0), bottom(0) {
+        int64_t cap = 1;
+        while (cap < static_cast<int64_t>(initialCapacity)) cap <<= 1;
+        arrays.push_back(std::make_unique<Array>(cap));
+        array.store(arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Owner only: push an element at the bottom
+    void push(T value) {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_acquire);
+        Array* a = array.load(std::memory_order_relaxed);
+
+        if (b - t > a->capacity - 1) {
+            a = grow(a, b, t);
+        }
+
+        a->put(b, value);
+        bottom.store(b + 1, std::memory_order_release);
+    }
+
+    // Owner only: pop the most recently pushed element
+    bool pop(T& out) {
+        int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        Array* a = array.load(std::memory_order_relaxed);
+        // seq_cst store/load pair instead of a standalone fence: same ordering
+        // against steal(), and visible to ThreadSanitizer
+        bottom.store(b, std::memory_order_seq_cst);
+        int64_t t = top.load(std::memory_order_seq_cst);
+
+        if (t > b) {
+            // Deque was empty
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = a->get(b);
+        if (t == b) {
+            // Last element: race against thieves for it
+            bool won = top.compare_exchange_strong(t, t + 1,
+                                                   std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            if (!won) {
+                out = T{};  // A thief took it; don't hand it out twice
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Any thread: take the oldest element from the top
+    bool steal(T& out) {
+        int64_t t = top.load(std::memory_order_seq_cst);
+        int64_t b = bottom.load(std::memory_order_seq_cst);
+
+        if (t >= b) {
+            return false;
+        }
+
+        Array* a = array.load(std::memory_order_acquire);
+        T value = a->get(t);
+        if (!top.compare_exchange_strong(t, t + 1,
+                                         std::memory_order_seq_cst,
+                                         std::memory_order_relaxed)) {
+            return false;  // Lost the race to the owner or another thief
+        }
+
+        out = value;
+        return true;
+    }
+
+    // Approximate number of elements (exact only when quiescent)
+    size_t size() const {
+        int64_t b = bottom.load(std::memory_order_relaxed);
+        int64_t t = top.load(std::memory_order_relaxed);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+    bool empty() const { return size() == 0; }
+};
+
+} // namespace PTManager
+
+#endif //PROCESS_THREAD_MANAGER_WORKSTEALINGDEQUE_H
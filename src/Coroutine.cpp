@@ -0,0 +1,98 @@
+#include "Coroutine.h"
+#include <vector>
+
+namespace PTManager {
+
+// ===== AsyncSemaphore Implementation =====
+
+/**
+ * @brief Constructs a coroutine semaphore
+ *
+ * @param initialCount Number of permits initially available
+ */
+AsyncSemaphore::AsyncSemaphore(size_t initialCount) : count(initialCount), waiters(16) {}
+
+/**
+ * @brief Takes a permit if one is available, without suspending
+ *
+ * @return true if a permit was taken
+ */
+bool AsyncSemaphore::tryAcquire() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count > 0) {
+        count--;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Queues a suspended coroutine for the next permit
+ *
+ * @param handle Coroutine awaiting acquire()
+ * @param pool Pool to resume it on, or nullptr to resume on the releasing thread
+ * @return false if a permit became available meanwhile (the coroutine keeps running)
+ */
+bool AsyncSemaphore::suspendWaiter(std::coroutine_handle<> handle, ThreadPool* pool) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (count > 0) {
+        count--;
+        return false;
+    }
+    waiters.push(Waiter{handle, pool});
+    return true;
+}
+
+/**
+ * @brief Returns permits, waking waiters in FIFO order
+ *
+ * @param permits Number of permits to release
+ *
+ * Each permit goes to the oldest waiter if there is one, otherwise it is
+ * added to the count. Waiters are resumed after the internal lock is
+ * released: posted to their pool, or run inline on this thread.
+ */
+void AsyncSemaphore::release(size_t permits) {
+    std::vector<Waiter> woken;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < permits; ++i) {
+            Waiter waiter;
+            if (waiters.pop(waiter)) {
+                woken.push_back(waiter);
+            } else {
+                count++;
+            }
+        }
+    }
+
+    for (const Waiter& waiter : woken) {
+        if (waiter.pool != nullptr) {
+            waiter.pool->post([handle = waiter.handle] { handle.resume(); });
+        } else {
+            waiter.handle.resume();
+        }
+    }
+}
+
+/**
+ * @brief Queries the number of available permits
+ *
+ * @return Current count; may change immediately after the call
+ */
+size_t AsyncSemaphore::getValue() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return count;
+}
+
+/**
+ * @brief Queries the number of suspended acquirers
+ *
+ * @return Coroutines waiting for a permit
+ */
+size_t AsyncSemaphore::getWaiters() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return waiters.size();
+}
+
+} // namespace PTManager
@@ -0,0 +1,756 @@
+#include "EventLoop.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace PTManager {
+
+namespace {
+
+void runCallback(TaskFunction& callback) {
+    try {
+        callback();
+    } catch (const std::exception& e) {
+        PTM_LOG_ERROR("EventLoop callback threw: " << e.what());
+    }
+}
+
+// Converts a waitid() result to the status word waitpid() would report
+int waitStatusOf(const siginfo_t& info) {
+    switch (info.si_code) {
+        case CLD_EXITED: return (info.si_status & 0xff) << 8;
+        case CLD_KILLED: return info.si_status & 0x7f;
+        case CLD_DUMPED: return (info.si_status & 0x7f) | 0x80;
+        default: return -1;
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Creates the epoll instance and starts the loop thread
+ *
+ * @param pool Pool that runs every callback, or nullptr to run them on the
+ *        loop thread. It must outlive the loop.
+ * @throws std::runtime_error if epoll, the wakeup eventfd or the timerfd
+ *         cannot be created
+ */
+EventLoop::EventLoop(ThreadPool* pool)
+    : epollFd(-1), wakeFd(-1), timerFd(-1), dispatchPool(pool), running(true),
+      nextTimerId(1), inFlight(0) {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd == -1) {
+        throw std::runtime_error(std::string("Failed to create epoll instance: ") + strerror(errno));
+    }
+
+    wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeFd == -1) {
+        int err = errno;
+        ::close(epollFd);
+        throw std::runtime_error(std::string("Failed to create eventfd: ") + strerror(err));
+    }
+
+    timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+    if (timerFd == -1) {
+        int err = errno;
+        ::close(wakeFd);
+        ::close(epollFd);
+        throw std::runtime_error(std::string("Failed to create timerfd: ") + strerror(err));
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wakeFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    event.data.fd = timerFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, timerFd, &event);
+
+    thread = std::thread([this] { run(); });
+}
+
+/**
+ * @brief Stops the loop thread and closes the epoll instance
+ */
+EventLoop::~EventLoop() {
+    stop();
+    ::close(timerFd);
+    ::close(wakeFd);
+    ::close(epollFd);
+}
+
+/**
+ * @brief Stops the loop and joins its thread
+ *
+ * Waits for callbacks already posted to the dispatch pool, so it must not
+ * be called from one of them. Pending registrations are dropped without
+ * running their callbacks, so coroutines still awaiting readiness stay
+ * suspended. Safe to call multiple times.
+ */
+void EventLoop::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    uint64_t one = 1;
+    ssize_t written = ::write(wakeFd, &one, sizeof(one));
+    (void)written;
+
+    if (thread.joinable()) {
+        thread.join();
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(dispatchMutex);
+        dispatchDone.wait(lock, [this] { return inFlight == 0; });
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    watches.clear();
+    handlers.clear();
+    for (auto& [pidfd, process] : processes) {
+        ::close(pidfd);
+    }
+    processes.clear();
+    timers.clear();
+    timerQueue.clear();
+}
+
+/**
+ * @brief Runs callback once when fd becomes readable
+ *
+ * @param fd Descriptor to watch
+ * @param callback Invoked on the loop thread, or on the dispatch pool
+ * @throws std::runtime_error if a read watch is already pending on fd or
+ *         epoll rejects the descriptor
+ */
+void EventLoop::watchReadable(int fd, TaskFunction callback) {
+    watch(fd, false, std::move(callback));
+}
+
+/**
+ * @brief Runs callback once when fd becomes writable
+ *
+ * @param fd Descriptor to watch
+ * @param callback Invoked on the loop thread, or on the dispatch pool
+ * @throws std::runtime_error if a write watch is already pending on fd or
+ *         epoll rejects the descriptor
+ */
+void EventLoop::watchWritable(int fd, TaskFunction callback) {
+    watch(fd, true, std::move(callback));
+}
+
+/**
+ * @brief Registers a one-shot callback for one direction of a descriptor
+ *
+ * @param fd Descriptor to watch
+ * @param writable true for EPOLLOUT, false for EPOLLIN
+ * @param callback Callback to store
+ */
+void EventLoop::watch(int fd, bool writable, TaskFunction&& callback) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!running.load()) {
+        throw std::runtime_error("EventLoop is stopped");
+    }
+    if (handlers.count(fd) > 0) {
+        throw std::runtime_error("Descriptor " + std::to_string(fd) + " already has a handler");
+    }
+
+    Watch& entry = watches[fd];
+    TaskFunction& slot = writable ? entry.onWritable : entry.onReadable;
+    if (slot) {
+        throw std::runtime_error("Descriptor " + std::to_string(fd) + " already has a pending " +
+                                 (writable ? "write" : "read") + " watch");
+    }
+    slot = std::move(callback);
+
+    try {
+        updateRegistration(fd, entry);
+    } catch (...) {
+        slot.reset();
+        if (!entry.onReadable && !entry.onWritable) {
+            watches.erase(fd);
+        }
+        throw;
+    }
+}
+
+/**
+ * @brief Arms epoll for the directions that still have callbacks
+ *
+ * @param fd Descriptor to (re)register
+ * @param watch Pending callbacks of the descriptor
+ *
+ * Must be called with mutex held. Uses EPOLLONESHOT so an event is
+ * delivered once per arming; a closed and reused descriptor number is
+ * handled by falling back between EPOLL_CTL_MOD and EPOLL_CTL_ADD.
+ */
+void EventLoop::updateRegistration(int fd, const Watch& watch) {
+    epoll_event event{};
+    event.events = EPOLLONESHOT;
+    if (watch.onReadable) event.events |= EPOLLIN;
+    if (watch.onWritable) event.events |= EPOLLOUT;
+    event.data.fd = fd;
+
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) == 0) {
+        return;
+    }
+    if (errno == ENOENT && epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0) {
+        return;
+    }
+    throw std::runtime_error("Failed to watch descriptor " + std::to_string(fd) + ": " +
+                             strerror(errno));
+}
+
+/**
+ * @brief Drops pending callbacks of a descriptor without running them
+ *
+ * @param fd Descriptor to forget; call before closing it
+ */
+void EventLoop::cancel(int fd) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (watches.erase(fd) > 0) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    }
+}
+
+/**
+ * @brief Registers a persistent handler for a descriptor
+ *
+ * @param fd Descriptor to watch; it must have no one-shot watches
+ * @param handler Invoked with the ready events each time fd is ready
+ * @param events EPOLLIN, EPOLLOUT or both
+ * @throws std::runtime_error if fd is already watched, the loop is stopped
+ *         or epoll rejects the descriptor
+ *
+ * The descriptor is re-armed only after the handler returns, so with a
+ * dispatch pool it still never runs concurrently with itself. A
+ * level-triggered source that the handler does not drain fires again.
+ */
+void EventLoop::addHandler(int fd, Handler handler, uint32_t events) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if (!running.load()) {
+        throw std::runtime_error("EventLoop is stopped");
+    }
+    if (handlers.count(fd) > 0 || watches.count(fd) > 0) {
+        throw std::runtime_error("Descriptor " + std::to_string(fd) + " is already watched");
+    }
+
+    epoll_event event{};
+    event.events = events | EPOLLONESHOT;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == -1) {
+        throw std::runtime_error("Failed to watch descriptor " + std::to_string(fd) + ": " +
+                                 strerror(errno));
+    }
+    handlers[fd] = HandlerEntry{events, std::make_shared<Handler>(std::move(handler))};
+}
+
+/**
+ * @brief Removes a persistent handler
+ *
+ * @param fd Descriptor to forget; call before closing it
+ * @return true if a handler was registered
+ *
+ * An invocation already in progress completes but is not re-armed.
+ */
+bool EventLoop::removeHandler(int fd) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (handlers.erase(fd) == 0) {
+        return false;
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    return true;
+}
+
+/**
+ * @brief Re-arms a descriptor after its handler ran
+ *
+ * @param fd Descriptor of the handler
+ * @param handler The handler that ran; nothing is done if fd was removed
+ *        or re-registered with another handler meanwhile
+ */
+void EventLoop::rearmHandler(int fd, const std::shared_ptr<Handler>& handler) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running.load()) {
+        return;
+    }
+
+    auto it = handlers.find(fd);
+    if (it == handlers.end() || it->second.handler != handler) {
+        return;
+    }
+
+    epoll_event event{};
+    event.events = it->second.events | EPOLLONESHOT;
+    event.data.fd = fd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) == -1) {
+        PTM_LOG_ERROR("Failed to re-arm descriptor " << fd << ": " << strerror(errno));
+        handlers.erase(it);
+    }
+}
+
+/**
+ * @brief Runs a callback once when a process exits
+ *
+ * @param pid Process to watch
+ * @param callback Invoked with pid and its waitpid()-style status
+ * @return true if the process is being watched
+ * @throws std::runtime_error if the loop is stopped
+ *
+ * Uses a pidfd, so any process can be watched without SIGCHLD handling. If
+ * pid is a child of this process the loop reaps it to collect the status;
+ * otherwise, or if someone else reaped it first, the status is -1.
+ */
+bool EventLoop::watchProcess(pid_t pid, ExitCallback callback) {
+    return watchProcess(pid, UsageExitCallback([callback = std::move(callback)](pid_t exited, int status,
+                                                                                const struct rusage*) {
+        callback(exited, status);
+    }));
+}
+
+/**
+ * @brief Runs callback once when a process exits, with its resource usage
+ *
+ * @param pid Process to watch
+ * @param callback Invoked with pid, its waitpid()-style status and the
+ *        rusage the kernel reported when reaping it (nullptr if the status
+ *        is -1)
+ * @return true if the process is being watched
+ * @throws std::runtime_error if the loop is stopped
+ */
+bool EventLoop::watchProcess(pid_t pid, UsageExitCallback callback) {
+    int pidfd = static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+    if (pidfd == -1) {
+        PTM_LOG_ERROR("Failed to open pidfd for " << pid << ": " << strerror(errno));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running.load()) {
+        ::close(pidfd);
+        throw std::runtime_error("EventLoop is stopped");
+    }
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = pidfd;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, pidfd, &event) == -1) {
+        PTM_LOG_ERROR("Failed to watch pidfd: " << strerror(errno));
+        ::close(pidfd);
+        return false;
+    }
+    processes[pidfd] = ProcessWatch{pid, std::move(callback)};
+    return true;
+}
+
+/**
+ * @brief Stops watching a process without running its callback
+ *
+ * @param pid Process passed to watchProcess()
+ * @return true if the process was being watched
+ */
+bool EventLoop::unwatchProcess(pid_t pid) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto it = processes.begin(); it != processes.end(); ++it) {
+        if (it->second.pid == pid) {
+            epoll_ctl(epollFd, EPOLL_CTL_DEL, it->first, nullptr);
+            ::close(it->first);
+            processes.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Collects the exit status of a process whose pidfd became readable
+ *
+ * @param pidfd Ready pidfd; it is closed and its watch removed
+ * @param ready Receives the exit callback
+ *
+ * Must be called with mutex held. The process has exited, so waitid() does
+ * not block: it either reaps our child or fails with ECHILD. The raw
+ * syscall is used because only it returns the rusage (the glibc wrapper
+ * drops that argument).
+ */
+void EventLoop::reapProcess(int pidfd, std::vector<TaskFunction>& ready) {
+    auto it = processes.find(pidfd);
+    if (it == processes.end()) {
+        return;
+    }
+
+    siginfo_t info{};
+    struct rusage usage{};
+    int status = -1;
+    if (syscall(SYS_waitid, P_PIDFD, pidfd, &info, WEXITED, &usage) == 0 && info.si_pid != 0) {
+        status = waitStatusOf(info);
+    }
+
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, pidfd, nullptr);
+    ::close(pidfd);
+    ready.push_back(TaskFunction([pid = it->second.pid, status, usage,
+                                  callback = std::move(it->second.callback)] {
+        callback(pid, status, status != -1 ? &usage : nullptr);
+    }));
+    processes.erase(it);
+}
+
+/**
+ * @brief Schedules a timer
+ *
+ * @param delay Time until the first run
+ * @param callback Invoked on every expiry
+ * @param interval Period of a repeating timer, or zero for a one-shot timer
+ * @return Identifier for cancelTimer()
+ * @throws std::runtime_error if the loop is stopped
+ *
+ * All timers share one timerfd armed for the earliest deadline. A repeating
+ * timer that falls behind skips the missed periods instead of bursting.
+ */
+EventLoop::TimerId EventLoop::addTimer(std::chrono::milliseconds delay, std::function<void()> callback,
+                                       std::chrono::milliseconds interval) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!running.load()) {
+        throw std::runtime_error("EventLoop is stopped");
+    }
+
+    TimerId id = nextTimerId++;
+    Clock::time_point due = Clock::now() + std::max(delay, std::chrono::milliseconds::zero());
+    timers[id] = Timer{due, std::max(interval, std::chrono::milliseconds::zero()),
+                       std::make_shared<std::function<void()>>(std::move(callback))};
+    timerQueue.emplace(due, id);
+
+    if (timerQueue.begin()->second == id) {
+        armTimerFd();
+    }
+    return id;
+}
+
+/**
+ * @brief Cancels a timer
+ *
+ * @param id Identifier returned by addTimer()
+ * @return true if the timer was still scheduled
+ *
+ * An expiry that was already dispatched may still run once.
+ */
+bool EventLoop::cancelTimer(TimerId id) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = timers.find(id);
+    if (it == timers.end()) {
+        return false;
+    }
+
+    timerQueue.erase({it->second.due, id});
+    timers.erase(it);
+    armTimerFd();
+    return true;
+}
+
+/**
+ * @brief Takes every due timer, rescheduling repeating ones
+ *
+ * @param ready Receives the expired callbacks
+ *
+ * Must be called with mutex held.
+ */
+void EventLoop::collectTimers(std::vector<TaskFunction>& ready) {
+    Clock::time_point now = Clock::now();
+
+    while (!timerQueue.empty() && timerQueue.begin()->first <= now) {
+        TimerId id = timerQueue.begin()->second;
+        timerQueue.erase(timerQueue.begin());
+
+        auto it = timers.find(id);
+        Timer& timer = it->second;
+        ready.push_back(TaskFunction([callback = timer.callback] { (*callback)(); }));
+
+        if (timer.interval > std::chrono::nanoseconds::zero()) {
+            do {
+                timer.due += timer.interval;
+            } while (timer.due <= now);
+            timerQueue.emplace(timer.due, id);
+        } else {
+            timers.erase(it);
+        }
+    }
+    armTimerFd();
+}
+
+/**
+ * @brief Points the timerfd at the earliest deadline, or disarms it
+ *
+ * Must be called with mutex held. steady_clock is CLOCK_MONOTONIC, so its
+ * time points are used directly as absolute timerfd expirations.
+ */
+void EventLoop::armTimerFd() {
+    itimerspec spec{};
+    if (!timerQueue.empty()) {
+        auto due = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            timerQueue.begin()->first.time_since_epoch());
+        auto secs = std::chrono::duration_cast<std::chrono::seconds>(due);
+        spec.it_value.tv_sec = static_cast<time_t>(secs.count());
+        spec.it_value.tv_nsec = static_cast<long>((due - secs).count());
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1;  // All-zero would disarm
+        }
+    }
+
+    if (timerfd_settime(timerFd, TFD_TIMER_ABSTIME, &spec, nullptr) == -1) {
+        PTM_LOG_ERROR("Failed to arm timerfd: " << strerror(errno));
+    }
+}
+
+/**
+ * @brief Runs a ready callback inline or posts it to the dispatch pool
+ *
+ * @param callback Callback to run
+ *
+ * Posted callbacks are counted so stop() can wait for them. If the pool
+ * refuses the task (it was shut down), the callback is dropped and the
+ * failure reported.
+ */
+void EventLoop::dispatch(TaskFunction&& callback) {
+    if (dispatchPool == nullptr) {
+        runCallback(callback);
+        return;
+    }
+
+    auto finished = [this] {
+        std::lock_guard<std::mutex> lock(dispatchMutex);
+        if (--inFlight == 0) {
+            dispatchDone.notify_all();
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(dispatchMutex);
+        ++inFlight;
+    }
+    try {
+        dispatchPool->post([task = std::move(callback), finished]() mutable {
+            runCallback(task);
+            finished();
+        });
+    } catch (const std::exception& e) {
+        PTM_LOG_ERROR("EventLoop dispatch failed: " << e.what());
+        finished();
+    }
+}
+
+/**
+ * @brief Queries the number of descriptors with pending callbacks
+ *
+ * @return Number of descriptors with one-shot watches
+ */
+size_t EventLoop::getWatchCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return watches.size();
+}
+
+/**
+ * @brief Queries the number of persistent handlers
+ *
+ * @return Number of descriptors registered with addHandler()
+ */
+size_t EventLoop::getHandlerCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return handlers.size();
+}
+
+/**
+ * @brief Queries the number of processes being watched
+ *
+ * @return Number of pending exit notifications
+ */
+size_t EventLoop::getProcessWatchCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return processes.size();
+}
+
+/**
+ * @brief Queries the number of scheduled timers
+ *
+ * @return Number of one-shot and repeating timers still scheduled
+ */
+size_t EventLoop::getTimerCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return timers.size();
+}
+
+/**
+ * @brief Loop thread body
+ *
+ * Waits for events and, under the lock, turns them into callbacks: due
+ * timers, exited processes, persistent handlers (re-armed once they ran)
+ * and the one-shot callbacks of every ready direction (an error or hangup
+ * counts as both). The callbacks are then run or dispatched outside the
+ * lock. Exceptions from callbacks are reported and do not stop the loop.
+ */
+void EventLoop::run() {
+    constexpr int MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+    std::vector<TaskFunction> ready;
+
+    while (running.load()) {
+        int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            PTM_LOG_ERROR("epoll_wait failed: " << strerror(errno));
+            break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (int i = 0; i < count; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == wakeFd) {
+                    uint64_t value;
+                    ssize_t drained = ::read(wakeFd, &value, sizeof(value));
+                    (void)drained;
+                    continue;
+                }
+                if (fd == timerFd) {
+                    uint64_t expirations;
+                    ssize_t drained = ::read(timerFd, &expirations, sizeof(expirations));
+                    (void)drained;
+                    collectTimers(ready);
+                    continue;
+                }
+
+                auto handlerIt = handlers.find(fd);
+                if (handlerIt != handlers.end()) {
+                    ready.push_back(TaskFunction(
+                        [this, fd, handler = handlerIt->second.handler, flags = events[i].events] {
+                            try {
+                                (*handler)(flags);
+                            } catch (const std::exception& e) {
+                                PTM_LOG_ERROR("EventLoop handler threw: " << e.what());
+                            }
+                            rearmHandler(fd, handler);
+                        }));
+                    continue;
+                }
+                if (processes.count(fd) > 0) {
+                    reapProcess(fd, ready);
+                    continue;
+                }
+
+                auto it = watches.find(fd);
+                if (it == watches.end()) {
+                    continue;
+                }
+
+                uint32_t flags = events[i].events;
+                bool failed = (flags & (EPOLLERR | EPOLLHUP)) != 0;
+                Watch& entry = it->second;
+                if (entry.onReadable && (failed || (flags & EPOLLIN))) {
+                    ready.push_back(std::move(entry.onReadable));
+                    entry.onReadable.reset();
+                }
+                if (entry.onWritable && (failed || (flags & EPOLLOUT))) {
+                    ready.push_back(std::move(entry.onWritable));
+                    entry.onWritable.reset();
+                }
+
+                if (!entry.onReadable && !entry.onWritable) {
+                    watches.erase(it);
+                } else {
+                    try {
+                        updateRegistration(fd, entry);
+                    } catch (const std::exception& e) {
+                        PTM_LOG_ERROR(e.what());
+                    }
+                }
+            }
+        }
+
+        for (TaskFunction& callback : ready) {
+            dispatch(std::move(callback));
+        }
+        ready.clear();
+    }
+}
+
+/**
+ * @brief Registers the awaiting coroutine for resumption on readiness
+ *
+ * @param handle Suspended coroutine
+ *
+ * The loop thread resumes it directly, or posts the resumption to the
+ * requested pool so I/O completion handling runs on a worker.
+ */
+void EventLoop::FdAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    TaskFunction resume([handle, target = pool] {
+        if (target != nullptr) {
+            target->post([handle] { handle.resume(); });
+        } else {
+            handle.resume();
+        }
+    });
+
+    if (writable) {
+        loop.watchWritable(fd, std::move(resume));
+    } else {
+        loop.watchReadable(fd, std::move(resume));
+    }
+}
+
+/**
+ * @brief Reads from a descriptor once it has data, without blocking a thread
+ *
+ * @param fd Descriptor to read from
+ * @param buffer Destination buffer
+ * @param size Maximum number of bytes
+ * @param resumeOn Pool to continue on after the wait, or nullptr
+ * @return Bytes read, 0 at end of stream, -1 on error (errno set)
+ */
+Task<ssize_t> EventLoop::readAsync(int fd, void* buffer, size_t size, ThreadPool* resumeOn) {
+    co_await readable(fd, resumeOn);
+    co_return ::read(fd, buffer, size);
+}
+
+/**
+ * @brief Writes a whole buffer to a descriptor, suspending while it is full
+ *
+ * @param fd Descriptor to write to
+ * @param data Bytes to write
+ * @param size Number of bytes
+ * @param resumeOn Pool to continue on after each wait, or nullptr
+ * @return size on success, -1 on error (errno set)
+ *
+ * Each writability notification guarantees room for PIPE_BUF bytes on a
+ * pipe, so the data is written in chunks of at most PIPE_BUF and the
+ * (blocking) descriptor never blocks the resuming thread.
+ */
+Task<ssize_t> EventLoop::writeAsync(int fd, const void* data, size_t size, ThreadPool* resumeOn) {
+    const char* bytes = static_cast<const char*>(data);
+    size_t written = 0;
+
+    while (written < size) {
+        co_await writable(fd, resumeOn);
+
+        size_t chunk = std::min<size_t>(size - written, PIPE_BUF);
+        ssize_t result = ::write(fd, bytes + written, chunk);
+        if (result == -1) {
+            if (errno == EINTR) continue;
+            co_return -1;
+        }
+        written += static_cast<size_t>(result);
+    }
+    co_return static_cast<ssize_t>(written);
+}
+
+} // namespace PTManager
@@ -1,14 +1,218 @@
 #include "IPC.h"
+#include "Logger.h"
+#include "Tracer.h"
 #include <unistd.h>
 #include <fcntl.h>
 #include <sys/stat.h>
 #include <sys/mman.h>
 #include <sys/msg.h>
+#include <sys/uio.h>
 #include <cstring>
-#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <climits>
+#include <csignal>
+#include <ctime>
 
 namespace PTManager {
 
+namespace {
+
+/**
+ * @brief Writes every byte described by an iovec array, resuming after
+ *        partial writes and interrupted calls
+ *
+ * @param fd Descriptor to write to
+ * @param iov Buffers to write; modified as data is consumed
+ * @param count Number of entries in iov
+ * @return true if everything was written
+ */
+bool writeAll(int fd, iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t written = ::writev(fd, iov, std::min(count, IOV_MAX));
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+
+        size_t remaining = static_cast<size_t>(written);
+        while (count > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Writes one length-prefixed frame with a single writev
+ *
+ * @param fd Descriptor to write to
+ * @param data Frame body
+ * @param size Body length
+ * @return true if the whole frame was written
+ *
+ * Frames up to PIPE_BUF bytes (header included) are written atomically,
+ * so concurrent writers to one pipe never interleave them.
+ */
+bool writeFrameTo(int fd, const void* data, size_t size) {
+    if (fd == -1) return false;
+    TraceSpan span(TraceEventType::IPC_SEND, static_cast<uint64_t>(fd), static_cast<int64_t>(size));
+
+    iovec iov[2];
+    iov[0].iov_base = &size;
+    iov[0].iov_len = sizeof(size);
+    iov[1].iov_base = const_cast<void*>(data);
+    iov[1].iov_len = size;
+    bool written = writeAll(fd, iov, size > 0 ? 2 : 1);
+    if (!written) span.setValue(-1);
+    return written;
+}
+
+/**
+ * @brief Writes a batch of frames, coalescing up to IOV_MAX / 2 per writev
+ *
+ * @param fd Descriptor to write to
+ * @param messages Range of string-like frame bodies
+ * @return true if every frame was written
+ */
+template<typename Range>
+bool writeFramesTo(int fd, const Range& messages) {
+    if (fd == -1) return false;
+    TraceSpan span(TraceEventType::IPC_SEND, static_cast<uint64_t>(fd));
+    int64_t bytes = 0;
+
+    const size_t perCall = IOV_MAX / 2;
+    std::vector<size_t> lengths(std::min(messages.size(), perCall));
+    std::vector<iovec> iov(2 * lengths.size());
+
+    for (size_t first = 0; first < messages.size(); first += perCall) {
+        size_t count = std::min(perCall, messages.size() - first);
+        for (size_t i = 0; i < count; ++i) {
+            const auto& message = messages[first + i];
+            lengths[i] = message.size();
+            iov[2 * i].iov_base = &lengths[i];
+            iov[2 * i].iov_len = sizeof(size_t);
+            iov[2 * i + 1].iov_base = const_cast<char*>(message.data());
+            iov[2 * i + 1].iov_len = message.size();
+            bytes += static_cast<int64_t>(message.size());
+        }
+        if (!writeAll(fd, iov.data(), static_cast<int>(2 * count))) {
+            span.setValue(-1);
+            return false;
+        }
+    }
+    span.setValue(bytes);
+    return true;
+}
+
+/**
+ * @brief Moves data between two descriptors with splice(), one of them a pipe
+ *
+ * @param in Source descriptor
+ * @param inOffset File offset to read from (advanced), or nullptr
+ * @param out Destination descriptor
+ * @param outOffset File offset to write at (advanced), or nullptr
+ * @param length Maximum number of bytes to move
+ * @return Bytes moved, stopping early at end of input; -1 if an error
+ *         occurred before anything was moved
+ */
+ssize_t spliceAll(int in, off_t* inOffset, int out, off_t* outOffset, size_t length) {
+    if (in == -1 || out == -1) return -1;
+
+    size_t moved = 0;
+    while (moved < length) {
+        ssize_t count = ::splice(in, inOffset, out, outOffset, length - moved, SPLICE_F_MOVE);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return moved > 0 ? static_cast<ssize_t>(moved) : -1;
+        }
+        if (count == 0) break;
+        moved += static_cast<size_t>(count);
+    }
+    return static_cast<ssize_t>(moved);
+}
+
+/**
+ * @brief Maps user memory into a pipe with vmsplice(), without copying
+ *
+ * @param pipeFd Write end of a pipe
+ * @param data Memory to hand to the pipe
+ * @param size Number of bytes
+ * @return Bytes queued; -1 if an error occurred before anything was queued
+ */
+ssize_t vmspliceAll(int pipeFd, const void* data, size_t size) {
+    if (pipeFd == -1) return -1;
+
+    const char* bytes = static_cast<const char*>(data);
+    size_t queued = 0;
+    while (queued < size) {
+        iovec iov{const_cast<char*>(bytes + queued), size - queued};
+        ssize_t count = ::vmsplice(pipeFd, &iov, 1, 0);
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            return queued > 0 ? static_cast<ssize_t>(queued) : -1;
+        }
+        queued += static_cast<size_t>(count);
+    }
+    return static_cast<ssize_t>(queued);
+}
+
+/**
+ * @brief Resizes a pipe's kernel buffer
+ *
+ * @param pipeFd Either end of the pipe
+ * @param bytes Requested capacity; the kernel rounds up to a power of two pages
+ * @return true on success
+ */
+bool setPipeCapacity(int pipeFd, size_t bytes) {
+    if (pipeFd == -1) return false;
+    if (fcntl(pipeFd, F_SETPIPE_SZ, static_cast<int>(bytes)) < 0) {
+        PTM_LOG_ERROR("Failed to set pipe capacity: " << strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Queries a pipe's kernel buffer size
+ *
+ * @param pipeFd Either end of the pipe
+ * @return Capacity in bytes, or 0 on error
+ */
+size_t getPipeCapacity(int pipeFd) {
+    if (pipeFd == -1) return 0;
+    int capacity = fcntl(pipeFd, F_GETPIPE_SZ);
+    return capacity < 0 ? 0 : static_cast<size_t>(capacity);
+}
+
+/**
+ * @brief Converts a relative timeout to the absolute CLOCK_REALTIME
+ *        deadline the mq_timed* calls expect
+ *
+ * @param timeout Time from now; zero yields an already expired deadline
+ * @return Absolute deadline
+ */
+timespec realtimeDeadline(std::chrono::milliseconds timeout) {
+    timespec deadline{};
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count();
+    deadline.tv_sec += static_cast<time_t>(nanos / 1000000000);
+    deadline.tv_nsec += static_cast<long>(nanos % 1000000000);
+    if (deadline.tv_nsec >= 1000000000) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000;
+    }
+    return deadline;
+}
+
+} // namespace
+
 // ===== Pipe Implementation =====
 
 /**
@@ -16,13 +220,13 @@ namespace PTManager {
  *
  * Creates a unidirectional communication channel using the pipe() system call.
  * The pipe consists of two file descriptors: fds[0] for reading and fds[1] for writing.
- * Logs error to stderr if pipe creation fails.
+ * Logs an error through the library logger if pipe creation fails.
  */
-Pipe::Pipe() : isOpen(false) {
+Pipe::Pipe() : fds{-1, -1}, isOpen(false) {
     if (pipe(fds) == 0) {
         isOpen = true;
     } else {
-        std::cerr << "Failed to create pipe: " << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Failed to create pipe: " << strerror(errno));
     }
 }
 
@@ -84,7 +288,10 @@ void Pipe::close() {
  */
 ssize_t Pipe::write(const void* data, size_t size) {
     if (!isOpen || fds[1] == -1) return -1;
-    return ::write(fds[1], data, size);
+    TraceSpan span(TraceEventType::IPC_SEND, static_cast<uint64_t>(fds[1]));
+    ssize_t written = ::write(fds[1], data, size);
+    span.setValue(written);
+    return written;
 }
 
 /**
@@ -98,7 +305,10 @@ ssize_t Pipe::write(const void* data, size_t size) {
  */
 ssize_t Pipe::read(void* buffer, size_t size) {
     if (!isOpen || fds[0] == -1) return -1;
-    return ::read(fds[0], buffer, size);
+    TraceSpan span(TraceEventType::IPC_RECEIVE, static_cast<uint64_t>(fds[0]));
+    ssize_t got = ::read(fds[0], buffer, size);
+    span.setValue(got);
+    return got;
 }
 
 /**
@@ -108,12 +318,45 @@ ssize_t Pipe::read(void* buffer, size_t size) {
  * @return true if entire string was written successfully, false otherwise
  *
  * Protocol: First writes the length as size_t, then writes the string content.
- * This allows the receiver to know exactly how many bytes to read.
+ * This allows the receiver to know exactly how many bytes to read. Both
+ * parts go out in a single writev() call.
  */
 bool Pipe::writeString(const std::string& str) {
-    size_t len = str.length();
-    if (write(&len, sizeof(len)) != sizeof(len)) return false;
-    return write(str.c_str(), len) == static_cast<ssize_t>(len);
+    return writeFrame(str.data(), str.size());
+}
+
+/**
+ * @brief Writes one length-prefixed frame with a single syscall
+ *
+ * @param data Frame body
+ * @param size Body length
+ * @return true if the whole frame was written
+ */
+bool Pipe::writeFrame(const void* data, size_t size) {
+    if (!isOpen) return false;
+    return writeFrameTo(fds[1], data, size);
+}
+
+/**
+ * @brief Writes many frames, coalescing them into few writev() calls
+ *
+ * @param messages Frame bodies, in order
+ * @return true if every frame was written
+ */
+bool Pipe::writeBatch(std::span<const std::string_view> messages) {
+    if (!isOpen) return false;
+    return writeFramesTo(fds[1], messages);
+}
+
+/**
+ * @brief Writes many string frames, coalescing them into few writev() calls
+ *
+ * @param messages Frame bodies, in order
+ * @return true if every frame was written
+ */
+bool Pipe::writeBatch(const std::vector<std::string>& messages) {
+    if (!isOpen) return false;
+    return writeFramesTo(fds[1], messages);
 }
 
 /**
@@ -138,6 +381,113 @@ std::string Pipe::readString(size_t maxSize) {
     return std::string(buffer.data(), len);
 }
 
+/**
+ * @brief Moves data from a descriptor into the pipe without copying it
+ *        through user space
+ *
+ * @param fd Source descriptor (file, socket or pipe)
+ * @param length Maximum number of bytes to move
+ * @param offset File offset to read from (advanced), or nullptr to use and
+ *               advance the descriptor's own offset
+ * @return Bytes moved, or -1 if nothing could be moved
+ *
+ * Blocks while the pipe is full, so a reader must be draining it.
+ */
+ssize_t Pipe::spliceFrom(int fd, size_t length, off_t* offset) {
+    if (!isOpen) return -1;
+    return spliceAll(fd, offset, fds[1], nullptr, length);
+}
+
+/**
+ * @brief Moves data from the pipe into a descriptor without copying it
+ *        through user space
+ *
+ * @param fd Destination descriptor (file, socket or pipe)
+ * @param length Maximum number of bytes to move
+ * @param offset File offset to write at (advanced), or nullptr
+ * @return Bytes moved (fewer at end of stream), or -1 if nothing could be
+ */
+ssize_t Pipe::spliceTo(int fd, size_t length, off_t* offset) {
+    if (!isOpen) return -1;
+    return spliceAll(fds[0], nullptr, fd, offset, length);
+}
+
+/**
+ * @brief Queues user memory into the pipe by reference
+ *
+ * @param data Memory to queue; must stay unchanged until it has been read
+ * @param size Number of bytes
+ * @return Bytes queued, or -1 if nothing could be queued
+ */
+ssize_t Pipe::vmspliceFrom(const void* data, size_t size) {
+    if (!isOpen) return -1;
+    return vmspliceAll(fds[1], data, size);
+}
+
+/**
+ * @brief Duplicates buffered data into another pipe without consuming it
+ *
+ * @param pipeFd Write end of the destination pipe
+ * @param length Maximum number of bytes to duplicate
+ * @return Bytes duplicated, 0 if the pipe is empty, or -1 on error
+ */
+ssize_t Pipe::teeTo(int pipeFd, size_t length) {
+    if (!isOpen || fds[0] == -1) return -1;
+    return ::tee(fds[0], pipeFd, length, 0);
+}
+
+/**
+ * @brief Resizes the pipe's kernel buffer
+ *
+ * @param bytes Requested capacity in bytes
+ * @return true on success
+ */
+bool Pipe::setCapacity(size_t bytes) {
+    if (!isOpen) return false;
+    return setPipeCapacity(fds[1] != -1 ? fds[1] : fds[0], bytes);
+}
+
+/**
+ * @brief Queries the pipe's kernel buffer size
+ *
+ * @return Capacity in bytes, or 0 if the pipe is closed
+ */
+size_t Pipe::getCapacity() const {
+    if (!isOpen) return 0;
+    return getPipeCapacity(fds[1] != -1 ? fds[1] : fds[0]);
+}
+
+/**
+ * @brief Reads from the pipe inside a coroutine without blocking a thread
+ *
+ * @param loop Event loop that watches the read end
+ * @param buffer Destination buffer
+ * @param size Maximum number of bytes to read
+ * @param resumeOn Pool to continue on once data is available, or nullptr
+ *                 to continue on the loop thread
+ * @return Task yielding bytes read, 0 at end of stream, or -1 on error
+ */
+Task<ssize_t> Pipe::readAsync(EventLoop& loop, void* buffer, size_t size, ThreadPool* resumeOn) {
+    if (!isOpen || fds[0] == -1) co_return -1;
+    co_return co_await loop.readAsync(fds[0], buffer, size, resumeOn);
+}
+
+/**
+ * @brief Writes a whole buffer to the pipe inside a coroutine
+ *
+ * @param loop Event loop that watches the write end
+ * @param data Bytes to write
+ * @param size Number of bytes
+ * @param resumeOn Pool to continue on after each wait, or nullptr
+ * @return Task yielding size on success, or -1 on error
+ *
+ * Suspends whenever the pipe is full instead of blocking the caller.
+ */
+Task<ssize_t> Pipe::writeAsync(EventLoop& loop, const void* data, size_t size, ThreadPool* resumeOn) {
+    if (!isOpen || fds[1] == -1) co_return -1;
+    co_return co_await loop.writeAsync(fds[1], data, size, resumeOn);
+}
+
 // ===== NamedPipe Implementation =====
 
 /**
@@ -176,16 +526,16 @@ NamedPipe::~NamedPipe() {
 bool NamedPipe::create(mode_t mode) {
     if (mkfifo(path.c_str(), mode) == 0) {
         isCreated = true;
-        std::cout << "Created named pipe: " << path << std::endl;
+        PTM_LOG_INFO("Created named pipe: " << path);
         return true;
     }
 
     if (errno == EEXIST) {
-        std::cout << "Named pipe already exists: " << path << std::endl;
+        PTM_LOG_INFO("Named pipe already exists: " << path);
         return true;
     }
 
-    std::cerr << "Failed to create named pipe: " << strerror(errno) << std::endl;
+    PTM_LOG_ERROR("Failed to create named pipe: " << strerror(errno));
     return false;
 }
 
@@ -200,7 +550,7 @@ bool NamedPipe::create(mode_t mode) {
 bool NamedPipe::openForReading() {
     fd = ::open(path.c_str(), O_RDONLY);
     if (fd < 0) {
-        std::cerr << "Failed to open pipe for reading: " << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Failed to open pipe for reading: " << strerror(errno));
         return false;
     }
     return true;
@@ -217,7 +567,7 @@ bool NamedPipe::openForReading() {
 bool NamedPipe::openForWriting() {
     fd = ::open(path.c_str(), O_WRONLY);
     if (fd < 0) {
-        std::cerr << "Failed to open pipe for writing: " << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Failed to open pipe for writing: " << strerror(errno));
         return false;
     }
     return true;
@@ -246,7 +596,7 @@ void NamedPipe::close() {
  */
 bool NamedPipe::remove() {
     if (unlink(path.c_str()) == 0) {
-        std::cout << "Removed named pipe: " << path << std::endl;
+        PTM_LOG_INFO("Removed named pipe: " << path);
         return true;
     }
     return false;
@@ -261,7 +611,10 @@ bool NamedPipe::remove() {
  */
 ssize_t NamedPipe::write(const void* data, size_t size) {
     if (fd < 0) return -1;
-    return ::write(fd, data, size);
+    TraceSpan span(TraceEventType::IPC_SEND, static_cast<uint64_t>(fd));
+    ssize_t written = ::write(fd, data, size);
+    span.setValue(written);
+    return written;
 }
 
 /**
@@ -273,7 +626,10 @@ ssize_t NamedPipe::write(const void* data, size_t size) {
  */
 ssize_t NamedPipe::read(void* buffer, size_t size) {
     if (fd < 0) return -1;
-    return ::read(fd, buffer, size);
+    TraceSpan span(TraceEventType::IPC_RECEIVE, static_cast<uint64_t>(fd));
+    ssize_t got = ::read(fd, buffer, size);
+    span.setValue(got);
+    return got;
 }
 
 /**
@@ -282,12 +638,42 @@ ssize_t NamedPipe::read(void* buffer, size_t size) {
  * @param str The string to write
  * @return true if entire string was written successfully, false otherwise
  *
- * Protocol: Writes length first (size_t), then string content.
+ * Protocol: Writes length first (size_t), then string content, in a
+ * single writev() call.
  */
 bool NamedPipe::writeString(const std::string& str) {
-    size_t len = str.length();
-    if (write(&len, sizeof(len)) != sizeof(len)) return false;
-    return write(str.c_str(), len) == static_cast<ssize_t>(len);
+    return writeFrame(str.data(), str.size());
+}
+
+/**
+ * @brief Writes one length-prefixed frame with a single syscall
+ *
+ * @param data Frame body
+ * @param size Body length
+ * @return true if the whole frame was written
+ */
+bool NamedPipe::writeFrame(const void* data, size_t size) {
+    return writeFrameTo(fd, data, size);
+}
+
+/**
+ * @brief Writes many frames, coalescing them into few writev() calls
+ *
+ * @param messages Frame bodies, in order
+ * @return true if every frame was written
+ */
+bool NamedPipe::writeBatch(std::span<const std::string_view> messages) {
+    return writeFramesTo(fd, messages);
+}
+
+/**
+ * @brief Writes many string frames, coalescing them into few writev() calls
+ *
+ * @param messages Frame bodies, in order
+ * @return true if every frame was written
+ */
+bool NamedPipe::writeBatch(const std::vector<std::string>& messages) {
+    return writeFramesTo(fd, messages);
 }
 
 /**
@@ -311,6 +697,174 @@ std::string NamedPipe::readString(size_t maxSize) {
     return std::string(buffer.data(), len);
 }
 
+/**
+ * @brief Reads from the FIFO inside a coroutine without blocking a thread
+ *
+ * @param loop Event loop that watches the descriptor
+ * @param buffer Destination buffer
+ * @param size Maximum number of bytes to read
+ * @param resumeOn Pool to continue on once data is available, or nullptr
+ * @return Task yielding bytes read, 0 at end of stream, or -1 if not open
+ */
+Task<ssize_t> NamedPipe::readAsync(EventLoop& loop, void* buffer, size_t size, ThreadPool* resumeOn) {
+    if (fd < 0) co_return -1;
+    co_return co_await loop.readAsync(fd, buffer, size, resumeOn);
+}
+
+/**
+ * @brief Writes a whole buffer to the FIFO inside a coroutine
+ *
+ * @param loop Event loop that watches the descriptor
+ * @param data Bytes to write
+ * @param size Number of bytes
+ * @param resumeOn Pool to continue on after each wait, or nullptr
+ * @return Task yielding size on success, or -1 on error
+ */
+Task<ssize_t> NamedPipe::writeAsync(EventLoop& loop, const void* data, size_t size, ThreadPool* resumeOn) {
+    if (fd < 0) co_return -1;
+    co_return co_await loop.writeAsync(fd, data, size, resumeOn);
+}
+
+/**
+ * @brief Moves data from a descriptor into the FIFO without copying it
+ *        through user space
+ *
+ * @param sourceFd Source descriptor (file, socket or pipe)
+ * @param length Maximum number of bytes to move
+ * @param offset File offset to read from (advanced), or nullptr
+ * @return Bytes moved, or -1 if nothing could be moved
+ */
+ssize_t NamedPipe::spliceFrom(int sourceFd, size_t length, off_t* offset) {
+    return spliceAll(sourceFd, offset, fd, nullptr, length);
+}
+
+/**
+ * @brief Moves data from the FIFO into a descriptor without copying it
+ *        through user space
+ *
+ * @param targetFd Destination descriptor (file, socket or pipe)
+ * @param length Maximum number of bytes to move
+ * @param offset File offset to write at (advanced), or nullptr
+ * @return Bytes moved (fewer at end of stream), or -1 if nothing could be
+ */
+ssize_t NamedPipe::spliceTo(int targetFd, size_t length, off_t* offset) {
+    return spliceAll(fd, nullptr, targetFd, offset, length);
+}
+
+/**
+ * @brief Queues user memory into the FIFO by reference
+ *
+ * @param data Memory to queue; must stay unchanged until it has been read
+ * @param size Number of bytes
+ * @return Bytes queued, or -1 if nothing could be queued
+ */
+ssize_t NamedPipe::vmspliceFrom(const void* data, size_t size) {
+    return vmspliceAll(fd, data, size);
+}
+
+/**
+ * @brief Duplicates buffered FIFO data into another pipe without consuming it
+ *
+ * @param pipeFd Write end of the destination pipe
+ * @param length Maximum number of bytes to duplicate
+ * @return Bytes duplicated, 0 if the FIFO is empty, or -1 on error
+ */
+ssize_t NamedPipe::teeTo(int pipeFd, size_t length) {
+    if (fd == -1) return -1;
+    return ::tee(fd, pipeFd, length, 0);
+}
+
+/**
+ * @brief Resizes the FIFO's kernel buffer
+ *
+ * @param bytes Requested capacity in bytes
+ * @return true on success
+ */
+bool NamedPipe::setCapacity(size_t bytes) {
+    return setPipeCapacity(fd, bytes);
+}
+
+/**
+ * @brief Queries the FIFO's kernel buffer size
+ *
+ * @return Capacity in bytes, or 0 if not open
+ */
+size_t NamedPipe::getCapacity() const {
+    return getPipeCapacity(fd);
+}
+
+// ===== FrameReader Implementation =====
+
+/**
+ * @brief Constructs a frame reader over a descriptor
+ *
+ * @param readFd Descriptor to read frames from; not owned
+ * @param bufferSize Initial size of the reusable buffer
+ * @param maxFrame Largest frame body accepted
+ */
+FrameReader::FrameReader(int readFd, size_t bufferSize, size_t maxFrame)
+    : fd(readFd), buffer(std::max(bufferSize, sizeof(size_t))), begin(0), end(0),
+      maxFrameSize(maxFrame), readCalls(0) {}
+
+/**
+ * @brief Makes at least needed bytes available from begin
+ *
+ * @param needed Number of contiguous bytes required
+ * @return false at end of stream or on a read error
+ *
+ * Moves the unparsed tail to the front (or grows the buffer) only when the
+ * free space behind it is too small, then reads as much as the descriptor
+ * has ready in one call per iteration.
+ */
+bool FrameReader::fill(size_t needed) {
+    while (end - begin < needed) {
+        if (buffer.size() - begin < needed) {
+            std::memmove(buffer.data(), buffer.data() + begin, end - begin);
+            end -= begin;
+            begin = 0;
+            if (buffer.size() < needed) {
+                buffer.resize(needed);
+            }
+        }
+
+        ssize_t count = ::read(fd, buffer.data() + end, buffer.size() - end);
+        if (count < 0 && errno == EINTR) continue;
+        if (count <= 0) return false;
+
+        readCalls++;
+        end += static_cast<size_t>(count);
+    }
+    return true;
+}
+
+/**
+ * @brief Returns the next frame, reading only when none is buffered
+ *
+ * @param frame Receives a view of the frame body inside the buffer
+ * @return true if a frame was read
+ */
+bool FrameReader::next(std::string_view& frame) {
+    if (begin == end) {
+        begin = end = 0;
+    }
+    TraceSpan span(TraceEventType::IPC_RECEIVE, static_cast<uint64_t>(fd), -1);
+    if (!fill(sizeof(size_t))) return false;
+
+    size_t length;
+    std::memcpy(&length, buffer.data() + begin, sizeof(length));
+    if (length > maxFrameSize) {
+        PTM_LOG_ERROR("Frame of " << length << " bytes exceeds the " << maxFrameSize << " byte limit");
+        return false;
+    }
+
+    if (!fill(sizeof(size_t) + length)) return false;
+
+    frame = std::string_view(buffer.data() + begin + sizeof(size_t), length);
+    begin += sizeof(size_t) + length;
+    span.setValue(static_cast<int64_t>(length));
+    return true;
+}
+
 // ===== SharedMemory Implementation =====
 
 /**
@@ -318,13 +872,15 @@ std::string NamedPipe::readString(size_t maxSize) {
  *
  * @param shmName Name of the shared memory object (must start with '/')
  * @param shmSize Size of the shared memory region in bytes
+ * @param mapOptions Page size, prefaulting, locking and advice for map()
  *
  * Initializes the object but does not create or map the shared memory.
  * Call create() or open(), then map() to use the shared memory.
  */
-SharedMemory::SharedMemory(const std::string& shmName, size_t shmSize)
+SharedMemory::SharedMemory(const std::string& shmName, size_t shmSize, const MapOptions& mapOptions)
     : name(shmName), fd(-1), addr(nullptr), size(shmSize),
-      isCreated(false), isMapped(false) {}
+      isCreated(false), isMapped(false), options(mapOptions), isLocked(false),
+      protection(PROT_READ | PROT_WRITE) {}
 
 /**
  * @brief Destructor that ensures complete cleanup of shared memory resources
@@ -340,6 +896,59 @@ SharedMemory::~SharedMemory() {
     }
 }
 
+/**
+ * @brief Queries the system's default huge page size
+ *
+ * @return Hugepagesize from /proc/meminfo, or 2 MiB if it cannot be read
+ */
+size_t SharedMemory::hugePageSize() {
+    static const size_t pageSize = [] {
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        size_t kilobytes = 0;
+        while (meminfo >> key) {
+            if (key == "Hugepagesize:" && meminfo >> kilobytes) {
+                return kilobytes * 1024;
+            }
+            meminfo.ignore(256, '\n');
+        }
+        return static_cast<size_t>(2 * 1024 * 1024);
+    }();
+    return pageSize;
+}
+
+/**
+ * @brief Opens the file backing the segment
+ *
+ * @param flags open() flags
+ * @param mode Permission bits used when creating
+ * @return true if fd is open; errno describes the failure otherwise
+ *
+ * HUGETLB segments live as files on the configured hugetlbfs mount and
+ * have their size rounded up to whole huge pages. If that mount cannot be
+ * used and fallback is allowed, a regular POSIX shm segment is used instead.
+ */
+bool SharedMemory::openSegment(int flags, mode_t mode) {
+    if (options.hugePages == HugePageMode::HUGETLB) {
+        std::string path = options.hugetlbfsPath + "/" + (name[0] == '/' ? name.substr(1) : name);
+        fd = ::open(path.c_str(), flags | O_CLOEXEC, mode);
+        if (fd >= 0) {
+            size_t pageSize = hugePageSize();
+            size = (size + pageSize - 1) / pageSize * pageSize;
+            hugetlbPath = path;
+            return true;
+        }
+        if (!options.fallbackToSmallPages) {
+            return false;
+        }
+        PTM_LOG_WARN("hugetlbfs segment " << path << " unavailable (" << strerror(errno)
+                     << "), using regular pages");
+    }
+
+    fd = shm_open(name.c_str(), flags, mode);
+    return fd >= 0;
+}
+
 /**
  * @brief Creates a new shared memory object
  *
@@ -351,21 +960,20 @@ SharedMemory::~SharedMemory() {
  * Cleans up file descriptor on ftruncate() failure.
  */
 bool SharedMemory::create(mode_t mode) {
-    fd = shm_open(name.c_str(), O_CREAT | O_RDWR, mode);
-    if (fd < 0) {
-        std::cerr << "Failed to create shared memory: " << strerror(errno) << std::endl;
+    if (!openSegment(O_CREAT | O_RDWR, mode)) {
+        PTM_LOG_ERROR("Failed to create shared memory: " << strerror(errno));
         return false;
     }
 
     if (ftruncate(fd, size) < 0) {
-        std::cerr << "Failed to set shared memory size: " << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Failed to set shared memory size: " << strerror(errno));
         ::close(fd);
         fd = -1;
         return false;
     }
 
     isCreated = true;
-    std::cout << "Created shared memory: " << name << " (" << size << " bytes)" << std::endl;
+    PTM_LOG_INFO("Created shared memory: " << name << " (" << size << " bytes)");
     return true;
 }
 
@@ -375,16 +983,16 @@ bool SharedMemory::create(mode_t mode) {
  * @return true if successfully opened, false otherwise
  *
  * Opens the shared memory object with read-write permissions.
- * The object must already exist (created by another process).
+ * The object must already exist (created by another process) and be
+ * constructed here with the same MapOptions.
  */
 bool SharedMemory::open() {
-    fd = shm_open(name.c_str(), O_RDWR, 0666);
-    if (fd < 0) {
-        std::cerr << "Failed to open shared memory: " << strerror(errno) << std::endl;
+    if (!openSegment(O_RDWR, 0666)) {
+        PTM_LOG_ERROR("Failed to open shared memory: " << strerror(errno));
         return false;
     }
 
-    std::cout << "Opened shared memory: " << name << std::endl;
+    PTM_LOG_INFO("Opened shared memory: " << name);
     return true;
 }
 
@@ -395,20 +1003,37 @@ bool SharedMemory::open() {
  * @return true if successfully mapped, false otherwise
  *
  * Uses mmap() to make the shared memory accessible as a regular memory region.
- * Must be called after create() or open().
+ * Must be called after create() or open(). The MapOptions given at
+ * construction are applied; if locking was requested and mlock() is
+ * refused, the mapping is undone and false is returned.
  */
 bool SharedMemory::map(int prot) {
     if (fd < 0) return false;
 
-    addr = mmap(nullptr, size, prot, MAP_SHARED, fd, 0);
+    int flags = MAP_SHARED;
+    if (usesHugetlbfs()) {
+        flags |= MAP_HUGETLB;
+    }
+    // Transparent huge pages must be advised before the pages are faulted in
+    if (options.populate && options.hugePages != HugePageMode::TRANSPARENT) {
+        flags |= MAP_POPULATE;
+    }
+
+    addr = mmap(nullptr, size, prot, flags, fd, 0);
     if (addr == MAP_FAILED) {
-        std::cerr << "Failed to map shared memory: " << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Failed to map shared memory: " << strerror(errno));
         addr = nullptr;
         return false;
     }
 
     isMapped = true;
-    std::cout << "Mapped shared memory at address: " << addr << std::endl;
+    protection = prot;
+    if (!applyOptions(options.populate && options.hugePages == HugePageMode::TRANSPARENT)) {
+        unmap();
+        return false;
+    }
+
+    PTM_LOG_INFO("Mapped shared memory at address: " << addr);
     return true;
 }
 
@@ -423,9 +1048,92 @@ void SharedMemory::unmap() {
         munmap(addr, size);
         addr = nullptr;
         isMapped = false;
+        isLocked = false;
     }
 }
 
+/**
+ * @brief Applies the advice, prefaulting and locking options to the mapping
+ *
+ * @param prefault Fault in every page now (when MAP_POPULATE was not used)
+ * @return false only if locking was requested and refused
+ *
+ * Advice that the kernel rejects is reported and otherwise ignored.
+ */
+bool SharedMemory::applyOptions(bool prefault) {
+    if (options.hugePages == HugePageMode::TRANSPARENT && madvise(addr, size, MADV_HUGEPAGE) != 0) {
+        PTM_LOG_ERROR("Failed to advise huge pages: " << strerror(errno));
+    }
+    if (options.advice != 0 && madvise(addr, size, options.advice) != 0) {
+        PTM_LOG_ERROR("Failed to apply memory advice: " << strerror(errno));
+    }
+
+    if (prefault) {
+        bool populated = false;
+#ifdef MADV_POPULATE_WRITE
+        int populate = (protection & PROT_WRITE) ? MADV_POPULATE_WRITE : MADV_POPULATE_READ;
+        populated = madvise(addr, size, populate) == 0;
+#endif
+        if (!populated) {
+            const long pageSize = sysconf(_SC_PAGESIZE);
+            volatile const char* bytes = static_cast<const char*>(addr);
+            for (size_t offset = 0; offset < size; offset += static_cast<size_t>(pageSize)) {
+                (void)bytes[offset];
+            }
+        }
+    }
+
+    if (options.lock) {
+        if (mlock(addr, size) != 0) {
+            PTM_LOG_ERROR("Failed to lock shared memory: " << strerror(errno));
+            return false;
+        }
+        isLocked = true;
+    }
+    return true;
+}
+
+/**
+ * @brief Changes the size of the segment and of this process's mapping
+ *
+ * @param newSize New size in bytes (rounded up to huge pages on hugetlbfs)
+ * @return true if the object and, when mapped, the mapping were resized
+ *
+ * The object is truncated only if its size differs, so other processes
+ * follow a resize by calling resize() with the same size, which just
+ * remaps. The mapping may move (mremap with MREMAP_MAYMOVE): re-read
+ * getAddress() and views afterwards. Shrinking while another process
+ * still maps the tail makes its accesses there fault with SIGBUS.
+ */
+bool SharedMemory::resize(size_t newSize) {
+    if (fd < 0) return false;
+
+    if (usesHugetlbfs()) {
+        size_t pageSize = hugePageSize();
+        newSize = (newSize + pageSize - 1) / pageSize * pageSize;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) != newSize) {
+        if (ftruncate(fd, static_cast<off_t>(newSize)) < 0) {
+            PTM_LOG_ERROR("Failed to resize shared memory: " << strerror(errno));
+            return false;
+        }
+    }
+
+    if (isMapped) {
+        void* moved = mremap(addr, size, newSize, MREMAP_MAYMOVE);
+        if (moved == MAP_FAILED) {
+            PTM_LOG_ERROR("Failed to remap shared memory: " << strerror(errno));
+            return false;
+        }
+        addr = moved;
+    }
+
+    size = newSize;
+    return !isMapped || applyOptions(options.populate);
+}
+
 /**
  * @brief Closes the file descriptor
  *
@@ -448,8 +1156,9 @@ void SharedMemory::close() {
  * Other processes with existing mappings can continue using them until unmapped.
  */
 bool SharedMemory::unlink() {
-    if (shm_unlink(name.c_str()) == 0) {
-        std::cout << "Unlinked shared memory: " << name << std::endl;
+    int result = usesHugetlbfs() ? ::unlink(hugetlbPath.c_str()) : shm_unlink(name.c_str());
+    if (result == 0) {
+        PTM_LOG_INFO("Unlinked shared memory: " << name);
         return true;
     }
     return false;
@@ -491,6 +1200,40 @@ bool SharedMemory::readData(void* buffer, size_t dataSize, size_t offset) {
     return true;
 }
 
+/**
+ * @brief Views the whole mapped region without copying
+ *
+ * @return Span over the mapping, empty if not mapped
+ */
+std::span<std::byte> SharedMemory::view() {
+    if (!isMapped) return {};
+    return {static_cast<std::byte*>(addr), size};
+}
+
+/**
+ * @brief Views part of the mapped region without copying
+ *
+ * @param offset Offset within the shared memory region
+ * @param length Number of bytes
+ * @return Span over the range, empty if not mapped or out of bounds
+ */
+std::span<std::byte> SharedMemory::view(size_t offset, size_t length) {
+    if (!isMapped || offset > size || length > size - offset) return {};
+    return {static_cast<std::byte*>(addr) + offset, length};
+}
+
+/**
+ * @brief Read-only view of part of the mapped region
+ *
+ * @param offset Offset within the shared memory region
+ * @param length Number of bytes
+ * @return Span over the range, empty if not mapped or out of bounds
+ */
+std::span<const std::byte> SharedMemory::view(size_t offset, size_t length) const {
+    if (!isMapped || offset > size || length > size - offset) return {};
+    return {static_cast<const std::byte*>(addr) + offset, length};
+}
+
 // ===== MessageQueue Implementation =====
 
 /**
@@ -507,7 +1250,7 @@ MessageQueue::MessageQueue(const std::string& path, int projId)
     : msgid(-1) {
     key = ftok(path.c_str(), projId);
     if (key == -1) {
-        std::cerr << "Failed to generate key: " << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Failed to generate key: " << strerror(errno));
     }
 }
 
@@ -532,11 +1275,11 @@ MessageQueue::~MessageQueue() {
 bool MessageQueue::create() {
     msgid = msgget(key, IPC_CREAT | 0666);
     if (msgid < 0) {
-        std::cerr << "Failed to create message queue: " << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Failed to create message queue: " << strerror(errno));
         return false;
     }
 
-    std::cout << "Created message queue with ID: " << msgid << std::endl;
+    PTM_LOG_INFO("Created message queue with ID: " << msgid);
     return true;
 }
 
@@ -550,7 +1293,7 @@ bool MessageQueue::create() {
 bool MessageQueue::open() {
     msgid = msgget(key, 0666);
     if (msgid < 0) {
-        std::cerr << "Failed to open message queue: " << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Failed to open message queue: " << strerror(errno));
         return false;
     }
     return true;
@@ -566,7 +1309,7 @@ bool MessageQueue::open() {
  */
 bool MessageQueue::remove() {
     if (msgctl(msgid, IPC_RMID, nullptr) == 0) {
-        std::cout << "Removed message queue" << std::endl;
+        PTM_LOG_INFO("Removed message queue");
         return true;
     }
     return false;
@@ -584,11 +1327,13 @@ bool MessageQueue::remove() {
  * Blocks by default unless IPC_NOWAIT is specified.
  */
 bool MessageQueue::send(const Message& msg, int flags) {
+    TraceSpan span(TraceEventType::IPC_SEND, static_cast<uint64_t>(msgid), static_cast<int64_t>(sizeof(msg.data)));
     if (msgsnd(msgid, &msg, sizeof(msg.data), flags) == 0) {
         return true;
     }
+    span.setValue(-1);
 
-    std::cerr << "Failed to send message: " << strerror(errno) << std::endl;
+    PTM_LOG_ERROR("Failed to send message: " << strerror(errno));
     return false;
 }
 
@@ -604,12 +1349,526 @@ bool MessageQueue::send(const Message& msg, int flags) {
  * The type parameter allows selective message retrieval.
  */
 bool MessageQueue::receive(Message& msg, long type, int flags) {
-    if (msgrcv(msgid, &msg, sizeof(msg.data), type, flags) >= 0) {
+    TraceSpan span(TraceEventType::IPC_RECEIVE, static_cast<uint64_t>(msgid), -1);
+    ssize_t received = msgrcv(msgid, &msg, sizeof(msg.data), type, flags);
+    span.setValue(received);
+    if (received >= 0) {
+        return true;
+    }
+
+    PTM_LOG_ERROR("Failed to rseceive message: " << strerror(errno));
+    return false;
+}
+
+/**
+ * @brief Sends a variable-length message
+ *
+ * @param type Message type (must be > 0)
+ * @param data Payload
+ * @param size Payload size in bytes
+ * @param flags Send flags (e.g., IPC_NOWAIT for non-blocking)
+ * @return true if sent successfully, false otherwise
+ *
+ * Unlike send(const Message&) only size bytes go through the kernel.
+ * Small payloads are framed on the stack; larger ones need one allocation.
+ */
+bool MessageQueue::send(long type, const void* data, size_t size, int flags) {
+    constexpr size_t STACK_FRAME = 512;
+    alignas(long) char stackFrame[STACK_FRAME];
+    std::vector<char> heapFrame;
+
+    char* frame = stackFrame;
+    if (sizeof(long) + size > STACK_FRAME) {
+        heapFrame.resize(sizeof(long) + size);
+        frame = heapFrame.data();
+    }
+    std::memcpy(frame, &type, sizeof(long));
+    if (size > 0) {
+        std::memcpy(frame + sizeof(long), data, size);
+    }
+
+    TraceSpan span(TraceEventType::IPC_SEND, static_cast<uint64_t>(msgid), static_cast<int64_t>(size));
+    if (msgsnd(msgid, frame, size, flags) == 0) {
+        return true;
+    }
+    span.setValue(-1);
+    if (errno != EAGAIN) {
+        PTM_LOG_ERROR("Failed to send message: " << strerror(errno));
+    }
+    return false;
+}
+
+/**
+ * @brief Receives the next message into the scratch buffer, growing it as needed
+ *
+ * @param type Set to the message type
+ * @param typeFilter Message type filter, as in receive(Message&, ...)
+ * @param flags Receive flags (e.g., IPC_NOWAIT)
+ * @return Payload size, or -1 on error (errno set; ENOMSG when IPC_NOWAIT
+ *         found nothing)
+ *
+ * A message larger than the buffer stays queued (no MSG_NOERROR), so the
+ * buffer is doubled and the call retried; no message can exceed the
+ * queue's byte limit.
+ */
+ssize_t MessageQueue::receiveRaw(long& type, long typeFilter, int flags) {
+    if (receiveBuffer.empty()) {
+        receiveBuffer.resize(sizeof(long) + 1024);
+    }
+    TraceSpan span(TraceEventType::IPC_RECEIVE, static_cast<uint64_t>(msgid), -1);
+
+    while (true) {
+        ssize_t received = msgrcv(msgid, receiveBuffer.data(), receiveBuffer.size() - sizeof(long),
+                                  typeFilter, flags & ~MSG_NOERROR);
+        if (received >= 0) {
+            std::memcpy(&type, receiveBuffer.data(), sizeof(long));
+            span.setValue(received);
+            return received;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno != E2BIG) {
+            return -1;
+        }
+
+        msqid_ds info{};
+        size_t limit = msgctl(msgid, IPC_STAT, &info) == 0 ? info.msg_qbytes : 0;
+        size_t payload = receiveBuffer.size() - sizeof(long);
+        if (payload >= limit) {
+            errno = E2BIG;
+            return -1;
+        }
+        receiveBuffer.resize(sizeof(long) + std::min(payload * 2, limit));
+    }
+}
+
+/**
+ * @brief Receives a variable-length message into a caller buffer
+ *
+ * @param buffer Destination for the payload
+ * @param capacity Size of buffer; a larger message stays queued
+ * @param type Set to the message type
+ * @param typeFilter Message type filter (0 = first message, >0 = specific type, <0 = first with type <= |type|)
+ * @param flags Receive flags (e.g., IPC_NOWAIT for non-blocking)
+ * @return Payload size, or -1 on error (E2BIG if it does not fit)
+ */
+ssize_t MessageQueue::receive(void* buffer, size_t capacity, long& type, long typeFilter, int flags) {
+    if (receiveBuffer.size() < sizeof(long) + capacity) {
+        receiveBuffer.resize(sizeof(long) + capacity);
+    }
+
+    TraceSpan span(TraceEventType::IPC_RECEIVE, static_cast<uint64_t>(msgid));
+    ssize_t received;
+    do {
+        received = msgrcv(msgid, receiveBuffer.data(), capacity, typeFilter, flags & ~MSG_NOERROR);
+    } while (received < 0 && errno == EINTR);
+    span.setValue(received);
+
+    if (received < 0) {
+        if (errno != ENOMSG) {
+            PTM_LOG_ERROR("Failed to receive message: " << strerror(errno));
+        }
+        return -1;
+    }
+    std::memcpy(&type, receiveBuffer.data(), sizeof(long));
+    std::memcpy(buffer, receiveBuffer.data() + sizeof(long), static_cast<size_t>(received));
+    return received;
+}
+
+/**
+ * @brief Receives a variable-length message of any size
+ *
+ * @param message Replaced with the payload
+ * @param type Set to the message type
+ * @param typeFilter Message type filter, as in receive(Message&, ...)
+ * @param flags Receive flags (e.g., IPC_NOWAIT for non-blocking)
+ * @return true if a message was received
+ */
+bool MessageQueue::receive(std::vector<char>& message, long& type, long typeFilter, int flags) {
+    ssize_t received = receiveRaw(type, typeFilter, flags);
+    if (received < 0) {
+        if (errno != ENOMSG) {
+            PTM_LOG_ERROR("Failed to receive message: " << strerror(errno));
+        }
+        return false;
+    }
+
+    const char* payload = receiveBuffer.data() + sizeof(long);
+    message.assign(payload, payload + received);
+    return true;
+}
+
+/**
+ * @brief Sends several variable-length messages of one type
+ *
+ * @param type Message type (must be > 0)
+ * @param messages Payloads, sent in order
+ * @param flags Send flags (e.g., IPC_NOWAIT)
+ * @return Number of messages sent; stops at the first failure
+ *
+ * SysV queues have no vectored send, so this is one msgsnd() per message;
+ * it saves the caller's loop, not syscalls.
+ */
+size_t MessageQueue::sendBatch(long type, std::span<const std::string_view> messages, int flags) {
+    size_t sent = 0;
+    for (std::string_view message : messages) {
+        if (!send(type, message.data(), message.size(), flags)) {
+            break;
+        }
+        sent++;
+    }
+    return sent;
+}
+
+/**
+ * @brief Drains up to maxMessages queued messages
+ *
+ * @param messages Received payloads are appended
+ * @param maxMessages Upper bound on messages taken
+ * @param typeFilter Message type filter, as in receive(Message&, ...)
+ * @param flags Flags for the first receive; the rest use IPC_NOWAIT
+ * @return Number of messages appended
+ */
+size_t MessageQueue::receiveBatch(std::vector<std::vector<char>>& messages, size_t maxMessages,
+                                  long typeFilter, int flags) {
+    size_t received = 0;
+    long type;
+
+    while (received < maxMessages) {
+        ssize_t size = receiveRaw(type, typeFilter, received == 0 ? flags : (flags | IPC_NOWAIT));
+        if (size < 0) {
+            if (errno != ENOMSG) {
+                PTM_LOG_ERROR("Failed to receive message: " << strerror(errno));
+            }
+            break;
+        }
+        const char* payload = receiveBuffer.data() + sizeof(long);
+        messages.emplace_back(payload, payload + size);
+        received++;
+    }
+    return received;
+}
+
+// ===== PosixMessageQueue Implementation =====
+
+/**
+ * @brief Constructs a POSIX message queue wrapper
+ *
+ * @param queueName Queue name, starting with '/'
+ * @param maxMsgs Queue depth used by create()
+ * @param maxMsgSize Largest message used by create()
+ *
+ * Does not open the queue; call create() or open().
+ */
+PosixMessageQueue::PosixMessageQueue(const std::string& queueName, long maxMsgs, long maxMsgSize)
+    : name(queueName), mq(static_cast<mqd_t>(-1)), maxMessages(maxMsgs), messageSize(maxMsgSize) {}
+
+/**
+ * @brief Destructor
+ *
+ * Closes this process's descriptor but, like MessageQueue, leaves the
+ * queue in place for other processes. Call unlink() to remove it.
+ */
+PosixMessageQueue::~PosixMessageQueue() {
+    close();
+}
+
+/**
+ * @brief Opens the queue and reads back its actual limits
+ *
+ * @param flags mq_open() flags
+ * @param nonBlocking Whether to add O_NONBLOCK
+ * @return true on success
+ */
+bool PosixMessageQueue::openQueue(int flags, bool nonBlocking) {
+    close();
+
+    if (nonBlocking) flags |= O_NONBLOCK;
+    mq_attr attr{};
+    attr.mq_maxmsg = maxMessages;
+    attr.mq_msgsize = messageSize;
+
+    mq = (flags & O_CREAT) ? mq_open(name.c_str(), flags, 0666, &attr) : mq_open(name.c_str(), flags);
+    if (mq == static_cast<mqd_t>(-1)) {
+        PTM_LOG_ERROR("Failed to open POSIX message queue " << name << ": " << strerror(errno));
+        return false;
+    }
+
+    if (mq_getattr(mq, &attr) == 0) {
+        maxMessages = attr.mq_maxmsg;
+        messageSize = attr.mq_msgsize;
+    }
+    return true;
+}
+
+/**
+ * @brief Creates the queue, or opens it if it already exists
+ *
+ * @param nonBlocking Open the descriptor with O_NONBLOCK
+ * @return true on success
+ *
+ * An existing queue keeps the limits it was created with; getMaxMessages()
+ * and getMessageSize() report the real ones afterwards.
+ */
+bool PosixMessageQueue::create(bool nonBlocking) {
+    return openQueue(O_CREAT | O_RDWR | O_CLOEXEC, nonBlocking);
+}
+
+/**
+ * @brief Opens an existing queue
+ *
+ * @param nonBlocking Open the descriptor with O_NONBLOCK
+ * @return true on success, false if the queue does not exist
+ */
+bool PosixMessageQueue::open(bool nonBlocking) {
+    return openQueue(O_RDWR | O_CLOEXEC, nonBlocking);
+}
+
+/**
+ * @brief Closes this process's descriptor
+ */
+void PosixMessageQueue::close() {
+    if (isOpen()) {
+        mq_close(mq);
+        mq = static_cast<mqd_t>(-1);
+    }
+}
+
+/**
+ * @brief Removes the queue name
+ *
+ * @return true if removed
+ *
+ * Descriptors that are still open keep working until closed.
+ */
+bool PosixMessageQueue::unlink() {
+    if (mq_unlink(name.c_str()) == 0) {
         return true;
     }
+    PTM_LOG_ERROR("Failed to unlink POSIX message queue " << name << ": " << strerror(errno));
+    return false;
+}
 
-    std::cerr << "Failed to rseceive message: " << strerror(errno) << std::endl;
+/**
+ * @brief Switches the descriptor between blocking and non-blocking mode
+ *
+ * @param enabled true for O_NONBLOCK
+ * @return true on success
+ */
+bool PosixMessageQueue::setNonBlocking(bool enabled) {
+    mq_attr attr{};
+    attr.mq_flags = enabled ? O_NONBLOCK : 0;
+    if (mq_setattr(mq, &attr, nullptr) == 0) {
+        return true;
+    }
+    PTM_LOG_ERROR("Failed to set queue flags: " << strerror(errno));
     return false;
 }
 
+/**
+ * @brief Sends a message
+ *
+ * @param data Payload
+ * @param size Payload size; at most getMessageSize()
+ * @param priority Higher priorities are received first
+ * @return true if queued
+ */
+bool PosixMessageQueue::send(const void* data, size_t size, unsigned int priority) {
+    TraceSpan span(TraceEventType::IPC_SEND, static_cast<uint64_t>(mq), static_cast<int64_t>(size));
+    while (mq_send(mq, static_cast<const char*>(data), size, priority) != 0) {
+        if (errno == EINTR) continue;
+        span.setValue(-1);
+        if (errno != EAGAIN) {
+            PTM_LOG_ERROR("Failed to send message: " << strerror(errno));
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Sends a string message
+ *
+ * @param message Payload
+ * @param priority Higher priorities are received first
+ * @return true if queued
+ */
+bool PosixMessageQueue::sendString(std::string_view message, unsigned int priority) {
+    return send(message.data(), message.size(), priority);
+}
+
+/**
+ * @brief Sends a message, waiting at most timeout for room
+ *
+ * @param data Payload
+ * @param size Payload size; at most getMessageSize()
+ * @param timeout Maximum wait while the queue is full
+ * @param priority Higher priorities are received first
+ * @return true if queued, false on timeout (errno ETIMEDOUT) or error
+ */
+bool PosixMessageQueue::timedSend(const void* data, size_t size, std::chrono::milliseconds timeout,
+                                  unsigned int priority) {
+    timespec deadline = realtimeDeadline(timeout);
+    TraceSpan span(TraceEventType::IPC_SEND, static_cast<uint64_t>(mq), static_cast<int64_t>(size));
+    while (mq_timedsend(mq, static_cast<const char*>(data), size, priority, &deadline) != 0) {
+        if (errno == EINTR) continue;
+        span.setValue(-1);
+        if (errno != ETIMEDOUT && errno != EAGAIN) {
+            PTM_LOG_ERROR("Failed to send message: " << strerror(errno));
+        }
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Receives the oldest message of the highest priority
+ *
+ * @param buffer Destination
+ * @param capacity Size of buffer; must be at least getMessageSize()
+ * @param priority Set to the message priority if non-null
+ * @return Payload size, or -1 on error
+ */
+ssize_t PosixMessageQueue::receive(void* buffer, size_t capacity, unsigned int* priority) {
+    TraceSpan span(TraceEventType::IPC_RECEIVE, static_cast<uint64_t>(mq));
+    ssize_t received;
+    do {
+        received = mq_receive(mq, static_cast<char*>(buffer), capacity, priority);
+    } while (received < 0 && errno == EINTR);
+    span.setValue(received);
+
+    if (received < 0 && errno != EAGAIN) {
+        PTM_LOG_ERROR("Failed to receive message: " << strerror(errno));
+    }
+    return received;
+}
+
+/**
+ * @brief Receives a message into a vector sized to fit
+ *
+ * @param message Replaced with the payload
+ * @param priority Set to the message priority if non-null
+ * @return true if a message was received
+ */
+bool PosixMessageQueue::receive(std::vector<char>& message, unsigned int* priority) {
+    message.resize(static_cast<size_t>(messageSize));
+    ssize_t received = receive(message.data(), message.size(), priority);
+    if (received < 0) {
+        message.clear();
+        return false;
+    }
+    message.resize(static_cast<size_t>(received));
+    return true;
+}
+
+/**
+ * @brief Receives a message, waiting at most timeout for one to arrive
+ *
+ * @param buffer Destination
+ * @param capacity Size of buffer; must be at least getMessageSize()
+ * @param timeout Maximum wait while the queue is empty
+ * @param priority Set to the message priority if non-null
+ * @return Payload size, or -1 on timeout (errno ETIMEDOUT) or error
+ */
+ssize_t PosixMessageQueue::timedReceive(void* buffer, size_t capacity, std::chrono::milliseconds timeout,
+                                        unsigned int* priority) {
+    timespec deadline = realtimeDeadline(timeout);
+    TraceSpan span(TraceEventType::IPC_RECEIVE, static_cast<uint64_t>(mq));
+    ssize_t received;
+    do {
+        received = mq_timedreceive(mq, static_cast<char*>(buffer), capacity, priority, &deadline);
+    } while (received < 0 && errno == EINTR);
+    span.setValue(received);
+
+    if (received < 0 && errno != ETIMEDOUT && errno != EAGAIN) {
+        PTM_LOG_ERROR("Failed to receive message: " << strerror(errno));
+    }
+    return received;
+}
+
+/**
+ * @brief Sends several messages with one priority
+ *
+ * @param messages Payloads, sent in order
+ * @param priority Priority of every message
+ * @return Number of messages sent; stops at the first failure
+ */
+size_t PosixMessageQueue::sendBatch(std::span<const std::string_view> messages, unsigned int priority) {
+    size_t sent = 0;
+    for (std::string_view message : messages) {
+        if (!send(message.data(), message.size(), priority)) {
+            break;
+        }
+        sent++;
+    }
+    return sent;
+}
+
+/**
+ * @brief Drains up to maxCount queued messages
+ *
+ * @param messages Received payloads are appended
+ * @param maxCount Upper bound on messages taken
+ * @return Number of messages appended
+ *
+ * The first receive blocks unless the descriptor is non-blocking; the
+ * rest use an expired deadline, so only what is already queued is taken.
+ */
+size_t PosixMessageQueue::receiveBatch(std::vector<std::vector<char>>& messages, size_t maxCount) {
+    std::vector<char> buffer(static_cast<size_t>(messageSize));
+    size_t received = 0;
+
+    while (received < maxCount) {
+        ssize_t size = received == 0
+            ? receive(buffer.data(), buffer.size())
+            : timedReceive(buffer.data(), buffer.size(), std::chrono::milliseconds::zero());
+        if (size < 0) {
+            break;
+        }
+        messages.emplace_back(buffer.data(), buffer.data() + size);
+        received++;
+    }
+    return received;
+}
+
+/**
+ * @brief Requests a signal when a message arrives on the empty queue
+ *
+ * @param signo Signal to raise in this process
+ * @return true if registered; only one process can be registered at a time
+ */
+bool PosixMessageQueue::notifyBySignal(int signo) {
+    sigevent event{};
+    event.sigev_notify = SIGEV_SIGNAL;
+    event.sigev_signo = signo;
+    if (mq_notify(mq, &event) == 0) {
+        return true;
+    }
+    PTM_LOG_ERROR("Failed to register queue notification: " << strerror(errno));
+    return false;
+}
+
+/**
+ * @brief Removes this process's notification registration
+ *
+ * @return true on success
+ */
+bool PosixMessageQueue::cancelNotify() {
+    return mq_notify(mq, nullptr) == 0;
+}
+
+/**
+ * @brief Queries how many messages are currently queued
+ *
+ * @return Message count, or -1 on error
+ */
+long PosixMessageQueue::getQueuedMessages() const {
+    mq_attr attr{};
+    if (mq_getattr(mq, &attr) != 0) {
+        return -1;
+    }
+    return attr.mq_curmsgs;
+}
+
 } // namespace PTManager
\ No newline at end of file
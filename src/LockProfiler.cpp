@@ -0,0 +1,564 @@
+#include "LockProfiler.h"
+#include "Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+
+namespace PTManager {
+
+namespace {
+
+size_t bucketOf(uint64_t ns) {
+    size_t bucket = 0;
+    while (ns > 1 && bucket + 1 < LockStats::BUCKETS) {
+        ns >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void raiseMax(std::atomic<uint64_t>& max, uint64_t value) {
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+#ifdef PTMANAGER_LOCK_PROFILING
+
+struct HeldLock {
+    LockProfiler::Record* record;
+    uint64_t acquiredNs;
+};
+
+// Owned locks the calling thread holds, in acquisition order
+thread_local std::vector<HeldLock> heldLocks;
+
+// Direct-mapped cache of order edges this thread has already reported to
+// the profiler, keyed by record serial, so repeated nested acquisitions
+// skip the profiler's lock. Dropped when reset() changes the graph epoch.
+struct KnownEdge {
+    uint64_t from;
+    uint64_t to;
+};
+constexpr size_t KNOWN_EDGES = 64;
+thread_local std::array<KnownEdge, KNOWN_EDGES> knownEdges{};
+thread_local uint64_t knownEdgesEpoch = 0;
+
+KnownEdge& knownEdgeSlot(uint64_t from, uint64_t to) {
+    return knownEdges[(from * 0x9e3779b97f4a7c15ull ^ to) % KNOWN_EDGES];
+}
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#endif
+
+} // namespace
+
+// ===== LockStats Implementation =====
+
+/**
+ * @brief Estimates a quantile from a log2 histogram
+ *
+ * @param histogram waitHistogram or holdHistogram
+ * @param q Quantile in (0, 1], e.g. 0.99
+ * @return Upper bound in nanoseconds of the bucket containing it, 0 if empty
+ */
+uint64_t LockStats::percentileNs(const std::array<uint64_t, BUCKETS>& histogram, double q) {
+    uint64_t total = 0;
+    for (uint64_t count : histogram) total += count;
+    if (total == 0) {
+        return 0;
+    }
+
+    uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(q * static_cast<double>(total) + 0.5));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += histogram[i];
+        if (seen >= target) {
+            return uint64_t{2} << i;
+        }
+    }
+    return uint64_t{2} << (BUCKETS - 1);
+}
+
+// ===== LockProfiler::Record Implementation =====
+
+LockProfiler::Record::Record(uint32_t lockId, uint64_t lockSerial, const char* lockKind,
+                             const std::string& lockName)
+    : id(lockId) {
+    assign(lockSerial, lockKind, lockName);
+}
+
+/**
+ * @brief Points the record at a newly registered lock
+ *
+ * @param lockSerial Serial of the new lock
+ * @param lockKind Primitive type
+ * @param lockName Lock name; empty or "unnamed" becomes kind#serial
+ *
+ * Counters must already be zero (fresh or cleared by clearCounters()).
+ */
+void LockProfiler::Record::assign(uint64_t lockSerial, const char* lockKind, const std::string& lockName) {
+    serial = lockSerial;
+    anonymous = lockName.empty() || lockName == "unnamed";
+    live = true;
+    kind = lockKind;
+    name = anonymous ? kind + "#" + std::to_string(lockSerial) : lockName;
+}
+
+/**
+ * @brief Counts one acquisition
+ *
+ * @param ns Time from the start of the attempt until the lock was held
+ * @param wasContended Whether the lock was not free at the first attempt
+ */
+void LockProfiler::Record::recordWait(uint64_t ns, bool wasContended) {
+    acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (wasContended) {
+        contended.fetch_add(1, std::memory_order_relaxed);
+    }
+    totalWaitNs.fetch_add(ns, std::memory_order_relaxed);
+    raiseMax(maxWaitNs, ns);
+    waitHistogram[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counts one completed hold
+ *
+ * @param ns Time from acquisition to release
+ */
+void LockProfiler::Record::recordHold(uint64_t ns) {
+    totalHoldNs.fetch_add(ns, std::memory_order_relaxed);
+    raiseMax(maxHoldNs, ns);
+    holdHistogram[bucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Zeroes every counter
+ */
+void LockProfiler::Record::clearCounters() {
+    acquisitions = 0;
+    contended = 0;
+    totalWaitNs = 0;
+    maxWaitNs = 0;
+    totalHoldNs = 0;
+    maxHoldNs = 0;
+    for (size_t i = 0; i < LockStats::BUCKETS; ++i) {
+        waitHistogram[i] = 0;
+        holdHistogram[i] = 0;
+    }
+}
+
+/**
+ * @brief Copies the counters
+ *
+ * @return Counters with the record's kind and name
+ */
+LockStats LockProfiler::Record::snapshot() const {
+    LockStats entry;
+    entry.kind = kind;
+    entry.name = name;
+    entry.acquisitions = acquisitions.load(std::memory_order_relaxed);
+    entry.contended = contended.load(std::memory_order_relaxed);
+    entry.totalWaitNs = totalWaitNs.load(std::memory_order_relaxed);
+    entry.maxWaitNs = maxWaitNs.load(std::memory_order_relaxed);
+    entry.totalHoldNs = totalHoldNs.load(std::memory_order_relaxed);
+    entry.maxHoldNs = maxHoldNs.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < LockStats::BUCKETS; ++i) {
+        entry.waitHistogram[i] = waitHistogram[i].load(std::memory_order_relaxed);
+        entry.holdHistogram[i] = holdHistogram[i].load(std::memory_order_relaxed);
+    }
+    return entry;
+}
+
+// ===== LockProfiler Implementation =====
+
+/**
+ * @brief Returns the process-wide profiler
+ *
+ * @return The profiler; never destroyed, so locks in static objects can
+ *         use it during shutdown
+ */
+LockProfiler& LockProfiler::instance() {
+    static LockProfiler* profiler = new LockProfiler();
+    return *profiler;
+}
+
+/**
+ * @brief Adds a lock to the registry
+ *
+ * @param kind Primitive type, e.g. "SafeMutex"
+ * @param name Lock name; empty or "unnamed" becomes kind#serial
+ * @return Record owned by the profiler, reusing one of a destroyed lock if
+ *         available; valid until unregisterLock()
+ */
+LockProfiler::Record* LockProfiler::registerLock(const char* kind, const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint64_t serial = nextSerial++;
+    if (!freeRecords.empty()) {
+        Record& record = records[freeRecords.back()];
+        freeRecords.pop_back();
+        record.assign(serial, kind, name);
+        return &record;
+    }
+    records.emplace_back(static_cast<uint32_t>(records.size()), serial, kind, name);
+    successors.emplace_back();
+    predecessors.emplace_back();
+    visitMarks.push_back(0);
+    return &records.back();
+}
+
+/**
+ * @brief Removes a destroyed lock from the registry
+ *
+ * @param record Record returned by registerLock()
+ *
+ * Drops the lock's edges from the order graph, adds its counters to the
+ * entry for its name (kind for unnamed locks) and queues the record for
+ * reuse. Reported cycles keep the lock's name.
+ */
+void LockProfiler::unregisterLock(Record* record) {
+    std::lock_guard<std::mutex> lock(mutex);
+    uint32_t id = record->id;
+
+    for (uint32_t next : successors[id]) {
+        std::vector<uint32_t>& back = predecessors[next];
+        back.erase(std::remove(back.begin(), back.end(), id), back.end());
+    }
+    for (uint32_t previous : predecessors[id]) {
+        std::vector<uint32_t>& forward = successors[previous];
+        forward.erase(std::remove(forward.begin(), forward.end(), id), forward.end());
+    }
+    successors[id].clear();
+    predecessors[id].clear();
+
+    LockStats stats = record->snapshot();
+    if (stats.acquisitions > 0) {
+        std::string key = record->anonymous ? record->kind : record->name;
+        auto [it, inserted] = retired.try_emplace(key);
+        LockStats& total = it->second;
+        if (inserted) {
+            total.kind = record->kind;
+            total.name = key;
+        }
+        total.acquisitions += stats.acquisitions;
+        total.contended += stats.contended;
+        total.totalWaitNs += stats.totalWaitNs;
+        total.maxWaitNs = std::max(total.maxWaitNs, stats.maxWaitNs);
+        total.totalHoldNs += stats.totalHoldNs;
+        total.maxHoldNs = std::max(total.maxHoldNs, stats.maxHoldNs);
+        for (size_t i = 0; i < LockStats::BUCKETS; ++i) {
+            total.waitHistogram[i] += stats.waitHistogram[i];
+            total.holdHistogram[i] += stats.holdHistogram[i];
+        }
+    }
+
+    record->clearCounters();
+    record->live = false;
+    freeRecords.push_back(id);
+}
+
+/**
+ * @brief Depth-first search in the lock-order graph
+ *
+ * @param from Start record id
+ * @param to Target record id
+ * @param path Receives the ids from from to to (both included) if found
+ * @return true if to is reachable from from
+ *
+ * Must be called with mutex held. Visited nodes are marked with a per-search
+ * value in visitMarks instead of clearing a fresh array on every search.
+ */
+bool LockProfiler::findPath(uint32_t from, uint32_t to, std::vector<uint32_t>& path) {
+    if (++visitMark == 0) {
+        std::fill(visitMarks.begin(), visitMarks.end(), 0);
+        visitMark = 1;
+    }
+    std::vector<std::pair<uint32_t, size_t>>& stack = searchStack;
+    stack.assign(1, {from, 0});
+    visitMarks[from] = visitMark;
+    path.assign(1, from);
+
+    while (!stack.empty()) {
+        auto& [node, next] = stack.back();
+        if (node == to) {
+            return true;
+        }
+        if (next == successors[node].size()) {
+            stack.pop_back();
+            path.pop_back();
+            continue;
+        }
+        uint32_t child = successors[node][next++];
+        if (visitMarks[child] != visitMark) {
+            visitMarks[child] = visitMark;
+            stack.emplace_back(child, 0);
+            path.push_back(child);
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Records that acquiring is taken while held are held
+ *
+ * @param acquiring Lock about to be acquired
+ * @param held Locks the calling thread holds
+ *
+ * Each new edge H -> acquiring is checked for a path acquiring -> ... -> H,
+ * which would let two threads taking the locks in the two orders deadlock.
+ * Each such cycle is reported once, when its closing edge first appears;
+ * the handler runs outside the profiler's lock.
+ */
+void LockProfiler::checkOrder(const Record* acquiring, const std::vector<const Record*>& held) {
+    std::vector<LockCycle> found;
+    CycleHandler handler;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const Record* holder : held) {
+            if (holder == acquiring) continue;
+            std::vector<uint32_t>& edges = successors[holder->id];
+            if (std::find(edges.begin(), edges.end(), acquiring->id) != edges.end()) continue;
+
+            std::vector<uint32_t> path;
+            if (findPath(acquiring->id, holder->id, path)) {
+                LockCycle cycle;
+                cycle.thread = std::this_thread::get_id();
+                cycle.locks.push_back(records[holder->id].name);
+                for (size_t i = 0; i + 1 < path.size(); ++i) {
+                    cycle.locks.push_back(records[path[i]].name);
+                }
+                cycles.push_back(cycle);
+                found.push_back(std::move(cycle));
+            }
+            edges.push_back(acquiring->id);
+            predecessors[acquiring->id].push_back(holder->id);
+        }
+        handler = cycleHandler;
+    }
+
+    for (const LockCycle& cycle : found) {
+        if (handler) {
+            handler(cycle);
+            continue;
+        }
+        std::string order;
+        for (const std::string& name : cycle.locks) {
+            order += "'" + name + "' -> ";
+        }
+        PTM_LOG_WARN("Potential deadlock: lock order cycle " << order << "'" << cycle.locks.front()
+                     << "' (closed by thread " << cycle.thread << ")");
+    }
+}
+
+/**
+ * @brief Copies every lock's counters
+ *
+ * @return One entry per live lock, then one per name (per kind for unnamed
+ *         locks) summing the locks destroyed so far
+ */
+std::vector<LockStats> LockProfiler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::vector<LockStats> stats;
+    stats.reserve(records.size() - freeRecords.size() + retired.size());
+    for (const Record& record : records) {
+        if (record.live) {
+            stats.push_back(record.snapshot());
+        }
+    }
+    for (const auto& [key, total] : retired) {
+        stats.push_back(total);
+    }
+    return stats;
+}
+
+/**
+ * @brief Lists the lock-order cycles reported so far
+ *
+ * @return Cycles in the order they were found
+ */
+std::vector<LockCycle> LockProfiler::getCycles() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cycles;
+}
+
+/**
+ * @brief Sets the function called for each newly found cycle
+ *
+ * @param handler Called on the acquiring thread; empty restores logging
+ *        the cycle as a warning
+ */
+void LockProfiler::setCycleHandler(CycleHandler handler) {
+    std::lock_guard<std::mutex> lock(mutex);
+    cycleHandler = std::move(handler);
+}
+
+/**
+ * @brief Starts a fresh measurement
+ *
+ * Locks stay registered; their counters, the totals of destroyed locks,
+ * the order graph and the reported cycles are cleared. Bumping the graph
+ * epoch makes probes forget the edges they cached.
+ */
+void LockProfiler::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (Record& record : records) {
+        record.clearCounters();
+    }
+    for (std::vector<uint32_t>& edges : successors) {
+        edges.clear();
+    }
+    for (std::vector<uint32_t>& edges : predecessors) {
+        edges.clear();
+    }
+    retired.clear();
+    cycles.clear();
+    epoch.fetch_add(1, std::memory_order_release);
+}
+
+/**
+ * @brief Prints a table of the acquired locks, most contended first
+ *
+ * @param out Stream to print to
+ */
+void LockProfiler::printReport(std::ostream& out) const {
+    std::vector<LockStats> stats = getStats();
+    stats.erase(std::remove_if(stats.begin(), stats.end(),
+                               [](const LockStats& entry) { return entry.acquisitions == 0; }),
+                stats.end());
+    std::sort(stats.begin(), stats.end(), [](const LockStats& a, const LockStats& b) {
+        return a.totalWaitNs > b.totalWaitNs;
+    });
+
+    out << "\n=== Lock Profile ===" << std::endl;
+    if (!enabled) {
+        out << "Lock profiling is disabled (build with PTMANAGER_LOCK_PROFILING)" << std::endl;
+        return;
+    }
+    out << std::left << std::setw(24) << "Lock" << std::right
+        << std::setw(12) << "Acquired" << std::setw(12) << "Contended"
+        << std::setw(14) << "Wait p99 ns" << std::setw(14) << "Wait max ns"
+        << std::setw(14) << "Hold p99 ns" << std::setw(14) << "Hold max ns" << std::endl;
+    for (const LockStats& entry : stats) {
+        out << std::left << std::setw(24) << entry.name << std::right
+            << std::setw(12) << entry.acquisitions << std::setw(12) << entry.contended
+            << std::setw(14) << LockStats::percentileNs(entry.waitHistogram, 0.99)
+            << std::setw(14) << entry.maxWaitNs
+            << std::setw(14) << LockStats::percentileNs(entry.holdHistogram, 0.99)
+            << std::setw(14) << entry.maxHoldNs << std::endl;
+    }
+
+    std::vector<LockCycle> found = getCycles();
+    out << "Lock order cycles: " << found.size() << std::endl;
+    for (const LockCycle& cycle : found) {
+        out << "  ";
+        for (const std::string& name : cycle.locks) {
+            out << name << " -> ";
+        }
+        out << cycle.locks.front() << std::endl;
+    }
+}
+
+#ifdef PTMANAGER_LOCK_PROFILING
+
+// ===== LockProbe Implementation =====
+
+/**
+ * @brief Registers a lock with the profiler
+ *
+ * @param kind Primitive type
+ * @param name Lock name for reports
+ * @param ownedLock false for locks released by other threads than the
+ *        acquirer (semaphores): no hold times, no lock-order tracking
+ */
+LockProbe::LockProbe(const char* kind, const std::string& name, bool ownedLock)
+    : record(LockProfiler::instance().registerLock(kind, name)), owned(ownedLock) {}
+
+/**
+ * @brief Unregisters the lock, folding its counters into its name's total
+ */
+LockProbe::~LockProbe() {
+    LockProfiler::instance().unregisterLock(record);
+}
+
+/**
+ * @brief Marks the start of an acquisition attempt
+ *
+ * @param blocking false for try-locks, which cannot deadlock and so are not
+ *        checked against the lock order
+ * @return Start time to pass to afterAcquire()
+ *
+ * The profiler is only consulted when some held -> this edge is missing
+ * from the thread's cache of known edges.
+ */
+uint64_t LockProbe::beforeAcquire(bool blocking) {
+    if (blocking && owned && !heldLocks.empty()) {
+        LockProfiler& profiler = LockProfiler::instance();
+        uint64_t epoch = profiler.graphEpoch();
+        if (knownEdgesEpoch != epoch) {
+            knownEdges.fill(KnownEdge{0, 0});
+            knownEdgesEpoch = epoch;
+        }
+
+        bool known = true;
+        for (const HeldLock& entry : heldLocks) {
+            const KnownEdge& edge = knownEdgeSlot(entry.record->serial, record->serial);
+            if (entry.record != record && (edge.from != entry.record->serial || edge.to != record->serial)) {
+                known = false;
+                break;
+            }
+        }
+
+        if (!known) {
+            std::vector<const LockProfiler::Record*> held;
+            held.reserve(heldLocks.size());
+            for (const HeldLock& entry : heldLocks) {
+                held.push_back(entry.record);
+            }
+            profiler.checkOrder(record, held);
+            for (const HeldLock& entry : heldLocks) {
+                knownEdgeSlot(entry.record->serial, record->serial) = KnownEdge{entry.record->serial, record->serial};
+            }
+        }
+    }
+    return nowNs();
+}
+
+/**
+ * @brief Records a successful acquisition
+ *
+ * @param start Value returned by beforeAcquire()
+ * @param contended Whether the lock was busy at the first attempt
+ */
+void LockProbe::afterAcquire(uint64_t start, bool contended) {
+    uint64_t now = nowNs();
+    record->recordWait(now - start, contended);
+    if (owned) {
+        heldLocks.push_back(HeldLock{record, now});
+    }
+}
+
+/**
+ * @brief Records a release by the calling thread
+ *
+ * Releases by a thread that does not hold the lock are ignored.
+ */
+void LockProbe::beforeRelease() {
+    if (!owned) {
+        return;
+    }
+    for (auto it = heldLocks.rbegin(); it != heldLocks.rend(); ++it) {
+        if (it->record == record) {
+            record->recordHold(nowNs() - it->acquiredNs);
+            heldLocks.erase(std::next(it).base());
+            return;
+        }
+    }
+}
+
+#endif
+
+} // namespace PTManager
@@ -0,0 +1,507 @@
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace PTManager {
+
+namespace {
+
+uint64_t realtimeNs() {
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint32_t& localThreadIndex() {
+    static thread_local uint32_t index = UINT32_MAX;
+    return index;
+}
+
+// Writes all of data, retrying on EINTR and short writes
+void writeFully(int fd, const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n = ::write(fd, data, length);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+}
+
+constexpr auto DRAIN_INTERVAL = std::chrono::milliseconds(10);
+
+} // namespace
+
+/**
+ * @brief Names a log level
+ *
+ * @param level Level to name
+ * @return Upper-case name, e.g. "WARN"
+ */
+const char* logLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARN: return "WARN";
+        case LogLevel::ERROR: return "ERROR";
+        case LogLevel::OFF: return "OFF";
+    }
+    return "UNKNOWN";
+}
+
+// ===== Sink Implementations =====
+
+/**
+ * @brief Writes one line to stdout or stderr
+ *
+ * @param record Line to write; WARN and above go to stderr
+ *
+ * The line is assembled on the stack and written with a single write(2),
+ * so lines from concurrent processes do not interleave mid-line.
+ */
+void ConsoleSink::write(const LogRecord& record) {
+    char line[Logger::MAX_MESSAGE + 96];
+    size_t length = 0;
+    if (prefixed) {
+        int n = std::snprintf(line, sizeof(line), "[%llu.%06llu] %-5s %d/%u ",
+                              static_cast<unsigned long long>(record.timeNs / 1000000000ull),
+                              static_cast<unsigned long long>(record.timeNs % 1000000000ull / 1000),
+                              logLevelName(record.level), static_cast<int>(record.pid), record.thread);
+        length = n > 0 ? std::min(static_cast<size_t>(n), sizeof(line) - 1) : 0;
+    }
+    size_t text = std::min(record.message.size(), sizeof(line) - 1 - length);
+    std::memcpy(line + length, record.message.data(), text);
+    length += text;
+    line[length++] = '\n';
+    writeFully(record.level >= LogLevel::WARN ? STDERR_FILENO : STDOUT_FILENO, line, length);
+}
+
+/**
+ * @brief Appends one line to the stream, without flushing
+ *
+ * @param record Line to write
+ */
+void StreamSink::write(const LogRecord& record) {
+    out << record.message << '\n';
+}
+
+/**
+ * @brief Flushes the stream
+ */
+void StreamSink::flush() {
+    out.flush();
+}
+
+// ===== Logger Implementation =====
+
+/**
+ * @brief Creates the logger with a ConsoleSink at INFO and starts the drainer
+ *
+ * If the drainer thread cannot be started, lines are written synchronously.
+ * The drain buffers are sized for one full ring up front so that the first
+ * lines logged do not allocate.
+ */
+Logger::Logger()
+    : level(LogLevel::INFO), async(true), dropped(0), nextThread(0), pid(getpid()), forked(false),
+      reportedDrops(0), sink(std::make_shared<ConsoleSink>()), stopping(false) {
+    batch.reserve(RING_CAPACITY);
+    order.reserve(RING_CAPACITY);
+    try {
+        drainer = std::thread([this] { drainLoop(); });
+    } catch (const std::system_error&) {
+        async = false;
+    }
+    pthread_atfork(&Logger::beforeFork, &Logger::afterForkParent, &Logger::afterForkChild);
+    std::atexit(&Logger::atExit);
+}
+
+/**
+ * @brief Returns the process-wide logger, creating it on first use
+ *
+ * @return The logger; never destroyed, so it can be used from static
+ *         destructors
+ */
+Logger& Logger::instance() {
+    static Logger* logger = new Logger();
+    return *logger;
+}
+
+/**
+ * @brief Marks a thread's ring for removal once it has been drained
+ */
+Logger::RingHandle::~RingHandle() {
+    if (ring) {
+        ring->retired.store(true, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Returns the calling thread's ring, registering it on first use
+ *
+ * @return The ring; only this thread pushes to it
+ */
+Logger::ThreadRing* Logger::localRing() {
+    static thread_local RingHandle handle;
+    if (!handle.ring) {
+        auto ring = std::make_shared<ThreadRing>();
+        ring->thread = threadIndex();
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        rings.push_back(ring);
+        handle.ring = std::move(ring);
+    }
+    return handle.ring.get();
+}
+
+/**
+ * @brief Returns the calling thread's index, assigning one on first use
+ *
+ * @return Small integer identifying the thread in LogRecord::thread
+ */
+uint32_t Logger::threadIndex() {
+    uint32_t& index = localThreadIndex();
+    if (index == UINT32_MAX) {
+        index = nextThread.fetch_add(1, std::memory_order_relaxed);
+    }
+    return index;
+}
+
+/**
+ * @brief Checks whether lines bypass the rings
+ *
+ * @return true if async logging is off, exit has begun or this is a
+ *         forked child without a drainer
+ */
+bool Logger::writesSynchronously() const {
+    return !async.load(std::memory_order_relaxed) || stopping.load(std::memory_order_relaxed) ||
+           forked.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Hands one line straight to the sink
+ *
+ * @param lineLevel Level of the line
+ * @param timeNs When it was logged
+ * @param thread Index of the logging thread
+ * @param text Message
+ */
+void Logger::writeNow(LogLevel lineLevel, uint64_t timeNs, uint32_t thread, std::string_view text) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    sink->write(LogRecord{lineLevel, timeNs, pid, thread, text});
+}
+
+/**
+ * @brief Logs one formatted line
+ *
+ * @param lineLevel Level of the line; ignored below the current level
+ * @param text Message without a trailing newline; truncated to MAX_MESSAGE
+ *
+ * Normally a wait-free push onto the calling thread's ring. The drainer is
+ * woken when the ring is half full and for errors; otherwise it picks the
+ * line up within DRAIN_INTERVAL.
+ */
+void Logger::submit(LogLevel lineLevel, std::string_view text) {
+    if (!enabled(lineLevel)) {
+        return;
+    }
+    uint64_t now = realtimeNs();
+    text = text.substr(0, MAX_MESSAGE);
+    if (writesSynchronously()) {
+        writeNow(lineLevel, now, threadIndex(), text);
+        return;
+    }
+
+    ThreadRing* ring = localRing();
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t used = head - ring->tail.load(std::memory_order_acquire);
+    if (used >= RING_CAPACITY) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        wakeCondition.notify_one();
+        return;
+    }
+
+    Entry& entry = ring->entries[head & (RING_CAPACITY - 1)];
+    entry.timeNs = now;
+    entry.level = lineLevel;
+    entry.length = static_cast<uint16_t>(text.size());
+    std::memcpy(entry.text, text.data(), text.size());
+    ring->head.store(head + 1, std::memory_order_release);
+
+    if (used + 1 == RING_CAPACITY / 2 || lineLevel >= LogLevel::ERROR) {
+        wakeCondition.notify_one();
+    }
+}
+
+/**
+ * @brief Moves every buffered line to the sink, oldest first
+ *
+ * @return Number of lines written
+ *
+ * Lines from different threads are merged by timestamp; lines from one
+ * thread keep their order. Rings of exited threads are dropped once
+ * drained. The batch buffers are reused, so steady-state draining does
+ * not allocate.
+ */
+size_t Logger::drain() {
+    std::lock_guard<std::mutex> drainLock(drainMutex);
+
+    batch.clear();
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (auto it = rings.begin(); it != rings.end();) {
+            ThreadRing& ring = **it;
+            bool retired = ring.retired.load(std::memory_order_acquire);
+            uint64_t tail = ring.tail.load(std::memory_order_relaxed);
+            uint64_t head = ring.head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail) {
+                batch.push_back(PendingLine{ring.entries[tail & (RING_CAPACITY - 1)], ring.thread});
+            }
+            ring.tail.store(tail, std::memory_order_release);
+            it = retired ? rings.erase(it) : it + 1;
+        }
+    }
+
+    // Sort indices rather than the entries; the index breaks ties so each
+    // thread's lines keep their order
+    order.clear();
+    for (size_t i = 0; i < batch.size(); ++i) {
+        order.emplace_back(batch[i].entry.timeNs, static_cast<uint32_t>(i));
+    }
+    std::sort(order.begin(), order.end());
+
+    uint64_t drops = dropped.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    for (const auto& [timeNs, index] : order) {
+        const PendingLine& line = batch[index];
+        sink->write(LogRecord{line.entry.level, timeNs, pid, line.thread,
+                              std::string_view(line.entry.text, line.entry.length)});
+    }
+    if (drops != reportedDrops) {
+        std::string note = "Logger dropped " + std::to_string(drops - reportedDrops) +
+                           " lines: per-thread buffer full";
+        sink->write(LogRecord{LogLevel::WARN, realtimeNs(), pid, threadIndex(), note});
+        reportedDrops = drops;
+    }
+    return batch.size();
+}
+
+/**
+ * @brief Body of the drainer thread
+ */
+void Logger::drainLoop() {
+    while (!stopping.load(std::memory_order_relaxed)) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait_for(lock, DRAIN_INTERVAL);
+        }
+        drain();
+    }
+}
+
+/**
+ * @brief Recomputes the threshold enabled() checks
+ *
+ * Must be called with sinkMutex held.
+ */
+void Logger::updateThreshold() {
+    LogLevel effective = sink->discards() ? LogLevel::OFF : level.load(std::memory_order_relaxed);
+    threshold.store(static_cast<uint8_t>(effective), std::memory_order_relaxed);
+}
+
+/**
+ * @brief Sets the minimum level that is logged
+ *
+ * @param minimum Lowest level written; OFF disables logging
+ */
+void Logger::setLevel(LogLevel minimum) {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    level.store(minimum, std::memory_order_relaxed);
+    updateThreshold();
+}
+
+/**
+ * @brief Replaces the sink
+ *
+ * @param newSink Destination for all later lines; nullptr installs a
+ *        NullSink
+ */
+void Logger::setSink(std::shared_ptr<LogSink> newSink) {
+    if (!newSink) {
+        newSink = std::make_shared<NullSink>();
+    }
+    drain();
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    sink->flush();
+    sink = std::move(newSink);
+    updateThreshold();
+}
+
+/**
+ * @brief Returns the current sink
+ *
+ * @return Shared pointer to the sink in use
+ */
+std::shared_ptr<LogSink> Logger::getSink() {
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    return sink;
+}
+
+/**
+ * @brief Switches between buffered and synchronous logging
+ *
+ * @param enable false writes each line before the log statement returns;
+ *        lines already buffered are written first. Has no effect on
+ *        enabling in a forked child or if the drainer never started.
+ */
+void Logger::setAsync(bool enable) {
+    if (!enable) {
+        async.store(false, std::memory_order_relaxed);
+        drain();
+        return;
+    }
+    if (drainer.joinable() && !forked.load(std::memory_order_relaxed)) {
+        async.store(true, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Writes every buffered line and flushes the sink
+ */
+void Logger::flush() {
+    drain();
+    std::lock_guard<std::mutex> lock(sinkMutex);
+    sink->flush();
+}
+
+/**
+ * @brief pthread_atfork prepare handler: holds the logger's locks across fork
+ *
+ * The child then inherits them unlocked rather than held by a thread that
+ * does not exist there.
+ */
+void Logger::beforeFork() {
+    Logger& logger = instance();
+    logger.drainMutex.lock();
+    logger.ringsMutex.lock();
+    logger.sinkMutex.lock();
+}
+
+/**
+ * @brief pthread_atfork parent handler: releases the locks taken for fork
+ */
+void Logger::afterForkParent() {
+    Logger& logger = instance();
+    logger.sinkMutex.unlock();
+    logger.ringsMutex.unlock();
+    logger.drainMutex.unlock();
+}
+
+/**
+ * @brief pthread_atfork child handler: switches the child to synchronous writes
+ *
+ * Lines the parent had buffered are forgotten; the parent still writes
+ * them.
+ */
+void Logger::afterForkChild() {
+    Logger& logger = instance();
+    logger.forked.store(true, std::memory_order_relaxed);
+    logger.pid = getpid();
+    logger.rings.clear();
+    logger.sinkMutex.unlock();
+    logger.ringsMutex.unlock();
+    logger.drainMutex.unlock();
+}
+
+/**
+ * @brief atexit handler: stops the drainer, then writes what is buffered
+ *
+ * Lines logged by later static destructors are written directly.
+ */
+void Logger::atExit() {
+    Logger& logger = instance();
+    logger.stopping.store(true, std::memory_order_relaxed);
+    if (!logger.forked.load(std::memory_order_relaxed) && logger.drainer.joinable()) {
+        logger.wakeCondition.notify_one();
+        logger.drainer.join();
+    }
+    logger.flush();
+}
+
+// ===== LogLine Implementation =====
+
+/**
+ * @brief Drops characters past MAX_MESSAGE, remembering that it did
+ *
+ * @param ch Character that did not fit
+ * @return A non-eof value, so the stream stays good
+ */
+LogLine::Buffer::int_type LogLine::Buffer::overflow(int_type ch) {
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        truncated = true;
+    }
+    return traits_type::not_eof(ch);
+}
+
+/**
+ * @brief Returns the formatted text, ending in "..." if it was truncated
+ *
+ * @return View into the buffer
+ */
+std::string_view LogLine::Buffer::view() {
+    if (truncated) {
+        std::memcpy(epptr() - 3, "...", 3);
+    }
+    return std::string_view(pbase(), static_cast<size_t>(pptr() - pbase()));
+}
+
+/**
+ * @brief Returns the calling thread's formatter
+ *
+ * @return Formatter reused by every line of this thread, so the stream is
+ *         constructed once per thread rather than once per line
+ */
+LogLine::Formatter& LogLine::local() {
+    static thread_local Formatter formatter;
+    return formatter;
+}
+
+/**
+ * @brief Starts a line
+ *
+ * @param level Level the line is submitted at
+ */
+LogLine::LogLine(LogLevel level) : lineLevel(level), formatter(&local()) {
+    if (formatter->busy) {
+        nested = std::make_unique<Formatter>();
+        formatter = nested.get();
+    }
+    formatter->busy = true;
+    formatter->buffer.reset();
+    formatter->stream.clear();
+    formatter->stream.flags(std::ios_base::skipws | std::ios_base::dec);
+    formatter->stream.precision(6);
+    formatter->stream.fill(' ');
+}
+
+/**
+ * @brief Submits the line
+ */
+LogLine::~LogLine() {
+    try {
+        Logger::instance().submit(lineLevel, formatter->buffer.view());
+    } catch (...) {
+        // Logging must never throw out of the statement that logs
+    }
+    formatter->busy = false;
+}
+
+} // namespace PTManager
@@ -0,0 +1,188 @@
+#include "MemoryPool.h"
+#include <mutex>
+
+namespace PTManager {
+namespace detail {
+
+namespace {
+
+constexpr size_t MIN_BLOCK_SIZE = 32;
+constexpr size_t NUM_CLASSES = 5;     // 32, 64, 128, 256, 512 bytes
+constexpr size_t BATCH_SIZE = 32;     // Blocks moved between cache and depot at once
+
+static_assert((MIN_BLOCK_SIZE << (NUM_CLASSES - 1)) == MAX_POOLED_SIZE,
+              "size classes must cover MAX_POOLED_SIZE");
+
+struct FreeBlock {
+    FreeBlock* next;
+    FreeBlock* nextBatch;   // Only meaningful on the first block of a depot batch
+};
+
+size_t classIndex(size_t bytes) {
+    size_t index = 0;
+    size_t blockSize = MIN_BLOCK_SIZE;
+    while (blockSize < bytes) {
+        blockSize <<= 1;
+        ++index;
+    }
+    return index;
+}
+
+size_t classSize(size_t index) {
+    return MIN_BLOCK_SIZE << index;
+}
+
+// Shared pool of block batches. Intentionally never destroyed so that blocks
+// released during static destruction or thread exit always have a home.
+struct Depot {
+    std::mutex mutex;
+    FreeBlock* batches[NUM_CLASSES] = {};
+};
+
+Depot& depot() {
+    static Depot* instance = new Depot();
+    return *instance;
+}
+
+void pushBatch(size_t index, FreeBlock* head) {
+    Depot& d = depot();
+    std::lock_guard<std::mutex> lock(d.mutex);
+    head->nextBatch = d.batches[index];
+    d.batches[index] = head;
+}
+
+FreeBlock* popBatch(size_t index) {
+    Depot& d = depot();
+    {
+        std::lock_guard<std::mutex> lock(d.mutex);
+        FreeBlock* head = d.batches[index];
+        if (head != nullptr) {
+            d.batches[index] = head->nextBatch;
+            return head;
+        }
+    }
+
+    // Depot is empty: carve a fresh chunk into a batch
+    size_t blockSize = classSize(index);
+    char* chunk = static_cast<char*>(::operator new(blockSize * BATCH_SIZE));
+    FreeBlock* head = nullptr;
+    for (size_t i = BATCH_SIZE; i-- > 0;) {
+        auto* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+        block->next = head;
+        head = block;
+    }
+    return head;
+}
+
+struct ThreadCache {
+    FreeBlock* lists[NUM_CLASSES] = {};
+    size_t counts[NUM_CLASSES] = {};
+
+    ~ThreadCache();
+};
+
+// Set once the cache of an exiting thread has been flushed; later releases
+// on that thread go straight to the depot
+thread_local bool cacheFlushed = false;
+thread_local ThreadCache cache;
+
+ThreadCache::~ThreadCache() {
+    for (size_t i = 0; i < NUM_CLASSES; ++i) {
+        if (lists[i] != nullptr) {
+            pushBatch(i, lists[i]);
+            lists[i] = nullptr;
+            counts[i] = 0;
+        }
+    }
+    cacheFlushed = true;
+}
+
+} // namespace
+
+/**
+ * @brief Allocates a block from the calling thread's cache
+ *
+ * @param bytes Requested size in bytes
+ * @return Pointer to storage aligned to alignof(std::max_align_t)
+ *
+ * Requests above MAX_POOLED_SIZE go to ::operator new. Otherwise a block of
+ * the matching size class is popped from the thread-local list, refilling it
+ * with one batch from the depot (or a new chunk) when empty.
+ */
+void* poolAllocate(size_t bytes) {
+    if (bytes > MAX_POOLED_SIZE) {
+        return ::operator new(bytes);
+    }
+
+    size_t index = classIndex(bytes);
+
+    if (cacheFlushed) {
+        FreeBlock* batch = popBatch(index);
+        FreeBlock* rest = batch->next;
+        if (rest != nullptr) {
+            pushBatch(index, rest);
+        }
+        return batch;
+    }
+
+    if (cache.lists[index] == nullptr) {
+        FreeBlock* batch = popBatch(index);
+        size_t count = 0;
+        for (FreeBlock* b = batch; b != nullptr; b = b->next) {
+            ++count;
+        }
+        cache.lists[index] = batch;
+        cache.counts[index] = count;
+    }
+
+    FreeBlock* block = cache.lists[index];
+    cache.lists[index] = block->next;
+    cache.counts[index]--;
+    return block;
+}
+
+/**
+ * @brief Returns a block obtained from poolAllocate()
+ *
+ * @param ptr Block to release (nullptr is ignored)
+ * @param bytes Size originally requested for the block
+ *
+ * Blocks may be released on any thread. When the local list grows past two
+ * batches, one batch is handed back to the depot for other threads to reuse.
+ */
+void poolDeallocate(void* ptr, size_t bytes) noexcept {
+    if (ptr == nullptr) return;
+
+    if (bytes > MAX_POOLED_SIZE) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    size_t index = classIndex(bytes);
+    auto* block = static_cast<FreeBlock*>(ptr);
+
+    if (cacheFlushed) {
+        block->next = nullptr;
+        pushBatch(index, block);
+        return;
+    }
+
+    block->next = cache.lists[index];
+    cache.lists[index] = block;
+
+    if (++cache.counts[index] >= 2 * BATCH_SIZE) {
+        // Detach the first BATCH_SIZE blocks and give them back
+        FreeBlock* head = cache.lists[index];
+        FreeBlock* tail = head;
+        for (size_t i = 1; i < BATCH_SIZE; ++i) {
+            tail = tail->next;
+        }
+        cache.lists[index] = tail->next;
+        cache.counts[index] -= BATCH_SIZE;
+        tail->next = nullptr;
+        pushBatch(index, head);
+    }
+}
+
+} // namespace detail
+} // namespace PTManager
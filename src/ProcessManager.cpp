@@ -1,13 +1,549 @@
 #include "ProcessManager.h"
+#include "EventLoop.h"
+#include "Logger.h"
+#include "Tracer.h"
 #include <unistd.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <spawn.h>
+#include <sys/mman.h>
 #include <sys/wait.h>
 #include <signal.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
 #include <iostream>
 #include <cstring>
+#include <fstream>
+#include <thread>
+#include <sys/stat.h>
 
+extern char** environ;
 
 namespace PTManager {
 
+namespace {
+
+constexpr size_t CLONE_STACK_SIZE = 64 * 1024;
+constexpr long CPU_MAX_PERIOD_USEC = 100000;
+
+// ResourceLimits turned into what the child applies with plain syscalls:
+// the CPU mask is built and the cgroup created and opened beforehand.
+struct ChildLimits {
+    const ResourceLimits* limits = nullptr;
+    cpu_set_t cpus;
+    bool pinned = false;
+    std::string cgroupPath;
+    int cgroupProcs = -1;          // cgroup.procs of the child's group
+};
+
+std::atomic<unsigned> cgroupCounter{0};
+
+/**
+ * @brief Writes a value to a cgroup interface file
+ *
+ * @param path Group directory
+ * @param file Interface file name, e.g. "memory.max"
+ * @param value Text to write
+ * @return 0 or an errno value
+ */
+int writeCgroupFile(const std::string& path, const char* file, const std::string& value) {
+    std::string target = path + "/" + file;
+    int fd = open(target.c_str(), O_WRONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return errno;
+    }
+    int err = write(fd, value.data(), value.size()) == static_cast<ssize_t>(value.size()) ? 0 : errno;
+    close(fd);
+    return err;
+}
+
+/**
+ * @brief Prepares limits for a child about to be created
+ *
+ * @param limits Requested limits
+ * @param prepared Filled in; release with releaseLimits()
+ * @return 0 or an errno value
+ *
+ * Creates the child's cgroup and writes its limits, so the child only has
+ * to move itself into it.
+ */
+int prepareLimits(const ResourceLimits& limits, ChildLimits& prepared) {
+    prepared.limits = &limits;
+
+    if (!limits.cpuAffinity.empty()) {
+        CPU_ZERO(&prepared.cpus);
+        for (int cpu : limits.cpuAffinity) {
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                return EINVAL;
+            }
+            CPU_SET(cpu, &prepared.cpus);
+        }
+        prepared.pinned = true;
+    }
+
+    if (limits.cgroupParent.empty()) {
+        return 0;
+    }
+    std::string path = limits.cgroupParent + "/ptm-" + std::to_string(getpid()) + "-" +
+                       std::to_string(cgroupCounter++);
+    if (mkdir(path.c_str(), 0755) == -1) {
+        return errno;
+    }
+    prepared.cgroupPath = path;
+
+    int err = 0;
+    if (err == 0 && limits.cpuQuota > 0) {
+        long quota = std::max(1000L, static_cast<long>(limits.cpuQuota * CPU_MAX_PERIOD_USEC));
+        err = writeCgroupFile(path, "cpu.max", std::to_string(quota) + " " + std::to_string(CPU_MAX_PERIOD_USEC));
+    }
+    if (err == 0 && limits.memoryMax > 0) {
+        err = writeCgroupFile(path, "memory.max", std::to_string(limits.memoryMax));
+    }
+    if (err == 0 && limits.memoryHigh > 0) {
+        err = writeCgroupFile(path, "memory.high", std::to_string(limits.memoryHigh));
+    }
+    if (err == 0 && limits.ioWeight > 0) {
+        err = writeCgroupFile(path, "io.weight", "default " + std::to_string(limits.ioWeight));
+    }
+    if (err == 0) {
+        prepared.cgroupProcs = open((path + "/cgroup.procs").c_str(), O_WRONLY | O_CLOEXEC);
+        if (prepared.cgroupProcs == -1) err = errno;
+    }
+    return err;
+}
+
+/**
+ * @brief Applies prepared limits to the calling (child) process
+ *
+ * @param prepared Result of prepareLimits()
+ * @return 0 or an errno value
+ *
+ * Async-signal-safe and allocation-free, so it can run after vfork().
+ */
+int applyLimits(const ChildLimits& prepared) {
+    if (prepared.limits == nullptr) {
+        return 0;
+    }
+    if (prepared.cgroupProcs != -1 && write(prepared.cgroupProcs, "0", 1) != 1) {
+        return errno;
+    }
+    for (const RLimit& limit : prepared.limits->rlimits) {
+        struct rlimit value{limit.soft, limit.hard};
+        if (setrlimit(limit.resource, &value) == -1) {
+            return errno;
+        }
+    }
+    if (prepared.pinned && sched_setaffinity(0, sizeof(prepared.cpus), &prepared.cpus) == -1) {
+        return errno;
+    }
+    return 0;
+}
+
+/**
+ * @brief Drops the parent's handles on prepared limits
+ *
+ * @param prepared Result of prepareLimits()
+ * @param started Whether a child now runs in the cgroup; if not, the
+ *        cgroup is removed again
+ */
+void releaseLimits(ChildLimits& prepared, bool started) {
+    if (prepared.cgroupProcs != -1) {
+        close(prepared.cgroupProcs);
+        prepared.cgroupProcs = -1;
+    }
+    if (!started && !prepared.cgroupPath.empty()) {
+        rmdir(prepared.cgroupPath.c_str());
+        prepared.cgroupPath.clear();
+    }
+}
+
+/**
+ * @brief Reads a "key value" line from a flat-keyed cgroup file
+ *
+ * @param file Path of cpu.stat, memory.events, ...
+ * @param key Key to look up
+ * @return The value, or -1 if the file or key is missing
+ */
+int64_t readCgroupKey(const std::string& file, const std::string& key) {
+    std::ifstream in(file);
+    std::string name;
+    int64_t value;
+    while (in >> name >> value) {
+        if (name == key) {
+            return value;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Converts the kernel's rusage to a ResourceUsage
+ *
+ * @param usage rusage of a reaped child
+ * @return The same figures, times as microseconds
+ */
+ResourceUsage usageOf(const struct rusage& usage) {
+    ResourceUsage result;
+    result.userTime = std::chrono::seconds(usage.ru_utime.tv_sec) + std::chrono::microseconds(usage.ru_utime.tv_usec);
+    result.systemTime = std::chrono::seconds(usage.ru_stime.tv_sec) + std::chrono::microseconds(usage.ru_stime.tv_usec);
+    result.maxRssKb = usage.ru_maxrss;
+    result.minorFaults = usage.ru_minflt;
+    result.majorFaults = usage.ru_majflt;
+    result.voluntaryContextSwitches = usage.ru_nvcsw;
+    result.involuntaryContextSwitches = usage.ru_nivcsw;
+    return result;
+}
+
+// Everything an exec-style child needs, built before the child exists:
+// after vfork() or clone(CLONE_VM) it shares our memory and must not
+// allocate, so it only makes syscalls on these prepared arrays.
+struct ExecPlan {
+    std::string path;
+    std::vector<std::string> argStorage;
+    std::vector<char*> argv;
+    std::vector<char*> envp;
+    char** env = nullptr;
+    const SpawnOptions* options = nullptr;
+    ChildLimits limits;
+    sigset_t parentMask;
+    volatile int childErrno = 0;   // Set by a shared-memory child whose exec failed
+    int errorPipe = -1;            // FORK: write end of the CLOEXEC error pipe
+};
+
+/**
+ * @brief Resolves a program name through PATH the way execvp() would
+ *
+ * @param program Name or path of the program
+ * @return Path of an executable file, or empty if none was found
+ */
+std::string resolveProgram(const std::string& program) {
+    if (program.find('/') != std::string::npos) {
+        return program;
+    }
+
+    const char* pathEnv = getenv("PATH");
+    std::string searchPath = pathEnv != nullptr ? pathEnv : "/usr/local/bin:/usr/bin:/bin";
+    size_t start = 0;
+    while (start <= searchPath.size()) {
+        size_t end = searchPath.find(':', start);
+        if (end == std::string::npos) end = searchPath.size();
+
+        std::string dir = searchPath.substr(start, end - start);
+        std::string candidate = (dir.empty() ? "." : dir) + "/" + program;
+        if (access(candidate.c_str(), X_OK) == 0) {
+            return candidate;
+        }
+        start = end + 1;
+    }
+    return {};
+}
+
+/**
+ * @brief Prepares argv/envp for a launch
+ *
+ * @param plan Plan to fill; its arrays point into its own storage
+ * @param program Program to run (argv[0])
+ * @param args Remaining arguments
+ * @param options Launch options, referenced by the plan
+ */
+void buildExecPlan(ExecPlan& plan, const std::string& program, const std::vector<std::string>& args,
+                   const SpawnOptions& options) {
+    plan.options = &options;
+    plan.argStorage.reserve(args.size() + 1);
+    plan.argStorage.push_back(program);
+    plan.argStorage.insert(plan.argStorage.end(), args.begin(), args.end());
+    for (std::string& arg : plan.argStorage) {
+        plan.argv.push_back(arg.data());
+    }
+    plan.argv.push_back(nullptr);
+
+    if (options.environment.empty()) {
+        plan.env = environ;
+    } else {
+        for (const std::string& entry : options.environment) {
+            plan.envp.push_back(const_cast<char*>(entry.c_str()));
+        }
+        plan.envp.push_back(nullptr);
+        plan.env = plan.envp.data();
+    }
+}
+
+/**
+ * @brief Moves a descriptor onto a standard stream in the child
+ *
+ * @param fd Source descriptor, or -1 to leave target alone
+ * @param target 0, 1 or 2
+ * @return false if dup2() failed
+ */
+bool redirect(int fd, int target) {
+    if (fd < 0) return true;
+    if (fd == target) {
+        int flags = fcntl(fd, F_GETFD);
+        return flags != -1 && fcntl(fd, F_SETFD, flags & ~FD_CLOEXEC) != -1;
+    }
+    return dup2(fd, target) != -1;
+}
+
+/**
+ * @brief Child side of the VFORK, CLONE and FORK methods
+ *
+ * @param plan Prepared launch
+ *
+ * Only async-signal-safe calls. The child has its own copy of the signal
+ * dispositions (no CLONE_SIGHAND), so handlers that point into the parent
+ * are reset to SIG_DFL before the parent's signal mask is restored; ignored
+ * signals stay ignored across exec, as with posix_spawn.
+ */
+[[noreturn]] void execChild(ExecPlan& plan) {
+    for (int sig = 1; sig < NSIG; ++sig) {
+        struct sigaction action;
+        if (sigaction(sig, nullptr, &action) == 0 && action.sa_handler != SIG_IGN &&
+            action.sa_handler != SIG_DFL) {
+            action.sa_handler = SIG_DFL;
+            action.sa_flags = 0;
+            sigemptyset(&action.sa_mask);
+            sigaction(sig, &action, nullptr);
+        }
+    }
+
+    const SpawnOptions& options = *plan.options;
+    int limitErr = applyLimits(plan.limits);
+    if (limitErr != 0) {
+        errno = limitErr;
+    }
+    bool ready = limitErr == 0 && (!options.newProcessGroup || setpgid(0, 0) == 0) &&
+                 redirect(options.stdinFd, STDIN_FILENO) &&
+                 redirect(options.stdoutFd, STDOUT_FILENO) &&
+                 redirect(options.stderrFd, STDERR_FILENO) &&
+                 (options.workingDirectory.empty() || chdir(options.workingDirectory.c_str()) == 0);
+
+    if (ready) {
+        sigprocmask(SIG_SETMASK, &plan.parentMask, nullptr);
+        execve(plan.path.c_str(), plan.argv.data(), plan.env);
+    }
+
+    int err = errno;
+    plan.childErrno = err;
+    if (plan.errorPipe != -1) {
+        ssize_t written = write(plan.errorPipe, &err, sizeof(err));
+        (void)written;
+    }
+    _exit(127);
+}
+
+int cloneEntry(void* arg) {
+    execChild(*static_cast<ExecPlan*>(arg));
+}
+
+/**
+ * @brief Launches through posix_spawn(3)
+ *
+ * @param plan Prepared launch; path is the unresolved program for posix_spawnp
+ * @param pid Set to the child PID
+ * @return 0 or an errno value
+ */
+int launchPosixSpawn(ExecPlan& plan, pid_t& pid) {
+    const SpawnOptions& options = *plan.options;
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_init(&attr);
+
+    if (options.stdinFd >= 0) posix_spawn_file_actions_adddup2(&actions, options.stdinFd, STDIN_FILENO);
+    if (options.stdoutFd >= 0) posix_spawn_file_actions_adddup2(&actions, options.stdoutFd, STDOUT_FILENO);
+    if (options.stderrFd >= 0) posix_spawn_file_actions_adddup2(&actions, options.stderrFd, STDERR_FILENO);
+    if (!options.workingDirectory.empty()) {
+        posix_spawn_file_actions_addchdir_np(&actions, options.workingDirectory.c_str());
+    }
+    if (options.newProcessGroup) {
+        posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+        posix_spawnattr_setpgroup(&attr, 0);
+    }
+
+    int result = options.searchPath
+        ? posix_spawnp(&pid, plan.path.c_str(), &actions, &attr, plan.argv.data(), plan.env)
+        : posix_spawn(&pid, plan.path.c_str(), &actions, &attr, plan.argv.data(), plan.env);
+
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    return result;
+}
+
+/**
+ * @brief Launches with vfork() or clone(CLONE_VM | CLONE_VFORK)
+ *
+ * @param plan Prepared launch with a resolved path
+ * @param useClone true for clone() on a private stack, false for vfork()
+ * @param pid Set to the child PID
+ * @return 0 or an errno value (exec failures included; the child is reaped)
+ *
+ * The calling thread is suspended until the child execs or exits, so the
+ * exec result is known on return. All signals are blocked meanwhile so no
+ * handler can run on the shared memory in the child.
+ */
+int launchSharedMemory(ExecPlan& plan, bool useClone, pid_t& pid) {
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &plan.parentMask);
+
+    int err = 0;
+    if (useClone) {
+        void* stack = mmap(nullptr, CLONE_STACK_SIZE, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_STACK, -1, 0);
+        if (stack == MAP_FAILED) {
+            err = errno;
+            pid = -1;
+        } else {
+            pid = clone(cloneEntry, static_cast<char*>(stack) + CLONE_STACK_SIZE,
+                        CLONE_VM | CLONE_VFORK | SIGCHLD, &plan);
+            if (pid == -1) err = errno;
+            munmap(stack, CLONE_STACK_SIZE);
+        }
+    } else {
+        pid = vfork();
+        if (pid == 0) {
+            execChild(plan);
+        }
+        if (pid == -1) err = errno;
+    }
+
+    pthread_sigmask(SIG_SETMASK, &plan.parentMask, nullptr);
+
+    if (pid > 0 && plan.childErrno != 0) {
+        err = plan.childErrno;
+        waitpid(pid, nullptr, 0);
+        pid = -1;
+    }
+    return err;
+}
+
+/**
+ * @brief Launches with fork() + execve()
+ *
+ * @param plan Prepared launch with a resolved path
+ * @param pid Set to the child PID
+ * @return 0 or an errno value (exec failures are reported through a
+ *         close-on-exec pipe and the child is reaped)
+ */
+int launchFork(ExecPlan& plan, pid_t& pid) {
+    int errorPipe[2];
+    if (pipe2(errorPipe, O_CLOEXEC) == -1) {
+        pid = -1;
+        return errno;
+    }
+
+    sigset_t all;
+    sigfillset(&all);
+    pthread_sigmask(SIG_BLOCK, &all, &plan.parentMask);
+    plan.errorPipe = errorPipe[1];
+    pid = fork();
+    if (pid == 0) {
+        close(errorPipe[0]);
+        execChild(plan);
+    }
+    int err = pid == -1 ? errno : 0;
+    pthread_sigmask(SIG_SETMASK, &plan.parentMask, nullptr);
+    close(errorPipe[1]);
+
+    if (pid > 0) {
+        int childErr = 0;
+        ssize_t got;
+        do {
+            got = read(errorPipe[0], &childErr, sizeof(childErr));
+        } while (got == -1 && errno == EINTR);
+        if (got == static_cast<ssize_t>(sizeof(childErr))) {
+            err = childErr;
+            waitpid(pid, nullptr, 0);
+            pid = -1;
+        }
+    }
+    close(errorPipe[0]);
+    return err;
+}
+
+/**
+ * @brief Starts one exec-style child with the requested method
+ *
+ * @param program Program to run
+ * @param args Arguments after argv[0]
+ * @param options Launch options
+ * @param err Set to the errno value on failure
+ * @param cgroupPath Set to the child's cgroup if options.resources asked for one
+ * @return Child PID, or -1 on failure
+ *
+ * Safe to call from several threads at once. posix_spawn() cannot run the
+ * limit setup in the child, so launches with limits use VFORK instead.
+ */
+pid_t launch(const std::string& program, const std::vector<std::string>& args,
+             const SpawnOptions& options, int& err, std::string& cgroupPath) {
+    ExecPlan plan;
+    buildExecPlan(plan, program, args, options);
+
+    SpawnMethod method = options.method;
+    if (method == SpawnMethod::POSIX_SPAWN && !options.resources.empty()) {
+        method = SpawnMethod::VFORK;
+    }
+    bool resolve = method != SpawnMethod::POSIX_SPAWN && options.searchPath;
+    plan.path = resolve ? resolveProgram(program) : program;
+    if (plan.path.empty()) {
+        err = ENOENT;
+        return -1;
+    }
+
+    if (!options.resources.empty()) {
+        err = prepareLimits(options.resources, plan.limits);
+        if (err != 0) {
+            releaseLimits(plan.limits, false);
+            return -1;
+        }
+    }
+
+    pid_t pid = -1;
+    switch (method) {
+        case SpawnMethod::POSIX_SPAWN: err = launchPosixSpawn(plan, pid); break;
+        case SpawnMethod::VFORK: err = launchSharedMemory(plan, false, pid); break;
+        case SpawnMethod::CLONE: err = launchSharedMemory(plan, true, pid); break;
+        case SpawnMethod::FORK: err = launchFork(plan, pid); break;
+    }
+
+    releaseLimits(plan.limits, err == 0);
+    cgroupPath = plan.limits.cgroupPath;
+    return err == 0 ? pid : -1;
+}
+
+/**
+ * @brief Runs create(index) for every index on up to concurrency threads
+ *
+ * @param count Number of indices
+ * @param concurrency Maximum number of threads, the caller included
+ * @param create Creates one process and returns its PID or -1
+ * @return PIDs by index
+ */
+template<typename Create>
+std::vector<pid_t> createConcurrently(size_t count, size_t concurrency, Create&& create) {
+    std::vector<pid_t> pids(count, -1);
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            pids[i] = create(i);
+        }
+    };
+
+    std::vector<std::thread> helpers;
+    size_t threads = std::min(std::max<size_t>(concurrency, 1), std::max<size_t>(count, 1));
+    for (size_t t = 1; t < threads; ++t) {
+        helpers.emplace_back(worker);
+    }
+    worker();
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+    return pids;
+}
+
+} // namespace
+
 /**
  * @brief Constructs a Process object with initial metadata
  *
@@ -20,14 +556,30 @@ namespace PTManager {
 Process::Process(pid_t p, const std::string& n)
     : pid(p), state(ProcessState::CREATED), name(n), exitStatus(-1) {}
 
+/**
+ * @brief Starts the reaper thread
+ *
+ * If the reaper's event loop cannot be created, children are reaped with
+ * waitpid() as they are waited for instead.
+ */
+ProcessManager::ProcessManager() {
+    try {
+        reaper = std::make_unique<EventLoop>();
+    } catch (const std::exception& e) {
+        PTM_LOG_ERROR("Asynchronous reaping unavailable: " << e.what());
+    }
+}
+
 /**
  * @brief Destructor that ensures all managed processes are cleaned up
  *
  * Terminates all running processes gracefully (SIGTERM), then forcefully (SIGKILL)
  * if necessary, and waits for them to complete. Prevents zombie processes.
+ * The reaper thread is stopped after the last child is reaped.
  */
 ProcessManager::~ProcessManager() {
     terminateAll();
+    reaper.reset();
 }
 
 /**
@@ -41,65 +593,436 @@ ProcessManager::~ProcessManager() {
  * with the task's return value. The parent records the process metadata and
  * continues execution. The task function should not return to caller - it will
  * be terminated with exit().
+ *
+ * With limits, the child applies them before running task and reports the
+ * outcome over a pipe, so a limit that cannot be applied fails the call
+ * instead of running the task unconstrained. Traced as a PROCESS_SPAWN span
+ * linked to the child's PROCESS_START.
  */
 pid_t ProcessManager::createProcess(const std::string& name,
-                                    std::function<int()> task) {
+                                    std::function<int()> task,
+                                    const ResourceLimits& limits) {
+    uint64_t traceId = Tracer::newId();
+    TraceSpan span(TraceEventType::PROCESS_SPAWN, traceId, -1);
+    ChildLimits prepared;
+    int statusPipe[2] = {-1, -1};
+    if (!limits.empty()) {
+        int err = prepareLimits(limits, prepared);
+        if (err == 0 && pipe2(statusPipe, O_CLOEXEC) == -1) {
+            err = errno;
+        }
+        if (err != 0) {
+            PTM_LOG_ERROR("Failed to prepare resource limits for '" << name << "': " << strerror(err));
+            releaseLimits(prepared, false);
+            return -1;
+        }
+    }
+
     pid_t pid = fork();
 
     if (pid < 0) {
-        std::cerr << "Fork failed: " << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Fork failed: " << strerror(errno));
+        if (statusPipe[0] != -1) {
+            close(statusPipe[0]);
+            close(statusPipe[1]);
+        }
+        releaseLimits(prepared, false);
         return -1;
     }
 
     if (pid == 0) {
         // Child process
+        if (statusPipe[1] != -1) {
+            int err = applyLimits(prepared);
+            ssize_t written = write(statusPipe[1], &err, sizeof(err));
+            (void)written;
+            if (err != 0) {
+                _exit(127);
+            }
+            close(statusPipe[0]);
+            close(statusPipe[1]);
+            if (prepared.cgroupProcs != -1) close(prepared.cgroupProcs);
+        }
+        Tracer::instant(TraceEventType::PROCESS_START, traceId);
         int exitCode = task();
         exit(exitCode);
     }
 
     // Parent process
-    Process proc(pid, name);
-    proc.state = ProcessState::RUNNING;
-    processes.emplace(pid, proc);
+    if (statusPipe[1] != -1) {
+        close(statusPipe[1]);
+        int childErr = EPIPE;
+        ssize_t got;
+        do {
+            got = read(statusPipe[0], &childErr, sizeof(childErr));
+        } while (got == -1 && errno == EINTR);
+        close(statusPipe[0]);
+        if (got != static_cast<ssize_t>(sizeof(childErr)) || childErr != 0) {
+            PTM_LOG_ERROR("Failed to apply resource limits for '" << name << "': " << strerror(childErr));
+            waitpid(pid, nullptr, 0);
+            releaseLimits(prepared, false);
+            return -1;
+        }
+    }
+    releaseLimits(prepared, true);
+    registerProcess(pid, name, prepared.cgroupPath);
+    span.setValue(pid);
+
+    PTM_LOG_INFO("Created process '" << name << "' with PID: " << pid);
+    return pid;
+}
+
+/**
+ * @brief Records a started child as RUNNING and hands it to the reaper
+ *
+ * @param pid Child PID
+ * @param name Human-readable identifier
+ * @param cgroupPath Cgroup created for the child, or empty
+ *
+ * The entry exists before the pidfd is watched, so an immediate exit is
+ * still recorded. A child the reaper cannot watch is reaped on demand.
+ */
+void ProcessManager::registerProcess(pid_t pid, const std::string& name, const std::string& cgroupPath) {
+    table.insert(pid, name, ProcessState::RUNNING);   // Replaces a reused PID's entry
+    {
+        std::lock_guard<std::mutex> lock(processMutex);
+        unwatched.erase(pid);
+        if (!cgroupPath.empty()) {
+            cgroups[pid] = cgroupPath;
+        }
+    }
+
+    bool watched = reaper != nullptr &&
+                   reaper->watchProcess(pid, [this](pid_t exited, int waitStatus, const struct rusage* usage) {
+                       onChildExit(exited, waitStatus, usage);
+                   });
+    if (!watched) {
+        std::lock_guard<std::mutex> lock(processMutex);
+        unwatched.insert(pid);
+    }
+}
+
+/**
+ * @brief Reaper callback: records a child's exit and wakes waiters
+ *
+ * @param pid Child that exited
+ * @param waitStatus waitpid()-style status, or -1 if it was reaped elsewhere
+ * @param usage rusage reported by the kernel, or nullptr
+ *
+ * Runs on the reaper thread; the exit callback is invoked outside the lock.
+ * processMutex is taken after the table update so a waiter that checked the
+ * table under it cannot miss the notification.
+ */
+void ProcessManager::onChildExit(pid_t pid, int waitStatus, const struct rusage* usage) {
+    ExitCallback callback;
+    int exitStatus = (waitStatus != -1 && WIFEXITED(waitStatus)) ? WEXITSTATUS(waitStatus) : -1;
+    // Traced first, so a waiter woken by the table update finds the event
+    Tracer::processExited(pid, exitStatus);
+    if (!table.markTerminated(pid, exitStatus, collectUsage(pid, usage))) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(processMutex);
+        callback = exitCallback;
+    }
+    processExited.notify_all();
+
+    if (callback) {
+        callback(pid, exitStatus);
+    }
+}
+
+/**
+ * @brief Builds the usage record of a reaped child
+ *
+ * @param pid Child that was reaped
+ * @param usage Its rusage, or nullptr if the status was lost
+ * @return rusage figures plus, if the child had a cgroup, the group's
+ *         totals; the group is removed afterwards
+ */
+ResourceUsage ProcessManager::collectUsage(pid_t pid, const struct rusage* usage) {
+    ResourceUsage result = usage != nullptr ? usageOf(*usage) : ResourceUsage{};
+
+    std::string cgroupPath;
+    {
+        std::lock_guard<std::mutex> lock(processMutex);
+        auto it = cgroups.find(pid);
+        if (it == cgroups.end()) {
+            return result;
+        }
+        cgroupPath = std::move(it->second);
+        cgroups.erase(it);
+    }
+
+    result.cgroupCpuUsec = readCgroupKey(cgroupPath + "/cpu.stat", "usage_usec");
+    result.cgroupOomKills = readCgroupKey(cgroupPath + "/memory.events", "oom_kill");
+    std::ifstream peak(cgroupPath + "/memory.peak");
+    if (!(peak >> result.cgroupMemoryPeak)) {
+        result.cgroupMemoryPeak = -1;
+    }
+    peak.close();
+    if (rmdir(cgroupPath.c_str()) == -1) {
+        PTM_LOG_ERROR("Failed to remove cgroup " << cgroupPath << ": " << strerror(errno));
+    }
+    return result;
+}
+
+/**
+ * @brief Reaps a child the reaper does not watch
+ *
+ * @param pid Child PID
+ * @param options waitpid() options (0 or WNOHANG)
+ * @return true if the child was reaped
+ *
+ * Must be called without processMutex held.
+ */
+bool ProcessManager::reapUnwatched(pid_t pid, int options) {
+    int wstatus;
+    struct rusage usage;
+    pid_t result;
+    do {
+        result = wait4(pid, &wstatus, options, &usage);
+    } while (result == -1 && errno == EINTR);
+
+    bool reaped = result == pid;
+    if (reaped || result == -1) {
+        // ECHILD: someone else reaped it, the status is lost
+        table.markTerminated(pid, reaped && WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : -1,
+                             collectUsage(pid, reaped ? &usage : nullptr));
+        {
+            std::lock_guard<std::mutex> lock(processMutex);
+            unwatched.erase(pid);
+        }
+        processExited.notify_all();
+    }
+    return reaped;
+}
+
+/**
+ * @brief Waits until every managed process has terminated
+ *
+ * @param lock Held lock on processMutex
+ * @param deadline Give up at this point; time_point::max() waits forever
+ * @return true if all processes terminated
+ *
+ * Unwatched children are polled with WNOHANG every 10 ms meanwhile.
+ */
+bool ProcessManager::allTerminated(std::unique_lock<std::mutex>& lock,
+                                   std::chrono::steady_clock::time_point deadline) {
+    using Clock = std::chrono::steady_clock;
+    constexpr auto POLL_INTERVAL = std::chrono::milliseconds(10);
+
+    while (true) {
+        if (table.liveCount() == 0) {
+            return true;
+        }
+        std::vector<pid_t> poll(unwatched.begin(), unwatched.end());
+
+        if (!poll.empty()) {
+            lock.unlock();
+            for (pid_t pid : poll) {
+                reapUnwatched(pid, WNOHANG);
+            }
+            lock.lock();
+        }
+
+        Clock::time_point now = Clock::now();
+        if (now >= deadline) {
+            return false;
+        }
+        if (!poll.empty()) {
+            processExited.wait_until(lock, std::min(deadline, now + POLL_INTERVAL));
+        } else if (deadline == Clock::time_point::max()) {
+            processExited.wait(lock);
+        } else {
+            processExited.wait_until(lock, deadline);
+        }
+    }
+}
+
+/**
+ * @brief Registers a callback for every child exit
+ *
+ * @param callback Invoked on the reaper thread with the PID and exit status
+ *        (-1 unless the process exited normally); empty to remove
+ *
+ * Children reaped on demand (no pidfd) report from the waiting thread.
+ */
+void ProcessManager::setExitCallback(ExitCallback callback) {
+    std::lock_guard<std::mutex> lock(processMutex);
+    exitCallback = std::move(callback);
+}
+
+/**
+ * @brief Starts a child that runs another program
+ *
+ * @param name Human-readable identifier for the process
+ * @param program Program to execute (looked up in PATH if options.searchPath)
+ * @param args Arguments after argv[0]
+ * @param options Launch method, environment, working directory and stdio
+ * @return PID of the child, or -1 if it could not be started
+ *
+ * Unlike createProcess(), the default POSIX_SPAWN method never copies the
+ * parent's page tables, so launch cost does not grow with the parent's
+ * memory. With every method except POSIX_SPAWN + searchPath the program is
+ * resolved before the child is created, and exec failures are reported
+ * here rather than as exit status 127.
+ */
+pid_t ProcessManager::spawnProcess(const std::string& name, const std::string& program,
+                                   const std::vector<std::string>& args,
+                                   const SpawnOptions& options) {
+    int err = 0;
+    std::string cgroupPath;
+    TraceSpan span(TraceEventType::PROCESS_SPAWN, 0, -1);
+    pid_t pid = launch(program, args, options, err, cgroupPath);
+    span.setValue(pid);
+    if (pid < 0) {
+        PTM_LOG_ERROR("Failed to spawn '" << program << "': " << strerror(err));
+        return -1;
+    }
 
-    std::cout << "Created process '" << name << "' with PID: " << pid << std::endl;
+    registerProcess(pid, name, cgroupPath);
+    PTM_LOG_INFO("Spawned process '" << name << "' (" << program << ") with PID: " << pid);
     return pid;
 }
 
+/**
+ * @brief Forks count children that each run task(index)
+ *
+ * @param count Number of children
+ * @param namePrefix Children are named namePrefix-<index>
+ * @param task Run in each child; its return value is the exit status
+ * @param concurrency Number of threads forking in parallel
+ * @return PID per index, -1 where fork() failed
+ *
+ * Each fork() still copies the page tables; running several at once only
+ * overlaps that work. Prefer spawnProcesses() when the children exec.
+ */
+std::vector<pid_t> ProcessManager::createProcesses(size_t count, const std::string& namePrefix,
+                                                   std::function<int(size_t index)> task,
+                                                   size_t concurrency) {
+    std::vector<pid_t> pids = createConcurrently(count, concurrency, [&task](size_t index) {
+        uint64_t traceId = Tracer::newId();
+        TraceSpan span(TraceEventType::PROCESS_SPAWN, traceId, -1);
+        pid_t pid = fork();
+        if (pid == 0) {
+            Tracer::instant(TraceEventType::PROCESS_START, traceId);
+            exit(task(index));
+        }
+        span.setValue(pid);
+        return pid;
+    });
+
+    size_t created = 0;
+    for (size_t i = 0; i < pids.size(); ++i) {
+        if (pids[i] > 0) {
+            registerProcess(pids[i], namePrefix + "-" + std::to_string(i));
+            created++;
+        }
+    }
+    if (created < count) {
+        PTM_LOG_ERROR("Fork failed for " << (count - created) << " of " << count << " processes");
+    }
+    PTM_LOG_INFO("Created " << created << " '" << namePrefix << "' processes");
+    return pids;
+}
+
+/**
+ * @brief Starts one exec-style child per request
+ *
+ * @param requests Name, program and arguments of each child
+ * @param options Shared launch options
+ * @param concurrency Number of threads spawning in parallel
+ * @return PID per request, -1 where the launch failed
+ *
+ * The vfork-like methods suspend only the launching thread until the
+ * child execs, so several threads keep spawning meanwhile.
+ */
+std::vector<pid_t> ProcessManager::spawnProcesses(const std::vector<SpawnRequest>& requests,
+                                                  const SpawnOptions& options,
+                                                  size_t concurrency) {
+    std::vector<int> errors(requests.size(), 0);
+    std::vector<std::string> cgroupPaths(requests.size());
+    std::vector<pid_t> pids = createConcurrently(requests.size(), concurrency,
+        [&requests, &options, &errors, &cgroupPaths](size_t index) {
+            return launch(requests[index].program, requests[index].args, options, errors[index],
+                          cgroupPaths[index]);
+        });
+
+    size_t created = 0;
+    for (size_t i = 0; i < pids.size(); ++i) {
+        if (pids[i] > 0) {
+            registerProcess(pids[i], requests[i].name, cgroupPaths[i]);
+            created++;
+        } else {
+            PTM_LOG_ERROR("Failed to spawn '" << requests[i].program << "': " << strerror(errors[i]));
+        }
+    }
+    PTM_LOG_INFO("Spawned " << created << " of " << requests.size() << " processes");
+    return pids;
+}
+
 /**
  * @brief Waits for a specific process to terminate and retrieves its exit status
  *
  * @param pid Process ID to wait for
  * @param status Optional pointer to store the exit status (can be nullptr)
- * @return true if process was found and successfully waited for, false otherwise
+ * @return true if process was found and has terminated, false otherwise
  *
- * Blocks until the specified process terminates. Updates internal process state
- * and extracts the exit code if the process exited normally. Returns false if
- * the PID is not managed by this ProcessManager.
+ * Blocks until the reaper records the termination (returns at once if it
+ * already has), and extracts the exit code if the process exited normally.
+ * Returns false if the PID is not managed by this ProcessManager.
  */
 bool ProcessManager::waitForProcess(pid_t pid, int* status) {
-    auto it = processes.find(pid);
-    if (it == processes.end()) {
-        return false;
-    }
+    return waitForProcess(pid, std::chrono::milliseconds::max(), status);
+}
 
-    int wstatus;
-    pid_t result = waitpid(pid, &wstatus, 0);
+/**
+ * @brief Waits at most timeout for a specific process to terminate
+ *
+ * @param pid Process ID to wait for
+ * @param timeout Maximum wait; milliseconds::max() waits forever
+ * @param status Optional pointer to store the exit status (can be nullptr)
+ * @return true if the process terminated in time, false on timeout or if
+ *         the PID is not managed by this ProcessManager
+ */
+bool ProcessManager::waitForProcess(pid_t pid, std::chrono::milliseconds timeout, int* status) {
+    using Clock = std::chrono::steady_clock;
+    bool forever = timeout == std::chrono::milliseconds::max();
+    Clock::time_point deadline = forever ? Clock::time_point::max() : Clock::now() + timeout;
 
-    if (result == pid) {
-        it->second.state = ProcessState::TERMINATED;
-        it->second.exitStatus = WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : -1;
+    std::unique_lock<std::mutex> lock(processMutex);
+    while (true) {
+        std::optional<ProcessRecord> record = table.find(pid);
+        if (!record) {
+            return false;
+        }
 
-        if (status) {
-            *status = it->second.exitStatus;
+        if (record->state == ProcessState::TERMINATED) {
+            if (status) {
+                *status = record->exitStatus;
+            }
+            PTM_LOG_INFO("Process " << pid << " (" << record->name
+                         << ") terminated with status: " << record->exitStatus);
+            return true;
         }
 
-        std::cout << "Process " << pid << " (" << it->second.name
-                  << ") terminated with status: " << it->second.exitStatus << std::endl;
-        return true;
+        if (unwatched.count(pid) > 0) {
+            lock.unlock();
+            bool reaped = reapUnwatched(pid, forever ? 0 : WNOHANG);
+            lock.lock();
+            if (reaped) continue;
+            if (Clock::now() >= deadline) return false;
+            processExited.wait_for(lock, std::chrono::milliseconds(10));
+        } else if (forever) {
+            processExited.wait(lock);
+        } else if (processExited.wait_until(lock, deadline) == std::cv_status::timeout) {
+            std::optional<ProcessRecord> current = table.find(pid);
+            if (!current || current->state != ProcessState::TERMINATED) {
+                return false;
+            }
+        }
     }
-
-    return false;
 }
 
 /**
@@ -107,19 +1030,21 @@ bool ProcessManager::waitForProcess(pid_t pid, int* status) {
  *
  * @param pid Process ID to send signal to
  * @param signal Signal number (e.g., SIGTERM, SIGKILL, SIGSTOP)
- * @return true if signal was successfully sent, false if process not found or kill() failed
+ * @return true if signal was successfully sent, false if process not found,
+ *         already terminated or kill() failed
  *
  * Does not wait for process termination - only sends the signal.
  * The process may ignore or handle certain signals (except SIGKILL and SIGSTOP).
+ * Terminated processes are skipped, since their PID may have been reused.
  */
 bool ProcessManager::terminateProcess(pid_t pid, int signal) {
-    auto it = processes.find(pid);
-    if (it == processes.end()) {
+    std::optional<ProcessRecord> record = table.find(pid);
+    if (!record || record->state == ProcessState::TERMINATED) {
         return false;
     }
 
     if (kill(pid, signal) == 0) {
-        std::cout << "Sent signal " << signal << " to process " << pid << std::endl;
+        PTM_LOG_INFO("Sent signal " << signal << " to process " << pid);
         return true;
     }
 
@@ -140,33 +1065,52 @@ bool ProcessManager::killProcess(pid_t pid) {
 }
 
 /**
- * @brief Queries and updates the current state of a process
+ * @brief Queries the current state of a process
  *
  * @param pid Process ID to check
  * @return Current ProcessState, or TERMINATED if PID not found
  *
- * Uses non-blocking waitpid() with WNOHANG to check if the process has terminated
- * without blocking. Updates internal state if termination is detected.
- * Does not affect zombie processes - they remain until explicitly waited for.
+ * The reaper keeps the state current, so this is a table lookup. Only
+ * children without a pidfd are checked with a non-blocking waitpid().
  */
 ProcessState ProcessManager::getProcessState(pid_t pid) {
-    auto it = processes.find(pid);
-    if (it == processes.end()) {
+    std::optional<ProcessRecord> record = table.find(pid);
+    if (!record) {
         return ProcessState::TERMINATED;
     }
 
-    // Check if process is still running
-    int status;
-    pid_t result = waitpid(pid, &status, WNOHANG);
-
-    if (result == pid) {
-        it->second.state = ProcessState::TERMINATED;
-        it->second.exitStatus = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
-    } else if (result == 0) {
-        it->second.state = ProcessState::RUNNING;
+    if (record->state != ProcessState::TERMINATED) {
+        bool isUnwatched;
+        {
+            std::lock_guard<std::mutex> lock(processMutex);
+            isUnwatched = unwatched.count(pid) > 0;
+        }
+        if (isUnwatched && reapUnwatched(pid, WNOHANG)) {
+            return ProcessState::TERMINATED;
+        }
+        record = table.find(pid);
     }
 
-    return it->second.state;
+    return record ? record->state : ProcessState::TERMINATED;
+}
+
+/**
+ * @brief Looks up a managed process
+ *
+ * @param pid Process ID
+ * @return Copy of the process entry, or nullopt if the PID is not tracked
+ *         (never created here, purged, or evicted after termination)
+ */
+std::optional<Process> ProcessManager::getProcess(pid_t pid) const {
+    std::optional<ProcessRecord> record = table.find(pid);
+    if (!record) {
+        return std::nullopt;
+    }
+    Process proc(record->pid, std::string(record->name));
+    proc.state = record->state;
+    proc.exitStatus = record->exitStatus;
+    proc.usage = record->usage;
+    return proc;
 }
 
 /**
@@ -174,55 +1118,64 @@ ProcessState ProcessManager::getProcessState(pid_t pid) {
  *
  * @return Vector containing PIDs of all processes tracked by this manager
  *
- * Includes both running and terminated processes that haven't been removed
- * from the internal tracking map.
+ * Includes both running and terminated processes that haven't been evicted
+ * or purged from the process table.
  */
 std::vector<pid_t> ProcessManager::getAllProcesses() const {
     std::vector<pid_t> pids;
-    for (const auto& pair : processes) {
-        pids.push_back(pair.first);
-    }
+    pids.reserve(table.size());
+    table.forEach([&pids](const ProcessRecord& record) {
+        pids.push_back(record.pid);
+    });
     return pids;
 }
 
 /**
  * @brief Waits for all managed processes to terminate
  *
- * Blocks until every non-terminated process has exited.
- * Skips processes already marked as TERMINATED to avoid waiting on
- * already-reaped processes.
+ * A single wait for the last exit: children are reaped in the order they
+ * finish, not one after another in map order.
  */
 void ProcessManager::waitForAll() {
-    for (auto& pair : processes) {
-        if (pair.second.state != ProcessState::TERMINATED) {
-            waitForProcess(pair.first);
-        }
-    }
+    std::unique_lock<std::mutex> lock(processMutex);
+    allTerminated(lock, std::chrono::steady_clock::time_point::max());
 }
 
 /**
  * @brief Terminates all managed processes gracefully, then forcefully if needed
  *
- * First attempts graceful termination by sending SIGTERM to all processes,
- * waits 1 second for them to clean up, then sends SIGKILL to any survivors.
- * Finally waits for all processes to be reaped to prevent zombies.
+ * @param gracePeriod Time the processes get to exit after SIGTERM
  *
- * This two-phase approach allows processes to perform cleanup operations
- * before being forcefully killed.
+ * Sends SIGTERM to every running process and escalates to SIGKILL for the
+ * survivors as soon as the grace period lapses. Returns as soon as every
+ * process has exited, so a prompt shutdown costs no fixed delay. Finally
+ * waits for all processes to be reaped to prevent zombies.
  */
-void ProcessManager::terminateAll() {
-    for (auto& pair : processes) {
-        if (pair.second.state != ProcessState::TERMINATED) {
-            terminateProcess(pair.first, SIGTERM);
+void ProcessManager::terminateAll(std::chrono::milliseconds gracePeriod) {
+    std::vector<pid_t> running;
+    table.forEach([&running](const ProcessRecord& record) {
+        if (record.state != ProcessState::TERMINATED) {
+            running.push_back(record.pid);
         }
+    });
+    if (running.empty()) {
+        return;
     }
 
-    // Wait a bit and then force kill if necessary
-    sleep(1);
+    for (pid_t pid : running) {
+        terminateProcess(pid, SIGTERM);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(processMutex);
+        if (allTerminated(lock, std::chrono::steady_clock::now() + gracePeriod)) {
+            return;
+        }
+    }
 
-    for (auto& pair : processes) {
-        if (pair.second.state != ProcessState::TERMINATED) {
-            killProcess(pair.first);
+    for (pid_t pid : running) {
+        if (getProcessState(pid) != ProcessState::TERMINATED) {
+            killProcess(pid);
         }
     }
 
@@ -238,13 +1191,13 @@ void ProcessManager::terminateAll() {
  * Prints "not found" message if the PID is not managed by this ProcessManager.
  */
 void ProcessManager::printProcessInfo(pid_t pid) {
-    auto it = processes.find(pid);
-    if (it == processes.end()) {
+    std::optional<ProcessRecord> record = table.find(pid);
+    if (!record) {
         std::cout << "Process " << pid << " not found" << std::endl;
         return;
     }
 
-    const Process& proc = it->second;
+    const ProcessRecord& proc = *record;
     std::cout << "Process " << proc.pid << " (" << proc.name << "):" << std::endl;
     std::cout << "  State: ";
 
@@ -259,6 +1212,9 @@ void ProcessManager::printProcessInfo(pid_t pid) {
     std::cout << std::endl;
     if (proc.state == ProcessState::TERMINATED) {
         std::cout << "  Exit Status: " << proc.exitStatus << std::endl;
+        std::cout << "  CPU: " << proc.usage.userTime.count() / 1000 << " ms user, "
+                  << proc.usage.systemTime.count() / 1000 << " ms system, max RSS "
+                  << proc.usage.maxRssKb << " KB" << std::endl;
     }
 }
 
@@ -269,11 +1225,12 @@ void ProcessManager::printProcessInfo(pid_t pid) {
  * Useful for debugging and monitoring the state of all child processes.
  */
 void ProcessManager::printAllProcesses() {
+    std::vector<pid_t> pids = getAllProcesses();
     std::cout << "\n=== Process Manager Status ===" << std::endl;
-    std::cout << "Total processes: " << processes.size() << std::endl;
+    std::cout << "Total processes: " << pids.size() << std::endl;
 
-    for (const auto& pair : processes) {
-        printProcessInfo(pair.first);
+    for (pid_t pid : pids) {
+        printProcessInfo(pid);
     }
     std::cout << "============================\n" << std::endl;
 }
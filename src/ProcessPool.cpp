@@ -0,0 +1,418 @@
+#include "ProcessPool.h"
+#include "Logger.h"
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace PTManager {
+
+// Request frames are a 4-byte handler id followed by the payload; response
+// frames are a status byte (1 = result, 0 = error message) and the body.
+
+/**
+ * @brief Creates an idle pool
+ *
+ * @param workerCount Number of worker processes start() forks
+ * @param maxTasks Tasks after which a worker is replaced, 0 for no limit
+ */
+ProcessPool::ProcessPool(size_t workerCount, size_t maxTasks)
+    : workers(workerCount), maxTasksPerWorker(maxTasks), started(false), stopping(false),
+      liveWorkers(0), completedTasks(0), failedTasks(0), crashes(0), recycles(0) {}
+
+/**
+ * @brief Shuts the pool down; queued tasks still run first
+ */
+ProcessPool::~ProcessPool() {
+    shutdown();
+}
+
+/**
+ * @brief Adds a handler workers can run
+ *
+ * @param name Name used by submit()
+ * @param handler Runs in a worker process with the task payload
+ * @throws std::runtime_error after start(), since running workers could
+ *         not see the new handler
+ */
+void ProcessPool::registerHandler(const std::string& name, Handler handler) {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (started) {
+        throw std::runtime_error("Handlers must be registered before ProcessPool::start()");
+    }
+
+    auto it = handlerIds.find(name);
+    if (it != handlerIds.end()) {
+        handlers[it->second] = std::move(handler);
+        return;
+    }
+    handlerIds.emplace(name, static_cast<uint32_t>(handlers.size()));
+    handlers.push_back(std::move(handler));
+}
+
+/**
+ * @brief Forks the workers and starts their supervising threads
+ *
+ * @return true if every worker started; false if the pool was already
+ *         started or some fork failed (the others still serve tasks)
+ */
+bool ProcessPool::start() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (started || stopping) {
+            return false;
+        }
+        started = true;
+    }
+
+    size_t spawned = 0;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (spawnWorker(i)) {
+            spawned++;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        liveWorkers = spawned;
+        if (spawned == 0) {
+            failQueued("No worker processes could be started");
+        }
+    }
+
+    for (size_t i = 0; i < workers.size(); ++i) {
+        if (workers[i].pid > 0) {
+            workers[i].supervisor = std::thread([this, i] { supervise(i); });
+        }
+    }
+    return spawned == workers.size();
+}
+
+/**
+ * @brief Stops accepting tasks, lets the workers drain the queue and reaps them
+ *
+ * Safe to call multiple times.
+ */
+void ProcessPool::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (stopping) {
+            return;
+        }
+        stopping = true;
+    }
+    queueCondition.notify_all();
+
+    for (Worker& worker : workers) {
+        if (worker.supervisor.joinable()) {
+            worker.supervisor.join();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    failQueued("ProcessPool is shut down");
+}
+
+/**
+ * @brief Queues a task for the next free worker
+ *
+ * @param handlerName Name passed to registerHandler()
+ * @param payload Bytes handed to the handler
+ * @return Future for the handler's result
+ * @throws std::runtime_error for an unknown handler, or once the pool is
+ *         stopped or has lost all its workers
+ */
+std::future<std::string> ProcessPool::submit(const std::string& handlerName, std::string payload) {
+    std::unique_lock<std::mutex> lock(queueMutex);
+
+    auto it = handlerIds.find(handlerName);
+    if (it == handlerIds.end()) {
+        throw std::runtime_error("Unknown ProcessPool handler: " + handlerName);
+    }
+    if (stopping || (started && liveWorkers == 0)) {
+        throw std::runtime_error("Cannot submit to stopped ProcessPool");
+    }
+
+    queue.push_back(PendingTask{it->second, std::move(payload), {}});
+    std::future<std::string> result = queue.back().result.get_future();
+    lock.unlock();
+
+    queueCondition.notify_one();
+    return result;
+}
+
+/**
+ * @brief Forks a worker into a slot
+ *
+ * @param index Worker slot; any previous worker must have been retired
+ * @return true if the worker is running
+ *
+ * Runs under managerMutex so no other pipe is being created or closed while
+ * the child inherits the descriptor table; the child then closes every
+ * descriptor above stderr but its own two pipe ends (see workerMain()).
+ */
+bool ProcessPool::spawnWorker(size_t index) {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    Worker& worker = workers[index];
+
+    worker.requests = std::make_unique<Pipe>();
+    worker.responses = std::make_unique<Pipe>();
+    worker.tasksRun = 0;
+    if (worker.requests->getReadFd() == -1 || worker.responses->getReadFd() == -1) {
+        worker.requests.reset();
+        worker.responses.reset();
+        return false;
+    }
+
+    pid_t pid = manager.createProcess("pool-worker-" + std::to_string(index), [this, index] {
+        workerMain(index);
+        _exit(0);
+        return 0;
+    });
+    if (pid < 0) {
+        worker.requests.reset();
+        worker.responses.reset();
+        return false;
+    }
+
+    worker.pid = pid;
+    worker.requests->closeRead();
+    worker.responses->closeWrite();
+    return true;
+}
+
+/**
+ * @brief Closes a worker's request pipe and reaps it
+ *
+ * @param worker Slot to clear; the worker exits at end of input, or has
+ *        already exited
+ */
+void ProcessPool::retireWorker(Worker& worker) {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    worker.requests.reset();
+    if (worker.pid > 0) {
+        manager.waitForProcess(worker.pid);
+    }
+    worker.responses.reset();
+    worker.pid = -1;
+}
+
+/**
+ * @brief Closes every descriptor above stderr except two
+ *
+ * @param keepA Descriptor to keep open
+ * @param keepB Descriptor to keep open
+ *
+ * Uses close_range() and falls back to closing each descriptor up to the
+ * RLIMIT_NOFILE limit on kernels without it.
+ */
+void ProcessPool::closeInheritedDescriptors(int keepA, int keepB) {
+    auto closeRange = [](unsigned int first, unsigned int last) {
+        if (first > last || syscall(SYS_close_range, first, last, 0) == 0) {
+            return;
+        }
+        struct rlimit limit{};
+        if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY) {
+            last = std::min<unsigned int>(last, static_cast<unsigned int>(limit.rlim_cur));
+        }
+        for (unsigned int fd = first; fd <= last && fd < 1u << 20; ++fd) {
+            close(static_cast<int>(fd));
+        }
+    };
+
+    unsigned int next = 3;
+    for (int keep : {std::min(keepA, keepB), std::max(keepA, keepB)}) {
+        if (keep >= static_cast<int>(next)) {
+            if (keep > static_cast<int>(next)) {
+                closeRange(next, static_cast<unsigned int>(keep) - 1);
+            }
+            next = static_cast<unsigned int>(keep) + 1;
+        }
+    }
+    closeRange(next, ~0u);
+}
+
+/**
+ * @brief Worker process body: serves request frames until end of input
+ *
+ * @param index Slot of this worker
+ *
+ * First closes every inherited descriptor above stderr except its request
+ * read end and response write end: other workers' pipes, the reaper's
+ * epoll and pidfds, and any pipe write end the parent holds, so their
+ * readers still see end of file while this worker lives. The Pipe objects
+ * are not updated; the worker leaves with _exit() and never closes them.
+ * Exits after maxTasksPerWorker tasks if a limit is set. Handler
+ * exceptions are sent back as error responses.
+ */
+void ProcessPool::workerMain(size_t index) {
+    Pipe& requests = *workers[index].requests;
+    Pipe& responses = *workers[index].responses;
+    closeInheritedDescriptors(requests.getReadFd(), responses.getWriteFd());
+
+    FrameReader reader(requests.getReadFd());
+    std::string_view frame;
+    std::string response;
+    size_t served = 0;
+
+    while (reader.next(frame) && frame.size() >= sizeof(uint32_t)) {
+        uint32_t handlerId;
+        std::memcpy(&handlerId, frame.data(), sizeof(handlerId));
+        std::string_view payload = frame.substr(sizeof(handlerId));
+
+        try {
+            if (handlerId >= handlers.size() || !handlers[handlerId]) {
+                throw std::runtime_error("Unknown handler id " + std::to_string(handlerId));
+            }
+            std::string result = handlers[handlerId](payload);
+            response.assign(1, '\1');
+            response += result;
+        } catch (const std::exception& e) {
+            response.assign(1, '\0');
+            response += e.what();
+        } catch (...) {
+            response.assign(1, '\0');
+            response += "Unknown exception in handler";
+        }
+
+        if (!responses.writeFrame(response.data(), response.size())) {
+            break;
+        }
+        if (maxTasksPerWorker != 0 && ++served >= maxTasksPerWorker) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Supervising thread of one worker slot
+ *
+ * @param index Worker slot
+ *
+ * Feeds queued tasks to the worker one at a time and completes their
+ * futures. A worker that dies mid-task (end of stream on its response pipe
+ * or a broken request pipe) fails that task and is replaced, as is one that
+ * reached its task limit. SIGPIPE is blocked on this thread so a dead
+ * worker surfaces as EPIPE rather than killing the parent.
+ */
+void ProcessPool::supervise(size_t index) {
+    sigset_t pipeSignal;
+    sigemptyset(&pipeSignal);
+    sigaddset(&pipeSignal, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSignal, nullptr);
+
+    Worker& worker = workers[index];
+    auto reader = std::make_unique<FrameReader>(worker.responses->getReadFd());
+    std::string request;
+
+    while (true) {
+        PendingTask task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) {
+                break;
+            }
+            task = std::move(queue.front());
+            queue.pop_front();
+        }
+
+        request.resize(sizeof(uint32_t));
+        std::memcpy(request.data(), &task.handlerId, sizeof(uint32_t));
+        request.append(task.payload);
+
+        std::string_view reply;
+        bool answered = worker.requests->writeFrame(request.data(), request.size()) &&
+                        reader->next(reply) && !reply.empty();
+        // Counters are updated before the future is completed, so a caller
+        // woken by it sees its own task counted
+        if (answered) {
+            std::string body(reply.substr(1));
+            if (reply[0] == '\1') {
+                completedTasks++;
+                task.result.set_value(std::move(body));
+            } else {
+                failedTasks++;
+                task.result.set_exception(std::make_exception_ptr(std::runtime_error(body)));
+            }
+
+            if (maxTasksPerWorker == 0 || ++worker.tasksRun < maxTasksPerWorker) {
+                continue;
+            }
+            recycles++;
+        } else {
+            failedTasks++;
+            crashes++;
+            task.result.set_exception(std::make_exception_ptr(std::runtime_error(
+                "Worker process " + std::to_string(worker.pid) + " died while running the task")));
+        }
+
+        retireWorker(worker);
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            if (stopping && queue.empty()) {
+                break;
+            }
+        }
+        if (!spawnWorker(index)) {
+            PTM_LOG_ERROR("Failed to respawn pool worker " << index);
+            break;
+        }
+        reader = std::make_unique<FrameReader>(worker.responses->getReadFd());
+    }
+
+    if (worker.pid > 0) {
+        retireWorker(worker);
+    }
+
+    std::lock_guard<std::mutex> lock(queueMutex);
+    if (--liveWorkers == 0) {
+        failQueued("No worker processes left");
+    }
+}
+
+/**
+ * @brief Fails every queued task
+ *
+ * @param reason Message of the exception stored in each future
+ *
+ * Must be called with queueMutex held.
+ */
+void ProcessPool::failQueued(const std::string& reason) {
+    for (PendingTask& task : queue) {
+        failedTasks++;
+        task.result.set_exception(std::make_exception_ptr(std::runtime_error(reason)));
+    }
+    queue.clear();
+}
+
+/**
+ * @brief Lists the PIDs of the running workers
+ *
+ * @return Current worker PIDs; they change as workers are replaced
+ */
+std::vector<pid_t> ProcessPool::getWorkerPids() {
+    std::lock_guard<std::mutex> lock(managerMutex);
+    std::vector<pid_t> pids;
+    for (const Worker& worker : workers) {
+        if (worker.pid > 0) {
+            pids.push_back(worker.pid);
+        }
+    }
+    return pids;
+}
+
+/**
+ * @brief Queries the number of tasks waiting for a worker
+ *
+ * @return Queued tasks not yet handed to a worker
+ */
+size_t ProcessPool::getPendingTasks() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return queue.size();
+}
+
+} // namespace PTManager
@@ -0,0 +1,378 @@
+#include "ProcessTable.h"
+#include <algorithm>
+
+namespace PTManager {
+
+// ===== NameTable Implementation =====
+
+/**
+ * @brief Returns the id of a name, storing it on first use
+ *
+ * @param name Name to intern
+ * @return Stable id for lookup()
+ */
+uint32_t NameTable::intern(std::string_view name) {
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex);
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    auto it = ids.find(name);
+    if (it != ids.end()) {
+        return it->second;
+    }
+    uint32_t id = static_cast<uint32_t>(names.size());
+    names.emplace_back(name);
+    ids.emplace(names.back(), id);
+    return id;
+}
+
+/**
+ * @brief Resolves an interned name
+ *
+ * @param id Id returned by intern()
+ * @return The name; valid for the table's lifetime
+ */
+std::string_view NameTable::lookup(uint32_t id) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return id < names.size() ? std::string_view(names[id]) : std::string_view();
+}
+
+/**
+ * @brief Queries the number of distinct names
+ *
+ * @return Interned name count
+ */
+size_t NameTable::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return names.size();
+}
+
+// ===== ProcessTable Implementation =====
+
+/**
+ * @brief Creates an empty table
+ *
+ * @param maxTerminated Terminated entries kept before the oldest are evicted
+ */
+ProcessTable::ProcessTable(size_t maxTerminated)
+    : entries(0), live(0), nextRetirement(1), maxRetired(maxTerminated) {}
+
+/**
+ * @brief Mixes a PID so consecutive PIDs spread over shards and slots
+ *
+ * @param pid Process ID
+ * @return 64-bit hash; the low bits pick the shard, the rest the slot
+ */
+uint64_t ProcessTable::hashOf(pid_t pid) {
+    uint64_t h = static_cast<uint64_t>(static_cast<uint32_t>(pid)) * 0x9E3779B97F4A7C15ull;
+    return h ^ (h >> 29);
+}
+
+/**
+ * @brief Home slot of a PID within its shard
+ *
+ * @param shard Shard holding the PID; must have slots
+ * @param pid Process ID
+ * @return Index where probing starts
+ */
+size_t ProcessTable::probeStart(const Shard& shard, pid_t pid) {
+    return static_cast<size_t>(hashOf(pid) >> 4) & (shard.slots.size() - 1);
+}
+
+/**
+ * @brief Finds the slot holding pid
+ *
+ * @param shard Shard to search, locked by the caller
+ * @param pid Process ID
+ * @return The slot, or nullptr
+ */
+const ProcessTable::Slot* ProcessTable::findSlot(const Shard& shard, pid_t pid) {
+    if (shard.slots.empty()) {
+        return nullptr;
+    }
+    size_t mask = shard.slots.size() - 1;
+    for (size_t i = probeStart(shard, pid);; i = (i + 1) & mask) {
+        const Slot& slot = shard.slots[i];
+        if (slot.pid == pid) return &slot;
+        if (slot.pid == 0) return nullptr;
+    }
+}
+
+ProcessTable::Slot* ProcessTable::findSlot(Shard& shard, pid_t pid) {
+    return const_cast<Slot*>(findSlot(static_cast<const Shard&>(shard), pid));
+}
+
+/**
+ * @brief Doubles a shard's slot array and reinserts its entries
+ *
+ * @param shard Shard to grow, locked for writing by the caller
+ */
+void ProcessTable::grow(Shard& shard) {
+    size_t capacity = std::max<size_t>(shard.slots.size() * 2, 16);
+    std::vector<Slot> old(capacity, Slot{0, ProcessState::CREATED, 0, -1});
+    std::vector<ResourceUsage> oldUsage(capacity);
+    std::vector<uint64_t> oldRetirements(capacity, 0);
+    old.swap(shard.slots);
+    oldUsage.swap(shard.usage);
+    oldRetirements.swap(shard.retirements);
+
+    size_t mask = shard.slots.size() - 1;
+    for (size_t j = 0; j < old.size(); ++j) {
+        if (old[j].pid == 0) continue;
+        size_t i = probeStart(shard, old[j].pid);
+        while (shard.slots[i].pid != 0) {
+            i = (i + 1) & mask;
+        }
+        shard.slots[i] = old[j];
+        shard.usage[i] = oldUsage[j];
+        shard.retirements[i] = oldRetirements[j];
+    }
+}
+
+/**
+ * @brief Removes a slot, shifting later probe-chain members back
+ *
+ * @param shard Shard holding the slot, locked for writing by the caller
+ * @param slot Occupied slot to clear
+ *
+ * Backward-shift deletion keeps every chain gap-free, so lookups never
+ * need tombstones.
+ */
+void ProcessTable::eraseSlot(Shard& shard, Slot* slot) {
+    if (slot->state != ProcessState::TERMINATED) {
+        live.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    size_t mask = shard.slots.size() - 1;
+    size_t hole = static_cast<size_t>(slot - shard.slots.data());
+    size_t next = hole;
+    while (true) {
+        next = (next + 1) & mask;
+        if (shard.slots[next].pid == 0) {
+            break;
+        }
+        size_t home = probeStart(shard, shard.slots[next].pid);
+        bool reachable = hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (reachable) {
+            continue;   // Still found from its home without crossing the hole
+        }
+        shard.slots[hole] = shard.slots[next];
+        shard.usage[hole] = shard.usage[next];
+        shard.retirements[hole] = shard.retirements[next];
+        hole = next;
+    }
+
+    shard.slots[hole].pid = 0;
+    shard.count--;
+    entries.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Adds or replaces the entry for a process
+ *
+ * @param pid Process ID (non-zero)
+ * @param name Display name; interned
+ * @param state Initial state
+ */
+void ProcessTable::insert(pid_t pid, std::string_view name, ProcessState state) {
+    uint32_t nameId = names.intern(name);
+    Shard& shard = shardFor(pid);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+    if (Slot* existing = findSlot(shard, pid)) {
+        bool wasLive = existing->state != ProcessState::TERMINATED;
+        bool isLive = state != ProcessState::TERMINATED;
+        *existing = Slot{pid, state, nameId, -1};
+        shard.usage[static_cast<size_t>(existing - shard.slots.data())] = ResourceUsage{};
+        shard.retirements[static_cast<size_t>(existing - shard.slots.data())] = 0;
+        if (wasLive != isLive) {
+            isLive ? live.fetch_add(1, std::memory_order_acq_rel) : live.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        return;
+    }
+
+    if ((shard.count + 1) * 2 > shard.slots.size()) {
+        grow(shard);
+    }
+    size_t mask = shard.slots.size() - 1;
+    size_t i = probeStart(shard, pid);
+    while (shard.slots[i].pid != 0) {
+        i = (i + 1) & mask;
+    }
+    shard.slots[i] = Slot{pid, state, nameId, -1};
+    shard.usage[i] = ResourceUsage{};
+    shard.retirements[i] = 0;
+    shard.count++;
+    entries.fetch_add(1, std::memory_order_relaxed);
+    if (state != ProcessState::TERMINATED) {
+        live.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
+
+/**
+ * @brief Marks a process TERMINATED and queues it for eviction
+ *
+ * @param pid Process ID
+ * @param exitStatus Exit status to record
+ * @param usage Resources the process used
+ * @return false if pid is unknown or already terminated
+ */
+bool ProcessTable::markTerminated(pid_t pid, int exitStatus, const ResourceUsage& usage) {
+    uint64_t number = nextRetirement.fetch_add(1, std::memory_order_relaxed);
+    {
+        Shard& shard = shardFor(pid);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        Slot* slot = findSlot(shard, pid);
+        if (slot == nullptr || slot->state == ProcessState::TERMINATED) {
+            return false;
+        }
+        size_t index = static_cast<size_t>(slot - shard.slots.data());
+        slot->state = ProcessState::TERMINATED;
+        slot->exitStatus = exitStatus;
+        shard.usage[index] = usage;
+        shard.retirements[index] = number;
+        live.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    retired.push_back(Retirement{pid, number});
+    evictRetired();
+    return true;
+}
+
+/**
+ * @brief Drops the oldest terminated entries beyond the retention limit
+ *
+ * Must be called with retiredMutex held. A queue entry only evicts the
+ * termination it was queued for: if the PID was reused since, the entry is
+ * skipped, whether the new process is running or has terminated too.
+ */
+void ProcessTable::evictRetired() {
+    while (retired.size() > maxRetired) {
+        Retirement entry = retired.front();
+        retired.pop_front();
+
+        Shard& shard = shardFor(entry.pid);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        Slot* slot = findSlot(shard, entry.pid);
+        if (slot != nullptr && slot->state == ProcessState::TERMINATED &&
+            shard.retirements[static_cast<size_t>(slot - shard.slots.data())] == entry.number) {
+            eraseSlot(shard, slot);
+        }
+    }
+}
+
+/**
+ * @brief Changes the state of a process
+ *
+ * @param pid Process ID
+ * @param state New state; TERMINATED behaves like markTerminated()
+ *        without a new exit status
+ * @return false if pid is unknown (or, for TERMINATED, already terminated)
+ */
+bool ProcessTable::setState(pid_t pid, ProcessState state) {
+    Shard& shard = shardFor(pid);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    Slot* slot = findSlot(shard, pid);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    if (state == ProcessState::TERMINATED) {
+        int exitStatus = slot->exitStatus;
+        lock.unlock();
+        return markTerminated(pid, exitStatus);
+    }
+    if (slot->state == ProcessState::TERMINATED) {
+        live.fetch_add(1, std::memory_order_acq_rel);
+    }
+    slot->state = state;
+    return true;
+}
+
+/**
+ * @brief Removes an entry
+ *
+ * @param pid Process ID
+ * @return true if the entry existed
+ */
+bool ProcessTable::erase(pid_t pid) {
+    Shard& shard = shardFor(pid);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    Slot* slot = findSlot(shard, pid);
+    if (slot == nullptr) {
+        return false;
+    }
+    eraseSlot(shard, slot);
+    return true;
+}
+
+/**
+ * @brief Looks up a process
+ *
+ * @param pid Process ID
+ * @return A snapshot of the entry, or nullopt
+ */
+std::optional<ProcessRecord> ProcessTable::find(pid_t pid) const {
+    const Shard& shard = shardFor(pid);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    const Slot* slot = findSlot(shard, pid);
+    if (slot == nullptr) {
+        return std::nullopt;
+    }
+    return ProcessRecord{slot->pid, slot->state, slot->exitStatus, names.lookup(slot->nameId),
+                         shard.usage[static_cast<size_t>(slot - shard.slots.data())]};
+}
+
+/**
+ * @brief Removes every terminated entry now
+ *
+ * @return Number of entries removed
+ */
+size_t ProcessTable::purgeTerminated() {
+    size_t removed = 0;
+    for (Shard& shard : shards) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        for (size_t i = 0; i < shard.slots.size();) {
+            Slot& slot = shard.slots[i];
+            if (slot.pid != 0 && slot.state == ProcessState::TERMINATED) {
+                eraseSlot(shard, &slot);   // May shift another entry into i
+                removed++;
+            } else {
+                i++;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    retired.clear();
+    return removed;
+}
+
+/**
+ * @brief Changes how many terminated entries are retained
+ *
+ * @param maxTerminated New limit; excess entries are evicted at once
+ */
+void ProcessTable::setRetention(size_t maxTerminated) {
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    maxRetired = maxTerminated;
+    evictRetired();
+}
+
+/**
+ * @brief Queries the retention limit
+ *
+ * @return Terminated entries kept before eviction
+ */
+size_t ProcessTable::getRetention() {
+    std::lock_guard<std::mutex> lock(retiredMutex);
+    return maxRetired;
+}
+
+} // namespace PTManager
@@ -0,0 +1,695 @@
+#include "ShmRingBuffer.h"
+#include "Futex.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <cstring>
+#include <new>
+#include <thread>
+
+namespace PTManager {
+
+namespace {
+
+constexpr uint32_t RING_MAGIC = 0x52494e47; // "RING"
+constexpr int SPIN_ATTEMPTS = 64;
+
+size_t recordSize(size_t length) {
+    constexpr size_t align = ShmRingBuffer::RECORD_ALIGN;
+    return (ShmRingBuffer::RECORD_HEADER_SIZE + length + align - 1) & ~(align - 1);
+}
+
+// Trace id of a ring: its control block's address in this process
+uint64_t traceChannel(const void* control) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(control));
+}
+
+uint64_t committedState(uint64_t position) { return 2 * position + 1; }
+uint64_t consumedState(uint64_t position) { return 2 * position + 2; }
+
+} // namespace
+
+// ===== ShmRingBuffer Implementation =====
+
+/**
+ * @brief Constructs a ring endpoint over a shared memory object
+ *
+ * @param shm Shared memory holding the ring; must be mapped before
+ *            initialize() or attach() and outlive this object
+ */
+ShmRingBuffer::ShmRingBuffer(SharedMemory& shm)
+    : memory(shm), control(nullptr), data(nullptr), mask(0), cachedHead(0), cachedTail(0) {}
+
+/**
+ * @brief Computes the shared memory size needed for a ring
+ *
+ * @param dataCapacity Minimum size of the data area in bytes
+ * @return Size to pass to the SharedMemory constructor
+ *
+ * The data area is rounded up to a power of two.
+ */
+size_t ShmRingBuffer::requiredSize(size_t dataCapacity) {
+    size_t capacity = 4 * RECORD_ALIGN;
+    while (capacity < dataCapacity) {
+        capacity <<= 1;
+    }
+    return sizeof(ControlBlock) + capacity;
+}
+
+/**
+ * @brief Formats the mapped region as an empty ring
+ *
+ * @param mode SPSC or MPMC; stored in the region so attach() picks it up
+ * @return true on success, false if the region is unmapped or too small
+ *
+ * Called once by the creating process, before any other endpoint attaches.
+ * The largest power of two that fits after the control block becomes the
+ * data area.
+ */
+bool ShmRingBuffer::initialize(RingMode mode) {
+    char* base = static_cast<char*>(memory.getAddress());
+    if (base == nullptr || memory.getSize() < requiredSize(0)) {
+        PTM_LOG_ERROR("Failed to initialize ring buffer: shared memory not mapped or too small");
+        return false;
+    }
+
+    uint64_t capacity = 4 * RECORD_ALIGN;
+    while (sizeof(ControlBlock) + capacity * 2 <= memory.getSize()) {
+        capacity <<= 1;
+    }
+
+    std::memset(base, 0, sizeof(ControlBlock) + capacity);
+    control = new (base) ControlBlock{};
+    control->mode = mode;
+    control->capacity = capacity;
+    control->magic = RING_MAGIC;
+
+    data = base + sizeof(ControlBlock);
+    mask = capacity - 1;
+    cachedHead = cachedTail = 0;
+    return true;
+}
+
+/**
+ * @brief Connects to a ring another process initialized
+ *
+ * @return true if the mapped region holds a valid ring
+ */
+bool ShmRingBuffer::attach() {
+    char* base = static_cast<char*>(memory.getAddress());
+    if (base == nullptr || memory.getSize() < requiredSize(0)) {
+        PTM_LOG_ERROR("Failed to attach ring buffer: shared memory not mapped or too small");
+        return false;
+    }
+
+    ControlBlock* block = reinterpret_cast<ControlBlock*>(base);
+    uint64_t capacity = block->capacity;
+    if (block->magic != RING_MAGIC || capacity == 0 || (capacity & (capacity - 1)) != 0 ||
+        sizeof(ControlBlock) + capacity > memory.getSize()) {
+        PTM_LOG_ERROR("Failed to attach ring buffer: region is not an initialized ring");
+        return false;
+    }
+
+    control = block;
+    data = base + sizeof(ControlBlock);
+    mask = capacity - 1;
+    cachedHead = control->head.load(std::memory_order_acquire);
+    cachedTail = control->tail.load(std::memory_order_acquire);
+    return true;
+}
+
+/**
+ * @brief Queries the largest payload a single record can carry
+ *
+ * @return Maximum message size in bytes
+ *
+ * Half the data area, so a record plus its wrap padding always fits.
+ */
+size_t ShmRingBuffer::maxRecordSize() const {
+    return getCapacity() / 2 - RECORD_HEADER_SIZE;
+}
+
+/**
+ * @brief Queries the bytes currently occupied by unreleased records
+ *
+ * @return Occupied bytes, including headers and padding
+ */
+size_t ShmRingBuffer::usedBytes() const {
+    uint64_t head = control->head.load(std::memory_order_acquire);
+    uint64_t tail = control->tail.load(std::memory_order_acquire);
+    return static_cast<size_t>(tail - head);
+}
+
+/**
+ * @brief Checks whether there is nothing left to read
+ *
+ * @return true if no record is waiting to be claimed
+ */
+bool ShmRingBuffer::empty() const {
+    const std::atomic<uint64_t>& readPosition =
+        control->mode == RingMode::MPMC ? control->claim : control->head;
+    return readPosition.load(std::memory_order_acquire) ==
+           control->tail.load(std::memory_order_acquire);
+}
+
+/**
+ * @brief Appends a record without blocking
+ *
+ * @param payload Message bytes
+ * @param size Message length; at most maxRecordSize()
+ * @return true if the record was published, false if the ring is full or
+ *         the record is too large
+ */
+bool ShmRingBuffer::tryWrite(const void* payload, size_t size) {
+    TraceSpan span(TraceEventType::IPC_SEND, traceChannel(control), -1);
+    Reservation slot = tryReserve(size);
+    if (!slot) {
+        return false;
+    }
+    if (size > 0) {
+        std::memcpy(slot.data.data(), payload, size);
+    }
+    commit(slot);
+    span.setValue(static_cast<int64_t>(size));
+    return true;
+}
+
+/**
+ * @brief Appends a record, waiting while the ring is full
+ *
+ * @param payload Message bytes
+ * @param size Message length; at most maxRecordSize()
+ * @param timeout Maximum time to wait for space; max() waits forever
+ * @return true if the record was published, false on timeout or if the
+ *         record is too large
+ */
+bool ShmRingBuffer::write(const void* payload, size_t size, std::chrono::milliseconds timeout) {
+    TraceSpan span(TraceEventType::IPC_SEND, traceChannel(control), -1);
+    Reservation slot = reserve(size, timeout);
+    if (!slot) {
+        return false;
+    }
+    if (size > 0) {
+        std::memcpy(slot.data.data(), payload, size);
+    }
+    commit(slot);
+    span.setValue(static_cast<int64_t>(size));
+    return true;
+}
+
+/**
+ * @brief Reserves space for a record without blocking
+ *
+ * @param size Payload length; at most maxRecordSize()
+ * @return Reservation whose data span points into the ring, or an empty
+ *         reservation if the ring is full or the record is too large
+ *
+ * The payload is produced in place and published by commit(). In SPSC mode
+ * the producer may hold only one reservation at a time.
+ */
+ShmRingBuffer::Reservation ShmRingBuffer::tryReserve(size_t size) {
+    if (size > maxRecordSize()) {
+        return {};
+    }
+    return control->mode == RingMode::MPMC ? reserveMpmc(size) : reserveSpsc(size);
+}
+
+/**
+ * @brief Reserves space for a record, waiting while the ring is full
+ *
+ * @param size Payload length; at most maxRecordSize()
+ * @param timeout Maximum time to wait for space; max() waits forever
+ * @return Reservation into the ring, empty on timeout or oversized record
+ */
+ShmRingBuffer::Reservation ShmRingBuffer::reserve(size_t size, std::chrono::milliseconds timeout) {
+    if (size > maxRecordSize()) {
+        return {};
+    }
+
+    Reservation slot;
+    blockUntil(control->spaceSignal, control->writersWaiting, timeout, [&] {
+        slot = tryReserve(size);
+        return static_cast<bool>(slot);
+    });
+    return slot;
+}
+
+/**
+ * @brief Publishes a reserved record to readers
+ *
+ * @param slot Reservation returned by tryReserve() or reserve(), with its
+ *             whole data span filled in
+ *
+ * MPMC reservations may be committed in any order; readers see them in
+ * reservation order.
+ */
+void ShmRingBuffer::commit(const Reservation& slot) {
+    if (control->mode == RingMode::MPMC) {
+        recordAt(slot.position)->state.store(committedState(slot.position), std::memory_order_release);
+    } else {
+        control->tail.store(slot.end, std::memory_order_release);
+    }
+    signalReaders();
+}
+
+/**
+ * @brief Takes the next record in place without blocking
+ *
+ * @return Record whose data span points into the ring, or an empty record
+ *         if nothing is ready
+ *
+ * The bytes stay valid, and the space stays occupied, until release().
+ */
+ShmRingBuffer::Record ShmRingBuffer::tryPeek() {
+    Record record;
+    claim(SIZE_MAX, record);
+    return record;
+}
+
+/**
+ * @brief Takes the next record in place, waiting while the ring is empty
+ *
+ * @param timeout Maximum time to wait; max() waits forever
+ * @return Record pointing into the ring, empty on timeout
+ */
+ShmRingBuffer::Record ShmRingBuffer::peek(std::chrono::milliseconds timeout) {
+    Record record;
+    blockUntil(control->dataSignal, control->readersWaiting, timeout,
+               [&] { return claim(SIZE_MAX, record) > 0; });
+    return record;
+}
+
+/**
+ * @brief Returns the space of a peeked record to writers
+ *
+ * @param record Record returned by tryPeek() or peek()
+ */
+void ShmRingBuffer::release(const Record& record) {
+    if (control->mode == RingMode::MPMC) {
+        recordAt(record.position)->state.store(consumedState(record.position), std::memory_order_seq_cst);
+        releaseConsumed();
+    } else {
+        control->head.store(record.end, std::memory_order_release);
+        signalWriters();
+    }
+}
+
+/**
+ * @brief Takes the next record without blocking
+ *
+ * @param buffer Destination for the payload
+ * @param capacity Size of buffer
+ * @param length Receives the payload length (or the required size if
+ *               buffer is too small)
+ * @return true if a record was read
+ */
+bool ShmRingBuffer::tryRead(void* buffer, size_t capacity, size_t& length) {
+    TraceSpan span(TraceEventType::IPC_RECEIVE, traceChannel(control), -1);
+    Record record;
+    int result = claim(capacity, record);
+    if (result == 0) {
+        return false;
+    }
+
+    length = record.data.size();
+    if (result < 0) {
+        return false;
+    }
+    if (length > 0) {
+        std::memcpy(buffer, record.data.data(), length);
+    }
+    release(record);
+    span.setValue(static_cast<int64_t>(length));
+    return true;
+}
+
+/**
+ * @brief Takes the next record, waiting while the ring is empty
+ *
+ * @param buffer Destination for the payload
+ * @param capacity Size of buffer
+ * @param length Receives the payload length (or the required size if
+ *               buffer is too small)
+ * @param timeout Maximum time to wait; max() waits forever
+ * @return true if a record was read; false on timeout or if the next
+ *         record does not fit in buffer
+ */
+bool ShmRingBuffer::read(void* buffer, size_t capacity, size_t& length, std::chrono::milliseconds timeout) {
+    TraceSpan span(TraceEventType::IPC_RECEIVE, traceChannel(control), -1);
+    Record record;
+    int result = 0;
+    if (!blockUntil(control->dataSignal, control->readersWaiting, timeout,
+                    [&] { return (result = claim(capacity, record)) != 0; })) {
+        return false;
+    }
+
+    length = record.data.size();
+    if (result < 0) {
+        return false;
+    }
+    if (length > 0) {
+        std::memcpy(buffer, record.data.data(), length);
+    }
+    release(record);
+    span.setValue(static_cast<int64_t>(length));
+    return true;
+}
+
+/**
+ * @brief Takes the next record into a vector without blocking
+ *
+ * @param message Replaced by the payload
+ * @return true if a record was read
+ */
+bool ShmRingBuffer::tryRead(std::vector<char>& message) {
+    TraceSpan span(TraceEventType::IPC_RECEIVE, traceChannel(control), -1);
+    Record record = tryPeek();
+    if (!record) {
+        return false;
+    }
+    const char* bytes = reinterpret_cast<const char*>(record.data.data());
+    message.assign(bytes, bytes + record.data.size());
+    release(record);
+    span.setValue(static_cast<int64_t>(message.size()));
+    return true;
+}
+
+/**
+ * @brief Takes the next record into a vector, waiting while the ring is empty
+ *
+ * @param message Replaced by the payload
+ * @param timeout Maximum time to wait; max() waits forever
+ * @return true if a record was read, false on timeout
+ */
+bool ShmRingBuffer::read(std::vector<char>& message, std::chrono::milliseconds timeout) {
+    TraceSpan span(TraceEventType::IPC_RECEIVE, traceChannel(control), -1);
+    Record record = peek(timeout);
+    if (!record) {
+        return false;
+    }
+    const char* bytes = reinterpret_cast<const char*>(record.data.data());
+    message.assign(bytes, bytes + record.data.size());
+    release(record);
+    span.setValue(static_cast<int64_t>(message.size()));
+    return true;
+}
+
+/**
+ * @brief Claims the next record for this reader
+ *
+ * @param maxLength Largest payload the caller accepts
+ * @param record Receives the claimed record; on -1 only its data size is set
+ * @return 1 if a record was claimed, 0 if nothing is ready, -1 if the next
+ *         record is larger than maxLength (it stays queued)
+ */
+int ShmRingBuffer::claim(size_t maxLength, Record& record) {
+    return control->mode == RingMode::MPMC ? claimMpmc(maxLength, record) : claimSpsc(maxLength, record);
+}
+
+/**
+ * @brief Retries an operation, sleeping on a futex word between attempts
+ *
+ * @param signal Futex word the other side bumps after making progress
+ * @param waiting Sleeper count the other side checks before bumping
+ * @param timeout Maximum time to wait; max() waits forever
+ * @param attempt Returns true once the operation succeeded
+ * @return true if attempt succeeded, false on timeout
+ *
+ * Spins (yielding) for a few attempts first. Before sleeping the waiter
+ * registers itself and retries once more, and the other side publishes
+ * before checking for waiters, so a wakeup cannot fall between the two.
+ */
+template<typename Attempt>
+bool ShmRingBuffer::blockUntil(std::atomic<uint32_t>& signal, std::atomic<uint32_t>& waiting,
+                               std::chrono::milliseconds timeout, Attempt&& attempt) {
+    for (int i = 0; i < SPIN_ATTEMPTS; ++i) {
+        if (attempt()) {
+            return true;
+        }
+        std::this_thread::yield();
+    }
+
+    bool forever = timeout == std::chrono::milliseconds::max();
+    auto deadline = forever ? std::chrono::steady_clock::time_point::max()
+                            : std::chrono::steady_clock::now() + timeout;
+
+    while (true) {
+        uint32_t observed = signal.load(std::memory_order_acquire);
+        waiting.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (attempt()) {
+            waiting.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        std::chrono::nanoseconds remaining = std::chrono::nanoseconds::max();
+        if (!forever) {
+            remaining = deadline - std::chrono::steady_clock::now();
+            if (remaining.count() <= 0) {
+                waiting.fetch_sub(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+
+        futexWait(signal, observed, remaining);
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Wakes readers sleeping on an empty ring, if there are any
+ */
+void ShmRingBuffer::signalReaders() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (control->readersWaiting.load(std::memory_order_relaxed) > 0) {
+        control->dataSignal.fetch_add(1, std::memory_order_release);
+        futexWake(control->dataSignal);
+    }
+}
+
+/**
+ * @brief Wakes writers sleeping on a full ring, if there are any
+ */
+void ShmRingBuffer::signalWriters() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (control->writersWaiting.load(std::memory_order_relaxed) > 0) {
+        control->spaceSignal.fetch_add(1, std::memory_order_release);
+        futexWake(control->spaceSignal);
+    }
+}
+
+/**
+ * @brief Single-producer reservation
+ *
+ * The producer owns tail and only re-reads head when its cached copy says
+ * the ring is full. Nothing is visible to the reader until commit() stores
+ * the new tail.
+ */
+ShmRingBuffer::Reservation ShmRingBuffer::reserveSpsc(size_t size) {
+    uint64_t capacity = control->capacity;
+    uint64_t tail = control->tail.load(std::memory_order_relaxed);
+    uint64_t need = recordSize(size);
+    uint64_t contiguous = capacity - (tail & mask);
+    uint64_t total = need > contiguous ? contiguous + need : need;
+
+    if (tail + total - cachedHead > capacity) {
+        cachedHead = control->head.load(std::memory_order_acquire);
+        if (tail + total - cachedHead > capacity) {
+            return {};
+        }
+    }
+
+    uint64_t position = tail;
+    if (need > contiguous) {
+        RecordHeader* pad = recordAt(position);
+        pad->length.store(static_cast<uint32_t>(contiguous - RECORD_HEADER_SIZE), std::memory_order_relaxed);
+        pad->padding.store(1, std::memory_order_relaxed);
+        position += contiguous;
+    }
+
+    RecordHeader* record = recordAt(position);
+    record->length.store(static_cast<uint32_t>(size), std::memory_order_relaxed);
+    record->padding.store(0, std::memory_order_relaxed);
+    return Reservation{{payloadOf(record), size}, position, tail + total};
+}
+
+/**
+ * @brief Single-consumer claim
+ *
+ * Padding records are skipped (and released) on the way. The record's
+ * space is handed back by release().
+ */
+int ShmRingBuffer::claimSpsc(size_t maxLength, Record& record) {
+    uint64_t head = control->head.load(std::memory_order_relaxed);
+
+    while (true) {
+        if (head == cachedTail) {
+            cachedTail = control->tail.load(std::memory_order_acquire);
+            if (head == cachedTail) {
+                return 0;
+            }
+        }
+
+        RecordHeader* header = recordAt(head);
+        uint32_t recordLength = header->length.load(std::memory_order_relaxed);
+
+        if (header->padding.load(std::memory_order_relaxed) != 0) {
+            head += recordLength + RECORD_HEADER_SIZE;
+            control->head.store(head, std::memory_order_release);
+            continue;
+        }
+
+        record.data = {payloadOf(header), recordLength};
+        if (recordLength > maxLength) {
+            return -1;
+        }
+        record.position = head;
+        record.end = head + recordSize(recordLength);
+        return 1;
+    }
+}
+
+/**
+ * @brief Multi-producer reservation
+ *
+ * Producers reserve space by advancing tail with a CAS; commit() then stores
+ * the record's position-tagged state. Records may be committed out of
+ * order; readers wait at the first uncommitted one.
+ */
+ShmRingBuffer::Reservation ShmRingBuffer::reserveMpmc(size_t size) {
+    uint64_t capacity = control->capacity;
+    uint64_t need = recordSize(size);
+    uint64_t tail = control->tail.load(std::memory_order_relaxed);
+    uint64_t contiguous;
+    uint64_t total;
+
+    while (true) {
+        contiguous = capacity - (tail & mask);
+        total = need > contiguous ? contiguous + need : need;
+
+        uint64_t head = control->head.load(std::memory_order_acquire);
+        if (tail + total > head + capacity) {
+            uint64_t current = control->tail.load(std::memory_order_relaxed);
+            if (current == tail) {
+                return {};
+            }
+            tail = current;
+            continue;
+        }
+
+        if (control->tail.compare_exchange_weak(tail, tail + total, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    uint64_t position = tail;
+    if (need > contiguous) {
+        RecordHeader* pad = recordAt(position);
+        pad->length.store(static_cast<uint32_t>(contiguous - RECORD_HEADER_SIZE), std::memory_order_relaxed);
+        pad->padding.store(1, std::memory_order_relaxed);
+        pad->state.store(committedState(position), std::memory_order_release);
+        position += contiguous;
+    }
+
+    RecordHeader* record = recordAt(position);
+    record->length.store(static_cast<uint32_t>(size), std::memory_order_relaxed);
+    record->padding.store(0, std::memory_order_relaxed);
+    return Reservation{{payloadOf(record), size}, position, tail + total};
+}
+
+/**
+ * @brief Multi-consumer claim
+ *
+ * Readers claim the committed record at claim with a CAS; release() marks
+ * it consumed and releaseConsumed() moves head over consumed records in
+ * order so writers can reuse the space. A reader holding a stale claim may
+ * probe a slot a writer is already refilling; the position-tagged state and
+ * the CAS on claim reject such probes.
+ */
+int ShmRingBuffer::claimMpmc(size_t maxLength, Record& record) {
+    uint64_t position = control->claim.load(std::memory_order_acquire);
+
+    while (true) {
+        if (position == control->tail.load(std::memory_order_acquire)) {
+            return 0;
+        }
+
+        RecordHeader* header = recordAt(position);
+        if (header->state.load(std::memory_order_acquire) != committedState(position)) {
+            uint64_t current = control->claim.load(std::memory_order_acquire);
+            if (current == position) {
+                return 0; // Writer has reserved but not committed yet
+            }
+            position = current;
+            continue;
+        }
+
+        uint32_t recordLength = header->length.load(std::memory_order_relaxed);
+        bool padding = header->padding.load(std::memory_order_relaxed) != 0;
+        uint64_t size = padding ? recordLength + RECORD_HEADER_SIZE : recordSize(recordLength);
+
+        if (!padding && recordLength > maxLength) {
+            // Only report the size if the record was still ours to read
+            if (header->state.load(std::memory_order_acquire) == committedState(position)) {
+                record.data = {payloadOf(header), recordLength};
+                return -1;
+            }
+            position = control->claim.load(std::memory_order_acquire);
+            continue;
+        }
+
+        if (!control->claim.compare_exchange_weak(position, position + size, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        if (padding) {
+            header->state.store(consumedState(position), std::memory_order_seq_cst);
+            releaseConsumed();
+            position += size;
+            continue;
+        }
+
+        record.data = {payloadOf(header), recordLength};
+        record.position = position;
+        record.end = position + size;
+        return 1;
+    }
+}
+
+/**
+ * @brief Advances head over the consumed records at the front of the ring
+ *
+ * Whoever swaps a consumed state to 0 owns the release of that record, so
+ * head moves strictly in order even with many readers. The state words of
+ * every slot inside the record are cleared before head passes it, so a
+ * reader never mistakes old bytes for a committed header on a later lap.
+ */
+void ShmRingBuffer::releaseConsumed() {
+    bool released = false;
+    uint64_t head = control->head.load(std::memory_order_seq_cst);
+
+    while (true) {
+        RecordHeader* record = recordAt(head);
+        uint64_t expected = consumedState(head);
+        if (!record->state.compare_exchange_strong(expected, 0, std::memory_order_seq_cst)) {
+            break;
+        }
+
+        uint32_t recordLength = record->length.load(std::memory_order_relaxed);
+        bool padding = record->padding.load(std::memory_order_relaxed) != 0;
+        uint64_t size = padding ? recordLength + RECORD_HEADER_SIZE : recordSize(recordLength);
+        for (uint64_t offset = RECORD_ALIGN; offset < size; offset += RECORD_ALIGN) {
+            recordAt(head + offset)->state.store(0, std::memory_order_relaxed);
+        }
+
+        head += size;
+        control->head.store(head, std::memory_order_seq_cst);
+        released = true;
+    }
+
+    if (released) {
+        signalWriters();
+    }
+}
+
+} // namespace PTManager
@@ -1,21 +1,162 @@
 #include "Synchronization.h"
-#include <iostream>
+#include "Futex.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <csignal>
+#include <ctime>
+#include <algorithm>
+#include <sched.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 namespace PTManager {
 
+namespace {
+
+constexpr uint32_t MIN_SPIN_ROUNDS = 4;
+constexpr uint32_t MAX_SPIN_ROUNDS = 100;
+constexpr uint32_t MAX_BACKOFF_PAUSES = 64;
+constexpr uint32_t SPINLOCK_ROUNDS_BEFORE_YIELD = 16;
+
+// Tells the CPU we are busy-waiting: saves power and frees the core's
+// resources for a sibling hyperthread
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+// Spinning only helps if the holder can run at the same time
+bool spinningUseful() {
+    static const bool multiCore = std::thread::hardware_concurrency() > 1;
+    return multiCore;
+}
+
+// Trace id of a lock: its address
+uint64_t traceLockId(const void* lock) {
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(lock));
+}
+
+} // namespace
+
+// ===== AdaptiveMutex Implementation =====
+
+/**
+ * @brief Constructs an unlocked mutex
+ */
+AdaptiveMutex::AdaptiveMutex() : state(0), spinEstimate(MIN_SPIN_ROUNDS) {}
+
+/**
+ * @brief Spins for the lock before the caller parks
+ *
+ * @return true if the lock was acquired
+ *
+ * Tries at most twice the rounds recent successful spins needed (bounded
+ * by MAX_SPIN_ROUNDS), pausing 1, 2, 4, ... up to MAX_BACKOFF_PAUSES times
+ * between reads of the lock word. The estimate follows the rounds that won
+ * the lock and shrinks when spinning fails, so locks that are held long stop
+ * wasting cycles.
+ */
+bool AdaptiveMutex::spinAcquire() {
+    if (!spinningUseful()) {
+        return false;
+    }
+
+    uint32_t estimate = spinEstimate.load(std::memory_order_relaxed);
+    uint32_t limit = std::min(MAX_SPIN_ROUNDS, estimate * 2 + MIN_SPIN_ROUNDS);
+    uint32_t backoff = 1;
+    for (uint32_t round = 0; round < limit; ++round) {
+        for (uint32_t i = 0; i < backoff; ++i) {
+            cpuRelax();
+        }
+        backoff = std::min(backoff * 2, MAX_BACKOFF_PAUSES);
+
+        uint32_t expected = 0;
+        if (state.load(std::memory_order_relaxed) == 0 &&
+            state.compare_exchange_weak(expected, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+            int32_t delta = static_cast<int32_t>(round) - static_cast<int32_t>(estimate);
+            spinEstimate.store(static_cast<uint32_t>(static_cast<int32_t>(estimate) + delta / 8),
+                               std::memory_order_relaxed);
+            return true;
+        }
+    }
+    spinEstimate.store(estimate - estimate / 8, std::memory_order_relaxed);
+    return false;
+}
+
+/**
+ * @brief Contended acquisition: spin, then sleep on the lock word
+ *
+ * @param deadline Give up at this point; time_point::max() waits forever
+ * @return true if the lock was acquired
+ *
+ * A parked locker marks the word 2 so that unlock() knows to wake someone.
+ * The winner of a wakeup keeps the mark, since others may still sleep.
+ * The whole call is traced as a LOCK_WAIT span.
+ */
+bool AdaptiveMutex::lockSlow(std::chrono::steady_clock::time_point deadline) {
+    using Clock = std::chrono::steady_clock;
+    TraceSpan wait(TraceEventType::LOCK_WAIT, traceLockId(this));
+
+    if (spinAcquire()) {
+        return true;
+    }
+
+    while (state.exchange(2, std::memory_order_acquire) != 0) {
+        std::chrono::nanoseconds remaining = std::chrono::nanoseconds::max();
+        if (deadline != Clock::time_point::max()) {
+            Clock::time_point now = Clock::now();
+            if (now >= deadline) {
+                return false;
+            }
+            remaining = deadline - now;
+        }
+        futexWait(state, 2, remaining);
+    }
+    return true;
+}
+
+/**
+ * @brief Acquires the mutex, waiting at most timeout
+ *
+ * @param timeout Maximum wait; milliseconds::max() waits forever
+ * @return true if the lock was acquired
+ */
+bool AdaptiveMutex::tryLockFor(std::chrono::milliseconds timeout) {
+    using Clock = std::chrono::steady_clock;
+    if (tryLock()) {
+        return true;
+    }
+    bool forever = timeout == std::chrono::milliseconds::max();
+    return lockSlow(forever ? Clock::time_point::max() : Clock::now() + timeout);
+}
+
+/**
+ * @brief Wakes one parked locker after an unlock of a contended mutex
+ */
+void AdaptiveMutex::wakeOne() {
+    futexWake(state, 1);
+}
+
 // ===== SafeMutex Implementation =====
 
 /**
  * @brief Constructs a SafeMutex with deadlock detection capabilities
  *
  * @param mutexName Identifier for debugging and error messages (defaults to "unnamed")
+ * @param trackOwner Record the owner to detect recursive locking; false
+ *        leaves only the lock itself on the fast path
  *
  * Initializes the mutex with no owner and zero lock count.
  * The name helps identify which mutex is involved in deadlock situations.
  */
-SafeMutex::SafeMutex(const std::string& mutexName)
-    : name(mutexName.empty() ? "unnamed" : mutexName),
-      owner(std::thread::id()), lockCount(0) {}
+SafeMutex::SafeMutex(const std::string& mutexName, bool trackOwner)
+    : name(mutexName.empty() ? "unnamed" : mutexName), tracking(trackOwner),
+      owner(std::thread::id()), lockCount(0), probe("SafeMutex", name) {}
 
 /**
  * @brief Attempts to acquire the mutex with timeout and recursive lock detection
@@ -26,25 +167,41 @@ SafeMutex::SafeMutex(const std::string& mutexName)
  * Detects and prevents recursive locking by the same thread, which would cause deadlock.
  * Uses timed locking to detect potential deadlocks when timeout expires.
  * Updates owner thread ID and increments lock count on successful acquisition.
+ * Without tracking, an uncontended call is just the lock's compare-and-swap.
  */
 bool SafeMutex::lock(std::chrono::milliseconds timeout) {
+    if (!tracking) {
+        uint64_t start = probe.beforeAcquire();
+        bool contended = !mtx.tryLock();
+        if (!contended || mtx.tryLockFor(timeout)) {
+            probe.afterAcquire(start, contended);
+            return true;
+        }
+        PTM_LOG_WARN("Deadlock warning: Thread " << std::this_thread::get_id()
+                     << " timeout waiting for mutex '" << name << "'");
+        return false;
+    }
+
     auto thisThreadId = std::this_thread::get_id();
 
     // Check for recursive locking (potential deadlock)
     if (owner.load() == thisThreadId) {
-        std::cerr << "Warning: Thread " << thisThreadId
-                  << " attempting to recursively lock mutex '" << name << "'" << std::endl;
+        PTM_LOG_WARN("Warning: Thread " << thisThreadId
+                     << " attempting to recursively lock mutex '" << name << "'");
         return false;
     }
 
-    if (mtx.try_lock_for(timeout)) {
+    uint64_t start = probe.beforeAcquire();
+    bool contended = !mtx.tryLock();
+    if (!contended || mtx.tryLockFor(timeout)) {
+        probe.afterAcquire(start, contended);
         owner.store(thisThreadId);
         lockCount++;
         return true;
     }
 
-    std::cerr << "Deadlock warning: Thread " << thisThreadId
-              << " timeout waiting for mutex '" << name << "'" << std::endl;
+    PTM_LOG_WARN("Deadlock warning: Thread " << thisThreadId
+                 << " timeout waiting for mutex '" << name << "'");
     return false;
 }
 
@@ -57,14 +214,16 @@ bool SafeMutex::lock(std::chrono::milliseconds timeout) {
  * Updates owner and lock count on success.
  */
 bool SafeMutex::tryLock() {
-    auto thisThreadId = std::this_thread::get_id();
-
-    if (mtx.try_lock()) {
-        owner.store(thisThreadId);
+    uint64_t start = probe.beforeAcquire(false);
+    if (!mtx.tryLock()) {
+        return false;
+    }
+    probe.afterAcquire(start, false);
+    if (tracking) {
+        owner.store(std::this_thread::get_id());
         lockCount++;
-        return true;
     }
-    return false;
+    return true;
 }
 
 /**
@@ -74,8 +233,11 @@ bool SafeMutex::tryLock() {
  * Caller must ensure they own the lock before calling.
  */
 void SafeMutex::unlock() {
-    owner.store(std::thread::id());
-    lockCount--;
+    probe.beforeRelease();
+    if (tracking) {
+        owner.store(std::thread::id());
+        lockCount--;
+    }
     mtx.unlock();
 }
 
@@ -84,10 +246,11 @@ void SafeMutex::unlock() {
  *
  * @return true if any thread owns the lock, false otherwise
  *
- * Thread-safe query that checks if owner is set to a valid thread ID.
+ * Thread-safe query that checks if owner is set to a valid thread ID, or
+ * the lock word itself when tracking is off.
  */
 bool SafeMutex::isLocked() const {
-    return owner.load() != std::thread::id();
+    return tracking ? owner.load() != std::thread::id() : mtx.isLocked();
 }
 
 // ===== SafeLockGuard Implementation =====
@@ -134,13 +297,12 @@ SafeLockGuard::~SafeLockGuard() {
  * Logs error if initialization fails.
  */
 Semaphore::Semaphore(unsigned int value, const std::string& semName)
-    : name(semName.empty() ? "unnamed" : semName), initialized(false) {
+    : name(semName.empty() ? "unnamed" : semName), initialized(false), probe("Semaphore", name, false) {
 
     if (sem_init(&sem, 0, value) == 0) {
         initialized = true;
     } else {
-        std::cerr << "Failed to initialize semaphore '" << name << "': "
-                  << strerror(errno) << std::endl;
+        PTM_LOG_ERROR("Failed to initialize semaphore '" << name << "': " << strerror(errno));
     }
 }
 
@@ -166,7 +328,16 @@ Semaphore::~Semaphore() {
  */
 bool Semaphore::wait() {
     if (!initialized) return false;
-    return sem_wait(&sem) == 0;
+    uint64_t start = probe.beforeAcquire();
+    bool contended = sem_trywait(&sem) != 0;
+    if (contended) {
+        TraceSpan wait(TraceEventType::LOCK_WAIT, traceLockId(this));
+        if (sem_wait(&sem) != 0) {
+            return false;
+        }
+    }
+    probe.afterAcquire(start, contended);
+    return true;
 }
 
 /**
@@ -178,7 +349,12 @@ bool Semaphore::wait() {
  */
 bool Semaphore::tryWait() {
     if (!initialized) return false;
-    return sem_trywait(&sem) == 0;
+    uint64_t start = probe.beforeAcquire(false);
+    if (sem_trywait(&sem) != 0) {
+        return false;
+    }
+    probe.afterAcquire(start, false);
+    return true;
 }
 
 /**
@@ -200,7 +376,13 @@ bool Semaphore::timedWait(std::chrono::milliseconds timeout) {
     ts.tv_sec += timeout.count() / 1000 + nsec / 1000000000;
     ts.tv_nsec = nsec % 1000000000;
 
-    return sem_timedwait(&sem, &ts) == 0;
+    uint64_t start = probe.beforeAcquire();
+    bool contended = sem_trywait(&sem) != 0;
+    if (contended && sem_timedwait(&sem, &ts) != 0) {
+        return false;
+    }
+    probe.afterAcquire(start, contended);
+    return true;
 }
 
 /**
@@ -241,8 +423,11 @@ int Semaphore::getValue() {
  *
  * Initializes counters for tracking active readers, writers, and waiting writers.
  * Writer preference prevents reader starvation of writers.
+ *
+ * @param lockName Identifier in lock profiles (defaults to RWLock#<n>)
  */
-RWLock::RWLock() : readers(0), writers(0), waitingWriters(0) {}
+RWLock::RWLock(const std::string& lockName)
+    : readers(0), writers(0), waitingWriters(0), probe("RWLock", lockName) {}
 
 /**
  * @brief Acquires a read lock (shared access)
@@ -252,14 +437,21 @@ RWLock::RWLock() : readers(0), writers(0), waitingWriters(0) {}
  * waiting writers to get their turn before allowing new readers.
  */
 void RWLock::readLock() {
+    uint64_t start = probe.beforeAcquire();
     std::unique_lock<std::mutex> lock(mutex);
 
     // Wait if there's a writer or waiting writers (writers have priority)
-    while (writers > 0 || waitingWriters > 0) {
-        readCV.wait(lock);
+    bool contended = writers > 0 || waitingWriters > 0;
+    if (contended) {
+        TraceSpan wait(TraceEventType::LOCK_WAIT, traceLockId(this));
+        while (writers > 0 || waitingWriters > 0) {
+            readCV.wait(lock);
+        }
     }
 
     readers++;
+    lock.unlock();
+    probe.afterAcquire(start, contended);
 }
 
 /**
@@ -269,6 +461,7 @@ void RWLock::readLock() {
  * waiting writer to proceed.
  */
 void RWLock::readUnlock() {
+    probe.beforeRelease();
     std::unique_lock<std::mutex> lock(mutex);
     readers--;
 
@@ -285,16 +478,23 @@ void RWLock::readUnlock() {
  * Increments waitingWriters to prevent new readers from acquiring the lock.
  */
 void RWLock::writeLock() {
+    uint64_t start = probe.beforeAcquire();
     std::unique_lock<std::mutex> lock(mutex);
     waitingWriters++;
 
     // Wait until no readers and no other writers
-    while (readers > 0 || writers > 0) {
-        writeCV.wait(lock);
+    bool contended = readers > 0 || writers > 0;
+    if (contended) {
+        TraceSpan wait(TraceEventType::LOCK_WAIT, traceLockId(this));
+        while (readers > 0 || writers > 0) {
+            writeCV.wait(lock);
+        }
     }
 
     waitingWriters--;
     writers++;
+    lock.unlock();
+    probe.afterAcquire(start, contended);
 }
 
 /**
@@ -304,6 +504,7 @@ void RWLock::writeLock() {
  * otherwise wakes all waiting readers to allow concurrent read access.
  */
 void RWLock::writeUnlock() {
+    probe.beforeRelease();
     std::unique_lock<std::mutex> lock(mutex);
     writers--;
 
@@ -315,6 +516,129 @@ void RWLock::writeUnlock() {
     }
 }
 
+// ===== ShardedRWLock Implementation =====
+
+/**
+ * @brief Constructs an unlocked sharded reader-writer lock
+ *
+ * @param slotCount Number of reader slots, rounded up to a power of two;
+ *        0 uses twice the hardware thread count, at least 8
+ *
+ * More slots spread readers further but make each writeLock() scan more.
+ */
+ShardedRWLock::ShardedRWLock(size_t slotCount) : writers(0) {
+    size_t wanted = slotCount != 0 ? slotCount
+                                   : std::max<size_t>(std::thread::hardware_concurrency() * 2, 8);
+    size_t count = 1;
+    while (count < wanted) {
+        count <<= 1;
+    }
+    slots = std::make_unique<ReaderSlot[]>(count);
+    slotMask = count - 1;
+}
+
+/**
+ * @brief Picks the calling thread's reader slot
+ *
+ * @return The same slot on every call from this thread
+ *
+ * Threads are numbered in order of first use, so up to getSlotCount()
+ * reader threads each get a slot of their own.
+ */
+ShardedRWLock::ReaderSlot& ShardedRWLock::slotForThread() {
+    static std::atomic<size_t> nextThread{0};
+    thread_local size_t threadIndex = nextThread.fetch_add(1, std::memory_order_relaxed);
+    return slots[threadIndex & slotMask];
+}
+
+/**
+ * @brief Acquires a read lock (shared access)
+ *
+ * The uncontended path is an increment of this thread's slot plus a read
+ * of the writer flag. The increment and the flag check pair with the
+ * writer's flag increment and slot scan (all sequentially consistent), so
+ * either the reader sees the writer and backs off, or the writer sees the
+ * reader and waits for it. Sleeps while writers are waiting or active.
+ */
+void ShardedRWLock::readLock() {
+    ReaderSlot& slot = slotForThread();
+    while (true) {
+        uint32_t waiting = writers.load(std::memory_order_seq_cst);
+        if (waiting == 0) {
+            slot.readers.fetch_add(1, std::memory_order_seq_cst);
+            if (writers.load(std::memory_order_seq_cst) == 0) {
+                return;
+            }
+            readUnlock();   // A writer came in between: let it go first
+            continue;
+        }
+        futexWait(writers, waiting);
+    }
+}
+
+/**
+ * @brief Attempts to acquire a read lock without blocking
+ *
+ * @return true if the read lock was acquired, false if a writer is
+ *         waiting or active
+ */
+bool ShardedRWLock::tryReadLock() {
+    if (writers.load(std::memory_order_seq_cst) != 0) {
+        return false;
+    }
+    ReaderSlot& slot = slotForThread();
+    slot.readers.fetch_add(1, std::memory_order_seq_cst);
+    if (writers.load(std::memory_order_seq_cst) == 0) {
+        return true;
+    }
+    readUnlock();
+    return false;
+}
+
+/**
+ * @brief Releases a read lock
+ *
+ * Must be called on the thread that took the read lock. The last reader of
+ * a slot wakes a writer waiting for it to drain.
+ */
+void ShardedRWLock::readUnlock() {
+    ReaderSlot& slot = slotForThread();
+    if (slot.readers.fetch_sub(1, std::memory_order_seq_cst) == 1 &&
+        writers.load(std::memory_order_seq_cst) != 0) {
+        futexWake(slot.readers);
+    }
+}
+
+/**
+ * @brief Acquires the write lock (exclusive access)
+ *
+ * Raises the writer count first, which stops new readers, then takes the
+ * writer mutex and waits for every reader slot to drain.
+ */
+void ShardedRWLock::writeLock() {
+    writers.fetch_add(1, std::memory_order_seq_cst);
+    writerMutex.lock();
+    for (size_t i = 0; i <= slotMask; ++i) {
+        uint32_t readers;
+        while ((readers = slots[i].readers.load(std::memory_order_seq_cst)) != 0) {
+            futexWait(slots[i].readers, readers);
+        }
+    }
+}
+
+/**
+ * @brief Releases the write lock
+ *
+ * Hands over to the next waiting writer if there is one; when the last
+ * writer leaves, all sleeping readers are woken.
+ */
+void ShardedRWLock::writeUnlock() {
+    writerMutex.unlock();
+    if (writers.fetch_sub(1, std::memory_order_seq_cst) == 1) {
+        futexWake(writers);
+    }
+}
+
 // ===== Barrier Implementation =====
 
 /**
@@ -448,25 +772,50 @@ void ConditionVariable::setReady(bool r) {
 /**
  * @brief Constructs a spinlock in unlocked state
  *
+ * @param lockName Identifier in lock profiles (defaults to SpinLock#<n>)
+ *
  * Initializes the atomic flag to clear (unlocked).
  * Spinlocks are efficient for very short critical sections where
  * the overhead of thread sleep/wake would exceed busy-waiting cost.
  */
-SpinLock::SpinLock() {
+SpinLock::SpinLock(const std::string& lockName) : probe("SpinLock", lockName) {
     flag.clear();
 }
 
 /**
  * @brief Acquires the spinlock using busy-waiting
  *
- * Continuously attempts to set the flag until successful.
- * Does not yield CPU - keeps spinning. Use only for very short critical sections.
- * Uses acquire memory ordering to ensure proper synchronization.
+ * Test-and-test-and-set: waiters spin on a plain read, so the cache line
+ * stays shared until the lock is released, and only then retry the atomic
+ * exchange. Between reads they pause with exponential backoff; past
+ * SPINLOCK_ROUNDS_BEFORE_YIELD rounds (at once on a single CPU) they yield
+ * so a descheduled holder can finish. Uses acquire memory ordering to
+ * ensure proper synchronization.
  */
 void SpinLock::lock() {
+    uint64_t start = probe.beforeAcquire();
+    if (!flag.test_and_set(std::memory_order_acquire)) {
+        probe.afterAcquire(start, false);
+        return;
+    }
+
+    TraceSpan wait(TraceEventType::LOCK_WAIT, traceLockId(this));
+    uint32_t round = spinningUseful() ? 0 : SPINLOCK_ROUNDS_BEFORE_YIELD;
+    uint32_t backoff = 1;
     while (flag.test_and_set(std::memory_order_acquire)) {
-        // Busy wait
+        while (flag.test(std::memory_order_relaxed)) {
+            if (round < SPINLOCK_ROUNDS_BEFORE_YIELD) {
+                for (uint32_t i = 0; i < backoff; ++i) {
+                    cpuRelax();
+                }
+                backoff = std::min(backoff * 2, MAX_BACKOFF_PAUSES);
+                round++;
+            } else {
+                sched_yield();
+            }
+        }
     }
+    probe.afterAcquire(start, true);
 }
 
 /**
@@ -478,7 +827,12 @@ void SpinLock::lock() {
  * Uses acquire memory ordering on successful lock.
  */
 bool SpinLock::tryLock() {
-    return !flag.test_and_set(std::memory_order_acquire);
+    uint64_t start = probe.beforeAcquire(false);
+    if (flag.test_and_set(std::memory_order_acquire)) {
+        return false;
+    }
+    probe.afterAcquire(start, false);
+    return true;
 }
 
 /**
@@ -489,7 +843,432 @@ bool SpinLock::tryLock() {
  * to the thread that acquires the lock next.
  */
 void SpinLock::unlock() {
+    probe.beforeRelease();
     flag.clear(std::memory_order_release);
 }
 
-} // namespace PTManager
\ No newline at end of file
+
+// ===== ProcessMutex Implementation =====
+
+/**
+ * @brief Initializes a robust, process-shared mutex in place
+ *
+ * Logs an error through the library logger if the attributes are not
+ * supported; every lock attempt then returns FAILED.
+ */
+ProcessMutex::ProcessMutex() : initialized(false) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+
+    int result = pthread_mutex_init(&mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    if (result == 0) {
+        initialized = true;
+    } else {
+        PTM_LOG_ERROR("Failed to initialize process mutex: " << strerror(result));
+    }
+}
+
+/**
+ * @brief Destroys the mutex; only the owner of the segment should do this
+ */
+ProcessMutex::~ProcessMutex() {
+    if (initialized) {
+        pthread_mutex_destroy(&mutex);
+    }
+}
+
+/**
+ * @brief Maps a pthread lock return code to a LockResult
+ *
+ * @param result Return value of a pthread_mutex_*lock call
+ * @return Corresponding LockResult
+ */
+LockResult ProcessMutex::interpret(int result) {
+    switch (result) {
+        case 0: return LockResult::ACQUIRED;
+        case EOWNERDEAD: return LockResult::OWNER_DIED;
+        case EBUSY:
+        case ETIMEDOUT: return LockResult::TIMEOUT;
+        default: return LockResult::FAILED;
+    }
+}
+
+/**
+ * @brief Blocks until the mutex is acquired
+ *
+ * @return ACQUIRED, OWNER_DIED (held; repair state, then makeConsistent()),
+ *         or FAILED if the mutex is unusable
+ *
+ * Tries the lock first so that only a contended acquisition is traced.
+ */
+LockResult ProcessMutex::lock() {
+    if (!initialized) return LockResult::FAILED;
+    int result = pthread_mutex_trylock(&mutex);
+    if (result == EBUSY) {
+        TraceSpan wait(TraceEventType::LOCK_WAIT, traceLockId(this));
+        result = pthread_mutex_lock(&mutex);
+    }
+    return interpret(result);
+}
+
+/**
+ * @brief Acquires the mutex, giving up after a timeout
+ *
+ * @param timeout Maximum time to wait (measured on CLOCK_MONOTONIC)
+ * @return ACQUIRED, OWNER_DIED, TIMEOUT or FAILED
+ */
+LockResult ProcessMutex::lock(std::chrono::milliseconds timeout) {
+    if (!initialized) return LockResult::FAILED;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    long nsec = ts.tv_nsec + (timeout.count() % 1000) * 1000000;
+    ts.tv_sec += timeout.count() / 1000 + nsec / 1000000000;
+    ts.tv_nsec = nsec % 1000000000;
+
+    return interpret(pthread_mutex_clocklock(&mutex, CLOCK_MONOTONIC, &ts));
+}
+
+/**
+ * @brief Acquires the mutex only if it is free
+ *
+ * @return ACQUIRED, OWNER_DIED, TIMEOUT if it is held, or FAILED
+ */
+LockResult ProcessMutex::tryLock() {
+    if (!initialized) return LockResult::FAILED;
+    return interpret(pthread_mutex_trylock(&mutex));
+}
+
+/**
+ * @brief Releases the mutex
+ */
+void ProcessMutex::unlock() {
+    if (initialized) {
+        pthread_mutex_unlock(&mutex);
+    }
+}
+
+/**
+ * @brief Marks the mutex usable again after an OWNER_DIED acquisition
+ *
+ * @return true on success; must be called while holding the mutex
+ */
+bool ProcessMutex::makeConsistent() {
+    return initialized && pthread_mutex_consistent(&mutex) == 0;
+}
+
+// ===== ProcessSemaphore Implementation =====
+
+/**
+ * @brief Initializes a process-shared semaphore in place
+ *
+ * @param value Initial count
+ */
+ProcessSemaphore::ProcessSemaphore(unsigned int value) : initialized(false) {
+    if (sem_init(&sem, 1, value) == 0) {
+        initialized = true;
+    } else {
+        PTM_LOG_ERROR("Failed to initialize process semaphore: " << strerror(errno));
+    }
+}
+
+/**
+ * @brief Destroys the semaphore; only the owner of the segment should do this
+ */
+ProcessSemaphore::~ProcessSemaphore() {
+    if (initialized) {
+        sem_destroy(&sem);
+    }
+}
+
+/**
+ * @brief Decrements the semaphore, blocking while it is zero
+ *
+ * @return true on success; signals interrupting the wait are retried
+ */
+bool ProcessSemaphore::wait() {
+    if (!initialized) return false;
+
+    while (sem_wait(&sem) != 0) {
+        if (errno != EINTR) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Decrements the semaphore only if it is positive
+ *
+ * @return true if decremented
+ */
+bool ProcessSemaphore::tryWait() {
+    if (!initialized) return false;
+    return sem_trywait(&sem) == 0;
+}
+
+/**
+ * @brief Decrements the semaphore, giving up after a timeout
+ *
+ * @param timeout Maximum time to wait (measured on CLOCK_MONOTONIC)
+ * @return true if decremented, false on timeout or error
+ */
+bool ProcessSemaphore::timedWait(std::chrono::milliseconds timeout) {
+    if (!initialized) return false;
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    long nsec = ts.tv_nsec + (timeout.count() % 1000) * 1000000;
+    ts.tv_sec += timeout.count() / 1000 + nsec / 1000000000;
+    ts.tv_nsec = nsec % 1000000000;
+
+    while (sem_clockwait(&sem, CLOCK_MONOTONIC, &ts) != 0) {
+        if (errno != EINTR) return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Increments the semaphore, waking one waiter in any process
+ *
+ * @return true on success
+ */
+bool ProcessSemaphore::post() {
+    if (!initialized) return false;
+    return sem_post(&sem) == 0;
+}
+
+/**
+ * @brief Queries the current count
+ *
+ * @return Semaphore value, or -1 on error
+ */
+int ProcessSemaphore::getValue() {
+    if (!initialized) return -1;
+
+    int value;
+    if (sem_getvalue(&sem, &value) == 0) {
+        return value;
+    }
+    return -1;
+}
+
+// ===== ProcessRWLock Implementation =====
+
+namespace {
+
+constexpr uint32_t RW_WRITER = 1u << 31;
+constexpr uint32_t RW_WRITER_WAITING = 1u << 30;
+constexpr uint32_t RW_READER_MASK = RW_WRITER_WAITING - 1;
+
+// How often waiters check whether the writer holding the lock is still alive
+constexpr auto WRITER_LIVENESS_INTERVAL = std::chrono::milliseconds(20);
+
+} // namespace
+
+/**
+ * @brief Initializes an unlocked reader-writer lock in place
+ */
+ProcessRWLock::ProcessRWLock() : state(0), sleepers(0), writerPid(0) {}
+
+/**
+ * @brief Checks whether the process holding the write lock has exited
+ *
+ * @param pid Receives the recorded writer; 0 while a writer is between
+ *            acquiring the lock and recording itself
+ * @return true if the recorded writer no longer exists
+ */
+bool ProcessRWLock::writerDied(pid_t& pid) {
+    pid = writerPid.load(std::memory_order_acquire);
+    return pid != 0 && kill(pid, 0) == -1 && errno == ESRCH;
+}
+
+/**
+ * @brief Sleeps until the state word changes from observed
+ *
+ * @param observed State value that made the caller wait
+ *
+ * While a writer holds the lock the sleep is bounded so its death is noticed.
+ */
+void ProcessRWLock::sleep(uint32_t observed) {
+    sleepers.fetch_add(1, std::memory_order_seq_cst);
+    if (observed & RW_WRITER) {
+        futexWait(state, observed, WRITER_LIVENESS_INTERVAL);
+    } else {
+        futexWait(state, observed);
+    }
+    sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Wakes every sleeper, skipping the syscall when there are none
+ */
+void ProcessRWLock::wakeAll() {
+    if (sleepers.load(std::memory_order_seq_cst) > 0) {
+        futexWake(state);
+    }
+}
+
+/**
+ * @brief Acquires shared access, waiting for writers (including queued ones)
+ *
+ * @return ACQUIRED, or OWNER_DIED if this reader had to release the lock of
+ *         a writer that died holding it
+ */
+LockResult ProcessRWLock::readLock() {
+    LockResult result = LockResult::ACQUIRED;
+    uint32_t current = state.load(std::memory_order_relaxed);
+
+    while (true) {
+        if ((current & (RW_WRITER | RW_WRITER_WAITING)) == 0) {
+            if (state.compare_exchange_weak(current, current + 1, std::memory_order_acquire)) {
+                return result;
+            }
+            continue;
+        }
+
+        pid_t pid;
+        if ((current & RW_WRITER) && writerDied(pid)) {
+            if (writerPid.compare_exchange_strong(pid, 0)) {
+                state.fetch_and(~RW_WRITER, std::memory_order_seq_cst);
+                wakeAll();
+            }
+            result = LockResult::OWNER_DIED;
+        } else {
+            sleep(current);
+        }
+        current = state.load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Acquires shared access only if no writer holds or awaits the lock
+ *
+ * @return true if acquired
+ */
+bool ProcessRWLock::tryReadLock() {
+    uint32_t current = state.load(std::memory_order_relaxed);
+    while ((current & (RW_WRITER | RW_WRITER_WAITING)) == 0) {
+        if (state.compare_exchange_weak(current, current + 1, std::memory_order_acquire)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Releases shared access; the last reader wakes waiting writers
+ */
+void ProcessRWLock::readUnlock() {
+    uint32_t previous = state.fetch_sub(1, std::memory_order_seq_cst);
+    if ((previous & RW_READER_MASK) == 1) {
+        wakeAll();
+    }
+}
+
+/**
+ * @brief Acquires exclusive access
+ *
+ * @return ACQUIRED, or OWNER_DIED if the lock was taken over from a writer
+ *         that died holding it (the protected data may be inconsistent)
+ *
+ * A waiting writer sets WRITER_WAITING so new readers queue behind it.
+ */
+LockResult ProcessRWLock::writeLock() {
+    uint32_t current = state.load(std::memory_order_relaxed);
+
+    while (true) {
+        if ((current & (RW_WRITER | RW_READER_MASK)) == 0) {
+            if (state.compare_exchange_weak(current, RW_WRITER, std::memory_order_acquire)) {
+                writerPid.store(getpid(), std::memory_order_release);
+                return LockResult::ACQUIRED;
+            }
+            continue;
+        }
+
+        pid_t pid;
+        if ((current & RW_WRITER) && writerDied(pid)) {
+            if (writerPid.compare_exchange_strong(pid, getpid(), std::memory_order_acq_rel)) {
+                return LockResult::OWNER_DIED;
+            }
+            current = state.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if ((current & RW_WRITER_WAITING) == 0) {
+            if (!state.compare_exchange_weak(current, current | RW_WRITER_WAITING, std::memory_order_relaxed)) {
+                continue;
+            }
+            current |= RW_WRITER_WAITING;
+        }
+
+        sleep(current);
+        current = state.load(std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Acquires exclusive access only if the lock is free
+ *
+ * @return true if acquired
+ */
+bool ProcessRWLock::tryWriteLock() {
+    uint32_t current = state.load(std::memory_order_relaxed);
+    while ((current & (RW_WRITER | RW_READER_MASK)) == 0) {
+        if (state.compare_exchange_weak(current, RW_WRITER, std::memory_order_acquire)) {
+            writerPid.store(getpid(), std::memory_order_release);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Releases exclusive access and wakes all waiters
+ *
+ * WRITER_WAITING is cleared too; writers still waiting set it again.
+ */
+void ProcessRWLock::writeUnlock() {
+    writerPid.store(0, std::memory_order_relaxed);
+    state.exchange(0, std::memory_order_seq_cst);
+    wakeAll();
+}
+
+// ===== ProcessBarrier Implementation =====
+
+/**
+ * @brief Initializes a barrier in place
+ *
+ * @param parties Number of participants per generation
+ */
+ProcessBarrier::ProcessBarrier(uint32_t parties) : threshold(parties), arrived(0), generation(0) {}
+
+/**
+ * @brief Waits until all parties of the current generation have arrived
+ *
+ * @return true for the last participant to arrive, false for the others
+ *
+ * The last arrival resets the count and advances the generation, so the
+ * barrier can be reused immediately.
+ */
+bool ProcessBarrier::wait() {
+    uint32_t current = generation.load(std::memory_order_acquire);
+
+    if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == threshold) {
+        arrived.store(0, std::memory_order_relaxed);
+        generation.fetch_add(1, std::memory_order_release);
+        futexWake(generation);
+        return true;
+    }
+
+    while (generation.load(std::memory_order_acquire) == current) {
+        futexWait(generation, current);
+    }
+    return false;
+}
+
+} // namespace PTManager
@@ -1,37 +1,298 @@
 #include "ThreadPool.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <algorithm>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
 
 namespace PTManager {
 
+namespace {
+
+uint64_t nowNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Counters in a WorkerSlot have a single writer, so no read-modify-write is needed
+void addRelaxed(std::atomic<uint64_t>& counter, uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+size_t histogramBucket(uint64_t nanos) {
+    uint64_t micros = nanos / 1000;
+    return std::min<size_t>(std::bit_width(micros), EXEC_HISTOGRAM_BUCKETS - 1);
+}
+
+// Gives a task its trace id and records its enqueue, if tracing
+void traceEnqueue(uint64_t& traceId, TaskPriority priority) {
+    if (Tracer::isEnabled()) {
+        traceId = Tracer::newId();
+        Tracer::instant(TraceEventType::TASK_ENQUEUE, traceId, static_cast<int64_t>(priority));
+    }
+}
+
+std::string readSysfs(const std::string& path) {
+    std::ifstream file(path);
+    std::string content;
+    std::getline(file, content);
+    return content;
+}
+
+} // namespace
+
+thread_local ThreadPool* ThreadPool::currentPool = nullptr;
+thread_local size_t ThreadPool::currentWorker = 0;
+
 /**
  * @brief Constructs a thread pool with specified number of worker threads
  *
  * @param numThreads Number of worker threads to create in the pool
+ * @param schedulingMode GLOBAL_QUEUE for a single shared queue, WORK_STEALING
+ *                       for per-worker deques with stealing
  *
- * Initializes all worker threads in IDLE state and starts them immediately.
- * Each worker runs the workerThread() function, waiting for tasks to be enqueued.
- * Workers persist until shutdown() is called.
+ * Equivalent to the ThreadPoolConfig constructor with an unbounded queue.
  */
-ThreadPool::ThreadPool(size_t numThreads)
-    : stop(false), activeTasks(0) {
+ThreadPool::ThreadPool(size_t numThreads, SchedulingMode schedulingMode)
+    : ThreadPool(ThreadPoolConfig{numThreads, schedulingMode}) {}
+
+/**
+ * @brief Constructs a thread pool from a configuration object
+ *
+ * @param config Worker count, scheduling mode, queue bounds, elastic sizing
+ *               and placement
+ * @throws std::runtime_error If the placement names an invalid CPU or a
+ *         NUMA node without CPUs
+ *
+ * Starts the minimum number of workers in IDLE state and returns once each
+ * of them has applied its placement (see initWorker()). Elastic pools also
+ * start a supervisor thread (see superviseGrowth()). Worker slots, and
+ * in WORK_STEALING mode local deques, are allocated for the maximum size up
+ * front so the pool can grow without reallocating shared state. Workers
+ * persist until shutdown() is called or, above the minimum, until they
+ * retire.
+ */
+ThreadPool::ThreadPool(const ThreadPoolConfig& config)
+    : stop(false), activeTasks(0), unfinishedTasks(0),
+      queueCapacity(config.queueCapacity), overflowPolicy(config.overflowPolicy),
+      blockedProducers(0),
+      numWorkers(std::max(config.numThreads, config.maxThreads)),
+      workerSlots(new WorkerSlot[numWorkers]),
+      minWorkers(config.numThreads), liveWorkers(0), slotInUse(numWorkers, 0),
+      spawnThresholdNanos(static_cast<uint64_t>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(config.spawnThreshold).count())),
+      idleTimeout(config.idleTimeout), workersSpawned(0), workersRetired(0), supervisorParked(false),
+      mode(config.schedulingMode), pendingTasks(0), globalQueued(0), sleepingWorkers(0),
+      placement(config.placement), cpuList(config.placement.cpus),
+      workersStarted(static_cast<std::ptrdiff_t>(config.numThreads)) {
+
+    size_t numThreads = config.numThreads;
 
-    workerStates.resize(numThreads, ThreadState::IDLE);
+    tasks.setStarvationLimit(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(config.starvationLimit).count()));
+
+    if (cpuList.empty() && placement.numaNode >= 0) {
+        cpuList = NumaTopology::getNodeCpus(placement.numaNode);
+        if (cpuList.empty()) {
+            throw std::runtime_error("NUMA node " + std::to_string(placement.numaNode) +
+                                     " has no CPUs");
+        }
+    }
+    for (int cpu : cpuList) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            throw std::runtime_error("Invalid CPU index " + std::to_string(cpu));
+        }
+    }
+
+    // Deques of initial workers are allocated by the workers themselves;
+    // those of elastic slots exist before any thief can look at them
+    if (mode == SchedulingMode::WORK_STEALING) {
+        localQueues.resize(numWorkers);
+        for (size_t i = numThreads; i < numWorkers; ++i) {
+            localQueues[i] = std::make_unique<WorkStealingDeque<QueuedTask*>>();
+        }
+    }
+
+    workers.resize(numWorkers);
+    for (size_t i = numThreads; i < numWorkers; ++i) {
+        workerSlots[i].state.store(ThreadState::TERMINATED, std::memory_order_relaxed);
+    }
 
     for (size_t i = 0; i < numThreads; ++i) {
-        workers.emplace_back([this, i] { workerThread(i); });
+        slotInUse[i] = 1;
+        liveWorkers++;
+        workers[i] = std::thread([this, i] {
+            initWorker(i, true);
+            workersStarted.arrive_and_wait();
+            workerThread(i);
+        });
     }
+    workersStarted.wait();
+
+    if (numWorkers > numThreads) {
+        growthSupervisor = std::thread([this] { superviseGrowth(); });
+    }
+
+    PTM_LOG_INFO("ThreadPool created with " << numThreads << " threads"
+                 << (numWorkers > numThreads ? " (elastic up to " + std::to_string(numWorkers) + ")" : "")
+                 << (mode == SchedulingMode::WORK_STEALING ? " (work-stealing)" : ""));
+}
 
-    std::cout << "ThreadPool created with " << numThreads << " threads" << std::endl;
+/**
+ * @brief Creates one thread pool per NUMA node
+ *
+ * @param config Template for every pool; numThreads == 0 selects one worker
+ *               per CPU of the node, placement.cpus and numaNode are replaced
+ * @return Pools in node order, skipping memory-only nodes
+ *
+ * Each pool only runs on its node's CPUs, and its queues are allocated by
+ * its own workers, so tasks submitted to a pool stay node-local.
+ */
+std::vector<std::unique_ptr<ThreadPool>> ThreadPool::createPerNumaNode(ThreadPoolConfig config) {
+    std::vector<std::unique_ptr<ThreadPool>> pools;
+    size_t threadsPerNode = config.numThreads;
+
+    for (int node : NumaTopology::getNodes()) {
+        std::vector<int> cpus = NumaTopology::getNodeCpus(node);
+        if (cpus.empty()) continue;
+
+        config.numThreads = threadsPerNode > 0 ? threadsPerNode : cpus.size();
+        config.placement.cpus.clear();
+        config.placement.numaNode = node;
+        pools.push_back(std::make_unique<ThreadPool>(config));
+    }
+    return pools;
+}
+
+/**
+ * @brief Per-worker setup run on the worker thread before it takes tasks
+ *
+ * @param id Index of the worker
+ * @param firstStart true for the workers started by the constructor
+ *
+ * Applies the placement first and only then allocates the worker's local
+ * deque, so under the kernel's first-touch policy its memory lands on the
+ * worker's NUMA node. When the pool is confined to a CPU list, worker 0
+ * likewise reallocates the global queue storage. Initial workers wait for
+ * each other after this step, so no worker can try to steal from a missing
+ * deque; elastic workers reuse the deque already allocated for their slot.
+ */
+void ThreadPool::initWorker(size_t id, bool firstStart) {
+    currentPool = this;
+    currentWorker = id;
+
+    applyPlacement(id);
+
+    if (!firstStart) {
+        return;
+    }
+    if (mode == SchedulingMode::WORK_STEALING) {
+        localQueues[id] = std::make_unique<WorkStealingDeque<QueuedTask*>>();
+    }
+    if (id == 0 && !cpuList.empty()) {
+        tasks.reallocate();
+    }
+}
+
+/**
+ * @brief Applies CPU affinity, scheduling policy, nice value and name to the calling worker
+ *
+ * @param id Index of the worker, selects its CPU when pinWorkers is set
+ *
+ * Failures are logged and otherwise ignored: a pool that cannot get a
+ * real-time policy still works, just without the latency guarantee.
+ */
+void ThreadPool::applyPlacement(size_t id) {
+    if (!cpuList.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (placement.pinWorkers) {
+            CPU_SET(cpuList[id % cpuList.size()], &set);
+        } else {
+            for (int cpu : cpuList) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0) {
+            PTM_LOG_WARN("Worker " << id << ": failed to set CPU affinity: "
+                         << strerror(rc));
+        }
+    }
+
+    if (placement.schedPolicy >= 0) {
+        sched_param param{};
+        param.sched_priority = placement.schedPriority;
+        int rc = pthread_setschedparam(pthread_self(), placement.schedPolicy, &param);
+        if (rc != 0) {
+            PTM_LOG_WARN("Worker " << id << ": failed to set scheduling policy: "
+                         << strerror(rc));
+        }
+    }
+
+    if (placement.niceValue) {
+        // Linux keeps the nice value per thread, addressed by the kernel thread id
+        if (setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), *placement.niceValue) != 0) {
+            PTM_LOG_WARN("Worker " << id << ": failed to set nice value: "
+                         << strerror(errno));
+        }
+    }
+
+    if (!placement.threadName.empty()) {
+        std::string name = placement.threadName + "-" + std::to_string(id);
+        name.resize(std::min<size_t>(name.size(), 15));
+        pthread_setname_np(pthread_self(), name.c_str());
+    }
 }
 
 /**
  * @brief Destructor that ensures graceful shutdown of the thread pool
  *
  * Calls shutdown() to stop all workers and wait for them to finish.
- * Ensures no thread handles are left dangling and all resources are cleaned up.
+ * Ensures no thread handles are left dangling and all resources are cleaned up,
+ * including any task still parked in a local deque.
  */
 ThreadPool::~ThreadPool() {
     shutdown();
+
+    for (auto& queue : localQueues) {
+        QueuedTask* leftover = nullptr;
+        while (queue->pop(leftover)) {
+            deleteTaskNode(leftover);
+        }
+    }
+}
+
+/**
+ * @brief Allocates a local deque node from the block pool
+ *
+ * @param task Task to move into the node
+ * @return Node owning the task; release with deleteTaskNode()
+ */
+ThreadPool::QueuedTask* ThreadPool::newTaskNode(QueuedTask&& task) {
+    void* block = detail::poolAllocate(sizeof(QueuedTask));
+    return ::new (block) QueuedTask(std::move(task));
+}
+
+/**
+ * @brief Destroys a node created by newTaskNode() and returns it to the pool
+ *
+ * @param node Node to release
+ */
+void ThreadPool::deleteTaskNode(QueuedTask* node) {
+    node->~QueuedTask();
+    detail::poolDeallocate(node, sizeof(QueuedTask));
 }
 
 /**
@@ -43,51 +304,600 @@ ThreadPool::~ThreadPool() {
  * Transitions: IDLE (waiting) -> RUNNING (executing) -> IDLE (waiting) -> TERMINATED (shutdown).
  * Handles exceptions within tasks to prevent worker thread termination.
  * Exits when stop flag is set and task queue is empty.
+ * Delegates to workStealingLoop() in WORK_STEALING mode.
  */
 void ThreadPool::workerThread(size_t id) {
+    if (mode == SchedulingMode::WORK_STEALING) {
+        workStealingLoop(id);
+        return;
+    }
+
+    WorkerSlot& slot = workerSlots[id];
+
     while (true) {
-        std::function<void()> task;
+        QueuedTask task;
 
         {
             std::unique_lock<std::mutex> lock(queueMutex);
 
-            {
-                std::lock_guard<std::mutex> stateLock(stateMutex);
-                workerStates[id] = ThreadState::IDLE;
+            auto ready = [this] { return stop.load() || !tasks.empty(); };
+            if (!ready() && parkWorker(id, lock, ready)) {
+                retireWorker(id, lock);
+                return;
             }
 
-            condition.wait(lock, [this] {
-                return stop.load() || !tasks.empty();
-            });
-
             if (stop.load() && tasks.empty()) {
-                std::lock_guard<std::mutex> stateLock(stateMutex);
-                workerStates[id] = ThreadState::TERMINATED;
+                slot.state.store(ThreadState::TERMINATED, std::memory_order_relaxed);
+                currentPool = nullptr;
                 return;
             }
 
-            if (!tasks.empty()) {
-                task = std::move(tasks.front());
-                tasks.pop();
+            TaskPriority priority;
+            if (tasks.pop(task, priority)) {
+                taskDequeued(priority);
+            }
+        }
+
+        if (task.function) {
+            runTask(id, task);
+        }
+    }
+}
+
+/**
+ * @brief Worker loop used in WORK_STEALING mode
+ *
+ * @param id Index of this worker, also the index of its local deque
+ *
+ * Nested enqueue() calls from this thread land in its local deque (see
+ * pushTask()). Keeps taking tasks via takeTask() and only parks on the
+ * condition variable when no task is pending anywhere in the pool.
+ */
+void ThreadPool::workStealingLoop(size_t id) {
+    WorkerSlot& slot = workerSlots[id];
+
+    while (true) {
+        QueuedTask task;
+
+        if (takeTask(id, task)) {
+            runTask(id, task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(queueMutex);
+
+        auto ready = [this] { return stop.load() || pendingTasks.load() > 0; };
+        if (parkWorker(id, lock, ready)) {
+            retireWorker(id, lock);
+            return;
+        }
+
+        if (stop.load() && pendingTasks.load() == 0) {
+            slot.state.store(ThreadState::TERMINATED, std::memory_order_relaxed);
+            currentPool = nullptr;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Parks an idle worker until ready() holds or it should retire
+ *
+ * @param id Index of the parking worker
+ * @param lock Held lock on queueMutex, released while parked
+ * @param ready Wakeup predicate of the calling loop
+ * @return true if the worker timed out while the pool is above its minimum
+ *         size and must call retireWorker(), false once ready() holds
+ *
+ * Workers of a pool at its minimum size wait without a timeout. The idle
+ * time is recorded in the worker's slot.
+ */
+template<typename Ready>
+bool ThreadPool::parkWorker(size_t id, std::unique_lock<std::mutex>& lock, Ready ready) {
+    WorkerSlot& slot = workerSlots[id];
+    slot.state.store(ThreadState::IDLE, std::memory_order_relaxed);
+    uint64_t idleStart = nowNanos();
+    bool retire = false;
+
+    sleepingWorkers++;
+    while (!ready()) {
+        if (liveWorkers.load() <= minWorkers) {
+            condition.wait(lock, ready);
+            break;
+        }
+        if (!condition.wait_for(lock, idleTimeout, ready) && liveWorkers.load() > minWorkers) {
+            retire = true;
+            break;
+        }
+    }
+    sleepingWorkers--;
+
+    addRelaxed(slot.idleNanos, nowNanos() - idleStart);
+    return retire;
+}
+
+/**
+ * @brief Removes the calling worker from the pool after an idle timeout
+ *
+ * @param id Index of the retiring worker
+ * @param lock Held lock on queueMutex; released before returning
+ *
+ * Frees the worker's slot for a later spawnWorker() and joins the threads of
+ * workers that retired before it, so their stacks are released without
+ * waiting for shutdown(). The caller's own thread is reaped the same way by
+ * the next worker to retire, the next spawn into its slot, or shutdown().
+ */
+void ThreadPool::retireWorker(size_t id, std::unique_lock<std::mutex>& lock) {
+    slotInUse[id] = 0;
+    liveWorkers--;
+    workersRetired++;
+    workerSlots[id].state.store(ThreadState::TERMINATED, std::memory_order_relaxed);
+
+    std::vector<std::thread> retired;
+    for (size_t i = 0; i < numWorkers; ++i) {
+        if (i != id && !slotInUse[i] && workers[i].joinable()) {
+            retired.push_back(std::move(workers[i]));
+        }
+    }
+    lock.unlock();
+
+    for (std::thread& worker : retired) {
+        worker.join();
+    }
+    currentPool = nullptr;
+}
+
+/**
+ * @brief Adds a worker if the global queue has backed up
+ *
+ * Must be called with queueMutex held. Does nothing for fixed-size pools,
+ * at the maximum size, after shutdown, or while some worker is idle. A new
+ * worker is started when the oldest queued task has waited longer than
+ * spawnThreshold, or immediately if no worker is alive. The check runs on
+ * every submission and every dequeue from the global queue, and from
+ * superviseGrowth() while no task is dequeued. A submission that finds the
+ * supervisor parked wakes it so it starts timing the new backlog.
+ */
+void ThreadPool::maybeGrow() {
+    size_t live = liveWorkers.load();
+    if (live >= numWorkers || stop.load() || tasks.empty()) {
+        return;
+    }
+    if (supervisorParked) {
+        supervisorParked = false;
+        growthCondition.notify_one();
+    }
+    if (live > 0) {
+        uint64_t now = nowNanos();
+        uint64_t waited = now - std::min(now, tasks.oldestEnqueueTime());
+        if (sleepingWorkers.load() > 0 || waited < spawnThresholdNanos) {
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        if (!slotInUse[i]) {
+            spawnWorker(i);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Supervisor loop of an elastic pool
+ *
+ * Calls maybeGrow() whenever the oldest queued task reaches spawnThreshold,
+ * so a burst submitted while every worker is busy is absorbed without
+ * waiting for one of them to finish a task. Parks without a timeout while
+ * the global queue is empty or the pool is at its maximum size, and exits
+ * once the pool stops.
+ */
+void ThreadPool::superviseGrowth() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+
+    while (!stop.load()) {
+        maybeGrow();
+
+        if (tasks.empty() || liveWorkers.load() >= numWorkers) {
+            supervisorParked = true;
+            growthCondition.wait(lock, [this] { return stop.load() || !supervisorParked; });
+            continue;
+        }
+
+        uint64_t now = nowNanos();
+        uint64_t due = tasks.oldestEnqueueTime() + spawnThresholdNanos;
+        uint64_t delay = due > now ? due - now : spawnThresholdNanos;
+        growthCondition.wait_for(lock, std::chrono::nanoseconds(std::max<uint64_t>(delay, 1)));
+    }
+}
+
+/**
+ * @brief Starts an elastic worker in a free slot
+ *
+ * @param id Free slot index
+ *
+ * Must be called with queueMutex held. Joins the slot's previous thread
+ * first if it has not been reaped yet; that thread has already left the
+ * pool and never needs the lock again. Failure to create a thread is
+ * logged and leaves the pool at its current size.
+ */
+void ThreadPool::spawnWorker(size_t id) {
+    if (workers[id].joinable()) {
+        workers[id].join();
+    }
+
+    workerSlots[id].state.store(ThreadState::IDLE, std::memory_order_relaxed);
+    try {
+        workers[id] = std::thread([this, id] {
+            initWorker(id, false);
+            workerThread(id);
+        });
+    } catch (const std::system_error& e) {
+        workerSlots[id].state.store(ThreadState::TERMINATED, std::memory_order_relaxed);
+        PTM_LOG_ERROR("Failed to spawn worker " << id << ": " << e.what());
+        return;
+    }
+
+    slotInUse[id] = 1;
+    liveWorkers++;
+    workersSpawned++;
+}
+
+/**
+ * @brief Finds the next task for a work-stealing worker
+ *
+ * @param id Index of the calling worker, or EXTERNAL_THREAD
+ * @param task Receives the task on success
+ * @return true if a task was taken, false if none could be found right now
+ *
+ * Lookup order: HIGH priority tasks of the global queue, own deque (LIFO,
+ * cache-warm), the rest of the global queue, then stealing the oldest task
+ * from a peer's deque. The global queue lock is only taken when the
+ * lock-free counters say it holds something. External threads and
+ * GLOBAL_QUEUE workers skip the local deque step.
+ */
+bool ThreadPool::takeTask(size_t id, QueuedTask& task) {
+    QueuedTask* raw = nullptr;
+    bool hasLocal = id < localQueues.size();
+
+    auto popGlobal = [this, &task] {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        TaskPriority priority;
+        if (tasks.pop(task, priority)) {
+            taskDequeued(priority);
+            return true;
+        }
+        return false;
+    };
+
+    if (queuedByPriority[static_cast<size_t>(TaskPriority::HIGH)].load() > 0 && popGlobal()) {
+        return true;
+    }
+
+    bool found = hasLocal && localQueues[id]->pop(raw);
+    if (!found && globalQueued.load() > 0 && popGlobal()) {
+        return true;
+    }
+
+    if (!found) {
+        size_t count = localQueues.size();
+        size_t start = hasLocal ? id + 1 : 0;
+        for (size_t i = 0; i < count && !found; ++i) {
+            size_t victim = (start + i) % count;
+            if (victim != id) {
+                found = localQueues[victim]->steal(raw);
+            }
+        }
+        if (raw != nullptr && id != EXTERNAL_THREAD) {
+            addRelaxed(workerSlots[id].steals, 1);
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    task = std::move(*raw);
+    deleteTaskNode(raw);
+    activeTasks++;
+    pendingTasks--;
+    return true;
+}
+
+/**
+ * @brief Executes one task on behalf of a worker
+ *
+ * @param id Index of the executing worker, or EXTERNAL_THREAD for a helping caller
+ * @param task Task to run; activeTasks must already account for it
+ *
+ * Marks the worker RUNNING, runs the task and reports exceptions that escape
+ * it (only possible for post()ed tasks). The task is destroyed before the
+ * completion is counted so its captures never outlive completion. Wakes
+ * waitForCompletion() when the last unfinished task completes.
+ * Queue wait, run time and the histogram are recorded in the worker's slot;
+ * tasks run by external helpers are not attributed to any worker. With
+ * tracing on, the run is a TASK_RUN span linked to the task's enqueue.
+ */
+void ThreadPool::runTask(size_t id, QueuedTask& task) {
+    WorkerSlot* slot = (id != EXTERNAL_THREAD) ? &workerSlots[id] : nullptr;
+    uint64_t start = nowNanos();
+    TraceSpan span(TraceEventType::TASK_RUN, task.traceId,
+                   id != EXTERNAL_THREAD ? static_cast<int64_t>(id) : -1);
+
+    if (slot != nullptr) {
+        slot->state.store(ThreadState::RUNNING, std::memory_order_relaxed);
+        addRelaxed(slot->queueWaitNanos, start - std::min(start, task.enqueueTime));
+    }
+
+    try {
+        task.function();
+    } catch (const std::exception& e) {
+        PTM_LOG_ERROR("Thread " << id << " caught exception: " << e.what());
+    }
+
+    task.function.reset();
+    span.end();
+
+    if (slot != nullptr) {
+        uint64_t elapsed = nowNanos() - start;
+        addRelaxed(slot->execNanos, elapsed);
+        addRelaxed(slot->execHistogram[histogramBucket(elapsed)], 1);
+        addRelaxed(slot->tasksExecuted, 1);
+    }
+
+    activeTasks--;
+
+    if (unfinishedTasks.fetch_sub(1) == 1) {
+        unfinishedTasks.notify_all();
+    }
+}
+
+/**
+ * @brief Updates counters after a task was popped from the global queue
+ *
+ * @param priority Class the task was queued in
+ *
+ * Must be called with queueMutex held. Wakes one producer blocked on a
+ * full bounded queue, and lets an elastic pool grow if the tasks behind
+ * the dequeued one are still waiting too long.
+ */
+void ThreadPool::taskDequeued(TaskPriority priority) {
+    activeTasks++;
+    globalQueued--;
+    queuedByPriority[static_cast<size_t>(priority)]--;
+    pendingTasks--;
+
+    if (blockedProducers > 0) {
+        notFull.notify_one();
+    }
+    if (numWorkers > minWorkers) {
+        maybeGrow();
+    }
+}
+
+/**
+ * @brief Blocks a producer until the bounded queue has room or the pool stops
+ *
+ * @param lock Held lock on queueMutex, released while waiting
+ */
+void ThreadPool::waitForSpace(std::unique_lock<std::mutex>& lock) {
+    blockedProducers++;
+    notFull.wait(lock, [this] {
+        return stop.load() || tasks.size() < queueCapacity;
+    });
+    blockedProducers--;
+}
+
+/**
+ * @brief Wakes up to count workers for newly queued tasks
+ *
+ * @param count Number of tasks just made available
+ *
+ * Uses a single notify_all when the batch covers every worker, otherwise
+ * one notify_one per task.
+ */
+void ThreadPool::notifyWorkers(size_t count) {
+    if (count >= liveWorkers.load()) {
+        condition.notify_all();
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            condition.notify_one();
+        }
+    }
+}
+
+/**
+ * @brief Runs a rejected task on the submitting thread (CALLER_RUNS)
+ *
+ * @param task Task to execute synchronously
+ *
+ * Exceptions are reported the same way as on a worker. enqueue()d tasks
+ * still deliver their result through the returned future.
+ */
+void ThreadPool::runInline(TaskFunction& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        PTM_LOG_ERROR("Caller-run task caught exception: " << e.what());
+    }
+}
+
+/**
+ * @brief Places a type-erased task into the appropriate queue
+ *
+ * @param task Task to schedule
+ * @param priority Class of the global queue to use
+ * @param nonBlocking If true, reject instead of applying the overflow policy
+ * @return false if nonBlocking and the bounded queue was full, true otherwise
+ * @throws std::runtime_error if the pool has been stopped, or if the queue is
+ *         full under OverflowPolicy::FAIL
+ *
+ * In WORK_STEALING mode, NORMAL tasks submitted from one of this pool's
+ * workers go to that worker's local deque without touching queueMutex; the
+ * lock is only taken to wake a sleeping worker. Everything else goes to the
+ * global queue of its class, subject to queueCapacity (shared by all
+ * classes). A worker of this pool never blocks on its own full queue; it
+ * runs the task inline instead.
+ */
+bool ThreadPool::pushTask(TaskFunction&& task, TaskPriority priority, bool nonBlocking) {
+    QueuedTask entry{std::move(task), nowNanos()};
+    traceEnqueue(entry.traceId, priority);
+
+    if (mode == SchedulingMode::WORK_STEALING && currentPool == this &&
+        priority == TaskPriority::NORMAL) {
+        if (stop) {
+            throw std::runtime_error("Cannot enqueue on stopped ThreadPool");
+        }
+
+        // Counted before publishing: a thief may take and count it off at once
+        unfinishedTasks++;
+        pendingTasks++;
+        localQueues[currentWorker]->push(newTaskNode(std::move(entry)));
+
+        if (sleepingWorkers.load() > 0) {
+            // Locking orders the wakeup after a sleeper's predicate check
+            { std::lock_guard<std::mutex> lock(queueMutex); }
+            condition.notify_one();
+        }
+        return true;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+
+        if (stop) {
+            throw std::runtime_error("Cannot enqueue on stopped ThreadPool");
+        }
+
+        if (queueCapacity > 0 && tasks.size() >= queueCapacity) {
+            if (nonBlocking) {
+                return false;
+            }
+
+            if (overflowPolicy == OverflowPolicy::FAIL) {
+                throw std::runtime_error("ThreadPool queue is full");
+            }
+
+            if (overflowPolicy == OverflowPolicy::CALLER_RUNS || currentPool == this) {
+                lock.unlock();
+                runInline(entry.function);
+                return true;
+            }
+
+            waitForSpace(lock);
+            if (stop) {
+                throw std::runtime_error("Cannot enqueue on stopped ThreadPool");
             }
         }
 
-        if (task) {
-            {
-                std::lock_guard<std::mutex> stateLock(stateMutex);
-                workerStates[id] = ThreadState::RUNNING;
+        unfinishedTasks++;
+        tasks.push(priority, std::move(entry));
+        globalQueued++;
+        queuedByPriority[static_cast<size_t>(priority)]++;
+        pendingTasks++;
+
+        if (numWorkers > minWorkers) {
+            maybeGrow();
+        }
+
+        // Notifying under the lock means an external producer is done with
+        // the pool once it releases queueMutex, so the task's completion may
+        // safely be followed by destruction of the pool
+        condition.notify_one();
+    }
+
+    return true;
+}
+
+/**
+ * @brief Queues several tasks with one lock acquisition and one wakeup pass
+ *
+ * @param batch Array of tasks to schedule (moved from)
+ * @param count Number of tasks in the array
+ * @throws std::runtime_error if the pool is stopped, or under OverflowPolicy::FAIL
+ *         if the whole batch does not fit (nothing is queued in that case)
+ *
+ * With a bounded queue and BLOCK, as many tasks as fit are queued, workers are
+ * woken, and the producer waits for room for the rest. With CALLER_RUNS (or
+ * when called from a worker of this pool) the tasks that do not fit run inline.
+ */
+void ThreadPool::pushBatch(TaskFunction* batch, size_t count) {
+    if (count == 0) return;
+
+    uint64_t now = nowNanos();
+
+    if (mode == SchedulingMode::WORK_STEALING && currentPool == this) {
+        if (stop) {
+            throw std::runtime_error("Cannot enqueue on stopped ThreadPool");
+        }
+
+        // Counted before publishing, as in pushTask()
+        unfinishedTasks += count;
+        pendingTasks += count;
+        for (size_t i = 0; i < count; ++i) {
+            QueuedTask entry{std::move(batch[i]), now};
+            traceEnqueue(entry.traceId, TaskPriority::NORMAL);
+            localQueues[currentWorker]->push(newTaskNode(std::move(entry)));
+        }
+
+        if (sleepingWorkers.load() > 0) {
+            { std::lock_guard<std::mutex> lock(queueMutex); }
+            notifyWorkers(count);
+        }
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(queueMutex);
+
+    if (stop) {
+        throw std::runtime_error("Cannot enqueue on stopped ThreadPool");
+    }
+
+    if (queueCapacity > 0 && overflowPolicy == OverflowPolicy::FAIL &&
+        tasks.size() + count > queueCapacity) {
+        throw std::runtime_error("ThreadPool queue is full");
+    }
+
+    size_t next = 0;
+    while (true) {
+        size_t room = count - next;
+        if (queueCapacity > 0) {
+            room = std::min(room, queueCapacity > tasks.size() ? queueCapacity - tasks.size() : 0);
+        }
+
+        for (size_t i = 0; i < room; ++i) {
+            QueuedTask entry{std::move(batch[next + i]), now};
+            traceEnqueue(entry.traceId, TaskPriority::NORMAL);
+            tasks.push(TaskPriority::NORMAL, std::move(entry));
+        }
+        unfinishedTasks += room;
+        globalQueued += room;
+        queuedByPriority[static_cast<size_t>(TaskPriority::NORMAL)] += room;
+        pendingTasks += room;
+        next += room;
+
+        if (room > 0) {
+            if (numWorkers > minWorkers) {
+                maybeGrow();
             }
+            notifyWorkers(room);
+        }
 
-            activeTasks++;
+        if (next == count) {
+            return;
+        }
 
-            try {
-                task();
-            } catch (const std::exception& e) {
-                std::cerr << "Thread " << id << " caught exception: "
-                          << e.what() << std::endl;
+        if (overflowPolicy == OverflowPolicy::CALLER_RUNS || currentPool == this) {
+            lock.unlock();
+            for (; next < count; ++next) {
+                runInline(batch[next]);
             }
+            return;
+        }
 
-            activeTasks--;
+        waitForSpace(lock);
+        if (stop) {
+            throw std::runtime_error("Cannot enqueue on stopped ThreadPool");
         }
     }
 }
@@ -97,37 +907,75 @@ void ThreadPool::workerThread(size_t id) {
  *
  * @return Number of pending tasks not yet assigned to workers
  *
- * Thread-safe query of the task queue size. Does not include tasks
+ * Thread-safe query of the task queue size, including tasks sitting in
+ * local deques in WORK_STEALING mode. Does not include tasks
  * currently being executed by workers.
  */
 size_t ThreadPool::getQueuedTasks() {
-    std::lock_guard<std::mutex> lock(queueMutex);
-    return tasks.size();
+    return pendingTasks.load();
+}
+
+/**
+ * @brief Returns the number of tasks waiting in one priority class
+ *
+ * @param priority Class to query
+ * @return Depth of that class in the global queue
+ *
+ * Lock-free. Nested NORMAL submissions sitting in work-stealing local deques
+ * are not included; getQueuedTasks() counts those.
+ */
+size_t ThreadPool::getQueuedTasks(TaskPriority priority) const {
+    return queuedByPriority[static_cast<size_t>(priority)].load();
 }
 
 /**
  * @brief Blocks until all queued and active tasks complete
  *
- * Polls the queue and active task count every 10ms until both are zero.
- * Does not prevent new tasks from being enqueued during the wait.
- * Useful for synchronization points where all work must finish before proceeding.
+ * @throws std::runtime_error if called from one of this pool's workers
+ *
+ * Sleeps on the unfinished-task counter (std::atomic::wait, futex-backed) and
+ * is woken by the worker that completes the last task, so there is no polling
+ * delay. Tasks enqueued during the wait extend it.
+ * Use a TaskGroup to wait for a subset of tasks, or from inside a task.
  */
 void ThreadPool::waitForCompletion() {
-    while (true) {
-        {
-            std::lock_guard<std::mutex> lock(queueMutex);
-            if (tasks.empty() && activeTasks.load() == 0) {
-                break;
-            }
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    if (currentPool == this) {
+        throw std::runtime_error("waitForCompletion() called from a worker of the same ThreadPool");
     }
+
+    size_t remaining = unfinishedTasks.load();
+    while (remaining != 0) {
+        unfinishedTasks.wait(remaining);
+        remaining = unfinishedTasks.load();
+    }
+}
+
+/**
+ * @brief Runs one pending task on the calling thread
+ *
+ * @return true if a task was executed, false if nothing was available
+ *
+ * Workers of this pool look in their own deque first; any other thread takes
+ * from the global queue or steals from a worker deque. Lets a thread that is
+ * waiting on pool work contribute to it instead of blocking.
+ */
+bool ThreadPool::tryRunPendingTask() {
+    size_t id = (currentPool == this) ? currentWorker : EXTERNAL_THREAD;
+
+    QueuedTask task;
+    if (!takeTask(id, task)) {
+        return false;
+    }
+
+    runTask(id, task);
+    return true;
 }
 
 /**
  * @brief Gracefully shuts down the thread pool
  *
- * Sets the stop flag, wakes all waiting workers, and joins all threads.
+ * Sets the stop flag, wakes all waiting workers, and joins all threads,
+ * including retired elastic workers that have not been reaped yet.
  * Workers will complete their current tasks but won't pick up new ones.
  * Remaining queued tasks are discarded. Safe to call multiple times.
  * After shutdown, the thread pool cannot be restarted.
@@ -142,14 +990,26 @@ void ThreadPool::shutdown() {
     }
 
     condition.notify_all();
+    notFull.notify_all();
+    growthCondition.notify_all();
 
-    for (std::thread& worker : workers) {
+    if (growthSupervisor.joinable()) {
+        growthSupervisor.join();
+    }
+
+    // Retiring workers also reap threads, so each handle is taken under the lock
+    for (size_t i = 0; i < workers.size(); ++i) {
+        std::thread worker;
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            worker = std::move(workers[i]);
+        }
         if (worker.joinable()) {
             worker.join();
         }
     }
 
-    std::cout << "ThreadPool shut down" << std::endl;
+    PTM_LOG_INFO("ThreadPool shut down");
 }
 
 /**
@@ -158,44 +1018,343 @@ void ThreadPool::shutdown() {
  * @param id Thread identifier (0-based index)
  * @return Current ThreadState, or TERMINATED if id is invalid
  *
- * Thread-safe query of worker state. States are updated by the worker itself:
+ * Lock-free query of worker state. States are updated by the worker itself:
  * IDLE while waiting, RUNNING while executing a task, TERMINATED after shutdown.
  */
-ThreadState ThreadPool::getThreadState(size_t id) {
-    if (id >= workerStates.size()) {
+ThreadState ThreadPool::getThreadState(size_t id) const {
+    if (id >= numWorkers) {
         return ThreadState::TERMINATED;
     }
 
-    std::lock_guard<std::mutex> lock(stateMutex);
-    return workerStates[id];
+    return workerSlots[id].state.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Takes a snapshot of pool and per-worker counters
+ *
+ * @return Pool-wide gauges plus one WorkerStats entry per worker slot
+ *
+ * Reads every counter with relaxed atomic loads and never blocks the
+ * workers, so it can be scraped at any frequency. Counters of different
+ * workers are not captured at exactly the same instant.
+ */
+ThreadPoolStats ThreadPool::getStats() const {
+    ThreadPoolStats stats;
+    stats.poolSize = liveWorkers.load(std::memory_order_relaxed);
+    stats.activeTasks = activeTasks.load(std::memory_order_relaxed);
+    stats.queuedTasks = pendingTasks.load(std::memory_order_relaxed);
+    for (size_t p = 0; p < TASK_PRIORITY_COUNT; ++p) {
+        stats.queuedByPriority[p] = queuedByPriority[p].load(std::memory_order_relaxed);
+    }
+    stats.workersSpawned = workersSpawned.load(std::memory_order_relaxed);
+    stats.workersRetired = workersRetired.load(std::memory_order_relaxed);
+    stats.workers.resize(numWorkers);
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        const WorkerSlot& slot = workerSlots[i];
+        WorkerStats& out = stats.workers[i];
+
+        out.state = slot.state.load(std::memory_order_relaxed);
+        out.tasksExecuted = slot.tasksExecuted.load(std::memory_order_relaxed);
+        out.steals = slot.steals.load(std::memory_order_relaxed);
+        out.idleTime = std::chrono::nanoseconds(slot.idleNanos.load(std::memory_order_relaxed));
+        out.queueWaitTime = std::chrono::nanoseconds(slot.queueWaitNanos.load(std::memory_order_relaxed));
+        out.executionTime = std::chrono::nanoseconds(slot.execNanos.load(std::memory_order_relaxed));
+        for (size_t b = 0; b < EXEC_HISTOGRAM_BUCKETS; ++b) {
+            out.executionHistogram[b] = slot.execHistogram[b].load(std::memory_order_relaxed);
+        }
+    }
+
+    return stats;
 }
 
 /**
  * @brief Prints a comprehensive status report of the thread pool
  *
  * Displays pool size, active task count, queued task count, and the state
- * of each individual worker thread. Thread-safe snapshot of current state.
+ * and task count of each individual worker thread, taken from getStats().
  * Useful for debugging and monitoring thread pool health and utilization.
  */
 void ThreadPool::printThreadStates() {
-    std::lock_guard<std::mutex> lock(stateMutex);
+    ThreadPoolStats stats = getStats();
 
     std::cout << "\n=== Thread Pool Status ===" << std::endl;
-    std::cout << "Pool size: " << workers.size() << std::endl;
-    std::cout << "Active tasks: " << activeTasks.load() << std::endl;
-    std::cout << "Queued tasks: " << getQueuedTasks() << std::endl;
+    std::cout << "Pool size: " << stats.poolSize << std::endl;
+    std::cout << "Active tasks: " << stats.activeTasks << std::endl;
+    std::cout << "Queued tasks: " << stats.queuedTasks << std::endl;
 
-    for (size_t i = 0; i < workerStates.size(); ++i) {
+    for (size_t i = 0; i < stats.workers.size(); ++i) {
+        const WorkerStats& worker = stats.workers[i];
         std::cout << "Thread " << i << ": ";
-        switch (workerStates[i]) {
+        switch (worker.state) {
             case ThreadState::IDLE: std::cout << "IDLE"; break;
             case ThreadState::RUNNING: std::cout << "RUNNING"; break;
             case ThreadState::BLOCKED: std::cout << "BLOCKED"; break;
             case ThreadState::TERMINATED: std::cout << "TERMINATED"; break;
         }
-        std::cout << std::endl;
+        std::cout << " (tasks: " << worker.tasksExecuted
+                  << ", steals: " << worker.steals << ")" << std::endl;
     }
     std::cout << "========================\n" << std::endl;
 }
 
-} // namespace PTManager
\ No newline at end of file
+// ===== TaskQueues Implementation =====
+
+/**
+ * @brief Replaces the storage of every ring with a fresh allocation
+ *
+ * Only valid while the queues are empty. Lets a pinned worker allocate the
+ * global queue on its own NUMA node.
+ */
+void ThreadPool::TaskQueues::reallocate() {
+    for (auto& ring : rings) {
+        ring = RingQueue<QueuedTask>();
+    }
+}
+
+/**
+ * @brief Removes the next task according to priority and the starvation guard
+ *
+ * @param out Receives the task
+ * @param priority Receives the class the task was taken from
+ * @return false if every class is empty
+ */
+bool ThreadPool::TaskQueues::pop(QueuedTask& out, TaskPriority& priority) {
+    size_t chosen = TASK_PRIORITY_COUNT;
+
+    if (starvationNanos > 0) {
+        uint64_t now = nowNanos();
+        uint64_t longestWait = 0;
+        for (size_t p = 1; p < TASK_PRIORITY_COUNT; ++p) {
+            if (rings[p].empty()) continue;
+            uint64_t waited = now - std::min(now, rings[p].front().enqueueTime);
+            if (waited >= starvationNanos && waited > longestWait) {
+                longestWait = waited;
+                chosen = p;
+            }
+        }
+    }
+
+    for (size_t p = 0; chosen == TASK_PRIORITY_COUNT && p < TASK_PRIORITY_COUNT; ++p) {
+        if (!rings[p].empty()) {
+            chosen = p;
+        }
+    }
+
+    if (chosen == TASK_PRIORITY_COUNT) {
+        return false;
+    }
+    priority = static_cast<TaskPriority>(chosen);
+    return rings[chosen].pop(out);
+}
+
+/**
+ * @brief Total number of tasks over all classes
+ */
+size_t ThreadPool::TaskQueues::size() const {
+    size_t total = 0;
+    for (const auto& ring : rings) {
+        total += ring.size();
+    }
+    return total;
+}
+
+/**
+ * @brief Enqueue time of the longest waiting task, for elastic growth
+ *
+ * @return steady_clock nanoseconds; UINT64_MAX if every class is empty
+ */
+uint64_t ThreadPool::TaskQueues::oldestEnqueueTime() const {
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (const auto& ring : rings) {
+        if (!ring.empty()) {
+            oldest = std::min(oldest, ring.front().enqueueTime);
+        }
+    }
+    return oldest;
+}
+
+// ===== ThreadPoolStats Implementation =====
+
+/**
+ * @brief Sums tasksExecuted over all workers in the snapshot
+ */
+uint64_t ThreadPoolStats::totalTasksExecuted() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) {
+        total += worker.tasksExecuted;
+    }
+    return total;
+}
+
+/**
+ * @brief Sums steals over all workers in the snapshot
+ */
+uint64_t ThreadPoolStats::totalSteals() const {
+    uint64_t total = 0;
+    for (const auto& worker : workers) {
+        total += worker.steals;
+    }
+    return total;
+}
+
+// ===== TaskGroup Implementation =====
+
+/**
+ * @brief Constructs an empty task group bound to a pool
+ *
+ * @param threadPool Pool that executes the group's tasks
+ */
+TaskGroup::TaskGroup(ThreadPool& threadPool)
+    : pool(threadPool), pending(0), failed(false) {}
+
+/**
+ * @brief Destructor that waits for outstanding tasks of the group
+ *
+ * Tasks reference the group, so it cannot be destroyed while any of them
+ * is still queued or running. Exceptions are swallowed here; call wait()
+ * explicitly to observe them.
+ */
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+/**
+ * @brief Marks one task of the group as complete
+ *
+ * Wakes waiters when the count drops to zero. atomic notify only uses the
+ * address as a key, so a waiter destroying the group right after observing
+ * zero is safe.
+ */
+void TaskGroup::finishOne() {
+    if (pending.fetch_sub(1) == 1) {
+        pending.notify_all();
+    }
+}
+
+/**
+ * @brief Waits until every task run() on this group has completed
+ *
+ * @throws The first exception thrown by any task of the group
+ *
+ * When called from a worker of the pool, the worker executes pending pool
+ * work via ThreadPool::tryRunPendingTask() while tasks are outstanding and only
+ * sleeps once nothing is runnable, so nested waits inside pool tasks cannot
+ * starve the pool. Other threads just sleep until the group's last task
+ * completes, and never get stuck running unrelated work.
+ */
+void TaskGroup::wait() {
+    waitFor(pool.isWorkerThread());
+}
+
+/**
+ * @brief Waits for the group while running pool work on any thread
+ *
+ * @throws The first exception thrown by any task of the group
+ *
+ * Unlike wait(), a thread outside the pool helps too, so a caller that
+ * split work into the group keeps working on it instead of blocking. It may
+ * run unrelated tasks of the pool while doing so.
+ */
+void TaskGroup::waitAndHelp() {
+    waitFor(true);
+}
+
+/**
+ * @brief Waits for the group's tasks, optionally running pool work meanwhile
+ *
+ * @param help Run pending pool tasks while the group is incomplete
+ * @throws The first exception thrown by any task of the group
+ *
+ * A helper that finds nothing to take yields and retries while the pool
+ * still counts queued tasks (a peer may be mid-push or mid-steal), and
+ * sleeps until the group changes once the queues are drained.
+ */
+void TaskGroup::waitFor(bool help) {
+    size_t remaining = pending.load();
+    while (remaining != 0) {
+        if (!help || !pool.tryRunPendingTask()) {
+            remaining = pending.load();
+            if (remaining == 0) break;
+            if (help && pool.getQueuedTasks() > 0) {
+                std::this_thread::yield();
+            } else {
+                pending.wait(remaining);
+            }
+        }
+        remaining = pending.load();
+    }
+
+    if (failed.exchange(false)) {
+        std::exception_ptr error = std::move(firstError);
+        firstError = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+/**
+ * @brief Lists the online NUMA nodes
+ *
+ * @return Node ids from /sys/devices/system/node/online, or {0} without NUMA support
+ */
+std::vector<int> NumaTopology::getNodes() {
+    std::vector<int> nodes = parseCpuList(readSysfs("/sys/devices/system/node/online"));
+    if (nodes.empty()) {
+        nodes.push_back(0);
+    }
+    return nodes;
+}
+
+/**
+ * @brief Lists the CPUs of a NUMA node
+ *
+ * @param node Node id
+ * @return CPU indices of the node; empty for unknown or memory-only nodes.
+ *         Without NUMA support node 0 holds every CPU.
+ */
+std::vector<int> NumaTopology::getNodeCpus(int node) {
+    std::string path = "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist";
+    std::ifstream file(path);
+    if (!file) {
+        std::vector<int> cpus;
+        if (node == 0) {
+            for (unsigned i = 0; i < std::thread::hardware_concurrency(); ++i) {
+                cpus.push_back(static_cast<int>(i));
+            }
+        }
+        return cpus;
+    }
+    std::string list;
+    std::getline(file, list);
+    return parseCpuList(list);
+}
+
+/**
+ * @brief Parses a kernel CPU/node list such as "0-3,8,10-11"
+ *
+ * @param list Comma separated indices and inclusive ranges
+ * @return Expanded indices in list order; malformed entries are skipped
+ */
+std::vector<int> NumaTopology::parseCpuList(const std::string& list) {
+    std::vector<int> result;
+    std::stringstream stream(list);
+    std::string item;
+
+    while (std::getline(stream, item, ',')) {
+        int first = 0;
+        int last = 0;
+        if (std::sscanf(item.c_str(), "%d-%d", &first, &last) == 2) {
+            for (int i = first; i <= last; ++i) {
+                result.push_back(i);
+            }
+        } else if (std::sscanf(item.c_str(), "%d", &first) == 1) {
+            result.push_back(first);
+        }
+    }
+    return result;
+}
+
+} // namespace PTManager
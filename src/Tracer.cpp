@@ -0,0 +1,834 @@
+#include "Tracer.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <vector>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace PTManager {
+
+namespace {
+
+constexpr uint64_t TRACE_MAGIC = 0x50544d5452414345; // "PTMTRACE"
+constexpr uint32_t TRACE_VERSION = 2;
+constexpr int TYPE_SHIFT = 56;
+constexpr uint64_t DURATION_MASK = (uint64_t(1) << TYPE_SHIFT) - 1;
+constexpr int ID_SLOT_SHIFT = 40;
+constexpr uint64_t ID_LOCAL_MASK = (uint64_t(1) << ID_SLOT_SHIFT) - 1;
+constexpr size_t MAX_THREADS_LIMIT = size_t(1) << 20;
+constexpr size_t MAX_EVENTS_LIMIT = size_t(1) << 24;
+
+// One event. sequence is 2n + 1 while the slot's n-th record is being
+// written and 2n + 2 once it is complete, so a reader can tell a finished
+// record from a torn or stale one.
+struct TraceRecord {
+    std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> typeDuration;     // type << TYPE_SHIFT | duration
+    std::atomic<uint64_t> id;
+    std::atomic<int64_t> value;
+};
+
+// Owner metadata is guarded by generation: odd while a thread (re)claims
+// the slot, so a reader can discard a slot that changed hands mid-copy
+struct alignas(64) TraceSlot {
+    std::atomic<uint32_t> generation;
+    std::atomic<pid_t> pid;                 // 0 until first claimed; kept after release
+    pid_t tid;
+    char name[16];
+    std::atomic<uint64_t> head;             // Records written by the current owner
+    std::atomic<uint64_t> lastId;           // Last newId() counter, carried over on reuse
+    std::atomic<uint64_t> claimedAt;        // Trace time of the claim
+    std::atomic<uint32_t> owned;            // 1 while a thread holds the slot
+    std::atomic<uint32_t> nextFree;         // Free list link: index + 1, 0 ends the list
+};
+
+struct alignas(64) TraceHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t tsc;                           // Timestamps are TSC ticks
+    uint64_t size;
+    uint32_t maxThreads;
+    uint32_t eventsPerThread;               // Power of two
+    uint64_t baseTicks;                     // Calibration point taken at creation
+    uint64_t baseNanos;                     // CLOCK_MONOTONIC at baseTicks
+    std::atomic<uint64_t> clearedAt;
+    std::atomic<uint32_t> nextSlot;
+    std::atomic<uint64_t> droppedThreads;
+    std::atomic<uint64_t> freeSlots;        // Released slots: ABA tag << 32 | top index + 1
+    std::atomic<uint64_t> recycledSlots;
+    std::atomic<uint64_t> retiredRecords;   // Events written by previous owners of reused slots
+};
+
+// This process's view of a mapped region
+struct TraceRegion {
+    TraceHeader* header;
+    TraceSlot* slots;
+    TraceRecord* records;
+    std::string name;
+};
+
+struct LocalSlot {
+    TraceSlot* slot;
+    TraceRecord* records;
+    uint64_t mask;
+    uint64_t head;
+    uint64_t nextId;
+    uint32_t index;
+    pid_t pid;                              // Process the slot belongs to; 0 before the first claim
+};
+
+// Copy of a slot's owner taken by collect()
+struct TraceThread {
+    pid_t pid;
+    pid_t tid;
+    char name[16];
+    uint64_t recorded;
+};
+
+struct TraceEvent {
+    pid_t pid;
+    pid_t tid;
+    uint64_t start;
+    uint64_t duration;
+    uint64_t id;
+    int64_t value;
+    TraceEventType type;
+};
+
+std::mutex regionMutex;
+std::atomic<TraceRegion*> currentRegion{nullptr};
+std::atomic<pid_t> currentPid{0};
+thread_local LocalSlot localSlot{};
+
+size_t regionSize(size_t maxThreads, size_t eventsPerThread) {
+    return sizeof(TraceHeader) + maxThreads * sizeof(TraceSlot) +
+           maxThreads * eventsPerThread * sizeof(TraceRecord);
+}
+
+TraceRegion* viewOf(void* base, const std::string& name) {
+    auto* header = static_cast<TraceHeader*>(base);
+    auto* slots = reinterpret_cast<TraceSlot*>(static_cast<char*>(base) + sizeof(TraceHeader));
+    auto* records = reinterpret_cast<TraceRecord*>(slots + header->maxThreads);
+    return new TraceRegion{header, slots, records, name};
+}
+
+// Constant-rate TSC that keeps ticking in deep C-states
+bool invariantTsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax, ebx, ecx, edx;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) {
+        return (edx & (1u << 8)) != 0;
+    }
+#endif
+    return false;
+}
+
+uint64_t nowNanos() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void beforeFork() { regionMutex.lock(); }
+void afterForkParent() { regionMutex.unlock(); }
+
+// The child's threads, including the forking one, claim their own slots
+void afterForkChild() {
+    regionMutex.unlock();
+    currentPid.store(getpid(), std::memory_order_relaxed);
+}
+
+void installForkHandlers() {
+    static bool installed = false;
+    if (!installed) {
+        currentPid.store(getpid(), std::memory_order_relaxed);
+        pthread_atfork(&beforeFork, &afterForkParent, &afterForkChild);
+        installed = true;
+    }
+}
+
+// Pushes a released slot onto the free list shared by every process
+void pushFreeSlot(TraceRegion& region, uint32_t index) {
+    std::atomic<uint64_t>& list = region.header->freeSlots;
+    uint64_t top = list.load(std::memory_order_relaxed);
+    uint64_t next;
+    do {
+        region.slots[index].nextFree.store(static_cast<uint32_t>(top), std::memory_order_relaxed);
+        next = ((top >> 32) + 1) << 32 | (index + 1);
+    } while (!list.compare_exchange_weak(top, next, std::memory_order_release, std::memory_order_relaxed));
+}
+
+// Pops a released slot, or returns maxThreads if there is none
+uint32_t popFreeSlot(TraceRegion& region) {
+    std::atomic<uint64_t>& list = region.header->freeSlots;
+    uint64_t top = list.load(std::memory_order_acquire);
+    while (static_cast<uint32_t>(top) != 0) {
+        uint32_t index = static_cast<uint32_t>(top) - 1;
+        uint64_t link = region.slots[index].nextFree.load(std::memory_order_relaxed);
+        uint64_t next = ((top >> 32) + 1) << 32 | link;
+        if (list.compare_exchange_weak(top, next, std::memory_order_acquire, std::memory_order_acquire)) {
+            return index;
+        }
+    }
+    return region.header->maxThreads;
+}
+
+// Returns a slot to the free list unless another releaser got there first
+void releaseSlot(TraceRegion& region, uint32_t index) {
+    uint32_t owned = 1;
+    if (region.slots[index].owned.compare_exchange_strong(owned, 0, std::memory_order_acq_rel)) {
+        pushFreeSlot(region, index);
+    }
+}
+
+/**
+ * @brief Gives the calling thread a slot of the current region
+ *
+ * @param self The thread's local state, reset to the new slot
+ * @return false if every slot is taken; the thread then stays untraced in
+ *         this process
+ *
+ * Called on a thread's first event and again in a forked child, whose
+ * inherited local state still points at the parent's slot. Never-used
+ * slots are taken first, so released slots keep their events for as long
+ * as possible; a reused slot starts an empty ring. Preserves errno, since
+ * traced IPC calls report errors through it.
+ */
+bool claimSlot(LocalSlot& self) {
+    int savedErrno = errno;
+    self = LocalSlot{};
+    self.pid = currentPid.load(std::memory_order_relaxed);
+
+    TraceRegion* region = currentRegion.load(std::memory_order_acquire);
+    if (region == nullptr) {
+        errno = savedErrno;
+        return false;
+    }
+    TraceHeader& header = *region->header;
+
+    uint32_t index = header.maxThreads;
+    if (header.nextSlot.load(std::memory_order_relaxed) < header.maxThreads) {
+        index = header.nextSlot.fetch_add(1, std::memory_order_relaxed);
+    }
+    bool reused = false;
+    if (index >= header.maxThreads) {
+        index = popFreeSlot(*region);
+        reused = true;
+    }
+    if (index >= header.maxThreads) {
+        header.droppedThreads.fetch_add(1, std::memory_order_relaxed);
+        errno = savedErrno;
+        return false;
+    }
+
+    TraceSlot& slot = region->slots[index];
+    uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+    slot.generation.store(generation + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (reused) {
+        header.retiredRecords.fetch_add(slot.head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        header.recycledSlots.fetch_add(1, std::memory_order_relaxed);
+    }
+    slot.tid = gettid();
+    std::memset(slot.name, 0, sizeof(slot.name));
+    pthread_getname_np(pthread_self(), slot.name, sizeof(slot.name));
+    slot.head.store(0, std::memory_order_relaxed);
+    slot.claimedAt.store(Tracer::now(), std::memory_order_relaxed);
+    slot.owned.store(1, std::memory_order_relaxed);
+    slot.pid.store(self.pid, std::memory_order_relaxed);
+    slot.generation.store(generation + 2, std::memory_order_release);
+
+    self.slot = &slot;
+    self.records = region->records + static_cast<size_t>(index) * header.eventsPerThread;
+    self.mask = header.eventsPerThread - 1;
+    self.nextId = slot.lastId.load(std::memory_order_relaxed);
+    self.index = index;
+
+    // Releases the slot when the thread exits, including the forking
+    // thread of a child that calls exit()
+    struct SlotReleaser {
+        ~SlotReleaser() {
+            LocalSlot& owner = localSlot;
+            TraceRegion* current = currentRegion.load(std::memory_order_acquire);
+            if (current != nullptr && owner.slot != nullptr &&
+                owner.pid == currentPid.load(std::memory_order_relaxed)) {
+                releaseSlot(*current, owner.index);
+            }
+            owner.slot = nullptr;
+            owner.records = nullptr;
+        }
+    };
+    static thread_local SlotReleaser releaser;
+    (void)releaser;
+
+    errno = savedErrno;
+    return true;
+}
+
+// Local state for the calling thread's slot in this process, or nullptr
+inline LocalSlot* localFor() {
+    LocalSlot& self = localSlot;
+    if (self.pid != currentPid.load(std::memory_order_relaxed) && !claimSlot(self)) {
+        return nullptr;
+    }
+    return self.records != nullptr ? &self : nullptr;
+}
+
+/**
+ * @brief Copies every complete, uncleared event out of a region
+ *
+ * @param region Region to read; other threads and processes may keep writing
+ * @param events Receives the events in no particular order
+ * @param threads Receives the owner of every slot holding events
+ *
+ * Each record is read between two loads of its sequence number and kept
+ * only if both show the expected completed value. A slot that was claimed
+ * by another thread while it was being copied is skipped entirely.
+ */
+void collect(const TraceRegion& region, std::vector<TraceEvent>& events,
+             std::vector<TraceThread>& threads) {
+    const TraceHeader& header = *region.header;
+    uint64_t clearedAt = header.clearedAt.load(std::memory_order_relaxed);
+    uint32_t claimed = std::min(header.nextSlot.load(std::memory_order_acquire), header.maxThreads);
+    uint64_t capacity = header.eventsPerThread;
+
+    for (uint32_t i = 0; i < claimed; ++i) {
+        const TraceSlot& slot = region.slots[i];
+        uint32_t generation = slot.generation.load(std::memory_order_acquire);
+        TraceThread thread;
+        thread.pid = slot.pid.load(std::memory_order_relaxed);
+        if (generation % 2 != 0 || thread.pid == 0) {
+            continue;
+        }
+        thread.tid = slot.tid;
+        std::memcpy(thread.name, slot.name, sizeof(thread.name));
+        thread.name[sizeof(thread.name) - 1] = '\0';
+        size_t firstEvent = events.size();
+
+        const TraceRecord* ring = region.records + static_cast<size_t>(i) * capacity;
+        uint64_t head = slot.head.load(std::memory_order_acquire);
+        thread.recorded = head;
+        for (uint64_t n = head > capacity ? head - capacity : 0; n < head; ++n) {
+            const TraceRecord& record = ring[n & (capacity - 1)];
+            uint64_t sequence = record.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * n + 2) {
+                continue;
+            }
+            TraceEvent event;
+            event.pid = thread.pid;
+            event.tid = thread.tid;
+            event.start = record.start.load(std::memory_order_relaxed);
+            uint64_t typeDuration = record.typeDuration.load(std::memory_order_relaxed);
+            event.id = record.id.load(std::memory_order_relaxed);
+            event.value = record.value.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (record.sequence.load(std::memory_order_relaxed) != sequence || event.start < clearedAt) {
+                continue;
+            }
+            event.type = static_cast<TraceEventType>(typeDuration >> TYPE_SHIFT);
+            event.duration = typeDuration & DURATION_MASK;
+            events.push_back(event);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.generation.load(std::memory_order_relaxed) != generation) {
+            events.resize(firstEvent);
+            continue;
+        }
+        threads.push_back(thread);
+    }
+}
+
+// Writes s as the body of a JSON string
+void writeJsonText(std::ostream& out, const char* s) {
+    for (; *s != '\0'; ++s) {
+        unsigned char ch = static_cast<unsigned char>(*s);
+        if (ch == '"' || ch == '\\') {
+            out << '\\' << *s;
+        } else if (ch < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            out << escaped;
+        } else {
+            out << *s;
+        }
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Names an event type as it appears in exported traces
+ *
+ * @param type Event type
+ * @return Static string
+ */
+const char* traceEventName(TraceEventType type) {
+    switch (type) {
+        case TraceEventType::TASK_ENQUEUE: return "enqueue";
+        case TraceEventType::TASK_RUN: return "task";
+        case TraceEventType::LOCK_WAIT: return "lock wait";
+        case TraceEventType::IPC_SEND: return "send";
+        case TraceEventType::IPC_RECEIVE: return "receive";
+        case TraceEventType::PROCESS_SPAWN: return "spawn";
+        case TraceEventType::PROCESS_START: return "start";
+        case TraceEventType::PROCESS_EXIT: return "exit";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Reads CLOCK_MONOTONIC, the trace clock where the TSC is unusable
+ *
+ * @return Nanoseconds
+ */
+uint64_t Tracer::monotonicNanos() {
+    return nowNanos();
+}
+
+/**
+ * @brief Starts recording, mapping the trace region on first use
+ *
+ * @param options Region name and sizes; ignored if a region already exists
+ * @return true if recording; false if the region could not be created
+ *
+ * An anonymous region is shared with children forked later. A named one is
+ * created afresh (replacing a stale object of the same name) and can be
+ * attach()ed by other processes; remove it with unlinkShared().
+ */
+bool Tracer::enable(const TraceOptions& options) {
+    std::lock_guard<std::mutex> lock(regionMutex);
+    installForkHandlers();
+
+    if (currentRegion.load(std::memory_order_relaxed) != nullptr) {
+        active.store(true, std::memory_order_release);
+        return true;
+    }
+
+    if (options.maxThreads == 0 || options.maxThreads > MAX_THREADS_LIMIT ||
+        options.eventsPerThread == 0 || options.eventsPerThread > MAX_EVENTS_LIMIT) {
+        PTM_LOG_ERROR("Invalid trace region size: " << options.maxThreads << " threads x "
+                      << options.eventsPerThread << " events");
+        return false;
+    }
+    size_t events = 1;
+    while (events < options.eventsPerThread) {
+        events <<= 1;
+    }
+    size_t size = regionSize(options.maxThreads, events);
+
+    void* base = MAP_FAILED;
+    if (options.sharedName.empty()) {
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    } else {
+        int fd = shm_open(options.sharedName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd == -1 && errno == EEXIST) {
+            shm_unlink(options.sharedName.c_str());
+            fd = shm_open(options.sharedName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        }
+        if (fd == -1) {
+            PTM_LOG_ERROR("Failed to create trace region " << options.sharedName << ": " << strerror(errno));
+            return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) == 0) {
+            base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd, 0);
+        }
+        if (base == MAP_FAILED) {
+            shm_unlink(options.sharedName.c_str());
+        }
+        close(fd);
+    }
+    if (base == MAP_FAILED) {
+        PTM_LOG_ERROR("Failed to map " << size << " byte trace region: " << strerror(errno));
+        return false;
+    }
+
+    bool useTsc = invariantTsc();
+    tscClock.store(useTsc, std::memory_order_relaxed);
+
+    auto* header = static_cast<TraceHeader*>(base);
+    header->version = TRACE_VERSION;
+    header->tsc = useTsc ? 1 : 0;
+    header->size = size;
+    header->maxThreads = static_cast<uint32_t>(options.maxThreads);
+    header->eventsPerThread = static_cast<uint32_t>(events);
+    header->baseNanos = nowNanos();
+    header->baseTicks = now();
+    header->clearedAt.store(0, std::memory_order_relaxed);
+    header->nextSlot.store(0, std::memory_order_relaxed);
+    header->droppedThreads.store(0, std::memory_order_relaxed);
+    header->freeSlots.store(0, std::memory_order_relaxed);
+    header->recycledSlots.store(0, std::memory_order_relaxed);
+    header->retiredRecords.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = TRACE_MAGIC;
+
+    currentRegion.store(viewOf(base, options.sharedName), std::memory_order_release);
+    active.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Joins a named trace region and starts recording into it
+ *
+ * @param sharedName Name the creating process passed in TraceOptions
+ * @return true if recording; false if the region is missing or invalid, or
+ *         this process already uses a different region
+ */
+bool Tracer::attach(const std::string& sharedName) {
+    std::lock_guard<std::mutex> lock(regionMutex);
+    installForkHandlers();
+
+    TraceRegion* existing = currentRegion.load(std::memory_order_relaxed);
+    if (existing != nullptr) {
+        if (existing->name != sharedName) {
+            PTM_LOG_ERROR("Cannot attach to trace region " << sharedName << ": already tracing into "
+                          << (existing->name.empty() ? "an anonymous region" : existing->name));
+            return false;
+        }
+        active.store(true, std::memory_order_release);
+        return true;
+    }
+
+    int fd = shm_open(sharedName.c_str(), O_RDWR, 0);
+    if (fd == -1) {
+        PTM_LOG_ERROR("Failed to open trace region " << sharedName << ": " << strerror(errno));
+        return false;
+    }
+    struct stat info{};
+    void* base = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && static_cast<size_t>(info.st_size) >= sizeof(TraceHeader)) {
+        base = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_NORESERVE, fd, 0);
+    }
+    close(fd);
+    if (base == MAP_FAILED) {
+        PTM_LOG_ERROR("Failed to map trace region " << sharedName);
+        return false;
+    }
+
+    auto* header = static_cast<TraceHeader*>(base);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->magic != TRACE_MAGIC || header->version != TRACE_VERSION ||
+        header->size != static_cast<uint64_t>(info.st_size) ||
+        header->size != regionSize(header->maxThreads, header->eventsPerThread)) {
+        PTM_LOG_ERROR("Trace region " << sharedName << " is not a valid trace region");
+        munmap(base, static_cast<size_t>(info.st_size));
+        return false;
+    }
+
+    tscClock.store(header->tsc != 0, std::memory_order_relaxed);
+    currentRegion.store(viewOf(base, sharedName), std::memory_order_release);
+    active.store(true, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Stops recording in this process; other processes keep tracing
+ */
+void Tracer::disable() {
+    active.store(false, std::memory_order_release);
+}
+
+/**
+ * @brief Appends an event to the calling thread's ring
+ *
+ * @param type Event type
+ * @param start Start time from now()
+ * @param end End time from now(); equal to start for instants
+ * @param id Type-specific id (see TraceEventType)
+ * @param value Type-specific value
+ *
+ * The ring has this one writer, so the head is kept thread-locally and only
+ * published for readers. The record is bracketed by its sequence number:
+ * odd while being written, then the completed value.
+ */
+void Tracer::record(TraceEventType type, uint64_t start, uint64_t end, uint64_t id, int64_t value) {
+    if (!isEnabled()) {
+        return;
+    }
+    LocalSlot* self = localFor();
+    if (self == nullptr) {
+        return;
+    }
+
+    uint64_t n = self->head;
+    TraceRecord& record = self->records[n & self->mask];
+    record.sequence.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    record.start.store(start, std::memory_order_relaxed);
+    record.typeDuration.store((static_cast<uint64_t>(type) << TYPE_SHIFT) |
+                              ((end > start ? end - start : 0) & DURATION_MASK),
+                              std::memory_order_relaxed);
+    record.id.store(id, std::memory_order_relaxed);
+    record.value.store(value, std::memory_order_relaxed);
+    record.sequence.store(2 * n + 2, std::memory_order_release);
+
+    self->head = n + 1;
+    self->slot->head.store(n + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Makes an id for linking related events, e.g. a task's enqueue and run
+ *
+ * @return Slot index in the high bits and a per-thread counter in the low
+ *         bits; 0 while disabled or for an untraced thread
+ */
+uint64_t Tracer::newId() {
+    if (!isEnabled()) {
+        return 0;
+    }
+    LocalSlot* self = localFor();
+    if (self == nullptr) {
+        return 0;
+    }
+    uint64_t counter = ++self->nextId;
+    self->slot->lastId.store(counter, std::memory_order_relaxed);
+    return (static_cast<uint64_t>(self->index + 1) << ID_SLOT_SHIFT) | (counter & ID_LOCAL_MASK);
+}
+
+/**
+ * @brief Records a child's exit and releases the slots its threads held
+ *
+ * @param pid Reaped child
+ * @param exitStatus Exit status reported as the event value
+ *
+ * Threads that exit normally release their own slot; this covers a child
+ * that ended with _exit(), exec or a signal. Only slots claimed before the
+ * exit was recorded are released, so a later process that reuses the PID
+ * keeps its own. Slots are released even while recording is disabled.
+ */
+void Tracer::processExited(pid_t pid, int exitStatus) {
+    uint64_t exitedAt = now();
+    if (isEnabled()) {
+        record(TraceEventType::PROCESS_EXIT, exitedAt, exitedAt, static_cast<uint64_t>(pid), exitStatus);
+    }
+
+    TraceRegion* region = currentRegion.load(std::memory_order_acquire);
+    if (region == nullptr || pid <= 0) {
+        return;
+    }
+    uint32_t claimed = std::min(region->header->nextSlot.load(std::memory_order_acquire),
+                                region->header->maxThreads);
+    for (uint32_t i = 0; i < claimed; ++i) {
+        const TraceSlot& slot = region->slots[i];
+        if (slot.owned.load(std::memory_order_acquire) != 0 &&
+            slot.pid.load(std::memory_order_relaxed) == pid &&
+            slot.claimedAt.load(std::memory_order_relaxed) < exitedAt) {
+            releaseSlot(*region, i);
+        }
+    }
+}
+
+/**
+ * @brief Writes the retained events of every process as Chrome trace JSON
+ *
+ * @param out Destination stream
+ * @return false if tracing was never enabled or the stream failed
+ *
+ * Times are microseconds since the region was created, converted with the
+ * tick rate measured between creation and now. Thread and process names
+ * are emitted as metadata; a process is named after its main thread.
+ */
+bool Tracer::writeChromeTrace(std::ostream& out) {
+    TraceRegion* region = currentRegion.load(std::memory_order_acquire);
+    if (region == nullptr) {
+        PTM_LOG_ERROR("Cannot export trace: tracing was never enabled");
+        return false;
+    }
+    const TraceHeader& header = *region->header;
+
+    std::vector<TraceEvent> events;
+    std::vector<TraceThread> threads;
+    collect(*region, events, threads);
+    std::sort(events.begin(), events.end(),
+              [](const TraceEvent& a, const TraceEvent& b) { return a.start < b.start; });
+
+    double nsPerTick = 1.0;
+    if (header.tsc != 0) {
+        uint64_t ticks = now() - header.baseTicks;
+        uint64_t nanos = nowNanos() - header.baseNanos;
+        if (ticks > 0 && nanos > 0) {
+            nsPerTick = static_cast<double>(nanos) / static_cast<double>(ticks);
+        }
+    }
+    auto micros = [&](uint64_t ticks) {
+        double us = (static_cast<double>(ticks) - static_cast<double>(header.baseTicks)) * nsPerTick / 1000.0;
+        char text[32];
+        std::snprintf(text, sizeof(text), "%.3f", us);
+        return std::string(text);
+    };
+    auto hex = [](uint64_t id) {
+        char text[24];
+        std::snprintf(text, sizeof(text), "\"0x%" PRIx64 "\"", id);
+        return std::string(text);
+    };
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    bool first = true;
+    auto begin = [&]() -> std::ostream& {
+        out << (first ? "\n" : ",\n");
+        first = false;
+        return out;
+    };
+
+    for (const TraceThread& thread : threads) {
+        if (thread.tid == thread.pid) {
+            begin() << "{\"ph\":\"M\",\"name\":\"process_name\",\"pid\":" << thread.pid << ",\"args\":{\"name\":\"";
+            writeJsonText(out, thread.name);
+            out << "\"}}";
+        }
+        begin() << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":" << thread.pid << ",\"tid\":" << thread.tid
+                << ",\"args\":{\"name\":\"";
+        writeJsonText(out, thread.name);
+        out << "\"}}";
+    }
+
+    for (const TraceEvent& event : events) {
+        const char* category = "task";
+        switch (event.type) {
+            case TraceEventType::LOCK_WAIT: category = "lock"; break;
+            case TraceEventType::IPC_SEND:
+            case TraceEventType::IPC_RECEIVE: category = "ipc"; break;
+            case TraceEventType::PROCESS_SPAWN:
+            case TraceEventType::PROCESS_START:
+            case TraceEventType::PROCESS_EXIT: category = "process"; break;
+            default: break;
+        }
+        std::string ts = micros(event.start);
+        char duration[32];
+        std::snprintf(duration, sizeof(duration), "%.3f", static_cast<double>(event.duration) * nsPerTick / 1000.0);
+
+        begin() << "{\"ph\":\"X\",\"name\":\"" << traceEventName(event.type) << "\",\"cat\":\"" << category
+                << "\",\"pid\":" << event.pid << ",\"tid\":" << event.tid << ",\"ts\":" << ts
+                << ",\"dur\":" << duration << ",\"args\":{";
+        switch (event.type) {
+            case TraceEventType::TASK_ENQUEUE: out << "\"priority\":" << event.value; break;
+            case TraceEventType::TASK_RUN: out << "\"worker\":" << event.value; break;
+            case TraceEventType::LOCK_WAIT: out << "\"lock\":" << hex(event.id); break;
+            case TraceEventType::IPC_SEND:
+            case TraceEventType::IPC_RECEIVE:
+                out << "\"channel\":" << event.id << ",\"bytes\":" << event.value;
+                break;
+            case TraceEventType::PROCESS_SPAWN: out << "\"child\":" << event.value; break;
+            case TraceEventType::PROCESS_START: break;
+            case TraceEventType::PROCESS_EXIT:
+                out << "\"child\":" << event.id << ",\"status\":" << event.value;
+                break;
+        }
+        out << "}}";
+
+        // Flow arrows from enqueue to run and from spawn to child start
+        if (event.id == 0) {
+            continue;
+        }
+        const char* flow = nullptr;
+        const char* phase = nullptr;
+        switch (event.type) {
+            case TraceEventType::TASK_ENQUEUE: flow = "task"; phase = "s"; break;
+            case TraceEventType::TASK_RUN: flow = "task"; phase = "f"; break;
+            case TraceEventType::PROCESS_SPAWN: flow = "spawn"; phase = "s"; break;
+            case TraceEventType::PROCESS_START: flow = "spawn"; phase = "f"; break;
+            default: break;
+        }
+        if (flow != nullptr) {
+            begin() << "{\"ph\":\"" << phase << "\",\"name\":\"" << flow << "\",\"cat\":\"" << category
+                    << "\",\"id\":" << hex(event.id) << ",\"pid\":" << event.pid << ",\"tid\":" << event.tid
+                    << ",\"ts\":" << ts << (phase[0] == 'f' ? ",\"bp\":\"e\"}" : "}");
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    return out.good();
+}
+
+/**
+ * @brief Writes the trace to a file, e.g. for ui.perfetto.dev
+ *
+ * @param path File to create or replace
+ * @return true if the whole trace was written
+ */
+bool Tracer::exportChromeTrace(const std::string& path) {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        PTM_LOG_ERROR("Failed to open trace file " << path << ": " << strerror(errno));
+        return false;
+    }
+    if (!writeChromeTrace(file)) {
+        PTM_LOG_ERROR("Failed to write trace file " << path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Drops every event recorded so far from later exports and stats
+ *
+ * Writers are not disturbed: events are filtered by start time rather than
+ * erased, so this is safe while other threads and processes keep tracing.
+ */
+void Tracer::clear() {
+    TraceRegion* region = currentRegion.load(std::memory_order_acquire);
+    if (region != nullptr) {
+        region->header->clearedAt.store(now(), std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Summarizes the trace region
+ *
+ * @return Slot and event counts across all processes; all zero if tracing
+ *         was never enabled
+ */
+TraceStats Tracer::getStats() {
+    TraceStats stats;
+    TraceRegion* region = currentRegion.load(std::memory_order_acquire);
+    if (region == nullptr) {
+        return stats;
+    }
+
+    std::vector<TraceEvent> events;
+    std::vector<TraceThread> threads;
+    collect(*region, events, threads);
+
+    const TraceHeader& header = *region->header;
+    stats.threads = threads.size();
+    stats.recorded = header.retiredRecords.load(std::memory_order_relaxed);
+    for (const TraceThread& thread : threads) {
+        stats.recorded += thread.recorded;
+    }
+    stats.retained = events.size();
+    stats.droppedThreads = header.droppedThreads.load(std::memory_order_relaxed);
+    stats.recycledSlots = header.recycledSlots.load(std::memory_order_relaxed);
+    return stats;
+}
+
+/**
+ * @brief Removes a named trace region; mapped processes keep their view
+ *
+ * @param sharedName Name the region was created with
+ * @return true if the object was removed
+ */
+bool Tracer::unlinkShared(const std::string& sharedName) {
+    if (shm_unlink(sharedName.c_str()) != 0) {
+        PTM_LOG_ERROR("Failed to remove trace region " << sharedName << ": " << strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+} // namespace PTManager
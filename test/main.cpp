@@ -2,17 +2,64 @@
 #include "ThreadPool.h"
 #include "IPC.h"
 #include "Synchronization.h"
+#include "ParallelAlgorithms.h"
+#include "Coroutine.h"
+#include "EventLoop.h"
+#include "ShmRingBuffer.h"
+#include "ProcessPool.h"
+#include "LockProfiler.h"
+#include "Logger.h"
+#include "Tracer.h"
+#include <algorithm>
 #include <iostream>
+#include <numeric>
+#include <sstream>
 #include <unistd.h>
 #include <chrono>
 #include <thread>
 #include <random>
 #include <vector>
 #include <cstring>
+#include <fcntl.h>
+#include <poll.h>
 #include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <pthread.h>
+#include <sched.h>
+#include <atomic>
+#include <cstdlib>
+#include <csignal>
+#include <new>
+#include <type_traits>
 
 using namespace PTManager;
 
+// Counts heap allocations while armed (used by the allocation-free submission test)
+static std::atomic<bool> countAllocations{false};
+static std::atomic<size_t> allocationCount{0};
+
+// The replacements forward to out-of-line helpers so that GCC cannot pair a
+// new-expression with the free() behind it (-Wmismatched-new-delete)
+__attribute__((noinline)) static void* countedAllocate(std::size_t size) {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocationCount++;
+    }
+    return std::malloc(size ? size : 1);
+}
+
+__attribute__((noinline)) static void countedRelease(void* p) noexcept { std::free(p); }
+
+void* operator new(std::size_t size) {
+    if (void* p = countedAllocate(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { countedRelease(p); }
+void operator delete(void* p, std::size_t) noexcept { countedRelease(p); }
+
 // ============================================================================
 // PROCESS MANAGEMENT TESTS
 // ============================================================================
@@ -32,6 +79,361 @@ int workerProcess(int id, int seconds) {
     return id * 10;
 }
 
+void testSpawnEngine() {
+    std::cout << "\n--- Spawn engine ---" << std::endl;
+
+    ProcessManager pm;
+    const std::pair<SpawnMethod, const char*> methods[] = {
+        {SpawnMethod::POSIX_SPAWN, "posix_spawn"}, {SpawnMethod::VFORK, "vfork"},
+        {SpawnMethod::CLONE, "clone"}, {SpawnMethod::FORK, "fork"}};
+
+    for (const auto& [method, label] : methods) {
+        SpawnOptions options;
+        options.method = method;
+        options.environment = {"SPAWN_CODE=3"};
+
+        // Exit status, environment and stdout redirection
+        Pipe output;
+        options.stdoutFd = output.getWriteFd();
+        pid_t pid = pm.spawnProcess(label, "sh", {"-c", "echo $SPAWN_CODE; exit $SPAWN_CODE"}, options);
+        output.closeWrite();
+        char echoed[8] = {};
+        ssize_t echoedSize = output.read(echoed, sizeof(echoed) - 1);
+        int status = -1;
+        bool ran = pid > 0 && pm.waitForProcess(pid, &status) && status == 3 &&
+                   echoedSize == 2 && std::string(echoed) == "3\n";
+
+        options.stdoutFd = -1;
+        bool missingRejected = pm.spawnProcess(label, "/nonexistent/program", {}, options) == -1;
+        std::cout << label << ": exit status and stdout " << (ran ? "✓" : "✗")
+                  << ", missing program rejected " << (missingRejected ? "✓" : "✗") << std::endl;
+    }
+
+    // Bulk exec launches from 4 threads
+    std::vector<SpawnRequest> requests;
+    for (int i = 0; i < 40; ++i) {
+        requests.push_back({"farm-" + std::to_string(i), "sh", {"-c", "exit " + std::to_string(i % 7)}});
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::vector<pid_t> farm = pm.spawnProcesses(requests, SpawnOptions{}, 4);
+    auto spawnUs = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    bool farmOk = true;
+    for (size_t i = 0; i < farm.size(); ++i) {
+        int status = -1;
+        farmOk = farmOk && farm[i] > 0 && pm.waitForProcess(farm[i], &status) &&
+                 status == static_cast<int>(i % 7);
+    }
+    std::cout << "spawnProcesses: 40 children in " << spawnUs << " us " << (farmOk ? "✓" : "✗") << std::endl;
+
+    // Bulk fork of in-process tasks
+    std::vector<pid_t> workers = pm.createProcesses(20, "bulk", [](size_t index) {
+        return static_cast<int>(index % 5);
+    }, 4);
+    bool workersOk = true;
+    for (size_t i = 0; i < workers.size(); ++i) {
+        int status = -1;
+        workersOk = workersOk && workers[i] > 0 && pm.waitForProcess(workers[i], &status) &&
+                    status == static_cast<int>(i % 5);
+    }
+    std::cout << "createProcesses: 20 forked tasks " << (workersOk ? "✓" : "✗") << std::endl;
+}
+
+void testProcessPool() {
+    std::cout << "\n--- Pre-forked process pool ---" << std::endl;
+
+    ProcessPool pool(3, 40);
+    pool.registerHandler("square", [](std::string_view payload) {
+        long value = std::stol(std::string(payload));
+        return std::to_string(value * value);
+    });
+    pool.registerHandler("pid", [](std::string_view) { return std::to_string(getpid()); });
+    pool.registerHandler("fail", [](std::string_view) -> std::string {
+        throw std::runtime_error("handler failure");
+    });
+    pool.registerHandler("crash", [](std::string_view) -> std::string { std::abort(); });
+
+    Pipe unrelated;
+    bool started = pool.start();
+    std::vector<pid_t> initialPids = pool.getWorkerPids();
+    std::cout << "Started " << initialPids.size() << " workers "
+              << (started && initialPids.size() == 3 ? "✓" : "✗") << std::endl;
+
+    // Workers must not keep the parent's unrelated descriptors open
+    unrelated.closeWrite();
+    pollfd hangup{unrelated.getReadFd(), POLLIN, 0};
+    char byte;
+    bool eof = poll(&hangup, 1, 1000) == 1 && read(unrelated.getReadFd(), &byte, 1) == 0;
+    std::cout << "Parent's pipe sees end of file while workers run: " << (eof ? "✓" : "✗") << std::endl;
+
+    const int tasks = 300;
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<std::string>> results;
+    for (int i = 0; i < tasks; ++i) {
+        results.push_back(pool.submit("square", std::to_string(i)));
+    }
+    bool squaresOk = true;
+    for (int i = 0; i < tasks; ++i) {
+        squaresOk = squaresOk && results[i].get() == std::to_string(static_cast<long>(i) * i);
+    }
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << tasks << " tasks in " << us << " us (" << (us / tasks) << " us/task) "
+              << (squaresOk ? "✓" : "✗") << std::endl;
+
+    // Each worker retires after 40 tasks
+    std::cout << "Workers recycled: " << pool.getRecycleCount()
+              << (pool.getRecycleCount() >= tasks / 40 - 3 ? " ✓" : " ✗") << std::endl;
+
+    auto pid = pool.submit("pid", "");
+    pid_t workerPid = static_cast<pid_t>(std::stol(pid.get()));
+    std::cout << "Tasks run in a separate process: " << (workerPid != getpid() ? "✓" : "✗") << std::endl;
+
+    bool failureReported = false;
+    try {
+        pool.submit("fail", "").get();
+    } catch (const std::runtime_error& e) {
+        failureReported = std::string(e.what()) == "handler failure";
+    }
+    std::cout << "Handler exception propagated: " << (failureReported ? "✓" : "✗") << std::endl;
+
+    bool crashReported = false;
+    try {
+        pool.submit("crash", "").get();
+    } catch (const std::runtime_error&) {
+        crashReported = true;
+    }
+    bool survives = pool.submit("square", "12").get() == "144";
+    bool respawned = false;
+    for (int i = 0; i < 200 && !respawned; ++i) {
+        respawned = pool.getWorkerPids().size() == 3;
+        if (!respawned) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    bool crashOk = crashReported && survives && respawned && pool.getCrashCount() == 1;
+    std::cout << "Crash fails only its task, worker respawned: " << (crashOk ? "✓" : "✗") << std::endl;
+
+    bool unknownRejected = false;
+    try {
+        pool.submit("missing", "");
+    } catch (const std::runtime_error&) {
+        unknownRejected = true;
+    }
+    pool.shutdown();
+    bool reaped = pool.getWorkerPids().empty();
+    std::cout << "Unknown handler rejected: " << (unknownRejected ? "✓" : "✗")
+              << ", workers reaped on shutdown: " << (reaped ? "✓" : "✗") << std::endl;
+}
+
+void testAsyncReaping() {
+    std::cout << "\n--- Asynchronous reaping ---" << std::endl;
+
+    ProcessManager pm;
+    std::mutex orderMutex;
+    std::vector<pid_t> exitOrder;
+    pm.setExitCallback([&](pid_t pid, int) {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        exitOrder.push_back(pid);
+    });
+
+    pid_t slow = pm.createProcess("slow", [] { usleep(300000); return 1; });
+    pid_t fast = pm.createProcess("fast", [] { usleep(50000); return 2; });
+    pid_t medium = pm.createProcess("medium", [] { usleep(150000); return 3; });
+
+    bool timedOut = !pm.waitForProcess(slow, std::chrono::milliseconds(20));
+    pm.waitForAll();
+    // The exit callback runs after the table update that wakes waitForAll()
+    for (int i = 0; i < 200; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            if (exitOrder.size() == 3) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    {
+        std::lock_guard<std::mutex> lock(orderMutex);
+        bool ordered = exitOrder == std::vector<pid_t>{fast, medium, slow};
+        std::cout << "Reaped in completion order with callbacks: " << (ordered ? "✓" : "✗")
+                  << ", timed wait expired: " << (timedOut ? "✓" : "✗") << std::endl;
+    }
+
+    int status = -1;
+    bool cached = pm.getProcessState(medium) == ProcessState::TERMINATED &&
+                  pm.waitForProcess(medium, &status) && status == 3;
+    std::cout << "State and status kept after reaping: " << (cached ? "✓" : "✗") << std::endl;
+
+    // Children that exit on SIGTERM: no fixed shutdown delay
+    for (int i = 0; i < 20; ++i) {
+        pm.createProcess("sleeper", [] { sleep(10); return 0; });
+    }
+    auto start = std::chrono::steady_clock::now();
+    pm.terminateAll();
+    auto promptMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "terminateAll of 20 cooperative children: " << promptMs << " ms"
+              << (promptMs < 500 ? " ✓" : " ✗") << std::endl;
+
+    // A child ignoring SIGTERM is killed once the grace period lapses
+    pid_t stubborn = pm.createProcess("stubborn", [] {
+        signal(SIGTERM, SIG_IGN);
+        sleep(10);
+        return 0;
+    });
+    usleep(50000);
+    start = std::chrono::steady_clock::now();
+    pm.terminateAll(std::chrono::milliseconds(200));
+    auto graceMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    bool killed = pm.getProcessState(stubborn) == ProcessState::TERMINATED;
+    std::cout << "Stubborn child killed after " << graceMs << " ms grace"
+              << (killed && graceMs >= 200 && graceMs < 900 ? " ✓" : " ✗") << std::endl;
+}
+
+void testProcessTable() {
+    std::cout << "\n--- Process table ---" << std::endl;
+
+    // Writers and readers on the table itself, 4 threads x 5000 PIDs
+    ProcessTable table(100);
+    constexpr int THREADS = 4;
+    constexpr int PER_THREAD = 5000;
+    std::atomic<int> misses{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&, t] {
+            std::string role = "role-" + std::to_string(t % 2);
+            for (int i = 1; i <= PER_THREAD; ++i) {
+                pid_t pid = t * PER_THREAD + i;
+                table.insert(pid, role, ProcessState::RUNNING);
+                std::optional<ProcessRecord> record = table.find(pid);
+                if (!record || record->name != role) misses++;
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    bool concurrent = misses == 0 && table.size() == THREADS * PER_THREAD &&
+                      table.liveCount() == THREADS * PER_THREAD && table.internedNames() == 2;
+    std::cout << "Concurrent insert/find of " << THREADS * PER_THREAD << " entries, "
+              << table.internedNames() << " interned names: " << (concurrent ? "✓" : "✗") << std::endl;
+
+    for (pid_t pid = 1; pid <= 1000; ++pid) {
+        table.markTerminated(pid, static_cast<int>(pid % 256));
+    }
+    bool evicted = table.size() == THREADS * PER_THREAD - 900 && !table.contains(1) &&
+                   table.find(1000) && table.find(1000)->exitStatus == 1000 % 256 &&
+                   !table.markTerminated(1000, 0);
+    std::cout << "Oldest terminated entries evicted past retention: " << (evicted ? "✓" : "✗") << std::endl;
+
+    size_t visited = 0;
+    size_t terminated = 0;
+    table.forEach([&](const ProcessRecord& record) {
+        visited++;
+        if (record.state == ProcessState::TERMINATED) terminated++;
+    });
+    size_t purged = table.purgeTerminated();
+    bool iterated = visited == table.size() + purged && terminated == 100 && purged == 100 &&
+                    table.find(PER_THREAD) && table.find(PER_THREAD)->state == ProcessState::RUNNING;
+    std::cout << "forEach visited " << visited << " entries, purged " << purged << ": "
+              << (iterated ? "✓" : "✗") << std::endl;
+
+    // A reused PID that terminates again keeps its place in the queue
+    ProcessTable reused(2);
+    reused.insert(1, "first", ProcessState::RUNNING);
+    reused.markTerminated(1, 0);
+    reused.insert(1, "second", ProcessState::RUNNING);
+    reused.insert(2, "other", ProcessState::RUNNING);
+    reused.markTerminated(2, 0);
+    reused.markTerminated(1, 0);
+    bool stale = reused.find(1) && reused.find(1)->name == "second" && reused.contains(2);
+    reused.insert(3, "third", ProcessState::RUNNING);
+    reused.markTerminated(3, 0);
+    bool requeued = !reused.contains(2) && reused.contains(1) && reused.contains(3);
+    std::cout << "Stale queue entry of a reused PID skipped: "
+              << (stale && requeued ? "✓" : "✗") << std::endl;
+
+    // Through ProcessManager: reaped children are evicted automatically
+    ProcessManager pm;
+    pm.setRetention(5);
+    for (int i = 0; i < 20; ++i) {
+        pm.createProcess("short-lived", [] { _exit(0); return 0; });
+    }
+    pm.waitForAll();
+    size_t retained = pm.getProcessCount();
+    bool bounded = retained == 5 && pm.getRunningCount() == 0 && pm.purgeTerminated() == 5 &&
+                   pm.getProcessCount() == 0;
+    std::cout << "Manager kept " << retained << " of 20 reaped children: " << (bounded ? "✓" : "✗") << std::endl;
+}
+
+void testResourceAccounting() {
+    std::cout << "\n--- Resource limits and accounting ---" << std::endl;
+
+    ProcessManager pm;
+    ResourceLimits limits;
+    limits.rlimits.push_back(RLimit{RLIMIT_NOFILE, 32, 64});
+    limits.cpuAffinity.push_back(0);
+    pid_t limited = pm.createProcess("limited", [] {
+        struct rlimit files;
+        cpu_set_t cpus;
+        bool applied = getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur == 32 && files.rlim_max == 64 &&
+                       sched_getaffinity(0, sizeof(cpus), &cpus) == 0 && CPU_COUNT(&cpus) == 1 &&
+                       CPU_ISSET(0, &cpus);
+        _exit(applied ? 0 : 1);
+        return 0;
+    }, limits);
+    int status = -1;
+    bool applied = limited > 0 && pm.waitForProcess(limited, &status) && status == 0;
+    std::cout << "rlimit and CPU affinity applied in the child: " << (applied ? "✓" : "✗") << std::endl;
+
+    ResourceLimits invalid;
+    invalid.rlimits.push_back(RLimit{RLIMIT_NOFILE, 64, 32});   // soft above hard
+    bool rejected = pm.createProcess("invalid", [] { return 0; }, invalid) == -1;
+    std::cout << "Unappliable limit fails creation: " << (rejected ? "✓" : "✗") << std::endl;
+
+    SpawnOptions options;
+    options.resources.rlimits.push_back(RLimit{RLIMIT_NOFILE, 40, 40});
+    pid_t spawned = pm.spawnProcess("ulimit", "sh", {"-c", "test \"$(ulimit -n)\" = 40"}, options);
+    bool spawnLimited = spawned > 0 && pm.waitForProcess(spawned, &status) && status == 0;
+    std::cout << "Limits applied to exec-style launch: " << (spawnLimited ? "✓" : "✗") << std::endl;
+
+    // A child that burns CPU and touches 32 MB
+    pid_t hog = pm.createProcess("hog", [] {
+        constexpr size_t SIZE = 32 * 1024 * 1024;
+        char* memory = static_cast<char*>(malloc(SIZE));
+        for (size_t i = 0; i < SIZE; i += 4096) memory[i] = 1;
+        volatile uint64_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(100)) sink = sink + 1;
+        free(memory);
+        _exit(0);
+        return 0;
+    });
+    pm.waitForProcess(hog);
+    std::optional<Process> record = pm.getProcess(hog);
+    bool accounted = record && record->usage.userTime + record->usage.systemTime >= std::chrono::milliseconds(50) &&
+                     record->usage.maxRssKb >= 32 * 1024 && record->usage.minorFaults >= 8000;
+    std::cout << "Reaped child's usage recorded: "
+              << (record ? record->usage.userTime.count() / 1000 : 0) << " ms user, "
+              << (record ? record->usage.maxRssKb : 0) << " KB max RSS, "
+              << (record ? record->usage.minorFaults : 0) << " minor faults "
+              << (accounted ? "✓" : "✗") << std::endl;
+
+    // Needs a delegated cgroup v2 hierarchy; skipped elsewhere
+    ResourceLimits grouped;
+    grouped.cgroupParent = "/sys/fs/cgroup";
+    grouped.memoryMax = 256 * 1024 * 1024;
+    if (access("/sys/fs/cgroup/cgroup.controllers", F_OK) != 0 || access("/sys/fs/cgroup", W_OK) != 0) {
+        std::cout << "cgroup v2 not writable, cgroup limits skipped" << std::endl;
+        return;
+    }
+    pid_t member = pm.createProcess("cgroup-member", [] { _exit(0); return 0; }, grouped);
+    if (member < 0) {
+        std::cout << "cgroup could not be created, cgroup limits skipped" << std::endl;
+        return;
+    }
+    pm.waitForProcess(member);
+    record = pm.getProcess(member);
+    bool inGroup = record && record->usage.cgroupCpuUsec >= 0;
+    std::cout << "Child ran in its own cgroup: " << (inGroup ? "✓" : "✗") << std::endl;
+}
+
 void testProcessManagement() {
     std::cout << "\n";
     std::cout << "========================================\n";
@@ -58,6 +460,12 @@ void testProcessManagement() {
     pm.waitForAll();
 
     pm.printAllProcesses();
+
+    testSpawnEngine();
+    testProcessPool();
+    testAsyncReaping();
+    testProcessTable();
+    testResourceAccounting();
     std::cout << "✓ Process management test completed\n" << std::endl;
 }
 
@@ -84,6 +492,762 @@ void ioTask(int id, int ms) {
               << "] Completed I/O task " << id << std::endl;
 }
 
+void testWorkStealing() {
+    std::cout << "\n--- Work-stealing scheduler ---" << std::endl;
+
+    ThreadPool pool(4, SchedulingMode::WORK_STEALING);
+    std::atomic<int> leaves{0};
+    const int roots = 8;
+    const int childrenPerRoot = 250;
+
+    // Each root task fans out from inside a worker, so children land in
+    // that worker's local deque and idle peers have to steal them
+    for (int i = 0; i < roots; ++i) {
+        pool.enqueue([&pool, &leaves, childrenPerRoot]() {
+            for (int j = 0; j < childrenPerRoot; ++j) {
+                pool.enqueue([&leaves, j]() {
+                    fibonacciTask(j % 30);
+                    leaves++;
+                });
+            }
+        });
+    }
+
+    pool.waitForCompletion();
+    std::cout << "Nested tasks executed: " << leaves.load()
+              << " / " << (roots * childrenPerRoot)
+              << (leaves.load() == roots * childrenPerRoot ? " ✓" : " ✗") << std::endl;
+
+    ThreadPoolStats stats = pool.getStats();
+    uint64_t expected = roots + roots * childrenPerRoot;
+    std::cout << "Stats: " << stats.totalTasksExecuted() << " tasks executed, "
+              << stats.totalSteals() << " steals"
+              << (stats.totalTasksExecuted() == expected ? " ✓" : " ✗") << std::endl;
+
+    uint64_t histogramTotal = 0;
+    for (const auto& worker : stats.workers) {
+        for (uint64_t count : worker.executionHistogram) {
+            histogramTotal += count;
+        }
+    }
+    std::cout << "Histogram entries: " << histogramTotal
+              << (histogramTotal == expected ? " ✓" : " ✗") << std::endl;
+}
+
+void testAllocationFreeSubmission() {
+    std::cout << "\n--- Allocation-free task submission ---" << std::endl;
+
+    ThreadPool pool(2);
+    const int batch = 1000;
+    std::atomic<int> posted{0};
+    std::vector<std::future<int>> results;
+    results.reserve(batch);
+
+    // Holding both workers lets the warm-up queue every task, so the queue
+    // reaches its high-water mark regardless of scheduling
+    auto runBatch = [&](bool holdWorkers) {
+        std::atomic<bool> released{!holdWorkers};
+        if (holdWorkers) {
+            for (int w = 0; w < 2; ++w) {
+                pool.post([&released]() { released.wait(false); });
+            }
+        }
+        for (int i = 0; i < batch; ++i) {
+            results.push_back(pool.enqueue([i]() { return i * 2; }));
+            pool.post([&posted]() { posted++; });
+        }
+        released = true;
+        released.notify_all();
+        for (auto& r : results) {
+            r.get();
+        }
+        results.clear();
+        pool.waitForCompletion();
+    };
+
+    runBatch(true);  // Warm up pools and queue capacity
+
+    allocationCount = 0;
+    countAllocations = true;
+    runBatch(false);
+    countAllocations = false;
+
+    std::cout << "Heap allocations for " << (2 * batch) << " steady-state submissions: "
+              << allocationCount.load()
+              << (allocationCount.load() == 0 ? " ✓" : " ✗") << std::endl;
+}
+
+long long parallelFib(ThreadPool& pool, int n) {
+    if (n < 18) {
+        return fibonacciTask(n);
+    }
+
+    long long left = 0;
+    long long right = 0;
+    TaskGroup group(pool);
+    group.run([&pool, &left, n]() { left = parallelFib(pool, n - 1); });
+    right = parallelFib(pool, n - 2);
+    group.wait();
+    return left + right;
+}
+
+void testTaskGroups() {
+    std::cout << "\n--- Task groups and completion waiting ---" << std::endl;
+
+    ThreadPool pool(4, SchedulingMode::WORK_STEALING);
+
+    // Nested waits inside pool tasks must not deadlock the pool
+    auto fib = pool.enqueue([&pool]() { return parallelFib(pool, 27); });
+    long long result = fib.get();
+    std::cout << "Nested TaskGroup fib(27) = " << result
+              << (result == fibonacciTask(27) ? " ✓" : " ✗") << std::endl;
+
+    // A group only waits for its own tasks
+    std::atomic<bool> release{false};
+    pool.post([&release]() {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::atomic<int> done{0};
+    TaskGroup group(pool);
+    for (int i = 0; i < 16; ++i) {
+        group.run([&done]() { done++; });
+    }
+    group.wait();
+    std::cout << "Group finished while unrelated task still running: "
+              << (done.load() == 16 && !release.load() ? "YES ✓" : "NO ✗") << std::endl;
+
+    release = true;
+
+    // Exceptions from group tasks surface in wait()
+    group.run([]() { throw std::runtime_error("group failure"); });
+    try {
+        group.wait();
+        std::cout << "Group exception propagated: NO ✗" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << "Group exception propagated: " << e.what() << " ✓" << std::endl;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; ++i) {
+        pool.post([]() {});
+        pool.waitForCompletion();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << "100 submit+waitForCompletion barriers took " << elapsed.count() << " us" << std::endl;
+}
+
+void testBoundedQueue() {
+    std::cout << "\n--- Bounded queue, overflow policies and batch enqueue ---" << std::endl;
+
+    std::atomic<bool> release{false};
+    auto gate = [&release]() {
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 1;
+        config.queueCapacity = 4;
+        config.overflowPolicy = OverflowPolicy::FAIL;
+        ThreadPool pool(config);
+
+        pool.post(gate);
+        while (pool.getActiveTasks() == 0) {
+            std::this_thread::yield();
+        }
+
+        int accepted = 0;
+        for (int i = 0; i < 6; ++i) {
+            if (pool.tryPost([]() {})) accepted++;
+        }
+        bool threw = false;
+        try {
+            pool.enqueue([]() { return 0; });
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        std::cout << "tryPost accepted " << accepted << "/6 with capacity 4, FAIL threw: "
+                  << (threw ? "YES" : "NO")
+                  << (accepted == 4 && threw ? " ✓" : " ✗") << std::endl;
+
+        release = true;
+        pool.waitForCompletion();
+        release = false;
+    }
+
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 1;
+        config.queueCapacity = 1;
+        config.overflowPolicy = OverflowPolicy::CALLER_RUNS;
+        ThreadPool pool(config);
+
+        pool.post(gate);
+        while (pool.getActiveTasks() == 0) {
+            std::this_thread::yield();
+        }
+        pool.post([]() {});
+        auto ranOn = pool.enqueue([]() { return std::this_thread::get_id(); });
+        std::cout << "CALLER_RUNS executed overflow on caller: "
+                  << (ranOn.get() == std::this_thread::get_id() ? "YES ✓" : "NO ✗") << std::endl;
+
+        release = true;
+        pool.waitForCompletion();
+    }
+
+    {
+        ThreadPoolConfig config;
+        config.numThreads = 2;
+        config.queueCapacity = 8;
+        config.overflowPolicy = OverflowPolicy::BLOCK;
+        ThreadPool pool(config);
+
+        std::vector<std::function<int()>> jobs;
+        for (int i = 1; i <= 100; ++i) {
+            jobs.push_back([i]() { return i; });
+        }
+
+        auto futures = pool.enqueueBatch(jobs);
+        int sum = 0;
+        for (auto& f : futures) {
+            sum += f.get();
+        }
+        std::cout << "enqueueBatch of 100 tasks into capacity-8 queue, sum: " << sum
+                  << (sum == 5050 ? " ✓" : " ✗") << std::endl;
+    }
+}
+
+void testParallelAlgorithms() {
+    std::cout << "\n--- Parallel algorithms ---" << std::endl;
+
+    ThreadPool pool(4, SchedulingMode::WORK_STEALING);
+    const size_t n = 200000;
+
+    std::vector<int> values(n);
+    parallel_for(pool, size_t{0}, n, [&values](size_t i) {
+        values[i] = static_cast<int>((i * 7919) % 10007);
+    });
+    bool filled = true;
+    for (size_t i = 0; i < n; ++i) {
+        filled = filled && values[i] == static_cast<int>((i * 7919) % 10007);
+    }
+    std::cout << "parallel_for filled " << n << " elements: " << (filled ? "YES ✓" : "NO ✗") << std::endl;
+
+    long long expectedSum = std::accumulate(values.begin(), values.end(), 0LL);
+    long long sum = parallel_reduce(pool, values.begin(), values.end(), 0LL);
+    std::cout << "parallel_reduce sum: " << sum
+              << (sum == expectedSum ? " ✓" : " ✗") << std::endl;
+
+    std::vector<long long> squares(n);
+    parallel_transform(pool, values.begin(), values.end(), squares.begin(),
+                       [](int v) { return static_cast<long long>(v) * v; });
+    bool transformed = true;
+    for (size_t i = 0; i < n; ++i) {
+        transformed = transformed && squares[i] == static_cast<long long>(values[i]) * values[i];
+    }
+    std::cout << "parallel_transform: " << (transformed ? "YES ✓" : "NO ✗") << std::endl;
+
+    std::vector<int> sorted = values;
+    parallel_sort(pool, sorted.begin(), sorted.end());
+    std::vector<int> reference = values;
+    std::sort(reference.begin(), reference.end());
+    std::cout << "parallel_sort matches std::sort: "
+              << (sorted == reference ? "YES ✓" : "NO ✗") << std::endl;
+
+    // A caller outside the pool helps with the other halves instead of
+    // sleeping after its leftmost leaf; a fair share here is 800 items
+    for (SchedulingMode mode : {SchedulingMode::GLOBAL_QUEUE, SchedulingMode::WORK_STEALING}) {
+        ThreadPool helped(4, mode);
+        std::thread::id caller = std::this_thread::get_id();
+        std::atomic<size_t> byCaller{0};
+        parallel_for(helped, 0, 4000, [&](int) {
+            auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(20);
+            while (std::chrono::steady_clock::now() < until) {
+            }
+            if (std::this_thread::get_id() == caller) byCaller++;
+        });
+        std::cout << "Caller ran " << byCaller << " of 4000 items ("
+                  << (mode == SchedulingMode::WORK_STEALING ? "work-stealing" : "global queue") << "): "
+                  << (byCaller >= 200 ? "✓" : "✗") << std::endl;
+    }
+}
+
+void testWorkerPlacement() {
+    std::cout << "\n--- Worker placement ---" << std::endl;
+
+    std::vector<int> parsed = NumaTopology::parseCpuList("0-3,8,10-11");
+    std::cout << "parseCpuList(\"0-3,8,10-11\"): "
+              << (parsed == std::vector<int>{0, 1, 2, 3, 8, 10, 11} ? "YES ✓" : "NO ✗") << std::endl;
+
+    ThreadPoolConfig config;
+    config.numThreads = 2;
+    config.placement.cpus = {0};
+    config.placement.pinWorkers = true;
+    config.placement.niceValue = 5;
+    config.placement.threadName = "ptm-bg";
+    ThreadPool background(config);
+
+    auto placed = background.enqueue([]() {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+        char name[16] = {};
+        pthread_getname_np(pthread_self(), name, sizeof(name));
+        return CPU_COUNT(&set) == 1 && CPU_ISSET(0, &set) &&
+               getpriority(PRIO_PROCESS, static_cast<id_t>(gettid())) == 5 &&
+               std::strncmp(name, "ptm-bg-", 7) == 0;
+    });
+    std::cout << "Worker pinned to CPU 0, nice 5, named ptm-bg-N: "
+              << (placed.get() ? "YES ✓" : "NO ✗") << std::endl;
+
+    std::vector<int> nodes = NumaTopology::getNodes();
+    ThreadPoolConfig perNode;
+    perNode.numThreads = 1;
+    perNode.schedulingMode = SchedulingMode::WORK_STEALING;
+    auto pools = ThreadPool::createPerNumaNode(perNode);
+
+    bool nodeLocal = !pools.empty();
+    for (auto& pool : pools) {
+        std::vector<int> cpus = NumaTopology::getNodeCpus(pool->getPlacement().numaNode);
+        int cpu = pool->enqueue([]() { return sched_getcpu(); }).get();
+        nodeLocal = nodeLocal && std::find(cpus.begin(), cpus.end(), cpu) != cpus.end();
+    }
+    std::cout << nodes.size() << " NUMA node(s), " << pools.size()
+              << " per-node pool(s) running on their own CPUs: "
+              << (nodeLocal ? "YES ✓" : "NO ✗") << std::endl;
+}
+
+void testElasticPool() {
+    std::cout << "\n--- Elastic pool ---" << std::endl;
+
+    ThreadPoolConfig config;
+    config.numThreads = 1;
+    config.maxThreads = 4;
+    config.spawnThreshold = std::chrono::milliseconds(1);
+    config.idleTimeout = std::chrono::milliseconds(50);
+    ThreadPool pool(config);
+
+    // The whole burst is queued at once and every task outlasts the sampling
+    // window, so growth cannot rely on a worker finishing a task
+    auto runBurst = [&pool]() {
+        std::vector<std::future<int>> results;
+        for (int i = 0; i < 8; ++i) {
+            results.push_back(pool.enqueue([i]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                return i;
+            }));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        size_t peak = pool.getPoolSize();
+        int sum = 0;
+        for (auto& r : results) {
+            sum += r.get();
+        }
+        return std::make_pair(sum, peak);
+    };
+
+    auto [sum, peak] = runBurst();
+    std::cout << "Burst grew pool from 1 to " << peak << " workers (max 4), sum " << sum << ": "
+              << (peak > 1 && peak <= 4 && sum == 28 ? "YES ✓" : "NO ✗") << std::endl;
+
+    for (int i = 0; i < 100 && pool.getPoolSize() > 1; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    ThreadPoolStats stats = pool.getStats();
+    std::cout << "Idle workers retired back to " << stats.poolSize << " (retired "
+              << stats.workersRetired << " of " << stats.workersSpawned << " spawned): "
+              << (stats.poolSize == 1 && stats.workersRetired == stats.workersSpawned ? "YES ✓" : "NO ✗")
+              << std::endl;
+
+    auto [sum2, peak2] = runBurst();
+    std::cout << "Second burst reused free slots (peak " << peak2 << "), sum " << sum2 << ": "
+              << (peak2 > 1 && sum2 == 28 ? "YES ✓" : "NO ✗") << std::endl;
+}
+
+void testTaskPriorities() {
+    std::cout << "\n--- Task priorities ---" << std::endl;
+
+    ThreadPoolConfig config;
+    config.numThreads = 1;
+    config.starvationLimit = std::chrono::milliseconds(0);
+    ThreadPool pool(config);
+
+    // Hold the only worker so everything below queues up
+    std::promise<void> release;
+    std::shared_future<void> gate = release.get_future().share();
+    pool.post([gate]() { gate.wait(); });
+    while (pool.getActiveTasks() == 0) {
+        std::this_thread::yield();
+    }
+
+    std::mutex orderMutex;
+    std::vector<TaskPriority> order;
+    auto record = [&](TaskPriority priority) {
+        return [&orderMutex, &order, priority]() {
+            std::lock_guard<std::mutex> lock(orderMutex);
+            order.push_back(priority);
+        };
+    };
+    for (int i = 0; i < 10; ++i) pool.post(TaskPriority::LOW, record(TaskPriority::LOW));
+    for (int i = 0; i < 10; ++i) pool.post(record(TaskPriority::NORMAL));
+    for (int i = 0; i < 5; ++i) pool.post(TaskPriority::HIGH, record(TaskPriority::HIGH));
+
+    bool depths = pool.getQueuedTasks(TaskPriority::HIGH) == 5 &&
+                  pool.getQueuedTasks(TaskPriority::NORMAL) == 10 &&
+                  pool.getQueuedTasks(TaskPriority::LOW) == 10;
+    std::cout << "Per-priority queue depth 5/10/10: " << (depths ? "YES ✓" : "NO ✗") << std::endl;
+
+    release.set_value();
+    pool.waitForCompletion();
+
+    bool ordered = order.size() == 25 &&
+        std::is_sorted(order.begin(), order.end(), [](TaskPriority a, TaskPriority b) {
+            return static_cast<int>(a) < static_cast<int>(b);
+        });
+    std::cout << "Executed HIGH, then NORMAL, then LOW: " << (ordered ? "YES ✓" : "NO ✗") << std::endl;
+
+    // With the starvation guard a LOW task that waited past the limit goes
+    // ahead of newer HIGH work
+    ThreadPoolConfig guarded;
+    guarded.numThreads = 1;
+    guarded.starvationLimit = std::chrono::milliseconds(5);
+    ThreadPool guardedPool(guarded);
+
+    std::promise<void> release2;
+    std::shared_future<void> gate2 = release2.get_future().share();
+    guardedPool.post([gate2]() { gate2.wait(); });
+    while (guardedPool.getActiveTasks() == 0) {
+        std::this_thread::yield();
+    }
+
+    order.clear();
+    guardedPool.post(TaskPriority::LOW, record(TaskPriority::LOW));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    for (int i = 0; i < 5; ++i) guardedPool.post(TaskPriority::HIGH, record(TaskPriority::HIGH));
+
+    release2.set_value();
+    guardedPool.waitForCompletion();
+    std::cout << "Starved LOW task served before newer HIGH tasks: "
+              << (!order.empty() && order.front() == TaskPriority::LOW ? "YES ✓" : "NO ✗") << std::endl;
+}
+
+Task<int> addOnPool(ThreadPool& pool, int a, int b) {
+    co_await pool.schedule();
+    if (!pool.isWorkerThread()) {
+        throw std::runtime_error("not resumed on the pool");
+    }
+    co_return a + b;
+}
+
+Task<int> sumOnPool(ThreadPool& pool, int n) {
+    int total = 0;
+    for (int i = 1; i <= n; ++i) {
+        total += co_await addOnPool(pool, i, 0);
+    }
+    co_return total;
+}
+
+Task<void> failOnPool(ThreadPool& pool) {
+    co_await pool.schedule();
+    throw std::runtime_error("coroutine failure");
+}
+
+Task<void> limitedWorker(ThreadPool& pool, AsyncSemaphore& slots,
+                         std::atomic<int>& inside, std::atomic<int>& peak) {
+    co_await slots.acquire(&pool);
+    int now = ++inside;
+    int seen = peak.load();
+    while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+    }
+    co_await pool.schedule();   // Yield while holding the permit
+    --inside;
+    slots.release();
+}
+
+void testCoroutines() {
+    std::cout << "\n--- Coroutines ---" << std::endl;
+
+    ThreadPool pool(2);
+
+    int sum = syncWait(sumOnPool(pool, 100));
+    std::cout << "Task<int> chain resumed on pool workers, sum 1..100: " << sum
+              << (sum == 5050 ? " ✓" : " ✗") << std::endl;
+
+    bool caught = false;
+    try {
+        syncWait(failOnPool(pool));
+    } catch (const std::runtime_error& e) {
+        caught = std::string(e.what()) == "coroutine failure";
+    }
+    std::cout << "Exception propagated through co_await: " << (caught ? "YES ✓" : "NO ✗") << std::endl;
+
+    AsyncSemaphore slots(4);
+    std::atomic<int> inside{0};
+    std::atomic<int> peak{0};
+    std::vector<std::future<void>> done;
+    for (int i = 0; i < 1000; ++i) {
+        done.push_back(spawn(pool, limitedWorker(pool, slots, inside, peak)));
+    }
+    for (auto& f : done) {
+        f.get();
+    }
+    std::cout << "1000 coroutines on 2 workers, AsyncSemaphore(4) peak holders " << peak.load()
+              << ", permits back " << slots.getValue() << ": "
+              << (peak.load() <= 4 && slots.getValue() == 4 ? "YES ✓" : "NO ✗") << std::endl;
+}
+
+// Collects lines in memory; the logger serializes calls to write()
+class CaptureSink : public LogSink {
+public:
+    std::vector<std::string> lines;
+    std::vector<LogLevel> levels;
+
+    void write(const LogRecord& record) override {
+        lines.emplace_back(record.message);
+        levels.push_back(record.level);
+    }
+};
+
+// Forwards lines to a pipe, so a forked child's output reaches the parent
+class PipeSink : public LogSink {
+private:
+    int fd;
+
+public:
+    explicit PipeSink(int writeFd) : fd(writeFd) {}
+    void write(const LogRecord& record) override {
+        std::string line(record.message);
+        line += '\n';
+        ssize_t ignored = ::write(fd, line.data(), line.size());
+        (void)ignored;
+    }
+};
+
+void testLogging() {
+    std::cout << "\n--- Asynchronous logger ---" << std::endl;
+
+    Logger& logger = Logger::instance();
+    std::shared_ptr<LogSink> original = logger.getSink();
+    LogLevel originalLevel = logger.getLevel();
+
+    auto capture = std::make_shared<CaptureSink>();
+    logger.setSink(capture);
+
+    int evaluated = 0;
+    auto countEvaluation = [&evaluated] { return ++evaluated; };
+    PTM_LOG_DEBUG("debug " << countEvaluation());
+    PTM_LOG_INFO("info " << countEvaluation());
+    PTM_LOG_ERROR("error " << countEvaluation());
+    logger.flush();
+    bool filtered = capture->lines.size() == 2 && evaluated == 2 && capture->lines[0] == "info 1" &&
+                    capture->levels[1] == LogLevel::ERROR;
+    std::cout << "DEBUG below the INFO level skipped without formatting: " << (filtered ? "YES ✓" : "NO ✗")
+              << std::endl;
+
+    capture->lines.clear();
+    constexpr int THREADS = 4;
+    constexpr int LINES = 200;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < LINES; ++i) {
+                PTM_LOG_INFO("t" << t << " " << i);
+                if (i % 64 == 63) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    logger.flush();
+    std::vector<int> next(THREADS, 0);
+    bool ordered = true;
+    for (const std::string& line : capture->lines) {
+        int t = 0, i = 0;
+        if (std::sscanf(line.c_str(), "t%d %d", &t, &i) != 2 || t < 0 || t >= THREADS || i < next[t]) {
+            ordered = false;
+            break;
+        }
+        next[t] = i + 1;
+    }
+    uint64_t dropped = logger.getDroppedCount();
+    bool complete = capture->lines.size() + dropped >= static_cast<size_t>(THREADS * LINES);
+    std::cout << capture->lines.size() << " lines from " << THREADS << " threads (" << dropped
+              << " dropped), per-thread order kept: " << (ordered && complete ? "YES ✓" : "NO ✗") << std::endl;
+
+    capture->lines.clear();
+    PTM_LOG_INFO(std::string(Logger::MAX_MESSAGE * 2, 'x'));
+    logger.flush();
+    bool truncated = capture->lines.size() == 1 && capture->lines[0].size() == Logger::MAX_MESSAGE &&
+                     capture->lines[0].compare(Logger::MAX_MESSAGE - 3, 3, "...") == 0;
+    std::cout << "Overlong line truncated to " << Logger::MAX_MESSAGE << " bytes: "
+              << (truncated ? "YES ✓" : "NO ✗") << std::endl;
+
+    int fds[2];
+    bool childLogged = false;
+    if (pipe(fds) == 0) {
+        logger.setSink(std::make_shared<PipeSink>(fds[1]));
+        pid_t pid = fork();
+        if (pid == 0) {
+            // No flush: the child has no drainer, so the line must be written
+            // before the statement returns
+            PTM_LOG_INFO("from child");
+            _exit(0);
+        }
+        waitpid(pid, nullptr, 0);
+        close(fds[1]);
+        char buffer[64] = {};
+        ssize_t n = read(fds[0], buffer, sizeof(buffer) - 1);
+        close(fds[0]);
+        childLogged = n > 0 && std::string(buffer) == "from child\n";
+    }
+    std::cout << "Forked child logs synchronously: " << (childLogged ? "YES ✓" : "NO ✗") << std::endl;
+
+    logger.setSink(nullptr);
+    evaluated = 0;
+    PTM_LOG_ERROR("discarded " << countEvaluation());
+    bool skipped = evaluated == 0 && !Logger::enabled(LogLevel::ERROR);
+    std::cout << "NullSink disables formatting: " << (skipped ? "YES ✓" : "NO ✗") << std::endl;
+
+    logger.setSink(original);
+    logger.setLevel(originalLevel);
+}
+
+size_t countOccurrences(const std::string& text, const std::string& pattern) {
+    size_t count = 0;
+    for (size_t at = text.find(pattern); at != std::string::npos; at = text.find(pattern, at + 1)) {
+        count++;
+    }
+    return count;
+}
+
+void testTracing() {
+    std::cout << "\n--- Task, lock, IPC and process tracing ---" << std::endl;
+
+    TraceOptions options;
+    options.eventsPerThread = 1024;
+    options.maxThreads = 64;
+    bool enabled = Tracer::enable(options) && Tracer::isEnabled();
+    Tracer::clear();
+    std::cout << "Tracing enabled: " << (enabled ? "YES ✓" : "NO ✗") << std::endl;
+
+    constexpr int TASKS = 8;
+    {
+        ThreadPool pool(2);
+        std::vector<std::future<int>> results;
+        for (int i = 0; i < TASKS; ++i) {
+            results.push_back(pool.enqueue([i] { return i; }));
+        }
+        for (auto& result : results) {
+            result.get();
+        }
+    }
+
+    SpinLock spin;
+    spin.lock();
+    std::thread waiter([&spin] {
+        spin.lock();
+        spin.unlock();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    spin.unlock();
+    waiter.join();
+
+    Pipe pipe;
+    pipe.writeString("ping");
+    std::string pong = pipe.readString();
+
+    pid_t child = -1;
+    {
+        ProcessManager pm;
+        child = pm.createProcess("traced-child", [] { return 3; });
+        pm.waitForProcess(child);
+    }
+
+    std::ostringstream json;
+    bool written = Tracer::writeChromeTrace(json);
+    std::string trace = json.str();
+
+    bool tasks = countOccurrences(trace, "\"name\":\"enqueue\"") == TASKS &&
+                 countOccurrences(trace, "\"name\":\"task\",\"cat\":\"task\",\"pid\"") == TASKS &&
+                 countOccurrences(trace, "\"ph\":\"s\",\"name\":\"task\"") == TASKS &&
+                 countOccurrences(trace, "\"ph\":\"f\",\"name\":\"task\"") == TASKS;
+    std::cout << TASKS << " tasks traced from enqueue to run with flow links: "
+              << (written && tasks ? "YES ✓" : "NO ✗") << std::endl;
+
+    bool lockWait = trace.find("\"name\":\"lock wait\"") != std::string::npos;
+    std::cout << "Contended SpinLock traced as a lock wait: " << (lockWait ? "YES ✓" : "NO ✗") << std::endl;
+
+    bool ipc = pong == "ping" && trace.find("\"name\":\"send\"") != std::string::npos &&
+               trace.find("\"bytes\":4}") != std::string::npos &&
+               trace.find("\"name\":\"receive\"") != std::string::npos;
+    std::cout << "Pipe send and receive traced with sizes: " << (ipc ? "YES ✓" : "NO ✗") << std::endl;
+
+    std::string childPid = std::to_string(child);
+    bool processes = child > 0 &&
+                     trace.find("\"name\":\"spawn\",\"cat\":\"process\"") != std::string::npos &&
+                     trace.find("\"name\":\"start\",\"cat\":\"process\",\"pid\":" + childPid + ",") !=
+                         std::string::npos &&
+                     trace.find("\"ph\":\"f\",\"name\":\"spawn\",\"cat\":\"process\",\"id\"") !=
+                         std::string::npos &&
+                     trace.find("\"child\":" + childPid + ",\"status\":3") != std::string::npos;
+    std::cout << "Child start recorded by the child in the shared region, exit by the parent: "
+              << (processes ? "YES ✓" : "NO ✗") << std::endl;
+
+    TraceStats before = Tracer::getStats();
+    std::thread burst([] {
+        for (int i = 0; i < 3000; ++i) {
+            Tracer::instant(TraceEventType::IPC_SEND, 1, i);
+        }
+    });
+    burst.join();
+    TraceStats after = Tracer::getStats();
+    bool wrapped = after.recorded - before.recorded == 3000 && after.retained - before.retained == 1024;
+    std::cout << "Full ring keeps the newest " << options.eventsPerThread << " events: "
+              << (wrapped ? "YES ✓" : "NO ✗") << std::endl;
+
+    // More short-lived threads and _exit()ing children than the region has slots
+    TraceStats beforeChurn = Tracer::getStats();
+    for (int i = 0; i < 80; ++i) {
+        std::thread([] { Tracer::instant(TraceEventType::IPC_SEND, 2, 0); }).join();
+    }
+    {
+        ProcessManager pm;
+        for (int i = 0; i < 80; ++i) {
+            pm.waitForProcess(pm.createProcess("churn", []() -> int { _exit(0); }));
+        }
+    }
+    TraceStats afterChurn = Tracer::getStats();
+    bool recycled = afterChurn.droppedThreads == beforeChurn.droppedThreads &&
+                    afterChurn.recycledSlots > beforeChurn.recycledSlots;
+    std::cout << "Slots of exited threads and processes are recycled (" << afterChurn.recycledSlots
+              << " reused, " << afterChurn.droppedThreads << " dropped): " << (recycled ? "YES ✓" : "NO ✗")
+              << std::endl;
+
+    Tracer::clear();
+    Tracer::disable();
+    {
+        TraceSpan ignored(TraceEventType::TASK_RUN);
+    }
+    Tracer::instant(TraceEventType::TASK_ENQUEUE);
+    bool quiet = !Tracer::isEnabled() && Tracer::getStats().retained == 0;
+    std::cout << "clear() hides old events, disable() stops recording: " << (quiet ? "YES ✓" : "NO ✗")
+              << std::endl;
+
+    const std::string path = "/tmp/ptm_trace_test.json";
+    bool exported = Tracer::exportChromeTrace(path);
+    unlink(path.c_str());
+    std::cout << "Trace exported to a file: " << (exported ? "YES ✓" : "NO ✗") << std::endl;
+}
+
 void testThreadPool() {
     std::cout << "\n";
     std::cout << "========================================\n";
@@ -134,6 +1298,18 @@ void testThreadPool() {
     }
 
     pool.waitForCompletion();
+
+    testWorkStealing();
+    testAllocationFreeSubmission();
+    testTaskGroups();
+    testBoundedQueue();
+    testParallelAlgorithms();
+    testWorkerPlacement();
+    testElasticPool();
+    testTaskPriorities();
+    testCoroutines();
+    testLogging();
+    testTracing();
     std::cout << "✓ Thread pool test completed\n" << std::endl;
 }
 
@@ -224,6 +1400,591 @@ void testSharedMemory() {
     }
 }
 
+Task<size_t> echoConversation(EventLoop& loop, ThreadPool& pool, Pipe& pipe) {
+    char buffer[64];
+    ssize_t n = co_await pipe.readAsync(loop, buffer, sizeof(buffer), &pool);
+    co_return n > 0 ? static_cast<size_t>(n) : 0;
+}
+
+Task<size_t> drainPipe(EventLoop& loop, ThreadPool& pool, Pipe& pipe, size_t expected) {
+    std::vector<char> buffer(65536);
+    size_t total = 0;
+    while (total < expected) {
+        ssize_t n = co_await pipe.readAsync(loop, buffer.data(), buffer.size(), &pool);
+        if (n <= 0) break;
+        total += static_cast<size_t>(n);
+    }
+    co_return total;
+}
+
+void testAsyncPipes() {
+    std::cout << "\n--- Test: Coroutine pipe I/O ---" << std::endl;
+
+    EventLoop loop;
+    ThreadPool pool(2);
+
+    const size_t conversations = 200;
+    std::vector<std::unique_ptr<Pipe>> pipes;
+    std::vector<std::future<size_t>> replies;
+    for (size_t i = 0; i < conversations; ++i) {
+        pipes.push_back(std::make_unique<Pipe>());
+        replies.push_back(spawn(pool, echoConversation(loop, pool, *pipes.back())));
+    }
+
+    const char message[] = "ping";
+    for (auto& pipe : pipes) {
+        pipe->write(message, sizeof(message));
+    }
+
+    size_t received = 0;
+    for (auto& reply : replies) {
+        received += reply.get();
+    }
+    std::cout << conversations << " concurrent pipe reads on 2 workers, bytes: " << received
+              << (received == conversations * sizeof(message) ? " ✓" : " ✗") << std::endl;
+
+    // 1 MiB through one pipe: the writer suspends whenever the pipe is full
+    Pipe bulk;
+    std::vector<char> payload(1 << 20, 'x');
+    auto reader = spawn(pool, drainPipe(loop, pool, bulk, payload.size()));
+    ssize_t written = syncWait(bulk.writeAsync(loop, payload.data(), payload.size(), &pool));
+    size_t read = reader.get();
+    std::cout << "writeAsync/readAsync of 1 MiB: wrote " << written << ", read " << read
+              << (written == static_cast<ssize_t>(payload.size()) && read == payload.size() ? " ✓" : " ✗")
+              << std::endl;
+}
+
+void testEventLoopSupervisor() {
+    std::cout << "\n--- Test: Event loop supervising child processes ---" << std::endl;
+
+    const size_t children = 50;
+    const size_t messagesPerChild = 20;
+    std::vector<std::unique_ptr<Pipe>> pipes;
+    ThreadPool pool(2);
+    EventLoop loop(&pool);
+
+    std::atomic<size_t> bytesReceived{0};
+    std::atomic<size_t> pipesClosed{0};
+    std::atomic<size_t> exits{0};
+    std::atomic<size_t> cleanExits{0};
+
+    // One loop thread serves every child: pipe data, EOF and exit status
+    for (size_t i = 0; i < children; ++i) {
+        pipes.push_back(std::make_unique<Pipe>());
+        Pipe& pipe = *pipes.back();
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            pipe.closeRead();
+            for (size_t m = 0; m < messagesPerChild; ++m) {
+                pipe.write("0123456789", 10);
+                usleep(500);
+            }
+            _exit(7);
+        }
+        pipe.closeWrite();
+
+        int fd = pipe.getReadFd();
+        loop.addHandler(fd, [&loop, &bytesReceived, &pipesClosed, fd](uint32_t) {
+            char buffer[256];
+            ssize_t n = ::read(fd, buffer, sizeof(buffer));
+            if (n > 0) {
+                bytesReceived += static_cast<size_t>(n);
+            } else {
+                loop.removeHandler(fd);
+                pipesClosed++;
+            }
+        });
+        loop.watchProcess(pid, [&exits, &cleanExits](pid_t, int status) {
+            if (status != -1 && WIFEXITED(status) && WEXITSTATUS(status) == 7) cleanExits++;
+            exits++;
+        });
+    }
+
+    // Timers: a periodic tick, a cancelled one-shot and a one-shot that fires
+    std::atomic<int> ticks{0};
+    std::atomic<bool> cancelledRan{false};
+    std::atomic<bool> oneShotRan{false};
+    auto tick = loop.addTimer(std::chrono::milliseconds(5), [&ticks] { ticks++; },
+                              std::chrono::milliseconds(5));
+    auto cancelled = loop.addTimer(std::chrono::milliseconds(20), [&cancelledRan] { cancelledRan = true; });
+    loop.addTimer(std::chrono::milliseconds(10), [&oneShotRan] { oneShotRan = true; });
+    bool cancelOk = loop.cancelTimer(cancelled);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while ((pipesClosed < children || exits < children) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    bool tickCancelled = loop.cancelTimer(tick);
+
+    std::cout << children << " children over " << loop.getHandlerCount() << " remaining handlers, bytes: "
+              << bytesReceived << ", EOFs: " << pipesClosed
+              << (bytesReceived == children * messagesPerChild * 10 && pipesClosed == children ? " ✓" : " ✗")
+              << std::endl;
+    std::cout << "Exit notifications: " << exits << ", status 7: " << cleanExits
+              << (exits == children && cleanExits == children && loop.getProcessWatchCount() == 0 ? " ✓" : " ✗")
+              << std::endl;
+    std::cout << "Periodic timer ticks: " << ticks << ", one-shot ran: " << oneShotRan
+              << ", cancelled ran: " << cancelledRan
+              << (ticks >= 3 && oneShotRan && cancelOk && !cancelledRan && tickCancelled &&
+                  loop.getTimerCount() == 0 ? " ✓" : " ✗")
+              << std::endl;
+
+    bool unknownRejected = !loop.watchProcess(999999999, [](pid_t, int) {});
+    std::cout << "Unknown pid rejected: " << (unknownRejected ? "✓" : "✗") << std::endl;
+}
+
+volatile sig_atomic_t queueNotified = 0;
+
+void testMessageQueues() {
+    std::cout << "\n--- Test: Message queues ---" << std::endl;
+
+    // SysV: variable-length payloads and batches
+    MessageQueue sysv("/tmp", 'Q');
+    if (!sysv.create()) {
+        std::cout << "Failed to create SysV queue ✗" << std::endl;
+        return;
+    }
+    std::vector<std::vector<char>> stale;
+    sysv.receiveBatch(stale, SIZE_MAX, 0, IPC_NOWAIT);
+
+    std::string large(5000, 'L');
+    long type = 0;
+    std::vector<char> message;
+    char small[16];
+    bool smallOk = sysv.send(3, "ctl", 3) && sysv.receive(small, sizeof(small), type) == 3 &&
+                   type == 3 && std::memcmp(small, "ctl", 3) == 0;
+    bool largeOk = sysv.send(4, large.data(), large.size()) && sysv.receive(message, type) &&
+                   type == 4 && std::string(message.begin(), message.end()) == large;
+    std::cout << "SysV 3-byte and 5000-byte messages: " << (smallOk && largeOk ? "✓" : "✗") << std::endl;
+
+    std::vector<std::string_view> batch = {"a", "bb", "ccc", "dddd", "eeeee", "ffffff"};
+    size_t sent = sysv.sendBatch(1, batch);
+    std::vector<std::vector<char>> drained;
+    size_t received = sysv.receiveBatch(drained, 100, 0, IPC_NOWAIT);
+    bool orderOk = received == batch.size();
+    for (size_t i = 0; orderOk && i < received; ++i) {
+        orderOk = std::string_view(drained[i].data(), drained[i].size()) == batch[i];
+    }
+    std::cout << "SysV batch sent " << sent << ", received " << received << (orderOk ? " ✓" : " ✗")
+              << std::endl;
+    sysv.remove();
+
+    // POSIX: priorities, timeouts, batches, notification and epoll
+    PosixMessageQueue posix("/ptm_test_mq", 10, 1024);
+    if (!posix.create()) {
+        std::cout << "Failed to create POSIX queue ✗" << std::endl;
+        return;
+    }
+    stale.clear();
+    posix.setNonBlocking(true);
+    posix.receiveBatch(stale, SIZE_MAX);
+    posix.setNonBlocking(false);
+
+    unsigned int priority = 0;
+    std::vector<char> first;
+    std::vector<char> second;
+    posix.sendString("low", 1);
+    posix.sendString("high", 5);
+    bool priorityOk = posix.receive(first, &priority) && priority == 5 &&
+                      std::string(first.begin(), first.end()) == "high" &&
+                      posix.receive(second, &priority) && priority == 1;
+    std::cout << "Highest priority received first: " << (priorityOk ? "✓" : "✗") << std::endl;
+
+    char buffer[1024];
+    auto start = std::chrono::steady_clock::now();
+    ssize_t timedOut = posix.timedReceive(buffer, sizeof(buffer), std::chrono::milliseconds(20));
+    int timedErrno = errno;
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    std::cout << "timedReceive on empty queue waited " << waited << " ms"
+              << (timedOut == -1 && timedErrno == ETIMEDOUT && waited >= 15 ? " ✓" : " ✗") << std::endl;
+
+    sent = posix.sendBatch(batch, 2);
+    drained.clear();
+    received = posix.receiveBatch(drained, 100);
+    std::cout << "POSIX batch sent " << sent << ", received " << received
+              << (sent == batch.size() && received == batch.size() ? " ✓" : " ✗") << std::endl;
+
+    struct sigaction action{};
+    struct sigaction previous{};
+    action.sa_handler = [](int) { queueNotified = 1; };
+    sigaction(SIGUSR2, &action, &previous);
+    queueNotified = 0;
+    bool registered = posix.notifyBySignal(SIGUSR2);
+    posix.sendString("wake", 0);
+    for (int i = 0; i < 100 && !queueNotified; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    posix.receive(first);
+    sigaction(SIGUSR2, &previous, nullptr);
+    std::cout << "mq_notify signal on arrival: " << (registered && queueNotified ? "✓" : "✗") << std::endl;
+
+    // A child produces; the parent consumes through the event loop
+    const int childMessages = 200;
+    std::atomic<int> consumed{0};
+    posix.setNonBlocking(true);
+    {
+        EventLoop loop;
+        loop.addHandler(posix.getFd(), [&posix, &consumed](uint32_t) {
+            char payload[1024];
+            while (posix.receive(payload, sizeof(payload)) >= 0) {
+                consumed++;
+            }
+        });
+
+        pid_t pid = fork();
+        if (pid == 0) {
+            PosixMessageQueue producer("/ptm_test_mq");
+            if (!producer.open()) _exit(1);
+            for (int i = 0; i < childMessages; ++i) {
+                if (!producer.sendString("event", 1)) _exit(1);
+            }
+            _exit(0);
+        }
+
+        int status = 0;
+        waitpid(pid, &status, 0);
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (consumed < childMessages && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        loop.removeHandler(posix.getFd());
+        std::cout << "EventLoop consumed " << consumed << " messages from a child"
+                  << (WIFEXITED(status) && WEXITSTATUS(status) == 0 && consumed == childMessages ? " ✓" : " ✗")
+                  << std::endl;
+    }
+
+    posix.close();
+    posix.unlink();
+}
+
+void testShmRingBuffer() {
+    std::cout << "\n--- Test: Shared memory ring buffer ---" << std::endl;
+
+    // SPSC: a child process streams variable-length records to the parent
+    const size_t records = 100000;
+    SharedMemory spscShm("/test_ring_spsc", ShmRingBuffer::requiredSize(64 * 1024));
+    if (!spscShm.create() || !spscShm.map()) {
+        std::cout << "Failed to set up ring memory ✗" << std::endl;
+        return;
+    }
+    ShmRingBuffer consumer(spscShm);
+    consumer.initialize(RingMode::SPSC);
+
+    std::vector<char> oversized(consumer.maxRecordSize() + 1);
+    std::cout << "Oversized record rejected: "
+              << (!consumer.tryWrite(oversized.data(), oversized.size()) ? "✓" : "✗") << std::endl;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        SharedMemory shm("/test_ring_spsc", ShmRingBuffer::requiredSize(64 * 1024));
+        ShmRingBuffer producer(shm);
+        if (!shm.open() || !shm.map() || !producer.attach()) _exit(1);
+
+        char record[200];
+        for (size_t i = 0; i < records; ++i) {
+            size_t length = i % sizeof(record) + 1;
+            for (size_t j = 0; j < length; ++j) record[j] = static_cast<char>(i + j);
+            producer.write(record, length);
+        }
+        _exit(0);
+    }
+
+    size_t intact = 0;
+    char record[200];
+    for (size_t i = 0; i < records; ++i) {
+        size_t length = 0;
+        if (!consumer.read(record, sizeof(record), length, std::chrono::milliseconds(5000))) break;
+        bool ok = length == i % sizeof(record) + 1;
+        for (size_t j = 0; ok && j < length; ++j) ok = record[j] == static_cast<char>(i + j);
+        intact += ok;
+    }
+    waitpid(pid, nullptr, 0);
+    auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "SPSC across processes: " << intact << "/" << records << " records intact, "
+              << static_cast<long>(records / elapsed) << " msgs/sec"
+              << (intact == records && consumer.empty() ? " ✓" : " ✗") << std::endl;
+
+    // MPMC: two producer processes, two consumer threads in this process
+    const size_t perProducer = 20000;
+    SharedMemory mpmcShm("/test_ring_mpmc", ShmRingBuffer::requiredSize(16 * 1024));
+    if (!mpmcShm.create() || !mpmcShm.map()) {
+        std::cout << "Failed to set up ring memory ✗" << std::endl;
+        return;
+    }
+    ShmRingBuffer ring(mpmcShm);
+    ring.initialize(RingMode::MPMC);
+
+    std::vector<pid_t> producers;
+    for (uint32_t id = 0; id < 2; ++id) {
+        pid_t child = fork();
+        if (child == 0) {
+            SharedMemory shm("/test_ring_mpmc", ShmRingBuffer::requiredSize(16 * 1024));
+            ShmRingBuffer producer(shm);
+            if (!shm.open() || !shm.map() || !producer.attach()) _exit(1);
+
+            for (uint32_t seq = 0; seq < perProducer; ++seq) {
+                uint32_t message[2] = {id, seq};
+                producer.write(message, sizeof(message));
+            }
+            _exit(0);
+        }
+        producers.push_back(child);
+    }
+
+    std::atomic<size_t> received{0};
+    std::atomic<uint64_t> sums[2] = {0, 0};
+    auto consume = [&] {
+        std::vector<char> message;
+        while (received.load() < 2 * perProducer) {
+            if (!ring.read(message, std::chrono::milliseconds(100))) continue;
+            uint32_t fields[2];
+            std::memcpy(fields, message.data(), sizeof(fields));
+            sums[fields[0] & 1] += fields[1];
+            received++;
+        }
+    };
+    std::thread first(consume);
+    std::thread second(consume);
+    first.join();
+    second.join();
+    for (pid_t child : producers) waitpid(child, nullptr, 0);
+
+    uint64_t expected = static_cast<uint64_t>(perProducer) * (perProducer - 1) / 2;
+    std::cout << "MPMC, 2 producer processes -> 2 consumer threads: received " << received.load()
+              << (received.load() == 2 * perProducer && sums[0] == expected && sums[1] == expected &&
+                  ring.empty() ? " ✓" : " ✗")
+              << std::endl;
+}
+
+void testZeroCopyRing() {
+    std::cout << "\n--- Test: Zero-copy shared memory views ---" << std::endl;
+
+    SharedMemory shm("/test_shm_views", 4096);
+    if (!shm.create() || !shm.map()) {
+        std::cout << "Failed to set up shared memory ✗" << std::endl;
+        return;
+    }
+    uint64_t* counter = shm.at<uint64_t>(8);
+    if (counter != nullptr) *counter = 42;
+    std::span<uint32_t> words = shm.arrayAt<uint32_t>(0, 1024);
+    bool viewsOk = counter != nullptr && words.size() == 1024 && words[2] == 42 &&
+                   shm.at<uint64_t>(3) == nullptr && shm.arrayAt<uint32_t>(0, 1025).empty() &&
+                   shm.view(4090, 16).empty() && shm.view(4080, 16).size() == 16;
+    std::cout << "Typed views with bounds and alignment checks: " << (viewsOk ? "✓" : "✗") << std::endl;
+
+    // 1 MiB frames produced in place by a child and consumed in place here
+    const size_t frames = 32;
+    const size_t frameSize = 1 << 20;
+    const size_t ringSize = ShmRingBuffer::requiredSize(4 * frameSize);
+    SharedMemory ringShm("/test_ring_zero_copy", ringSize);
+    if (!ringShm.create() || !ringShm.map()) {
+        std::cout << "Failed to set up ring memory ✗" << std::endl;
+        return;
+    }
+    ShmRingBuffer consumer(ringShm);
+    consumer.initialize(RingMode::SPSC);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    pid_t pid = fork();
+    if (pid == 0) {
+        SharedMemory memory("/test_ring_zero_copy", ringSize);
+        ShmRingBuffer producer(memory);
+        if (!memory.open() || !memory.map() || !producer.attach()) _exit(1);
+
+        for (size_t i = 0; i < frames; ++i) {
+            ShmRingBuffer::Reservation slot = producer.reserve(frameSize);
+            if (!slot) _exit(1);
+            std::fill(slot.data.begin(), slot.data.end(), static_cast<std::byte>(i));
+            producer.commit(slot);
+        }
+        _exit(0);
+    }
+
+    size_t intact = 0;
+    for (size_t i = 0; i < frames; ++i) {
+        ShmRingBuffer::Record record = consumer.peek(std::chrono::milliseconds(5000));
+        if (!record) break;
+        bool ok = record.data.size() == frameSize &&
+                  std::all_of(record.data.begin(), record.data.end(),
+                              [i](std::byte b) { return b == static_cast<std::byte>(i); });
+        intact += ok;
+        consumer.release(record);
+    }
+    waitpid(pid, nullptr, 0);
+    auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "Reserve/commit + peek/release of " << frames << " x 1 MiB frames: " << intact << " intact, "
+              << static_cast<long>(frames / elapsed) << " frames/sec"
+              << (intact == frames && consumer.empty() ? " ✓" : " ✗") << std::endl;
+}
+
+static bool allPagesResident(void* address, size_t length) {
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    std::vector<unsigned char> residency((length + pageSize - 1) / pageSize);
+    if (mincore(address, length, residency.data()) != 0) return false;
+    return std::all_of(residency.begin(), residency.end(), [](unsigned char page) { return page & 1; });
+}
+
+void testSharedMemoryOptions() {
+    std::cout << "\n--- Test: Shared memory mapping options ---" << std::endl;
+
+    MapOptions huge;
+    huge.hugePages = HugePageMode::HUGETLB;
+    SharedMemory hugeShm("/test_shm_huge", 4 << 20, huge);
+    bool hugeOk = hugeShm.create() && hugeShm.map();
+    std::cout << "HUGETLB segment (" << (hugeShm.usesHugetlbfs() ? "hugetlbfs" : "fallback to regular pages")
+              << "): " << (hugeOk ? "✓" : "✗") << std::endl;
+
+    MapOptions strict;
+    strict.hugePages = HugePageMode::HUGETLB;
+    strict.hugetlbfsPath = "/nonexistent-hugetlbfs";
+    strict.fallbackToSmallPages = false;
+    SharedMemory strictShm("/test_shm_strict", 2 << 20, strict);
+    bool refused = !strictShm.create();
+    std::cout << "HUGETLB without fallback on a missing mount fails: " << (refused ? "✓" : "✗") << std::endl;
+
+    MapOptions transparent;
+    transparent.hugePages = HugePageMode::TRANSPARENT;
+    transparent.populate = true;
+    transparent.advice = MADV_WILLNEED;
+    SharedMemory thpShm("/test_shm_thp", 4 << 20, transparent);
+    bool thpOk = thpShm.create() && thpShm.map() && allPagesResident(thpShm.getAddress(), thpShm.getSize());
+    std::cout << "Transparent huge page advice + prefault, all pages resident: " << (thpOk ? "✓" : "✗")
+              << std::endl;
+
+    MapOptions pinned;
+    pinned.populate = true;
+    pinned.lock = true;
+    SharedMemory pinnedShm("/test_shm_pinned", 1 << 20, pinned);
+    bool pinnedOk = pinnedShm.create() && pinnedShm.map() && pinnedShm.isMemoryLocked() &&
+                    allPagesResident(pinnedShm.getAddress(), pinnedShm.getSize());
+    std::cout << "MAP_POPULATE + mlock: " << (pinnedOk ? "✓" : "✗") << std::endl;
+
+    // Grow a segment while a second process follows the new size
+    SharedMemory growShm("/test_shm_grow", 64 * 1024);
+    if (!growShm.create() || !growShm.map()) {
+        std::cout << "Failed to set up shared memory ✗" << std::endl;
+        return;
+    }
+    *growShm.at<uint64_t>(0) = 0xfeedULL;
+    bool grown = growShm.resize(1 << 20) && growShm.getSize() == (1 << 20) &&
+                 *growShm.at<uint64_t>(0) == 0xfeedULL;
+    *growShm.at<uint64_t>((1 << 20) - 8) = 0xbeefULL;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        SharedMemory follower("/test_shm_grow", 64 * 1024);
+        if (!follower.open() || !follower.map() || !follower.resize(1 << 20)) _exit(1);
+        _exit(*follower.at<uint64_t>((1 << 20) - 8) == 0xbeefULL ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    bool followed = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    std::cout << "resize() 64 KiB -> 1 MiB keeps data, other process remaps: "
+              << (grown && followed ? "✓" : "✗") << std::endl;
+}
+
+void testFramedPipeIO() {
+    std::cout << "\n--- Test: Vectored and batched pipe I/O ---" << std::endl;
+
+    const size_t messages = 20000;
+    const size_t batchSize = 500;
+    Pipe pipe;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        pipe.closeRead();
+        std::vector<std::string> batch;
+        for (size_t i = 0; i < messages; ++i) {
+            batch.push_back("log line " + std::to_string(i));
+            if (batch.size() == batchSize) {
+                if (!pipe.writeBatch(batch)) _exit(1);
+                batch.clear();
+            }
+        }
+        pipe.writeString("done");
+        _exit(0);
+    }
+
+    pipe.closeWrite();
+    FrameReader reader(pipe.getReadFd());
+    std::string_view frame;
+    size_t intact = 0;
+    for (size_t i = 0; i < messages && reader.next(frame); ++i) {
+        intact += frame == "log line " + std::to_string(i);
+    }
+    bool finished = reader.next(frame) && frame == "done" && !reader.next(frame);
+    waitpid(pid, nullptr, 0);
+
+    double perRead = static_cast<double>(messages) / std::max<size_t>(reader.getReadCalls(), 1);
+    std::cout << intact << "/" << messages << " framed messages in " << messages / batchSize
+              << " batched writes and " << reader.getReadCalls() << " reads ("
+              << static_cast<long>(perRead) << " messages per read)"
+              << (intact == messages && finished && perRead > 10 ? " ✓" : " ✗") << std::endl;
+}
+
+void testZeroCopyPipes() {
+    std::cout << "\n--- Test: splice / vmsplice / tee ---" << std::endl;
+
+    const size_t fileSize = 4 << 20;
+    const char* sourcePath = "/tmp/ptm_splice_source";
+    const char* targetPath = "/tmp/ptm_splice_target";
+    std::vector<char> content(fileSize);
+    for (size_t i = 0; i < fileSize; ++i) content[i] = static_cast<char>(i * 31 + 7);
+    int source = ::open(sourcePath, O_CREAT | O_TRUNC | O_RDWR, 0644);
+    bool prepared = source != -1 && ::write(source, content.data(), fileSize) == static_cast<ssize_t>(fileSize);
+
+    Pipe pipe;
+    bool resized = pipe.setCapacity(1 << 20) && pipe.getCapacity() >= (1u << 20);
+    std::cout << "F_SETPIPE_SZ to 1 MiB, capacity now " << pipe.getCapacity() << (resized ? " ✓" : " ✗")
+              << std::endl;
+
+    // File -> pipe -> file, never copied through user space
+    pid_t pid = fork();
+    if (pid == 0) {
+        pipe.closeWrite();
+        int target = ::open(targetPath, O_CREAT | O_TRUNC | O_WRONLY, 0644);
+        _exit(target != -1 && pipe.spliceTo(target, fileSize) == static_cast<ssize_t>(fileSize) ? 0 : 1);
+    }
+    pipe.closeRead();
+    off_t offset = 0;
+    ssize_t moved = prepared ? pipe.spliceFrom(source, fileSize, &offset) : -1;
+    pipe.closeWrite();
+    int status = 0;
+    waitpid(pid, &status, 0);
+
+    std::vector<char> copy(fileSize);
+    int target = ::open(targetPath, O_RDONLY);
+    bool identical = target != -1 && ::read(target, copy.data(), fileSize) == static_cast<ssize_t>(fileSize) &&
+                     copy == content;
+    std::cout << "splice 4 MiB file -> pipe -> child -> file: moved " << moved
+              << (moved == static_cast<ssize_t>(fileSize) && WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+                  identical ? " ✓" : " ✗")
+              << std::endl;
+    if (source != -1) ::close(source);
+    if (target != -1) ::close(target);
+    ::unlink(sourcePath);
+    ::unlink(targetPath);
+
+    // vmsplice user pages into a pipe, then tee them into a second pipe
+    Pipe first;
+    Pipe second;
+    std::vector<char> block(16 * 1024, 'v');
+    ssize_t queued = first.vmspliceFrom(block.data(), block.size());
+    ssize_t duplicated = first.teeTo(second.getWriteFd(), block.size());
+
+    std::vector<char> fromFirst(block.size());
+    std::vector<char> fromSecond(block.size());
+    bool bothRead = first.read(fromFirst.data(), fromFirst.size()) == static_cast<ssize_t>(block.size()) &&
+                    second.read(fromSecond.data(), fromSecond.size()) == static_cast<ssize_t>(block.size());
+    std::cout << "vmsplice 16 KiB then tee into a second pipe: queued " << queued << ", duplicated " << duplicated
+              << (bothRead && fromFirst == block && fromSecond == block ? " ✓" : " ✗") << std::endl;
+}
+
 void testIPC() {
     std::cout << "\n";
     std::cout << "========================================\n";
@@ -232,7 +1993,15 @@ void testIPC() {
 
     testUnnamedPipe();
     testNamedPipe();
+    testFramedPipeIO();
+    testZeroCopyPipes();
     testSharedMemory();
+    testSharedMemoryOptions();
+    testAsyncPipes();
+    testEventLoopSupervisor();
+    testMessageQueues();
+    testShmRingBuffer();
+    testZeroCopyRing();
 
     std::cout << "✓ IPC test completed\n" << std::endl;
 }
@@ -301,6 +2070,67 @@ void testMutex() {
               << " | Perfect sync: " << (counter == numThreads * iterations ? "YES ✓" : "NO ✗") << std::endl;
 }
 
+void testAdaptiveLocks() {
+    std::cout << "\n--- Test: Adaptive Locks ---" << std::endl;
+
+    constexpr int THREADS = 4;
+    constexpr int ITERATIONS = 50000;
+    AdaptiveMutex adaptive;
+    SpinLock spin;
+    SafeMutex untracked("untracked", false);
+    long adaptiveCount = 0, spinCount = 0, untrackedCount = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < ITERATIONS; ++i) {
+                { std::lock_guard<AdaptiveMutex> lock(adaptive); adaptiveCount++; }
+                spin.lock(); spinCount++; spin.unlock();
+                { SafeLockGuard lock(untracked); untrackedCount++; }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    long expected = static_cast<long>(THREADS) * ITERATIONS;
+    bool exclusive = adaptiveCount == expected && spinCount == expected && untrackedCount == expected;
+    std::cout << "AdaptiveMutex, SpinLock and untracked SafeMutex under " << THREADS
+              << " threads: " << (exclusive ? "✓" : "✗") << std::endl;
+
+    // Timed acquisition gives up while another thread holds the lock
+    adaptive.lock();
+    bool timedOut = false;
+    auto start = std::chrono::steady_clock::now();
+    std::thread contender([&] { timedOut = !adaptive.tryLockFor(std::chrono::milliseconds(50)); });
+    contender.join();
+    auto waitedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    adaptive.unlock();
+    bool reacquired = adaptive.tryLock();
+    if (reacquired) adaptive.unlock();
+    std::cout << "tryLockFor timed out after " << waitedMs << " ms: "
+              << (timedOut && waitedMs >= 50 && reacquired && !adaptive.isLocked() ? "✓" : "✗") << std::endl;
+
+    bool untrackedState = untracked.tryLock() && untracked.isLocked() &&
+                          untracked.getOwner() == std::thread::id();
+    untracked.unlock();
+    untrackedState = untrackedState && !untracked.isLocked() && !untracked.isTracking();
+    std::cout << "Untracked SafeMutex skips owner bookkeeping: " << (untrackedState ? "✓" : "✗") << std::endl;
+
+    // Uncontended cost per lock/unlock pair
+    constexpr int PAIRS = 1000000;
+    SafeMutex tracked("tracked");
+    auto timePairs = [](auto&& pair) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < PAIRS; ++i) pair();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() / PAIRS;
+    };
+    double trackedNs = timePairs([&] { tracked.lock(); tracked.unlock(); });
+    double untrackedNs = timePairs([&] { untracked.lock(); untracked.unlock(); });
+    double adaptiveNs = timePairs([&] { adaptive.lock(); adaptive.unlock(); });
+    std::cout << "Uncontended lock+unlock: tracked SafeMutex " << trackedNs << " ns, untracked "
+              << untrackedNs << " ns, AdaptiveMutex " << adaptiveNs << " ns" << std::endl;
+}
+
 void testSemaphore() {
     std::cout << "\n--- Test: Semaphore (Producer-Consumer) ---" << std::endl;
 
@@ -389,6 +2219,182 @@ void testRWLock() {
     std::cout << "Reader-Writer test completed!" << std::endl;
 }
 
+void testScalableReadLocks() {
+    std::cout << "\n--- Test: Scalable Read Locks ---" << std::endl;
+
+    constexpr int READERS = 4;
+    constexpr int WRITES = 500;
+
+    // Writers keep first == second; a reader seeing them differ saw a torn write
+    ShardedRWLock sharded;
+    long first = 0, second = 0;
+    std::atomic<bool> done{false};
+    std::atomic<long> torn{0}, reads{0};
+    std::vector<std::thread> threads;
+    for (int r = 0; r < READERS; ++r) {
+        threads.emplace_back([&] {
+            while (!done.load()) {
+                sharded.readLock();
+                if (first != second) torn++;
+                sharded.readUnlock();
+                reads++;
+            }
+        });
+    }
+    for (int i = 0; i < WRITES; ++i) {
+        sharded.writeLock();
+        first++;
+        std::this_thread::yield();
+        second++;
+        sharded.writeUnlock();
+    }
+    done = true;
+    for (auto& thread : threads) thread.join();
+    threads.clear();
+    bool exclusive = torn == 0 && first == WRITES && second == WRITES;
+    std::cout << "ShardedRWLock (" << sharded.getSlotCount() << " slots): " << reads.load()
+              << " reads during " << WRITES << " writes, torn: " << torn.load()
+              << (exclusive ? " ✓" : " ✗") << std::endl;
+
+    bool tryRead = sharded.tryReadLock();
+    if (tryRead) sharded.readUnlock();
+    std::cout << "tryReadLock on a free lock: " << (tryRead ? "✓" : "✗") << std::endl;
+
+    struct Config {
+        long version;
+        long checksum;
+        int limits[6];
+    };
+    SeqLock<Config> config(Config{0, 0, {}});
+    done = false;
+    torn = 0;
+    reads = 0;
+    for (int r = 0; r < READERS; ++r) {
+        threads.emplace_back([&] {
+            while (!done.load()) {
+                Config snapshot = config.load();
+                long sum = 0;
+                for (int limit : snapshot.limits) sum += limit;
+                if (snapshot.checksum != snapshot.version * 6 || sum != snapshot.checksum) torn++;
+                reads++;
+            }
+        });
+    }
+    for (int i = 1; i <= WRITES; ++i) {
+        config.update([](const Config& current) {
+            Config next = current;
+            next.version++;
+            for (int& limit : next.limits) limit = static_cast<int>(next.version);
+            next.checksum = next.version * 6;
+            return next;
+        });
+        if (i % 64 == 0) std::this_thread::yield();
+    }
+    done = true;
+    for (auto& thread : threads) thread.join();
+    bool consistent = torn == 0 && config.load().version == WRITES && config.getSequence() == 2u * WRITES;
+    std::cout << "SeqLock: " << reads.load() << " snapshots during " << WRITES << " updates, torn: "
+              << torn.load() << (consistent ? " ✓" : " ✗") << std::endl;
+
+    // Read-side cost against the mutex-based RWLock, no writers
+    constexpr int ACQUISITIONS = 50000;
+    RWLock classic;
+    auto timeReaders = [&](auto&& acquire) {
+        std::vector<std::thread> readers;
+        auto begin = std::chrono::steady_clock::now();
+        for (int r = 0; r < READERS; ++r) {
+            readers.emplace_back([&] { for (int i = 0; i < ACQUISITIONS; ++i) acquire(); });
+        }
+        for (auto& reader : readers) reader.join();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count() /
+               (static_cast<double>(READERS) * ACQUISITIONS);
+    };
+    double classicNs = timeReaders([&] { classic.readLock(); classic.readUnlock(); });
+    double shardedNs = timeReaders([&] { sharded.readLock(); sharded.readUnlock(); });
+    double seqNs = timeReaders([&] { config.load(); });
+    std::cout << "Read acquisition with " << READERS << " readers: RWLock " << classicNs
+              << " ns, ShardedRWLock " << shardedNs << " ns, SeqLock " << seqNs << " ns" << std::endl;
+}
+
+void testLockProfiling() {
+    std::cout << "\n--- Test: Lock Profiling ---" << std::endl;
+
+    if constexpr (!LockProfiler::enabled) {
+        bool empty = std::is_empty_v<LockProbe> && sizeof(SpinLock) == sizeof(std::atomic_flag);
+        std::cout << "Profiling compiled out, probes take no space: " << (empty ? "✓" : "✗") << std::endl;
+        return;
+    }
+
+    std::vector<LockCycle> reported;
+    std::mutex reportedMutex;
+    LockProfiler::instance().setCycleHandler([&](const LockCycle& cycle) {
+        std::lock_guard<std::mutex> lock(reportedMutex);
+        reported.push_back(cycle);
+    });
+
+    SafeMutex accounts("profiled_accounts");
+    SafeMutex ledger("profiled_ledger");
+    SpinLock counterLock("profiled_spin");
+    long counter = 0;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 2000; ++i) {
+                counterLock.lock();
+                counter++;
+                counterLock.unlock();
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    // accounts -> ledger, later ledger -> accounts: an inversion, reported
+    // when the second order is first attempted even though it cannot
+    // deadlock here
+    {
+        SafeLockGuard first(accounts);
+        SafeLockGuard second(ledger);
+    }
+    {
+        SafeLockGuard first(ledger);
+        SafeLockGuard second(accounts);
+    }
+    LockProfiler::instance().setCycleHandler(nullptr);
+
+    LockStats spinStats, accountStats;
+    for (const LockStats& stats : LockProfiler::instance().getStats()) {
+        if (stats.name == "profiled_spin") spinStats = stats;
+        if (stats.name == "profiled_accounts") accountStats = stats;
+    }
+    uint64_t histogramTotal = 0;
+    for (uint64_t count : spinStats.waitHistogram) histogramTotal += count;
+    bool counted = counter == 8000 && spinStats.acquisitions == 8000 && histogramTotal == 8000 &&
+                   accountStats.acquisitions == 2 && accountStats.totalHoldNs > 0;
+    std::cout << "Acquisitions and histograms recorded (spin contended " << spinStats.contended
+              << " of " << spinStats.acquisitions << "): " << (counted ? "✓" : "✗") << std::endl;
+
+    bool cycleFound = reported.size() == 1 && reported[0].locks.size() == 2 &&
+                      reported[0].locks[0] == "profiled_ledger" && reported[0].locks[1] == "profiled_accounts";
+    std::cout << "Lock order inversion reported at acquisition: " << (cycleFound ? "✓" : "✗") << std::endl;
+
+    // Per-object locks: destroyed locks leave the graph and share one entry
+    size_t entriesBefore = LockProfiler::instance().getStats().size();
+    for (int i = 0; i < 1000; ++i) {
+        SafeMutex perObject("profiled_per_object");
+        SafeLockGuard outer(accounts);
+        SafeLockGuard inner(perObject);
+    }
+    std::vector<LockStats> afterChurn = LockProfiler::instance().getStats();
+    uint64_t perObjectAcquisitions = 0;
+    for (const LockStats& stats : afterChurn) {
+        if (stats.name == "profiled_per_object") perObjectAcquisitions += stats.acquisitions;
+    }
+    bool bounded = afterChurn.size() == entriesBefore + 1 && perObjectAcquisitions == 1000;
+    std::cout << "1000 destroyed locks folded into one entry: " << (bounded ? "✓" : "✗") << std::endl;
+    LockProfiler::instance().printReport(std::cout);
+}
+
 void testBarrier() {
     std::cout << "\n--- Test: Barrier Synchronization ---" << std::endl;
 
@@ -468,6 +2474,155 @@ void testDeadlockPrevention() {
     std::cout << "Deadlock prevention demonstrated!" << std::endl;
 }
 
+struct SharedSyncState {
+    ProcessMutex mutex;
+    ProcessSemaphore items;
+    ProcessRWLock rwlock;
+    ProcessBarrier barrier{5};
+    uint64_t counter = 0;
+    uint64_t left = 0;
+    uint64_t right = 0;
+    std::atomic<uint32_t> arrivals{0};
+    std::atomic<uint32_t> serialWaiters{0};
+};
+
+static bool waitForChildren(const std::vector<pid_t>& children) {
+    bool allOk = true;
+    for (pid_t child : children) {
+        int status = 0;
+        waitpid(child, &status, 0);
+        allOk = allOk && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    }
+    return allOk;
+}
+
+void testProcessSharedSync() {
+    std::cout << "\n--- Test: Process-shared primitives ---" << std::endl;
+
+    SharedMemory shm("/test_sync_shared", sizeof(SharedSyncState));
+    if (!shm.create() || !shm.map()) {
+        std::cout << "Failed to set up shared memory ✗" << std::endl;
+        return;
+    }
+    SharedSyncState* shared = new (shm.at<SharedSyncState>(0)) SharedSyncState();
+
+    // Robust mutex: four processes increment one counter
+    std::vector<pid_t> children;
+    for (int i = 0; i < 4; ++i) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            for (int j = 0; j < 10000; ++j) {
+                shared->mutex.lock();
+                shared->counter++;
+                shared->mutex.unlock();
+            }
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+    bool childrenOk = waitForChildren(children);
+    std::cout << "ProcessMutex, 4 processes x 10000 increments: " << shared->counter
+              << (childrenOk && shared->counter == 40000 ? " ✓" : " ✗") << std::endl;
+
+    pid_t pid = fork();
+    if (pid == 0) {
+        shared->mutex.lock();
+        _exit(0); // Dies holding the mutex
+    }
+    waitpid(pid, nullptr, 0);
+    LockResult died = shared->mutex.lock();
+    bool repaired = died == LockResult::OWNER_DIED && shared->mutex.makeConsistent();
+    shared->mutex.unlock();
+    bool usable = shared->mutex.tryLock() == LockResult::ACQUIRED;
+    shared->mutex.unlock();
+    std::cout << "Owner death reported and recovered: " << (repaired && usable ? "✓" : "✗") << std::endl;
+
+    // Semaphore handoffs between processes
+    const int handoffs = 10000;
+    auto start = std::chrono::high_resolution_clock::now();
+    pid = fork();
+    if (pid == 0) {
+        for (int i = 0; i < handoffs; ++i) {
+            if (!shared->items.wait()) _exit(1);
+        }
+        _exit(0);
+    }
+    for (int i = 0; i < handoffs; ++i) {
+        shared->items.post();
+    }
+    childrenOk = waitForChildren({pid});
+    auto elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+    std::cout << "ProcessSemaphore, " << handoffs << " cross-process posts: "
+              << static_cast<long>(handoffs / elapsed) << " handoffs/sec"
+              << (childrenOk && shared->items.getValue() == 0 ? " ✓" : " ✗") << std::endl;
+
+    // RW lock: writers keep left == right, the reader never sees them differ
+    children.clear();
+    for (int i = 0; i < 2; ++i) {
+        pid = fork();
+        if (pid == 0) {
+            for (int j = 0; j < 5000; ++j) {
+                shared->rwlock.writeLock();
+                shared->left++;
+                shared->right++;
+                shared->rwlock.writeUnlock();
+            }
+            _exit(0);
+        }
+        children.push_back(pid);
+    }
+    int tornReads = 0;
+    for (int i = 0; i < 5000; ++i) {
+        shared->rwlock.readLock();
+        tornReads += shared->left != shared->right;
+        shared->rwlock.readUnlock();
+    }
+    childrenOk = waitForChildren(children);
+    std::cout << "ProcessRWLock, 2 writer processes + reader: " << tornReads << " torn reads, total "
+              << shared->left << (childrenOk && tornReads == 0 && shared->left == 10000 ? " ✓" : " ✗")
+              << std::endl;
+
+    pid = fork();
+    if (pid == 0) {
+        shared->rwlock.writeLock();
+        _exit(0); // Dies holding the write lock
+    }
+    waitpid(pid, nullptr, 0);
+    bool takenOver = shared->rwlock.writeLock() == LockResult::OWNER_DIED;
+    shared->rwlock.writeUnlock();
+    bool readable = shared->rwlock.tryReadLock();
+    if (readable) shared->rwlock.readUnlock();
+    std::cout << "Dead writer detected and lock taken over: " << (takenOver && readable ? "✓" : "✗")
+              << std::endl;
+
+    // Barrier: five processes, three generations
+    const uint32_t rounds = 3;
+    auto runRounds = [&] {
+        bool ok = true;
+        for (uint32_t round = 0; round < rounds; ++round) {
+            shared->arrivals++;
+            if (shared->barrier.wait()) shared->serialWaiters++;
+            ok = ok && shared->arrivals.load() >= 5 * (round + 1);
+            shared->barrier.wait();
+        }
+        return ok;
+    };
+    children.clear();
+    for (int i = 0; i < 4; ++i) {
+        pid = fork();
+        if (pid == 0) {
+            _exit(runRounds() ? 0 : 1);
+        }
+        children.push_back(pid);
+    }
+    bool parentOk = runRounds();
+    childrenOk = waitForChildren(children);
+    std::cout << "ProcessBarrier, 5 processes x " << rounds << " rounds: "
+              << (parentOk && childrenOk && shared->serialWaiters.load() == rounds ? "✓" : "✗") << std::endl;
+
+    shared->~SharedSyncState();
+}
+
 void testSynchronization() {
     std::cout << "\n";
     std::cout << "========================================\n";
@@ -476,10 +2631,14 @@ void testSynchronization() {
 
     testRaceCondition();
     testMutex();
+    testAdaptiveLocks();
     testSemaphore();
     testRWLock();
+    testScalableReadLocks();
     testBarrier();
+    testProcessSharedSync();
     testDeadlockPrevention();
+    testLockProfiling();
 
     std::cout << "✓ Synchronization test completed\n" << std::endl;
 }